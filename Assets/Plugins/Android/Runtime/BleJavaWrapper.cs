@@ -19,12 +19,55 @@ namespace toio.Android
         private IntPtr bleDeviceCls;
         private IntPtr javaBleManagerObj;
 
+        // method ids are resolved once in Initialize
+        private IntPtr managerGetScannerMethod;
+        private IntPtr managerConnectMethod;
+        private IntPtr managerGetDeviceByAddrMethod;
+        private IntPtr managerGetConnectedDeviceNumMethod;
+        private IntPtr managerGetConnectedDeviceMethod;
+        private IntPtr managerDisconnectMethod;
+        private IntPtr managerUpdateDisconnectedMethod;
+        private IntPtr managerGetDisconnectedDeviceNumMethod;
+        private IntPtr managerGetDisconnectedDeviceAddrMethod;
+        private IntPtr managerGetDeviceKeysVersionMethod;
+
+        private IntPtr scannerStartScanWithUuidMethod;
+        private IntPtr scannerStartScanMethod;
+        private IntPtr scannerAddScanFilterMethod;
+        private IntPtr scannerClearScanFilterMethod;
+        private IntPtr scannerStopScanMethod;
+        private IntPtr scannerBlitMethod;
+        private IntPtr scannerGetDeviceNumMethod;
+        private IntPtr scannerGetDeviceAddrMethod;
+        private IntPtr scannerGetDeviceNameByAddrMethod;
+        private IntPtr scannerGetRssiByAddrMethod;
+
+        private IntPtr deviceWriteDataMethod;
+        private IntPtr deviceSetNotificationMethod;
+        private IntPtr deviceReadRequestMethod;
+        private IntPtr deviceBlitMethod;
+        private IntPtr deviceGetAddressMethod;
+        private IntPtr deviceGetReadNumMethod;
+        private IntPtr deviceGetServiceUuidFromReadDataMethod;
+        private IntPtr deviceGetCharacteristicFromReadDataMethod;
+        private IntPtr deviceIsNotifyReadDataMethod;
+        private IntPtr deviceGetDataFromReadDataMethod;
+        private IntPtr deviceBlitCharaMethod;
+        private IntPtr deviceGetKeysNumMethod;
+        private IntPtr deviceGetServiceUuidFromKeysMethod;
+        private IntPtr deviceGetCharastricUuidFromKeysMethod;
+
+        // libblepluginandroid.so is loaded by BleManagerObj; without it every update goes through JNI
+        private bool isNativeBridgeAvailable;
+
         private ArgJvalueBuilder argBuilder;
 
         private List<BleScannedDevice> scannedDevices = new List<BleScannedDevice>();
         private List<BleCharacteristicData> readDatas = new List<BleCharacteristicData>();
         private List<string> disconnectedDevices = new List<string>();
         private Dictionary<string, List<BleCharastericsKeyInfo> > charastericsKeyInfos = new Dictionary<string, List<BleCharastericsKeyInfo> >();
+        // BleManagerObj.getDeviceKeysVersion at the last pass that found keys for every connected device
+        private int charastericsKeysVersion = -1;
 
         public void Initialize()
         {
@@ -45,6 +88,48 @@ namespace toio.Android
             AndroidJNI.CallVoidMethod(javaBleManagerObj, initMethod, argBuilder.Build());
 
             AndroidJNI.PopLocalFrame(IntPtr.Zero);
+            this.CacheMethodIds();
+            this.isNativeBridgeAvailable = BleNativeBridge.IsAvailable();
+        }
+
+        private void CacheMethodIds()
+        {
+            managerGetScannerMethod = AndroidJNI.GetMethodID(bleManagerCls, "getScanner", "()Lcom/toio/ble/BleScannerObj;");
+            managerConnectMethod = AndroidJNI.GetMethodID(bleManagerCls, "connect", "(Ljava/lang/String;)Lcom/toio/ble/BleDeviceObj;");
+            managerGetDeviceByAddrMethod = AndroidJNI.GetMethodID(bleManagerCls, "getDeviceByAddr", "(Ljava/lang/String;)Lcom/toio/ble/BleDeviceObj;");
+            managerGetConnectedDeviceNumMethod = AndroidJNI.GetMethodID(bleManagerCls, "getConnectedDeviceNum", "()I");
+            managerGetConnectedDeviceMethod = AndroidJNI.GetMethodID(bleManagerCls, "getConnectedDevice", "(I)Lcom/toio/ble/BleDeviceObj;");
+            managerDisconnectMethod = AndroidJNI.GetMethodID(bleManagerCls, "disconnect", "(Ljava/lang/String;)V");
+            managerUpdateDisconnectedMethod = AndroidJNI.GetMethodID(bleManagerCls, "updateDisconnected", "()V");
+            managerGetDisconnectedDeviceNumMethod = AndroidJNI.GetMethodID(bleManagerCls, "getDisconnectedDeviceNum", "()I");
+            managerGetDisconnectedDeviceAddrMethod = AndroidJNI.GetMethodID(bleManagerCls, "getDisconnectedDeviceAddr", "(I)Ljava/lang/String;");
+            managerGetDeviceKeysVersionMethod = AndroidJNI.GetMethodID(bleManagerCls, "getDeviceKeysVersion", "()I");
+
+            scannerStartScanWithUuidMethod = AndroidJNI.GetMethodID(bleScannerCls, "startScan", "(Ljava/lang/String;)V");
+            scannerStartScanMethod = AndroidJNI.GetMethodID(bleScannerCls, "startScan", "()V");
+            scannerAddScanFilterMethod = AndroidJNI.GetMethodID(bleScannerCls, "addScanFilter", "(Ljava/lang/String;)V");
+            scannerClearScanFilterMethod = AndroidJNI.GetMethodID(bleScannerCls, "clearScanFilter", "()V");
+            scannerStopScanMethod = AndroidJNI.GetMethodID(bleScannerCls, "stopScan", "()V");
+            scannerBlitMethod = AndroidJNI.GetMethodID(bleScannerCls, "blit", "()V");
+            scannerGetDeviceNumMethod = AndroidJNI.GetMethodID(bleScannerCls, "getDeviceNum", "()I");
+            scannerGetDeviceAddrMethod = AndroidJNI.GetMethodID(bleScannerCls, "getDeviceAddr", "(I)Ljava/lang/String;");
+            scannerGetDeviceNameByAddrMethod = AndroidJNI.GetMethodID(bleScannerCls, "getDeviceNameByAddr", "(Ljava/lang/String;)Ljava/lang/String;");
+            scannerGetRssiByAddrMethod = AndroidJNI.GetMethodID(bleScannerCls, "getRssiByAddr", "(Ljava/lang/String;)I");
+
+            deviceWriteDataMethod = AndroidJNI.GetMethodID(bleDeviceCls, "writeData", "(Ljava/lang/String;Ljava/lang/String;[BZ)V");
+            deviceSetNotificationMethod = AndroidJNI.GetMethodID(bleDeviceCls, "setNotification", "(Ljava/lang/String;Ljava/lang/String;Z)V");
+            deviceReadRequestMethod = AndroidJNI.GetMethodID(bleDeviceCls, "readRequest", "(Ljava/lang/String;Ljava/lang/String;)V");
+            deviceBlitMethod = AndroidJNI.GetMethodID(bleDeviceCls, "blit", "()V");
+            deviceGetAddressMethod = AndroidJNI.GetMethodID(bleDeviceCls, "getAddress", "()Ljava/lang/String;");
+            deviceGetReadNumMethod = AndroidJNI.GetMethodID(bleDeviceCls, "getReadNum", "()I");
+            deviceGetServiceUuidFromReadDataMethod = AndroidJNI.GetMethodID(bleDeviceCls, "getServiceUuidFromReadData", "(I)Ljava/lang/String;");
+            deviceGetCharacteristicFromReadDataMethod = AndroidJNI.GetMethodID(bleDeviceCls, "getCharacteristicFromReadData", "(I)Ljava/lang/String;");
+            deviceIsNotifyReadDataMethod = AndroidJNI.GetMethodID(bleDeviceCls, "isNotifyReadData", "(I)Z");
+            deviceGetDataFromReadDataMethod = AndroidJNI.GetMethodID(bleDeviceCls, "getDataFromReadData", "(I)[B");
+            deviceBlitCharaMethod = AndroidJNI.GetMethodID(bleDeviceCls, "blitChara", "()V");
+            deviceGetKeysNumMethod = AndroidJNI.GetMethodID(bleDeviceCls, "getKeysNum", "()I");
+            deviceGetServiceUuidFromKeysMethod = AndroidJNI.GetMethodID(bleDeviceCls, "getServiceUuidFromKeys", "(I)Ljava/lang/String;");
+            deviceGetCharastricUuidFromKeysMethod = AndroidJNI.GetMethodID(bleDeviceCls, "getCharastricUuidFromKeys", "(I)Ljava/lang/String;");
         }
         private IntPtr GetGlobalRefClass(string name)
         {
@@ -68,11 +153,9 @@ namespace toio.Android
         {
             AndroidJNI.PushLocalFrame(32);
             var scanner = GetScanner();
-            var scanMethod = AndroidJNI.GetMethodID(this.bleScannerCls, "startScan", "(Ljava/lang/String;)V");
-
             this.argBuilder.Clear().Append(ArgJvalueBuilder.GenerateJvalue(uuid));
 
-            AndroidJNI.CallVoidMethod(scanner, scanMethod, this.argBuilder.Build());
+            AndroidJNI.CallVoidMethod(scanner, this.scannerStartScanWithUuidMethod, this.argBuilder.Build());
             AndroidJNI.PopLocalFrame(IntPtr.Zero);
         }
 
@@ -80,22 +163,19 @@ namespace toio.Android
         {
             AndroidJNI.PushLocalFrame(32);
             var scanner = GetScanner();
-            var startScanMethod = AndroidJNI.GetMethodID(this.bleScannerCls, "startScan", "()V");
-            var addScanFilterMethod = AndroidJNI.GetMethodID(this.bleScannerCls, "addScanFilter", "(Ljava/lang/String;)V");
-            var clearScanMethod = AndroidJNI.GetMethodID(this.bleScannerCls, "clearScanFilter", "()V");
 
-            AndroidJNI.CallVoidMethod(scanner, clearScanMethod, null);
+            AndroidJNI.CallVoidMethod(scanner, this.scannerClearScanFilterMethod, null);
 
             if (uuids != null)
             {
                 foreach (var uuid in uuids)
                 {
                     this.argBuilder.Clear().Append(ArgJvalueBuilder.GenerateJvalue(uuid));
-                    AndroidJNI.CallVoidMethod(scanner, addScanFilterMethod, this.argBuilder.Build());
+                    AndroidJNI.CallVoidMethod(scanner, this.scannerAddScanFilterMethod, this.argBuilder.Build());
                 }
             }
 
-            AndroidJNI.CallVoidMethod(scanner, startScanMethod, null);
+            AndroidJNI.CallVoidMethod(scanner, this.scannerStartScanMethod, null);
             AndroidJNI.PopLocalFrame(IntPtr.Zero);
         }
 
@@ -103,31 +183,30 @@ namespace toio.Android
         {
             AndroidJNI.PushLocalFrame(32);
             var scanner = GetScanner();
-            var scanMethod = AndroidJNI.GetMethodID(this.bleScannerCls, "stopScan", "()V");
-            AndroidJNI.CallVoidMethod(scanner, scanMethod, null);
+            AndroidJNI.CallVoidMethod(scanner, this.scannerStopScanMethod, null);
             AndroidJNI.PopLocalFrame(IntPtr.Zero);
         }
 
         public void UpdateScannerResult()
         {
+            scannedDevices.Clear();
+            if (this.isNativeBridgeAvailable &&
+                BleNativeBridge.UpdateScanResult(this.javaBleManagerObj, this.scannedDevices))
+            {
+                return;
+            }
             AndroidJNI.PushLocalFrame(32);
             var scanner = GetScanner();
-            var blitMethod = AndroidJNI.GetMethodID(this.bleScannerCls, "blit", "()V");
-            var getDeviceNumMethod = AndroidJNI.GetMethodID(this.bleScannerCls, "getDeviceNum", "()I");
-            var getDeviceAddrMethod = AndroidJNI.GetMethodID(this.bleScannerCls, "getDeviceAddr", "(I)Ljava/lang/String;");
-            var getDeviceNameByAddrMethod = AndroidJNI.GetMethodID(this.bleScannerCls, "getDeviceNameByAddr", "(Ljava/lang/String;)Ljava/lang/String;");
-            var getRssiByAddrMethod = AndroidJNI.GetMethodID(this.bleScannerCls, "getRssiByAddr", "(Ljava/lang/String;)I");
-
-            AndroidJNI.CallVoidMethod(scanner, blitMethod, null);
-            int num = AndroidJNI.CallIntMethod(scanner, getDeviceNumMethod, null);
-            scannedDevices.Clear();
+
+            AndroidJNI.CallVoidMethod(scanner, this.scannerBlitMethod, null);
+            int num = AndroidJNI.CallIntMethod(scanner, this.scannerGetDeviceNumMethod, null);
             for (int i = 0; i < num; ++i)
             {
                 argBuilder.Clear().Append(ArgJvalueBuilder.GenerateJvalue(i));
-                string addr = AndroidJNI.CallStringMethod(scanner, getDeviceAddrMethod, argBuilder.Build());
+                string addr = AndroidJNI.CallStringMethod(scanner, this.scannerGetDeviceAddrMethod, argBuilder.Build());
                 argBuilder.Clear().Append(ArgJvalueBuilder.GenerateJvalue(addr));
-                string name = AndroidJNI.CallStringMethod(scanner, getDeviceNameByAddrMethod, argBuilder.Build());
-                int rssi = AndroidJNI.CallIntMethod(scanner, getRssiByAddrMethod, argBuilder.Build());
+                string name = AndroidJNI.CallStringMethod(scanner, this.scannerGetDeviceNameByAddrMethod, argBuilder.Build());
+                int rssi = AndroidJNI.CallIntMethod(scanner, this.scannerGetRssiByAddrMethod, argBuilder.Build());
                 var scanDevice = new BleScannedDevice(addr, name, rssi);
                 this.scannedDevices.Add(scanDevice);
             }
@@ -136,9 +215,8 @@ namespace toio.Android
 
         public void ConnectRequest(string addr)
         {
-            var connectMethod = AndroidJNI.GetMethodID(this.bleManagerCls, "connect", "(Ljava/lang/String;)Lcom/toio/ble/BleDeviceObj;");
             this.argBuilder.Clear().Append(ArgJvalueBuilder.GenerateJvalue(addr));
-            AndroidJNI.CallObjectMethod(this.javaBleManagerObj, connectMethod, this.argBuilder.Build());
+            AndroidJNI.CallObjectMethod(this.javaBleManagerObj, this.managerConnectMethod, this.argBuilder.Build());
         }
 
         public List<BleScannedDevice> GetScannedDevices()
@@ -162,59 +240,68 @@ namespace toio.Android
             bool withResponse)
         {
             var deviceObj = GetDeviceObj(addr);
-            var writeMethod = AndroidJNI.GetMethodID(bleDeviceCls, "writeData",
-                "(Ljava/lang/String;Ljava/lang/String;[BZ)V");
             this.argBuilder.Clear().
                 Append(ArgJvalueBuilder.GenerateJvalue(serviceUuid)).
                 Append(ArgJvalueBuilder.GenerateJvalue(characteristicUUID)).
                 Append(ArgJvalueBuilder.GenerateJvalue(data, length)).
                 Append(ArgJvalueBuilder.GenerateJvalue(withResponse));
-            AndroidJNI.CallVoidMethod(deviceObj, writeMethod, this.argBuilder.Build());
+            AndroidJNI.CallVoidMethod(deviceObj, this.deviceWriteDataMethod, this.argBuilder.Build());
         }
 
         public void SetNotificateFlag(string addr, string serviceUuid,
             string characteristicUUID, bool isEnable)
         {
             var deviceObj = GetDeviceObj(addr);
-            var setNotificationMethod = AndroidJNI.GetMethodID(bleDeviceCls, "setNotification",
-                "(Ljava/lang/String;Ljava/lang/String;Z)V");
             this.argBuilder.Clear().
                 Append(ArgJvalueBuilder.GenerateJvalue(serviceUuid)).
                 Append(ArgJvalueBuilder.GenerateJvalue(characteristicUUID)).
                 Append(ArgJvalueBuilder.GenerateJvalue(isEnable));
-            AndroidJNI.CallVoidMethod(deviceObj, setNotificationMethod, this.argBuilder.Build());
+            AndroidJNI.CallVoidMethod(deviceObj, this.deviceSetNotificationMethod, this.argBuilder.Build());
         }
 
         public void ReadCharacteristicRequest(string addr, string serviceUuid,
             string characteristicUUID )
         {
             var deviceObj = GetDeviceObj(addr);
-            var readrequestMethod = AndroidJNI.GetMethodID(bleDeviceCls, "readRequest",
-                "(Ljava/lang/String;Ljava/lang/String;)V");
             this.argBuilder.Clear().
                 Append(ArgJvalueBuilder.GenerateJvalue(serviceUuid)).
                 Append(ArgJvalueBuilder.GenerateJvalue(characteristicUUID));
-            AndroidJNI.CallVoidMethod(deviceObj, readrequestMethod, this.argBuilder.Build());
+            AndroidJNI.CallVoidMethod(deviceObj, this.deviceReadRequestMethod, this.argBuilder.Build());
         }
 
         public void UpdateConnectedDevices()
         {
             this.readDatas.Clear();
             AndroidJNI.PushLocalFrame(32);
-            var getConnectedDeviceNumMethod = AndroidJNI.GetMethodID(bleManagerCls, 
-                "getConnectedDeviceNum", "()I");
-            var getConnectedDeviceMethod = AndroidJNI.GetMethodID(bleManagerCls,
-                "getConnectedDevice", "(I)Lcom/toio/ble/BleDeviceObj;");
-            int num = AndroidJNI.CallIntMethod(javaBleManagerObj, getConnectedDeviceNumMethod, null);
-            
+            int num = AndroidJNI.CallIntMethod(javaBleManagerObj, this.managerGetConnectedDeviceNumMethod, null);
+            bool readByNative = this.isNativeBridgeAvailable &&
+                BleNativeBridge.UpdateDeviceData(this.javaBleManagerObj, this.readDatas);
+            // with the native bridge the devices are walked only when a device or its keys changed
+            int keysVersion = AndroidJNI.CallIntMethod(this.javaBleManagerObj, this.managerGetDeviceKeysVersionMethod, null);
+            if (readByNative && keysVersion == this.charastericsKeysVersion)
+            {
+                AndroidJNI.PopLocalFrame(IntPtr.Zero);
+                return;
+            }
+
+            bool isAllKeysKnown = true;
             for (int i = 0; i < num; ++i)
             {
                 AndroidJNI.PushLocalFrame(32);
                 this.argBuilder.Clear().Append(ArgJvalueBuilder.GenerateJvalue(i));
-                var device = AndroidJNI.CallObjectMethod(this.javaBleManagerObj, getConnectedDeviceMethod, argBuilder.Build());
-                this.UpdateBleDevice(device);
+                var device = AndroidJNI.CallObjectMethod(this.javaBleManagerObj, this.managerGetConnectedDeviceMethod, argBuilder.Build());
+                if (readByNative)
+                {
+                    isAllKeysKnown &= this.UpdateBleDeviceKeys(device);
+                }
+                else
+                {
+                    this.UpdateBleDevice(device);
+                }
                 AndroidJNI.PopLocalFrame(IntPtr.Zero);
             }
+            // a device still discovering its services keeps the walk going next frame
+            this.charastericsKeysVersion = isAllKeysKnown ? keysVersion : -1;
             AndroidJNI.PopLocalFrame(IntPtr.Zero);
         }
 
@@ -226,32 +313,34 @@ namespace toio.Android
             SafeRelease(ref bleDeviceCls);
             SafeRelease(ref javaBleManagerObj);
         }
+        // returns whether the device's characteristic keys are known
+        private bool UpdateBleDeviceKeys(IntPtr device)
+        {
+            if(device == IntPtr.Zero) { return false; }
+            string addr = AndroidJNI.CallStringMethod(device, this.deviceGetAddressMethod, null);
+            this.UpdateCharastricsKeys(addr, device);
+            return this.charastericsKeyInfos.ContainsKey(addr);
+        }
+
         private void UpdateBleDevice(IntPtr device)
         {
             if(device == IntPtr.Zero) { return; }
             AndroidJNI.PushLocalFrame(64);
-            var blitMethod = AndroidJNI.GetMethodID(bleDeviceCls, "blit", "()V");
-            var getAddrMethod = AndroidJNI.GetMethodID(bleDeviceCls, "getAddress", "()Ljava/lang/String;");
-            var readNumMethod = AndroidJNI.GetMethodID(bleDeviceCls, "getReadNum", "()I");
-            var getCharacteristicMethod = AndroidJNI.GetMethodID(bleDeviceCls, "getCharacteristicFromReadData", "(I)Ljava/lang/String;");
-            var getServiceUuidMethod = AndroidJNI.GetMethodID(bleDeviceCls, "getServiceUuidFromReadData", "(I)Ljava/lang/String;");
-            var isNotifyMethod = AndroidJNI.GetMethodID(bleDeviceCls, "isNotifyReadData", "(I)Z");
-            var getReadDataMethod = AndroidJNI.GetMethodID(bleDeviceCls, "getDataFromReadData", "(I)[B");
-
-            string addr = AndroidJNI.CallStringMethod(device, getAddrMethod, null);
+
+            string addr = AndroidJNI.CallStringMethod(device, this.deviceGetAddressMethod, null);
             this.UpdateCharastricsKeys(addr, device);
 
             // read Charastrics Data
-            AndroidJNI.CallVoidMethod(device, blitMethod, null);
-            int readNum = AndroidJNI.CallIntMethod(device, readNumMethod,null);
+            AndroidJNI.CallVoidMethod(device, this.deviceBlitMethod, null);
+            int readNum = AndroidJNI.CallIntMethod(device, this.deviceGetReadNumMethod,null);
             
             for ( int i = 0; i < readNum; ++i)
             {
                 this.argBuilder.Clear().Append(ArgJvalueBuilder.GenerateJvalue(i));
-                string serviceUuid = AndroidJNI.CallStringMethod(device, getServiceUuidMethod, argBuilder.Build());
-                string charastristic = AndroidJNI.CallStringMethod(device,getCharacteristicMethod,argBuilder.Build() );
-                bool isNotify = AndroidJNI.CallBooleanMethod(device, isNotifyMethod, argBuilder.Build());
-                var dataObj = AndroidJNI.CallObjectMethod(device, getReadDataMethod, argBuilder.Build());
+                string serviceUuid = AndroidJNI.CallStringMethod(device, this.deviceGetServiceUuidFromReadDataMethod, argBuilder.Build());
+                string charastristic = AndroidJNI.CallStringMethod(device,this.deviceGetCharacteristicFromReadDataMethod,argBuilder.Build() );
+                bool isNotify = AndroidJNI.CallBooleanMethod(device, this.deviceIsNotifyReadDataMethod, argBuilder.Build());
+                var dataObj = AndroidJNI.CallObjectMethod(device, this.deviceGetDataFromReadDataMethod, argBuilder.Build());
                 var sbytes = AndroidJNI.FromSByteArray(dataObj);
                 var characteristicData = new BleCharacteristicData(addr,serviceUuid, charastristic, sbytes, isNotify);
                 this.readDatas.Add(characteristicData);
@@ -266,15 +355,9 @@ namespace toio.Android
             {
                 return;
             }
-            var blitCharaMethod = AndroidJNI.GetMethodID(this.bleDeviceCls, "blitChara", "()V");
-            var getKeyNumMethod = AndroidJNI.GetMethodID(this.bleDeviceCls, "getKeysNum", "()I");
-            var getServiceUuidFromKeysMethod = AndroidJNI.GetMethodID(this.bleDeviceCls,
-                "getServiceUuidFromKeys", "(I)Ljava/lang/String;");
-            var getCharastricUuidFromKeysMethod = AndroidJNI.GetMethodID(this.bleDeviceCls,
-                "getCharastricUuidFromKeys", "(I)Ljava/lang/String;");
             // blit chara
-            AndroidJNI.CallVoidMethod(device, blitCharaMethod, null);
-            int num = AndroidJNI.CallIntMethod(device, getKeyNumMethod,null);
+            AndroidJNI.CallVoidMethod(device, this.deviceBlitCharaMethod, null);
+            int num = AndroidJNI.CallIntMethod(device, this.deviceGetKeysNumMethod,null);
             if (num <= 0)
             {
                 return;
@@ -283,8 +366,8 @@ namespace toio.Android
             for( int i =0;i < num; ++i)
             {
                 this.argBuilder.Clear().Append(ArgJvalueBuilder.GenerateJvalue(i));
-                string serviceUuid = AndroidJNI.CallStringMethod(device, getServiceUuidFromKeysMethod, argBuilder.Build());
-                string charastricUuid = AndroidJNI.CallStringMethod(device, getCharastricUuidFromKeysMethod, argBuilder.Build());
+                string serviceUuid = AndroidJNI.CallStringMethod(device, this.deviceGetServiceUuidFromKeysMethod, argBuilder.Build());
+                string charastricUuid = AndroidJNI.CallStringMethod(device, this.deviceGetCharastricUuidFromKeysMethod, argBuilder.Build());
                 var keyInfo = new BleCharastericsKeyInfo(addr, serviceUuid, charastricUuid);
                 list.Add(keyInfo);
             }
@@ -293,35 +376,31 @@ namespace toio.Android
         }
         public void Disconnect(string addr)
         {
-            var disconnectMethod = AndroidJNI.GetMethodID(this.bleManagerCls,
-                "disconnect", "(Ljava/lang/String;)V");
             this.argBuilder.Clear().Append(ArgJvalueBuilder.GenerateJvalue(addr));
             AndroidJNI.CallVoidMethod(this.javaBleManagerObj, 
-                disconnectMethod, this.argBuilder.Build());
+                this.managerDisconnectMethod, this.argBuilder.Build());
         }
 
         public void UpdateDisconnectedDevices()
         {
-            var updateDisconnectedMethod = AndroidJNI.GetMethodID(this.bleManagerCls,
-                "updateDisconnected", "()V");
-            var getDisconnectedNumMethod = AndroidJNI.GetMethodID(this.bleManagerCls,
-                "getDisconnectedDeviceNum", "()I");
-            var getDisconnectedDeviceAddr = AndroidJNI.GetMethodID(this.bleManagerCls,
-                "getDisconnectedDeviceAddr", "(I)Ljava/lang/String;");
-            AndroidJNI.CallVoidMethod(this.javaBleManagerObj, updateDisconnectedMethod, null);
+            AndroidJNI.CallVoidMethod(this.javaBleManagerObj, this.managerUpdateDisconnectedMethod, null);
             disconnectedDevices.Clear();
 
-            int num = AndroidJNI.CallIntMethod(this.javaBleManagerObj, getDisconnectedNumMethod, null);
+            int num = AndroidJNI.CallIntMethod(this.javaBleManagerObj, this.managerGetDisconnectedDeviceNumMethod, null);
             for(int i = 0; i < num; ++i)
             {
                 this.argBuilder.Clear().Append( ArgJvalueBuilder.GenerateJvalue(i) );
                 string addr = AndroidJNI.CallStringMethod(this.javaBleManagerObj,
-                    getDisconnectedDeviceAddr,this.argBuilder.Build());
+                    this.managerGetDisconnectedDeviceAddrMethod,this.argBuilder.Build());
                 this.disconnectedDevices.Add(addr);
             }
 
             foreach (var addr in disconnectedDevices)
                 this.charastericsKeyInfos.Remove(addr);
+            if (disconnectedDevices.Count > 0)
+            {
+                this.charastericsKeysVersion = -1;
+            }
         }
         public List<string> GetDisconnectedDevices()
         {
@@ -330,15 +409,13 @@ namespace toio.Android
 
         private System.IntPtr GetScanner()
         {
-            var getScanner = AndroidJNI.GetMethodID(bleManagerCls, "getScanner", "()Lcom/toio/ble/BleScannerObj;");
-            var scanner = AndroidJNI.CallObjectMethod(this.javaBleManagerObj, getScanner, null);
+            var scanner = AndroidJNI.CallObjectMethod(this.javaBleManagerObj, this.managerGetScannerMethod, null);
             return scanner;
         }
         private System.IntPtr GetDeviceObj(string addr)
         {
-            var getDeviceMethod = AndroidJNI.GetMethodID(bleManagerCls, "getDeviceByAddr", "(Ljava/lang/String;)Lcom/toio/ble/BleDeviceObj;");
             this.argBuilder.Clear().Append(ArgJvalueBuilder.GenerateJvalue(addr));
-            var deviceObj = AndroidJNI.CallObjectMethod(this.javaBleManagerObj, getDeviceMethod, this.argBuilder.Build());
+            var deviceObj = AndroidJNI.CallObjectMethod(this.javaBleManagerObj, this.managerGetDeviceByAddrMethod, this.argBuilder.Build());
             return deviceObj;
         }
 
@@ -0,0 +1,154 @@
+
+#if UNITY_ANDROID && !UNITY_EDITOR
+#define UNITY_ANDROID_RUNTIME
+#endif
+
+
+#if UNITY_ANDROID_RUNTIME
+using System;
+using System.Collections.Generic;
+using System.Runtime.InteropServices;
+using System.Text;
+using toio.Android.Data;
+
+namespace toio.Android
+{
+    // libblepluginandroid.so : reads the buffers BleScannerObj/BleManagerObj pack on the Java side.
+    // layout: bleplugin_projects/Android/BlePluginAndroid/BlePackedBuffer.h
+    internal static class BleNativeBridge
+    {
+        private const string DLL_NAME = "blepluginandroid";
+        private const int ScanRecordSize = 10;
+        private const int DeviceDataRecordSize = 42;
+        private const byte DeviceDataNotify = 0x01;
+
+        [DllImport(DLL_NAME)]
+        [return: MarshalAs(UnmanagedType.U1)]
+        private static extern bool _BlePluginAndroidIsAvailable();
+        [DllImport(DLL_NAME)]
+        private static extern int _BlePluginAndroidUpdateScanResult(IntPtr manager, out IntPtr buffer);
+        [DllImport(DLL_NAME)]
+        private static extern int _BlePluginAndroidUpdateDeviceData(IntPtr manager, out IntPtr buffer);
+
+        private static byte[] buffer = new byte[4096];
+        private static Dictionary<ulong, string> addrStrings = new Dictionary<ulong, string>();
+        private static Dictionary<Guid, string> uuidStrings = new Dictionary<Guid, string>();
+
+        public static bool IsAvailable()
+        {
+            try
+            {
+                return _BlePluginAndroidIsAvailable();
+            }
+            catch (DllNotFoundException)
+            {
+                return false;
+            }
+            catch (EntryPointNotFoundException)
+            {
+                return false;
+            }
+        }
+
+        // returns false when the caller should fall back to the JNI path
+        public static bool UpdateScanResult(IntPtr manager, List<BleScannedDevice> scannedDevices)
+        {
+            IntPtr ptr;
+            int size = _BlePluginAndroidUpdateScanResult(manager, out ptr);
+            if (size < 0 || ptr == IntPtr.Zero) { return false; }
+            var data = CopyBuffer(ptr, size);
+
+            int num = BitConverter.ToInt32(data, 0);
+            int offset = 4;
+            for (int i = 0; i < num; ++i)
+            {
+                string addr = GetAddress(data, offset);
+                int rssi = BitConverter.ToInt16(data, offset + 6);
+                int nameLength = BitConverter.ToUInt16(data, offset + 8);
+                string name = (nameLength > 0) ? Encoding.UTF8.GetString(data, offset + ScanRecordSize, nameLength) : null;
+                scannedDevices.Add(new BleScannedDevice(addr, name, rssi));
+                offset += ScanRecordSize + nameLength;
+            }
+            return true;
+        }
+
+        public static bool UpdateDeviceData(IntPtr manager, List<BleCharacteristicData> readDatas)
+        {
+            IntPtr ptr;
+            int size = _BlePluginAndroidUpdateDeviceData(manager, out ptr);
+            if (size < 0 || ptr == IntPtr.Zero) { return false; }
+            var data = CopyBuffer(ptr, size);
+
+            int num = BitConverter.ToInt32(data, 0);
+            int offset = 4;
+            for (int i = 0; i < num; ++i)
+            {
+                string addr = GetAddress(data, offset);
+                bool isNotify = (data[offset + 6] & DeviceDataNotify) != 0;
+                string serviceUuid = GetUuid(data, offset + 8);
+                string characteristic = GetUuid(data, offset + 24);
+                int length = BitConverter.ToUInt16(data, offset + 40);
+                var bytes = new byte[length];
+                Array.Copy(data, offset + DeviceDataRecordSize, bytes, 0, length);
+                readDatas.Add(new BleCharacteristicData(addr, serviceUuid, characteristic, bytes, isNotify));
+                offset += DeviceDataRecordSize + length;
+            }
+            return true;
+        }
+
+        private static byte[] CopyBuffer(IntPtr ptr, int size)
+        {
+            if (buffer.Length < size)
+            {
+                buffer = new byte[Math.Max(size, buffer.Length * 2)];
+            }
+            Marshal.Copy(ptr, buffer, 0, size);
+            return buffer;
+        }
+
+        private static string GetAddress(byte[] data, int offset)
+        {
+            ulong key = 0;
+            for (int i = 0; i < 6; ++i)
+            {
+                key = (key << 8) | data[offset + i];
+            }
+            string addr;
+            if (!addrStrings.TryGetValue(key, out addr))
+            {
+                var sb = new StringBuilder(17);
+                for (int i = 0; i < 6; ++i)
+                {
+                    if (i > 0) { sb.Append(':'); }
+                    sb.Append(data[offset + i].ToString("X2"));
+                }
+                addr = sb.ToString();
+                addrStrings.Add(key, addr);
+            }
+            return addr;
+        }
+
+        // same text as java.util.UUID.toString()
+        private static string GetUuid(byte[] data, int offset)
+        {
+            var key = new Guid(BitConverter.ToInt32(data, offset),
+                BitConverter.ToInt16(data, offset + 4), BitConverter.ToInt16(data, offset + 6),
+                data[offset + 8], data[offset + 9], data[offset + 10], data[offset + 11],
+                data[offset + 12], data[offset + 13], data[offset + 14], data[offset + 15]);
+            string uuid;
+            if (!uuidStrings.TryGetValue(key, out uuid))
+            {
+                var sb = new StringBuilder(36);
+                for (int i = 0; i < 16; ++i)
+                {
+                    if (i == 4 || i == 6 || i == 8 || i == 10) { sb.Append('-'); }
+                    sb.Append(data[offset + i].ToString("x2"));
+                }
+                uuid = sb.ToString();
+                uuidStrings.Add(key, uuid);
+            }
+            return uuid;
+        }
+    }
+}
+#endif
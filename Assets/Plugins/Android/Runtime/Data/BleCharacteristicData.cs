@@ -30,6 +30,17 @@ namespace toio.Android.Data
                 data[i] = unchecked((byte)sbytes[i]);
             }
         }
+
+        public BleCharacteristicData(string addr, string service,
+            string ch, byte[] bytes, bool isNot)
+        {
+            this.deviceAddr = addr;
+            this.serviceUuid = service;
+            this.characteristic = ch;
+            this.isNotify = isNot;
+            this.length = bytes.Length;
+            this.data = bytes;
+        }
     }
 }
 #endif
\ No newline at end of file
@@ -10,11 +10,14 @@ import android.bluetooth.BluetoothProfile;
 import android.content.Context;
 import android.util.Log;
 
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
 import java.util.ArrayList;
 import java.util.HashMap;
 import java.util.List;
 import java.util.Map;
 import java.util.Objects;
+import java.util.UUID;
 
 public class BleDeviceObj extends BluetoothGattCallback {
 
@@ -60,12 +63,16 @@ public class BleDeviceObj extends BluetoothGattCallback {
     private class ReadData{
         public String serviceUuid;
         public String characteristic;
+        public UUID serviceUuidObj;
+        public UUID characteristicObj;
         public byte[] data;
         public boolean isNotification;
 
         public ReadData(BluetoothGattCharacteristic characteristic,boolean notify){
-            this.serviceUuid = characteristic.getService().getUuid().toString();
-            this.characteristic = characteristic.getUuid().toString();
+            this.serviceUuidObj = characteristic.getService().getUuid();
+            this.characteristicObj = characteristic.getUuid();
+            this.serviceUuid = this.serviceUuidObj.toString();
+            this.characteristic = this.characteristicObj.toString();
             byte[] origin = characteristic.getValue();
             // 念のためコピー
             if( origin != null) {
@@ -80,6 +87,8 @@ public class BleDeviceObj extends BluetoothGattCallback {
 
     private ArrayList<ReadData> readDataBuffer = new ArrayList<ReadData>(32);
     private ArrayList<ReadData> pubDataBuffer = new ArrayList<ReadData>(32);
+    // records written by the last packReadData, removed once the native side accepted them
+    private int packedNum = 0;
 
     public void disconnect(){
         if(bluetoothGatt != null){
@@ -88,6 +97,7 @@ public class BleDeviceObj extends BluetoothGattCallback {
         }
         charastricsKeys.clear();
         this.charastricsKeyHashMap.clear();
+        BleManagerObj.notifyDeviceKeysChanged();
         this.isAvailable = false;
         this.disconnected = true;
     }
@@ -102,8 +112,52 @@ public class BleDeviceObj extends BluetoothGattCallback {
                 pubDataBuffer.add(data);
             }
             readDataBuffer.clear();
+            packedNum = 0;
         }
     }
+    private static final int PACKED_RECORD_SIZE = 42;
+
+    // appends the pending read data to buf (called from BleManagerObj.packDeviceData)
+    // nothing is removed here: commitPackedReadData drops the packed records after the native
+    // side validated the buffer, so a failed pack delivers them again on the next call.
+    public int packReadData(ByteBuffer buf){
+        int num = 0;
+        synchronized (this){
+            for(ReadData data : readDataBuffer){
+                int length = (data.data != null) ? data.data.length : 0;
+                if(buf.remaining() < PACKED_RECORD_SIZE + length){
+                    break;
+                }
+                BleScannerObj.putAddress(buf, this.address);
+                buf.put((byte)(data.isNotification ? 1 : 0));
+                buf.put((byte)0);
+                putUuid(buf, data.serviceUuidObj);
+                putUuid(buf, data.characteristicObj);
+                buf.putShort((short)length);
+                if(length > 0){
+                    buf.put(data.data);
+                }
+                ++num;
+            }
+            packedNum = num;
+        }
+        return num;
+    }
+
+    public void commitPackedReadData(){
+        synchronized (this){
+            readDataBuffer.subList(0, Math.min(packedNum, readDataBuffer.size())).clear();
+            packedNum = 0;
+        }
+    }
+
+    private static void putUuid(ByteBuffer buf, UUID uuid){
+        buf.order(ByteOrder.BIG_ENDIAN);
+        buf.putLong(uuid.getMostSignificantBits());
+        buf.putLong(uuid.getLeastSignificantBits());
+        buf.order(ByteOrder.LITTLE_ENDIAN);
+    }
+
     public void blitChara(){
         pubCharastricsKeyHashMap.clear();
         this.charastricsKeys.clear();
@@ -247,6 +301,7 @@ public class BleDeviceObj extends BluetoothGattCallback {
                 }
             }
         }
+        BleManagerObj.notifyDeviceKeysChanged();
         this.isAvailable = true;
     }
 
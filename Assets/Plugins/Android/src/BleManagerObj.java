@@ -6,8 +6,11 @@ import android.bluetooth.BluetoothManager;
 import android.bluetooth.le.BluetoothLeScanner;
 import android.content.Context;
 
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
 import java.util.ArrayList;
 import java.util.HashMap;
+import java.util.concurrent.atomic.AtomicInteger;
 
 public class BleManagerObj {
     private BluetoothAdapter bluetoothAdapter;
@@ -20,6 +23,16 @@ public class BleManagerObj {
     private ArrayList<String> disconnectedDevices;
 
     private static BleManagerObj instance;
+    // bumped whenever a connected device or its characteristic keys change
+    private static final AtomicInteger deviceKeysVersion = new AtomicInteger();
+
+    static {
+        try {
+            System.loadLibrary("blepluginandroid");
+        } catch (UnsatisfiedLinkError e) {
+            // optional; BleJavaWrapper falls back to plain JNI calls
+        }
+    }
 
     private BleManagerObj() {
     }
@@ -52,9 +65,18 @@ public class BleManagerObj {
         BleDeviceObj deviceObj = new BleDeviceObj(device,this.context);
         this.deviceObjHashMap.put(addr,deviceObj);
         this.bluetoothDeviceObjs.add(deviceObj);
+        notifyDeviceKeysChanged();
         return  deviceObj;
     }
 
+    static void notifyDeviceKeysChanged(){
+        deviceKeysVersion.incrementAndGet();
+    }
+    // lets the managed side skip the per-device key walk while nothing changed
+    public int getDeviceKeysVersion(){
+        return deviceKeysVersion.get();
+    }
+
     public BleDeviceObj getDeviceByAddr(String addr){
         return this.deviceObjHashMap.get(addr);
     }
@@ -69,6 +91,26 @@ public class BleManagerObj {
         return this.bluetoothDeviceObjs.get(idx);
     }
 
+    // packs read data of every connected device into buf for the native bridge
+    public int packDeviceData(ByteBuffer buf){
+        buf.clear();
+        buf.order(ByteOrder.LITTLE_ENDIAN);
+        buf.putInt(0);
+        int num = 0;
+        for(BleDeviceObj deviceObj : this.bluetoothDeviceObjs){
+            num += deviceObj.packReadData(buf);
+        }
+        buf.putInt(0, num);
+        return buf.position();
+    }
+
+    // called by the native bridge once the packed device data passed validation
+    public void commitDeviceData(){
+        for(BleDeviceObj deviceObj : this.bluetoothDeviceObjs){
+            deviceObj.commitPackedReadData();
+        }
+    }
+
     public void disconnect(String addr){
         BleDeviceObj obj = this.deviceObjHashMap.get(addr);
         if( obj != null) {
@@ -84,6 +126,7 @@ public class BleManagerObj {
                 this.disconnectedDevices.add( deviceObj.getAddress());
                 this.deviceObjHashMap.remove(deviceObj.getAddress());
                 this.bluetoothDeviceObjs.remove(i);
+                notifyDeviceKeysChanged();
                 --i;
             }
         }
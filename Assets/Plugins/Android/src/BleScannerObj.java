@@ -8,8 +8,12 @@ import android.bluetooth.le.ScanSettings;
 import android.content.Context;
 import android.os.ParcelUuid;
 
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.nio.charset.StandardCharsets;
 import java.util.ArrayList;
 import java.util.HashMap;
+import java.util.Iterator;
 import java.util.List;
 import java.util.Map;
 import java.util.UUID;
@@ -32,6 +36,9 @@ public class BleScannerObj extends ScanCallback{
     private List<ScanFilter> scanFilters = new ArrayList<>(8);
     private boolean isScanning = false;
 
+    private static final int PACKED_RECORD_SIZE = 10;
+    private static final byte[] EMPTY_NAME = new byte[0];
+
 
 
     public BleScannerObj(BluetoothLeScanner scanner,Context cxt){
@@ -54,6 +61,46 @@ public class BleScannerObj extends ScanCallback{
         }
     }
 
+    // packs the results since the last call into buf for the native bridge
+    // layout: bleplugin_projects/Android/BlePluginAndroid/BlePackedBuffer.h
+    // records that do not fit are kept for the next call.
+    public int packScanResult(ByteBuffer buf){
+        buf.clear();
+        buf.order(ByteOrder.LITTLE_ENDIAN);
+        buf.putInt(0);
+        int num = 0;
+        synchronized (this) {
+            Iterator<Map.Entry<String, BluetoothDevice>> it = bleDevices.entrySet().iterator();
+            while (it.hasNext()) {
+                Map.Entry<String, BluetoothDevice> entry = it.next();
+                String addr = entry.getKey();
+                String name = entry.getValue().getName();
+                byte[] nameBytes = (name != null) ? name.getBytes(StandardCharsets.UTF_8) : EMPTY_NAME;
+                if (buf.remaining() < PACKED_RECORD_SIZE + nameBytes.length) {
+                    break;
+                }
+                putAddress(buf, addr);
+                buf.putShort((short)(int)bleRssi.get(addr));
+                buf.putShort((short)nameBytes.length);
+                buf.put(nameBytes);
+                this.foundDevicesInScan.put(addr, entry.getValue());
+                it.remove();
+                ++num;
+            }
+        }
+        buf.putInt(0, num);
+        return buf.position();
+    }
+
+    // "AA:BB:CC:DD:EE:FF" -> 6 bytes
+    static void putAddress(ByteBuffer buf, String addr){
+        for (int i = 0; i < 6; ++i) {
+            int high = Character.digit(addr.charAt(i * 3), 16);
+            int low = Character.digit(addr.charAt(i * 3 + 1), 16);
+            buf.put((byte)((high << 4) | low));
+        }
+    }
+
     public int getDeviceNum(){
         return pubAddresses.size();
     }
@@ -24,7 +24,7 @@ namespace toio
         private static extern void _uiOSDestroyClient(FinalizedActionDelegate finalizedAction);
 
         [DllImport(DLL_NAME)]
-        private static extern void _uiOSStartDeviceScan(string[] filteredUUIDs, DiscoveredActionDelegate discoveredAction, bool allowDuplicates);
+        private static extern void _uiOSStartDeviceScanBinary(string[] filteredUUIDs, DiscoveredActionDelegate discoveredAction, bool allowDuplicates);
 
         [DllImport(DLL_NAME)]
         private static extern void _uiOSStopDeviceScan();
@@ -32,6 +32,9 @@ namespace toio
         [DllImport(DLL_NAME)]
         private static extern void _uiOSConnectToDevice(string identifier, ConnectedPeripheralActionDelegate connectedPeripheralAction, DiscoveredServiceActionDelegate discoveredServiceAction, DiscoveredCharacteristicActionDelegate discoveredCharacteristicAction, PendingDisconnectedPeripheralActionDelegate disconnectedPeripheralAction);
 
+        [DllImport(DLL_NAME)]
+        private static extern void _uiOSConnectToDeviceWithGattTable(string identifier, ConnectedPeripheralActionDelegate connectedPeripheralAction, DiscoveredGattTableActionDelegate discoveredGattTableAction, PendingDisconnectedPeripheralActionDelegate disconnectedPeripheralAction);
+
         [DllImport(DLL_NAME)]
         private static extern void _uiOSCancelDeviceConnection(string identifier, DisconnectedPeripheralActionDelegate disconnectedPeripheralAction);
 
@@ -39,17 +42,64 @@ namespace toio
         private static extern void _uiOSCancelDeviceConnectionAll();
 
         [DllImport(DLL_NAME)]
-        private static extern void _uiOSReadCharacteristicForDevice(string identifier, string serviceUUID, string characteristicUUID, DidReadCharacteristicActionDelegate didReadChracteristicAction);
+        private static extern void _uiOSReadCharacteristicForDeviceBinary(string identifier, string serviceUUID, string characteristicUUID, DidReadCharacteristicActionDelegate didReadChracteristicAction);
 
         [DllImport(DLL_NAME)]
-        private static extern void _uiOSWriteCharacteristicForDevice(string identifier, string serviceUUID, string characteristicUUID, string data, int length, bool withResponse, DidWriteCharacteristicActionDelegate didWriteCharacteristicAction);
+        private static extern void _uiOSWriteCharacteristicForDeviceBinary(string identifier, string serviceUUID, string characteristicUUID, byte[] data, int length, bool withResponse, DidWriteCharacteristicActionDelegate didWriteCharacteristicAction);
 
         [DllImport(DLL_NAME)]
-        private static extern void _uiOSMonitorCharacteristicForDevice(string identifier, string serviceUUID, string characteristicUUID, NotifiedCharacteristicActionDelegate notifiedCharacteristicAction);
+        private static extern void _uiOSMonitorCharacteristicForDeviceBinary(string identifier, string serviceUUID, string characteristicUUID, NotifiedCharacteristicActionDelegate notifiedCharacteristicAction);
 
         [DllImport(DLL_NAME)]
         private static extern void _uiOSUnMonitorCharacteristicForDevice(string identifier, string serviceUUID, string characteristicUUID);
 
+        [DllImport(DLL_NAME)]
+        private static extern void _uiOSSetNotificationBuffering(bool enable);
+
+        [DllImport(DLL_NAME)]
+        private static extern int _uiOSDrainNotifications([Out] NotificationRecord[] records, int maxNum, [Out] byte[] payload, int payloadSize);
+
+        [DllImport(DLL_NAME)]
+        private static extern int _uiOSGetDroppedNotificationNum();
+
+        [DllImport(DLL_NAME)]
+        private static extern IntPtr _uiOSGetInternedDeviceIdentifier(int deviceId);
+
+        [DllImport(DLL_NAME)]
+        private static extern IntPtr _uiOSGetInternedCharacteristicUUID(int characteristicId);
+
+        [DllImport(DLL_NAME)]
+        private static extern int _uiOSInternDevice(string identifier);
+
+        [DllImport(DLL_NAME)]
+        private static extern int _uiOSInternCharacteristic(string serviceUUID, string characteristicUUID);
+
+        [DllImport(DLL_NAME)]
+        private static extern void _uiOSReadCharacteristicById(int deviceId, int characteristicId, DidReadCharacteristicByIdActionDelegate didReadChracteristicAction);
+
+        [DllImport(DLL_NAME)]
+        private static extern void _uiOSWriteCharacteristicById(int deviceId, int characteristicId, byte[] data, int length, bool withResponse, DidWriteCharacteristicByIdActionDelegate didWriteCharacteristicAction);
+
+        [DllImport(DLL_NAME)]
+        private static extern void _uiOSMonitorCharacteristicById(int deviceId, int characteristicId, NotifiedCharacteristicByIdActionDelegate notifiedCharacteristicAction);
+
+        // copies a payload handed over by the native layer; the pointer is only valid during the callback
+        private static byte[] CopyData(IntPtr data, int length)
+        {
+            // an empty value may come without a buffer; it is still a value, not a missing one
+            if (length == 0)
+            {
+                return new byte[0];
+            }
+            if (data == IntPtr.Zero || length < 0)
+            {
+                return null;
+            }
+            var bytes = new byte[length];
+            Marshal.Copy(data, bytes, 0, length);
+            return bytes;
+        }
+
         //
         // ErrorAction
         //
@@ -96,26 +146,13 @@ namespace toio
         // DiscoveredAction
         //
         private static Action<string, string, int, byte[]> DiscoveredAction = null;
-        private delegate void DiscoveredActionDelegate(string identifier, string name, string rssi, string base64ManufacturerData);
+        private delegate void DiscoveredActionDelegate(string identifier, string name, int rssi, IntPtr manufacturerData, int length);
         [AOT.MonoPInvokeCallback(typeof(DiscoveredActionDelegate))]
-        private static void DiscoveredActionCallback(string identifier, string name, string rssi, string base64ManufacturerData)
+        private static void DiscoveredActionCallback(string identifier, string name, int rssi, IntPtr manufacturerData, int length)
         {
             if (DiscoveredAction != null)
             {
-                int iRssi = 0;
-                if (!int.TryParse(rssi, out iRssi))
-                {
-                    iRssi = 0;
-                }
-
-                byte[] data = null;
-                try
-                {
-                    data = System.Convert.FromBase64String(base64ManufacturerData);
-                }
-                catch { }
-
-                DiscoveredAction(identifier, name, iRssi, data);
+                DiscoveredAction(identifier, name, rssi, CopyData(manufacturerData, length));
             }
         }
 
@@ -167,6 +204,22 @@ namespace toio
         }
 
 
+        //
+        // DiscoveredGattTableAction
+        //
+        private static Dictionary<string, Action<string, byte[]>> DiscoveredGattTableAction = new Dictionary<string, Action<string, byte[]>>();
+        private delegate void DiscoveredGattTableActionDelegate(string identifier, IntPtr table, int length);
+        [AOT.MonoPInvokeCallback(typeof(DiscoveredGattTableActionDelegate))]
+        private static void DiscoveredGattTableActionCallback(string identifier, IntPtr table, int length)
+        {
+            identifier = identifier.ToUpper();
+            Action<string, byte[]> action;
+            if (DiscoveredGattTableAction.TryGetValue(identifier, out action) && action != null)
+            {
+                action(identifier, CopyData(table, length));
+            }
+        }
+
         //
         // PendingDisconnectedPeripheralAction
         //
@@ -201,9 +254,9 @@ namespace toio
         // DidReadCharacteristicAction
         //
         private static Dictionary<string, Dictionary<string, Action<string, string, byte[]>>> DidReadCharacteristicAction = new Dictionary<string, Dictionary<string, Action<string, string, byte[]>>>();
-        private delegate void DidReadCharacteristicActionDelegate(string identifier, string characteristicUUID, string base64Data);
+        private delegate void DidReadCharacteristicActionDelegate(string identifier, string characteristicUUID, IntPtr data, int length);
         [AOT.MonoPInvokeCallback(typeof(DidReadCharacteristicActionDelegate))]
-        private static void DidReadCharacteristicActionCallback(string identifier, string characteristicUUID, string base64Data)
+        private static void DidReadCharacteristicActionCallback(string identifier, string characteristicUUID, IntPtr data, int length)
         {
             identifier = identifier.ToUpper();
             characteristicUUID = characteristicUUID.ToUpper();
@@ -215,8 +268,7 @@ namespace toio
                     var action = actions[characteristicUUID];
                     if (action != null)
                     {
-                        byte[] data = System.Convert.FromBase64String(base64Data);
-                        action(identifier, characteristicUUID, data);
+                        action(identifier, characteristicUUID, CopyData(data, length));
                     }
                 }
             }
@@ -250,12 +302,15 @@ namespace toio
         // NotifiedCharacteristicAction
         //
         private static Dictionary<string, Dictionary<string, Action<string, string, byte[]>>> NotifiedCharacteristicAction = new Dictionary<string, Dictionary<string, Action<string, string, byte[]>>>();
-        private delegate void NotifiedCharacteristicActionDelegate(string identifier, string characteristicUUID, string base64Data);
+        private delegate void NotifiedCharacteristicActionDelegate(string identifier, string characteristicUUID, IntPtr data, int length);
         [AOT.MonoPInvokeCallback(typeof(NotifiedCharacteristicActionDelegate))]
-        private static void NotifiedCharacteristicActionCallback(string identifier, string characteristicUUID, string base64Data)
+        private static void NotifiedCharacteristicActionCallback(string identifier, string characteristicUUID, IntPtr data, int length)
+        {
+            InvokeNotifiedCharacteristicAction(identifier.ToUpper(), characteristicUUID.ToUpper(), CopyData(data, length));
+        }
+
+        private static void InvokeNotifiedCharacteristicAction(string identifier, string characteristicUUID, byte[] data)
         {
-            identifier = identifier.ToUpper();
-            characteristicUUID = characteristicUUID.ToUpper();
             if (NotifiedCharacteristicAction != null && NotifiedCharacteristicAction.ContainsKey(identifier))
             {
                 var actions = NotifiedCharacteristicAction[identifier];
@@ -264,13 +319,84 @@ namespace toio
                     var action = actions[characteristicUUID];
                     if (action != null)
                     {
-                        byte[] data = System.Convert.FromBase64String(base64Data);
                         action(identifier, characteristicUUID, data);
                     }
                 }
             }
         }
 
+        //
+        // Id-based actions
+        //
+        private static long PackIds(int deviceId, int characteristicId)
+        {
+            return ((long)deviceId << 32) | (uint)characteristicId;
+        }
+
+        private static Dictionary<long, Action<int, int, byte[]>> DidReadCharacteristicByIdAction = new Dictionary<long, Action<int, int, byte[]>>();
+        private delegate void DidReadCharacteristicByIdActionDelegate(int deviceId, int characteristicId, IntPtr data, int length);
+        [AOT.MonoPInvokeCallback(typeof(DidReadCharacteristicByIdActionDelegate))]
+        private static void DidReadCharacteristicByIdActionCallback(int deviceId, int characteristicId, IntPtr data, int length)
+        {
+            Action<int, int, byte[]> action;
+            if (DidReadCharacteristicByIdAction.TryGetValue(PackIds(deviceId, characteristicId), out action) && action != null)
+            {
+                action(deviceId, characteristicId, CopyData(data, length));
+            }
+        }
+
+        private static Dictionary<long, Action<int, int>> DidWriteCharacteristicByIdAction = new Dictionary<long, Action<int, int>>();
+        private delegate void DidWriteCharacteristicByIdActionDelegate(int deviceId, int characteristicId);
+        [AOT.MonoPInvokeCallback(typeof(DidWriteCharacteristicByIdActionDelegate))]
+        private static void DidWriteCharacteristicByIdActionCallback(int deviceId, int characteristicId)
+        {
+            Action<int, int> action;
+            if (DidWriteCharacteristicByIdAction.TryGetValue(PackIds(deviceId, characteristicId), out action) && action != null)
+            {
+                action(deviceId, characteristicId);
+            }
+        }
+
+        private static Dictionary<long, Action<int, int, byte[]>> NotifiedCharacteristicByIdAction = new Dictionary<long, Action<int, int, byte[]>>();
+        private delegate void NotifiedCharacteristicByIdActionDelegate(int deviceId, int characteristicId, IntPtr data, int length);
+        [AOT.MonoPInvokeCallback(typeof(NotifiedCharacteristicByIdActionDelegate))]
+        private static void NotifiedCharacteristicByIdActionCallback(int deviceId, int characteristicId, IntPtr data, int length)
+        {
+            Action<int, int, byte[]> action;
+            if (NotifiedCharacteristicByIdAction.TryGetValue(PackIds(deviceId, characteristicId), out action) && action != null)
+            {
+                action(deviceId, characteristicId, CopyData(data, length));
+            }
+        }
+
+        //
+        // Buffered notifications
+        //
+        [StructLayout(LayoutKind.Sequential)]
+        private struct NotificationRecord
+        {
+            public int deviceId;
+            public int characteristicId;
+            public double timestamp;
+            public int dataOffset;
+            public int dataSize;
+        }
+        private static NotificationRecord[] NotificationRecords = new NotificationRecord[256];
+        private static byte[] NotificationPayload = new byte[16 * 1024];
+        private static List<string> InternedDeviceIdentifiers = new List<string>();
+        private static List<string> InternedCharacteristicUUIDs = new List<string>();
+
+        // interned ids are only ever appended on the native side, so names are fetched once per id
+        private static string GetInternedName(List<string> names, int id, bool isDevice)
+        {
+            while (names.Count <= id)
+            {
+                var ptr = isDevice ? _uiOSGetInternedDeviceIdentifier(names.Count) : _uiOSGetInternedCharacteristicUUID(names.Count);
+                names.Add(ptr == IntPtr.Zero ? string.Empty : Marshal.PtrToStringAnsi(ptr).ToUpper());
+            }
+            return names[id];
+        }
+
         public static void Initialize(Action initializedAction, Action<string> errorAction = null)
         {
             InitializedAction = initializedAction;
@@ -291,7 +417,7 @@ namespace toio
         public static void StartScan(string[] serviceUUIDs, Action<string, string, int, byte[]> discoveredAction = null)
         {
             DiscoveredAction = discoveredAction;
-            _uiOSStartDeviceScan(serviceUUIDs, DiscoveredActionCallback, false);
+            _uiOSStartDeviceScanBinary(serviceUUIDs, DiscoveredActionCallback, false);
         }
 
         public static void StopScan()
@@ -309,6 +435,27 @@ namespace toio
             _uiOSConnectToDevice(identifier, ConnectedPeripheralActionCallback, DiscoveredServiceActionCallback, DiscoveredCharacteristicActionCallback, PendingDisconnectedPeripheralActionCallback);
         }
 
+        // Same as ConnectToPeripheral, but the discovered services and characteristics arrive as one packed table:
+        //   int serviceNum, int characteristicNum,
+        //   serviceNum x { byte uuid[16] },
+        //   characteristicNum x { byte uuid[16], ushort serviceIndex, ushort properties }
+        // Integers are little endian and properties use the GATT characteristic property bits.
+        public static void ConnectToPeripheralWithGattTable(string identifier, Action<string> connectedPeripheralAction = null, Action<string, byte[]> discoveredGattTableAction = null, Action<string> disconnectedPeripheralAction = null)
+        {
+            identifier = identifier.ToUpper();
+            ConnectedPeripheralAction[identifier] = connectedPeripheralAction;
+            DiscoveredGattTableAction[identifier] = discoveredGattTableAction;
+            PendingDisconnectedPeripheralAction[identifier] = disconnectedPeripheralAction;
+            _uiOSConnectToDeviceWithGattTable(identifier, ConnectedPeripheralActionCallback, DiscoveredGattTableActionCallback, PendingDisconnectedPeripheralActionCallback);
+        }
+
+        // Formats a 16 byte UUID of the packed GATT table like the UUID strings used by the other APIs.
+        public static string GattTableUuidToString(byte[] table, int offset)
+        {
+            var hex = BitConverter.ToString(table, offset, 16).Replace("-", "");
+            return hex.Substring(0, 8) + "-" + hex.Substring(8, 4) + "-" + hex.Substring(12, 4) + "-" + hex.Substring(16, 4) + "-" + hex.Substring(20, 12);
+        }
+
         public static void DisconnectPeripheral(string identifier, Action<string> disconnectedPeripheralAction = null)
         {
             identifier = identifier.ToUpper();
@@ -331,7 +478,7 @@ namespace toio
                 DidReadCharacteristicAction[identifier] = new Dictionary<string, Action<string, string, byte[]>>();
             }
             DidReadCharacteristicAction[identifier][characteristicUUID] = didReadChracteristicAction;
-            _uiOSReadCharacteristicForDevice(identifier, serviceUUID, characteristicUUID, DidReadCharacteristicActionCallback);
+            _uiOSReadCharacteristicForDeviceBinary(identifier, serviceUUID, characteristicUUID, DidReadCharacteristicActionCallback);
         }
 
         public static void WriteCharacteristic(string identifier, string serviceUUID, string characteristicUUID, byte[] data, int length, bool withResponse, Action<string, string> didWriteCharacteristicAction)
@@ -344,7 +491,7 @@ namespace toio
                 DidWriteCharacteristicAction[identifier] = new Dictionary<string, Action<string, string>>();
             }
             DidWriteCharacteristicAction[identifier][characteristicUUID] = didWriteCharacteristicAction;
-            _uiOSWriteCharacteristicForDevice(identifier, serviceUUID, characteristicUUID, Convert.ToBase64String(data), length, withResponse, DidWriteCharacteristicActionCallback);
+            _uiOSWriteCharacteristicForDeviceBinary(identifier, serviceUUID, characteristicUUID, data, length, withResponse, DidWriteCharacteristicActionCallback);
         }
 
         public static void SubscribeCharacteristic(string identifier, string serviceUUID, string characteristicUUID, Action<string, string, byte[]> notifiedCharacteristicAction)
@@ -357,7 +504,7 @@ namespace toio
                 NotifiedCharacteristicAction[identifier] = new Dictionary<string, Action<string, string, byte[]>>();
             }
             NotifiedCharacteristicAction[identifier][characteristicUUID] = notifiedCharacteristicAction;
-            _uiOSMonitorCharacteristicForDevice(identifier, serviceUUID, characteristicUUID, NotifiedCharacteristicActionCallback);
+            _uiOSMonitorCharacteristicForDeviceBinary(identifier, serviceUUID, characteristicUUID, NotifiedCharacteristicActionCallback);
         }
 
         public static void UnSubscribeCharacteristic(string identifier, string serviceUUID, string characteristicUUID, Action<string> action)
@@ -372,6 +519,78 @@ namespace toio
             NotifiedCharacteristicAction[identifier][characteristicUUID] = null;
             _uiOSUnMonitorCharacteristicForDevice(identifier, serviceUUID, characteristicUUID);
         }
+
+        // Interned ids let the hot path skip string marshalling on both sides.
+        // Ids stay valid for the lifetime of the process.
+        public static int InternDevice(string identifier)
+        {
+            return _uiOSInternDevice(identifier.ToUpper());
+        }
+
+        public static int InternCharacteristic(string serviceUUID, string characteristicUUID)
+        {
+            return _uiOSInternCharacteristic(serviceUUID.ToUpper(), characteristicUUID.ToUpper());
+        }
+
+        public static void ReadCharacteristic(int deviceId, int characteristicId, Action<int, int, byte[]> didReadChracteristicAction)
+        {
+            DidReadCharacteristicByIdAction[PackIds(deviceId, characteristicId)] = didReadChracteristicAction;
+            _uiOSReadCharacteristicById(deviceId, characteristicId, DidReadCharacteristicByIdActionCallback);
+        }
+
+        public static void WriteCharacteristic(int deviceId, int characteristicId, byte[] data, int length, bool withResponse, Action<int, int> didWriteCharacteristicAction)
+        {
+            DidWriteCharacteristicByIdAction[PackIds(deviceId, characteristicId)] = didWriteCharacteristicAction;
+            _uiOSWriteCharacteristicById(deviceId, characteristicId, data, length, withResponse, DidWriteCharacteristicByIdActionCallback);
+        }
+
+        public static void SubscribeCharacteristic(int deviceId, int characteristicId, Action<int, int, byte[]> notifiedCharacteristicAction)
+        {
+            NotifiedCharacteristicByIdAction[PackIds(deviceId, characteristicId)] = notifiedCharacteristicAction;
+            _uiOSMonitorCharacteristicById(deviceId, characteristicId, NotifiedCharacteristicByIdActionCallback);
+        }
+
+        // While enabled, notifications are queued natively and delivered by UpdateNotifications()
+        // instead of one callback per notification. Disabling delivers what is still queued.
+        public static void SetNotificationBuffering(bool enable)
+        {
+            _uiOSSetNotificationBuffering(enable);
+            if (!enable)
+            {
+                UpdateNotifications();
+            }
+        }
+
+        // Delivers the queued notifications to the subscribed actions; call once per frame.
+        public static void UpdateNotifications()
+        {
+            int num;
+            while ((num = _uiOSDrainNotifications(NotificationRecords, NotificationRecords.Length, NotificationPayload, NotificationPayload.Length)) > 0)
+            {
+                for (int i = 0; i < num; ++i)
+                {
+                    var record = NotificationRecords[i];
+                    var data = new byte[record.dataSize];
+                    Buffer.BlockCopy(NotificationPayload, record.dataOffset, data, 0, record.dataSize);
+                    Action<int, int, byte[]> action;
+                    if (NotifiedCharacteristicByIdAction.TryGetValue(PackIds(record.deviceId, record.characteristicId), out action) && action != null)
+                    {
+                        action(record.deviceId, record.characteristicId, data);
+                        continue;
+                    }
+                    InvokeNotifiedCharacteristicAction(
+                        GetInternedName(InternedDeviceIdentifiers, record.deviceId, true),
+                        GetInternedName(InternedCharacteristicUUIDs, record.characteristicId, false),
+                        data);
+                }
+            }
+        }
+
+        // Number of notifications overwritten because the native buffer was not drained in time.
+        public static int GetDroppedNotificationNum()
+        {
+            return _uiOSGetDroppedNotificationNum();
+        }
     }
 }
 #endif
\ No newline at end of file
@@ -29,7 +29,7 @@ namespace toio
     private static extern void _uiOSDestroyClient(FinalizedActionDelegate finalizedAction);
 
 	[DllImport (DLL_NAME)]
-    private static extern void _uiOSStartDeviceScan(string[] filteredUUIDs, DiscoveredActionDelegate discoveredAction, bool allowDuplicates);
+    private static extern void _uiOSStartDeviceScanBinary(string[] filteredUUIDs, DiscoveredActionDelegate discoveredAction, bool allowDuplicates);
 
 	[DllImport (DLL_NAME)]
     private static extern void _uiOSStopDeviceScan();
@@ -37,6 +37,9 @@ namespace toio
 	[DllImport (DLL_NAME)]
     private static extern void _uiOSConnectToDevice(string identifier, ConnectedPeripheralActionDelegate connectedPeripheralAction, DiscoveredServiceActionDelegate discoveredServiceAction, DiscoveredCharacteristicActionDelegate discoveredCharacteristicAction, PendingDisconnectedPeripheralActionDelegate disconnectedPeripheralAction);
 
+	[DllImport (DLL_NAME)]
+    private static extern void _uiOSConnectToDeviceWithGattTable(string identifier, ConnectedPeripheralActionDelegate connectedPeripheralAction, DiscoveredGattTableActionDelegate discoveredGattTableAction, PendingDisconnectedPeripheralActionDelegate disconnectedPeripheralAction);
+
 	[DllImport (DLL_NAME)]
     private static extern void _uiOSCancelDeviceConnection(string identifier, DisconnectedPeripheralActionDelegate disconnectedPeripheralAction);
 
@@ -44,18 +47,65 @@ namespace toio
     private static extern void _uiOSCancelDeviceConnectionAll();
 
 	[DllImport (DLL_NAME)]
-    private static extern void _uiOSReadCharacteristicForDevice(string identifier, string serviceUUID, string characteristicUUID, DidReadCharacteristicActionDelegate didReadChracteristicAction);
+    private static extern void _uiOSReadCharacteristicForDeviceBinary(string identifier, string serviceUUID, string characteristicUUID, DidReadCharacteristicActionDelegate didReadChracteristicAction);
 
 	[DllImport (DLL_NAME)]
-    private static extern void _uiOSWriteCharacteristicForDevice(string identifier, string serviceUUID, string characteristicUUID, string data, int length, bool withResponse, DidWriteCharacteristicActionDelegate didWriteCharacteristicAction);
+    private static extern void _uiOSWriteCharacteristicForDeviceBinary(string identifier, string serviceUUID, string characteristicUUID, byte[] data, int length, bool withResponse, DidWriteCharacteristicActionDelegate didWriteCharacteristicAction);
 
 	[DllImport (DLL_NAME)]
-    private static extern void _uiOSMonitorCharacteristicForDevice(string identifier, string serviceUUID, string characteristicUUID, NotifiedCharacteristicActionDelegate notifiedCharacteristicAction);
+    private static extern void _uiOSMonitorCharacteristicForDeviceBinary(string identifier, string serviceUUID, string characteristicUUID, NotifiedCharacteristicActionDelegate notifiedCharacteristicAction);
 
 	[DllImport (DLL_NAME)]
     private static extern void _uiOSUnMonitorCharacteristicForDevice(string identifier, string serviceUUID, string characteristicUUID);
+
+	[DllImport (DLL_NAME)]
+    private static extern void _uiOSSetNotificationBuffering(bool enable);
+
+	[DllImport (DLL_NAME)]
+    private static extern int _uiOSDrainNotifications([Out] NotificationRecord[] records, int maxNum, [Out] byte[] payload, int payloadSize);
+
+	[DllImport (DLL_NAME)]
+    private static extern int _uiOSGetDroppedNotificationNum();
+
+	[DllImport (DLL_NAME)]
+    private static extern IntPtr _uiOSGetInternedDeviceIdentifier(int deviceId);
+
+	[DllImport (DLL_NAME)]
+    private static extern IntPtr _uiOSGetInternedCharacteristicUUID(int characteristicId);
+
+	[DllImport (DLL_NAME)]
+    private static extern int _uiOSInternDevice(string identifier);
+
+	[DllImport (DLL_NAME)]
+    private static extern int _uiOSInternCharacteristic(string serviceUUID, string characteristicUUID);
+
+	[DllImport (DLL_NAME)]
+    private static extern void _uiOSReadCharacteristicById(int deviceId, int characteristicId, DidReadCharacteristicByIdActionDelegate didReadChracteristicAction);
+
+	[DllImport (DLL_NAME)]
+    private static extern void _uiOSWriteCharacteristicById(int deviceId, int characteristicId, byte[] data, int length, bool withResponse, DidWriteCharacteristicByIdActionDelegate didWriteCharacteristicAction);
+
+	[DllImport (DLL_NAME)]
+    private static extern void _uiOSMonitorCharacteristicById(int deviceId, int characteristicId, NotifiedCharacteristicByIdActionDelegate notifiedCharacteristicAction);
 #endif
 
+        // copies a payload handed over by the native layer; the pointer is only valid during the callback
+        private static byte[] CopyData(IntPtr data, int length)
+        {
+            // an empty value may come without a buffer; it is still a value, not a missing one
+            if (length == 0)
+            {
+                return new byte[0];
+            }
+            if (data == IntPtr.Zero || length < 0)
+            {
+                return null;
+            }
+            var bytes = new byte[length];
+            Marshal.Copy(data, bytes, 0, length);
+            return bytes;
+        }
+
         //
         // ErrorAction
         //
@@ -102,26 +152,13 @@ namespace toio
         // DiscoveredAction
         //
         private static Action<string, string, int, byte[]> DiscoveredAction = null;
-        private delegate void DiscoveredActionDelegate(string identifier, string name, string rssi, string base64ManufacturerData);
+        private delegate void DiscoveredActionDelegate(string identifier, string name, int rssi, IntPtr manufacturerData, int length);
         [AOT.MonoPInvokeCallback(typeof(DiscoveredActionDelegate))]
-        private static void DiscoveredActionCallback(string identifier, string name, string rssi, string base64ManufacturerData)
+        private static void DiscoveredActionCallback(string identifier, string name, int rssi, IntPtr manufacturerData, int length)
         {
             if (DiscoveredAction != null)
             {
-                int iRssi = 0;
-                if (!int.TryParse(rssi, out iRssi))
-                {
-                    iRssi = 0;
-                }
-
-                byte[] data = null;
-                try
-                {
-                    data = System.Convert.FromBase64String(base64ManufacturerData);
-                }
-                catch { }
-
-                DiscoveredAction(identifier, name, iRssi, data);
+                DiscoveredAction(identifier, name, rssi, CopyData(manufacturerData, length));
             }
         }
 
@@ -173,6 +210,22 @@ namespace toio
         }
 
 
+        //
+        // DiscoveredGattTableAction
+        //
+        private static Dictionary<string, Action<string, byte[]>> DiscoveredGattTableAction = new Dictionary<string, Action<string, byte[]>>();
+        private delegate void DiscoveredGattTableActionDelegate(string identifier, IntPtr table, int length);
+        [AOT.MonoPInvokeCallback(typeof(DiscoveredGattTableActionDelegate))]
+        private static void DiscoveredGattTableActionCallback(string identifier, IntPtr table, int length)
+        {
+            identifier = identifier.ToUpper();
+            Action<string, byte[]> action;
+            if (DiscoveredGattTableAction.TryGetValue(identifier, out action) && action != null)
+            {
+                action(identifier, CopyData(table, length));
+            }
+        }
+
         //
         // PendingDisconnectedPeripheralAction
         //
@@ -207,9 +260,9 @@ namespace toio
         // DidReadCharacteristicAction
         //
         private static Dictionary<string, Dictionary<string, Action<string, string, byte[]>>> DidReadCharacteristicAction = new Dictionary<string, Dictionary<string, Action<string, string, byte[]>>>();
-        private delegate void DidReadCharacteristicActionDelegate(string identifier, string characteristicUUID, string base64Data);
+        private delegate void DidReadCharacteristicActionDelegate(string identifier, string characteristicUUID, IntPtr data, int length);
         [AOT.MonoPInvokeCallback(typeof(DidReadCharacteristicActionDelegate))]
-        private static void DidReadCharacteristicActionCallback(string identifier, string characteristicUUID, string base64Data)
+        private static void DidReadCharacteristicActionCallback(string identifier, string characteristicUUID, IntPtr data, int length)
         {
             identifier = identifier.ToUpper();
             characteristicUUID = characteristicUUID.ToUpper();
@@ -221,8 +274,7 @@ namespace toio
                     var action = actions[characteristicUUID];
                     if (action != null)
                     {
-                        byte[] data = System.Convert.FromBase64String(base64Data);
-                        action(identifier, characteristicUUID, data);
+                        action(identifier, characteristicUUID, CopyData(data, length));
                     }
                 }
             }
@@ -256,12 +308,15 @@ namespace toio
         // NotifiedCharacteristicAction
         //
         private static Dictionary<string, Dictionary<string, Action<string, string, byte[]>>> NotifiedCharacteristicAction = new Dictionary<string, Dictionary<string, Action<string, string, byte[]>>>();
-        private delegate void NotifiedCharacteristicActionDelegate(string identifier, string characteristicUUID, string base64Data);
+        private delegate void NotifiedCharacteristicActionDelegate(string identifier, string characteristicUUID, IntPtr data, int length);
         [AOT.MonoPInvokeCallback(typeof(NotifiedCharacteristicActionDelegate))]
-        private static void NotifiedCharacteristicActionCallback(string identifier, string characteristicUUID, string base64Data)
+        private static void NotifiedCharacteristicActionCallback(string identifier, string characteristicUUID, IntPtr data, int length)
+        {
+            InvokeNotifiedCharacteristicAction(identifier.ToUpper(), characteristicUUID.ToUpper(), CopyData(data, length));
+        }
+
+        private static void InvokeNotifiedCharacteristicAction(string identifier, string characteristicUUID, byte[] data)
         {
-            identifier = identifier.ToUpper();
-            characteristicUUID = characteristicUUID.ToUpper();
             if (NotifiedCharacteristicAction != null && NotifiedCharacteristicAction.ContainsKey(identifier))
             {
                 var actions = NotifiedCharacteristicAction[identifier];
@@ -270,13 +325,86 @@ namespace toio
                     var action = actions[characteristicUUID];
                     if (action != null)
                     {
-                        byte[] data = System.Convert.FromBase64String(base64Data);
                         action(identifier, characteristicUUID, data);
                     }
                 }
             }
         }
 
+        //
+        // Id-based actions
+        //
+        private static long PackIds(int deviceId, int characteristicId)
+        {
+            return ((long)deviceId << 32) | (uint)characteristicId;
+        }
+
+        private static Dictionary<long, Action<int, int, byte[]>> DidReadCharacteristicByIdAction = new Dictionary<long, Action<int, int, byte[]>>();
+        private delegate void DidReadCharacteristicByIdActionDelegate(int deviceId, int characteristicId, IntPtr data, int length);
+        [AOT.MonoPInvokeCallback(typeof(DidReadCharacteristicByIdActionDelegate))]
+        private static void DidReadCharacteristicByIdActionCallback(int deviceId, int characteristicId, IntPtr data, int length)
+        {
+            Action<int, int, byte[]> action;
+            if (DidReadCharacteristicByIdAction.TryGetValue(PackIds(deviceId, characteristicId), out action) && action != null)
+            {
+                action(deviceId, characteristicId, CopyData(data, length));
+            }
+        }
+
+        private static Dictionary<long, Action<int, int>> DidWriteCharacteristicByIdAction = new Dictionary<long, Action<int, int>>();
+        private delegate void DidWriteCharacteristicByIdActionDelegate(int deviceId, int characteristicId);
+        [AOT.MonoPInvokeCallback(typeof(DidWriteCharacteristicByIdActionDelegate))]
+        private static void DidWriteCharacteristicByIdActionCallback(int deviceId, int characteristicId)
+        {
+            Action<int, int> action;
+            if (DidWriteCharacteristicByIdAction.TryGetValue(PackIds(deviceId, characteristicId), out action) && action != null)
+            {
+                action(deviceId, characteristicId);
+            }
+        }
+
+        private static Dictionary<long, Action<int, int, byte[]>> NotifiedCharacteristicByIdAction = new Dictionary<long, Action<int, int, byte[]>>();
+        private delegate void NotifiedCharacteristicByIdActionDelegate(int deviceId, int characteristicId, IntPtr data, int length);
+        [AOT.MonoPInvokeCallback(typeof(NotifiedCharacteristicByIdActionDelegate))]
+        private static void NotifiedCharacteristicByIdActionCallback(int deviceId, int characteristicId, IntPtr data, int length)
+        {
+            Action<int, int, byte[]> action;
+            if (NotifiedCharacteristicByIdAction.TryGetValue(PackIds(deviceId, characteristicId), out action) && action != null)
+            {
+                action(deviceId, characteristicId, CopyData(data, length));
+            }
+        }
+
+        //
+        // Buffered notifications
+        //
+        [StructLayout(LayoutKind.Sequential)]
+        private struct NotificationRecord
+        {
+            public int deviceId;
+            public int characteristicId;
+            public double timestamp;
+            public int dataOffset;
+            public int dataSize;
+        }
+        private static NotificationRecord[] NotificationRecords = new NotificationRecord[256];
+        private static byte[] NotificationPayload = new byte[16 * 1024];
+        private static List<string> InternedDeviceIdentifiers = new List<string>();
+        private static List<string> InternedCharacteristicUUIDs = new List<string>();
+
+#if UNITY_IOS
+        // interned ids are only ever appended on the native side, so names are fetched once per id
+        private static string GetInternedName(List<string> names, int id, bool isDevice)
+        {
+            while (names.Count <= id)
+            {
+                var ptr = isDevice ? _uiOSGetInternedDeviceIdentifier(names.Count) : _uiOSGetInternedCharacteristicUUID(names.Count);
+                names.Add(ptr == IntPtr.Zero ? string.Empty : Marshal.PtrToStringAnsi(ptr).ToUpper());
+            }
+            return names[id];
+        }
+#endif
+
         public static void Initialize(Action initializedAction, Action<string> errorAction = null)
         {
 #if UNITY_IOS
@@ -302,7 +430,7 @@ namespace toio
         {
 #if UNITY_IOS
         DiscoveredAction = discoveredAction;
-        _uiOSStartDeviceScan(serviceUUIDs, DiscoveredActionCallback, false);
+        _uiOSStartDeviceScanBinary(serviceUUIDs, DiscoveredActionCallback, false);
 #endif
         }
 
@@ -325,6 +453,29 @@ namespace toio
 #endif
         }
 
+        // Same as ConnectToPeripheral, but the discovered services and characteristics arrive as one packed table:
+        //   int serviceNum, int characteristicNum,
+        //   serviceNum x { byte uuid[16] },
+        //   characteristicNum x { byte uuid[16], ushort serviceIndex, ushort properties }
+        // Integers are little endian and properties use the GATT characteristic property bits.
+        public static void ConnectToPeripheralWithGattTable(string identifier, Action<string> connectedPeripheralAction = null, Action<string, byte[]> discoveredGattTableAction = null, Action<string> disconnectedPeripheralAction = null)
+        {
+#if UNITY_IOS
+        identifier = identifier.ToUpper();
+        ConnectedPeripheralAction[identifier] = connectedPeripheralAction;
+        DiscoveredGattTableAction[identifier] = discoveredGattTableAction;
+        PendingDisconnectedPeripheralAction[identifier] = disconnectedPeripheralAction;
+        _uiOSConnectToDeviceWithGattTable(identifier, ConnectedPeripheralActionCallback, DiscoveredGattTableActionCallback, PendingDisconnectedPeripheralActionCallback);
+#endif
+        }
+
+        // Formats a 16 byte UUID of the packed GATT table like the UUID strings used by the other APIs.
+        public static string GattTableUuidToString(byte[] table, int offset)
+        {
+            var hex = BitConverter.ToString(table, offset, 16).Replace("-", "");
+            return hex.Substring(0, 8) + "-" + hex.Substring(8, 4) + "-" + hex.Substring(12, 4) + "-" + hex.Substring(16, 4) + "-" + hex.Substring(20, 12);
+        }
+
         public static void DisconnectPeripheral(string identifier, Action<string> disconnectedPeripheralAction = null)
         {
 #if UNITY_IOS
@@ -351,7 +502,7 @@ namespace toio
             DidReadCharacteristicAction[identifier] = new Dictionary<string, Action<string, string, byte[]>>();
         }
         DidReadCharacteristicAction[identifier][characteristicUUID] = didReadChracteristicAction;
-        _uiOSReadCharacteristicForDevice(identifier, serviceUUID, characteristicUUID, DidReadCharacteristicActionCallback);
+        _uiOSReadCharacteristicForDeviceBinary(identifier, serviceUUID, characteristicUUID, DidReadCharacteristicActionCallback);
 #endif
         }
 
@@ -365,7 +516,7 @@ namespace toio
             DidWriteCharacteristicAction[identifier] = new Dictionary<string, Action<string, string>>();
         }
         DidWriteCharacteristicAction[identifier][characteristicUUID] = didWriteCharacteristicAction;
-        _uiOSWriteCharacteristicForDevice(identifier, serviceUUID, characteristicUUID, Convert.ToBase64String(data), length, withResponse, DidWriteCharacteristicActionCallback);
+        _uiOSWriteCharacteristicForDeviceBinary(identifier, serviceUUID, characteristicUUID, data, length, withResponse, DidWriteCharacteristicActionCallback);
 #endif
         }
 
@@ -379,7 +530,7 @@ namespace toio
             NotifiedCharacteristicAction[identifier] = new Dictionary<string, Action<string, string, byte[]>>();
         }
         NotifiedCharacteristicAction[identifier][characteristicUUID] = notifiedCharacteristicAction;
-        _uiOSMonitorCharacteristicForDevice(identifier, serviceUUID, characteristicUUID, NotifiedCharacteristicActionCallback);
+        _uiOSMonitorCharacteristicForDeviceBinary(identifier, serviceUUID, characteristicUUID, NotifiedCharacteristicActionCallback);
 #endif
         }
 
@@ -394,6 +545,96 @@ namespace toio
         }
         NotifiedCharacteristicAction[identifier][characteristicUUID] = null;
         _uiOSUnMonitorCharacteristicForDevice(identifier, serviceUUID, characteristicUUID);
+#endif
+        }
+
+        // Interned ids let the hot path skip string marshalling on both sides.
+        // Ids stay valid for the lifetime of the process.
+        public static int InternDevice(string identifier)
+        {
+#if UNITY_IOS
+        return _uiOSInternDevice(identifier.ToUpper());
+#else
+        return -1;
+#endif
+        }
+
+        public static int InternCharacteristic(string serviceUUID, string characteristicUUID)
+        {
+#if UNITY_IOS
+        return _uiOSInternCharacteristic(serviceUUID.ToUpper(), characteristicUUID.ToUpper());
+#else
+        return -1;
+#endif
+        }
+
+        public static void ReadCharacteristic(int deviceId, int characteristicId, Action<int, int, byte[]> didReadChracteristicAction)
+        {
+#if UNITY_IOS
+        DidReadCharacteristicByIdAction[PackIds(deviceId, characteristicId)] = didReadChracteristicAction;
+        _uiOSReadCharacteristicById(deviceId, characteristicId, DidReadCharacteristicByIdActionCallback);
+#endif
+        }
+
+        public static void WriteCharacteristic(int deviceId, int characteristicId, byte[] data, int length, bool withResponse, Action<int, int> didWriteCharacteristicAction)
+        {
+#if UNITY_IOS
+        DidWriteCharacteristicByIdAction[PackIds(deviceId, characteristicId)] = didWriteCharacteristicAction;
+        _uiOSWriteCharacteristicById(deviceId, characteristicId, data, length, withResponse, DidWriteCharacteristicByIdActionCallback);
+#endif
+        }
+
+        public static void SubscribeCharacteristic(int deviceId, int characteristicId, Action<int, int, byte[]> notifiedCharacteristicAction)
+        {
+#if UNITY_IOS
+        NotifiedCharacteristicByIdAction[PackIds(deviceId, characteristicId)] = notifiedCharacteristicAction;
+        _uiOSMonitorCharacteristicById(deviceId, characteristicId, NotifiedCharacteristicByIdActionCallback);
+#endif
+        }
+
+        // While enabled, notifications are queued natively and delivered by UpdateNotifications()
+        // instead of one callback per notification. Disabling delivers what is still queued.
+        public static void SetNotificationBuffering(bool enable)
+        {
+#if UNITY_IOS
+        _uiOSSetNotificationBuffering(enable);
+        if (!enable) {
+            UpdateNotifications();
+        }
+#endif
+        }
+
+        // Delivers the queued notifications to the subscribed actions; call once per frame.
+        public static void UpdateNotifications()
+        {
+#if UNITY_IOS
+        int num;
+        while ((num = _uiOSDrainNotifications(NotificationRecords, NotificationRecords.Length, NotificationPayload, NotificationPayload.Length)) > 0) {
+            for (int i = 0; i < num; ++i) {
+                var record = NotificationRecords[i];
+                var data = new byte[record.dataSize];
+                Buffer.BlockCopy(NotificationPayload, record.dataOffset, data, 0, record.dataSize);
+                Action<int, int, byte[]> action;
+                if (NotifiedCharacteristicByIdAction.TryGetValue(PackIds(record.deviceId, record.characteristicId), out action) && action != null) {
+                    action(record.deviceId, record.characteristicId, data);
+                    continue;
+                }
+                InvokeNotifiedCharacteristicAction(
+                    GetInternedName(InternedDeviceIdentifiers, record.deviceId, true),
+                    GetInternedName(InternedCharacteristicUUIDs, record.characteristicId, false),
+                    data);
+            }
+        }
+#endif
+        }
+
+        // Number of notifications overwritten because the native buffer was not drained in time.
+        public static int GetDroppedNotificationNum()
+        {
+#if UNITY_IOS
+        return _uiOSGetDroppedNotificationNum();
+#else
+        return 0;
 #endif
         }
     }
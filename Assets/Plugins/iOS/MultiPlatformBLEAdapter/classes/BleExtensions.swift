@@ -54,6 +54,7 @@ extension ScannedPeripheral {
             "mtu": mtu,
 
             "manufacturerData": manufacturerData as Any,
+            "rawManufacturerData": advertisementData.manufacturerData as Any,
             "serviceData": serviceData as Any,
             "serviceUUIDs": serviceUUIDs as Any,
             "localName": advertisementData.localName as Any,
@@ -108,9 +109,6 @@ extension Service {
 }
 
 extension Characteristic {
-    var valueBase64: String? {
-        return value?.base64
-    }
     var jsIdentifier: Double {
         return Double(UInt64(objectId) & ((1 << 53) - 1))
     }
@@ -127,13 +125,14 @@ extension Characteristic {
             "isNotifiable": properties.contains(.notify),
             "isNotifying": isNotifying,
             "isIndicatable": properties.contains(.indicate),
-            "value": valueBase64 as Any
+            // raw bytes only: the string callbacks encode base64 themselves, the binary path never does
+            "rawValue": value as Any
         ]
     }
 }
 
 extension Descriptor {
-    var valueBase64: String? {
+    var rawValue: Data? {
         guard let value = self.value else {
             return nil
         }
@@ -145,18 +144,17 @@ extension Descriptor {
                 fallthrough
             case CBUUIDServerCharacteristicConfigurationString:
                 var data = (value as! NSNumber).uint16Value.littleEndian
-                return Data.init(bytes: &data, count: 2).base64
+                return Data.init(bytes: &data, count: 2)
 
             // String types.
             case CBUUIDCharacteristicUserDescriptionString:
-                let data = (value as! String).data(using: String.Encoding.utf8)
-                return data?.base64
+                return (value as! String).data(using: String.Encoding.utf8)
 
             // Data types.
             case CBUUIDCharacteristicFormatString:
                 fallthrough
             case CBUUIDCharacteristicAggregateFormatString:
-                return (value as! Data).base64
+                return (value as! Data)
         default:
             return nil
         }
@@ -173,7 +171,7 @@ extension Descriptor {
             "serviceID": characteristic.service.jsIdentifier,
             "serviceUUID": characteristic.service.uuid.fullUUIDString,
             "deviceID": characteristic.service.peripheral.identifier.uuidString,
-            "value": valueBase64 as Any
+            "rawValue": rawValue as Any
         ]
     }
 }
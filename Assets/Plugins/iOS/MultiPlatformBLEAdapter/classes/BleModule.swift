@@ -806,6 +806,25 @@ public class BleClientManager : NSObject {
                                          promise: SafePromise(resolve: resolve, reject: reject))
     }
 
+    @objc
+    public func writeCharacteristicForDevice(  _ deviceIdentifier: String,
+                                                      serviceUUID: String,
+                                               characteristicUUID: String,
+                                                            value: Data,
+                                                         response: Bool,
+                                                    transactionId: String,
+                                                          resolve: @escaping Resolve,
+                                                           reject: @escaping Reject) {
+        let observable = getCharacteristicForDevice(deviceIdentifier,
+                                                    serviceUUID: serviceUUID,
+                                                    characteristicUUID: characteristicUUID)
+        safeWriteCharacteristicForDevice(observable,
+                                         value: value,
+                                         response: response,
+                                         transactionId: transactionId,
+                                         promise: SafePromise(resolve: resolve, reject: reject))
+    }
+
     @objc
     public func writeCharacteristicForService(  _ serviceIdentifier: Double,
                                                  characteristicUUID: String,
@@ -75,6 +75,15 @@
                             resolver:(void (^)(NSDictionary *characteristic))resolve
                             rejecter:(void (^)(NSString *code, NSString *message, NSError *error))reject;
 
+- (void)writeCharacteristicForDevice:(NSString *)deviceIdentifier
+                         serviceUUID:(NSString *)serviceUUID
+                  characteristicUUID:(NSString *)characteristicUUID
+                               value:(NSData *)value
+                        withResponse:(BOOL)response
+                       transactionId:(NSString *)transactionId
+                            resolver:(void (^)(NSDictionary *characteristic))resolve
+                            rejecter:(void (^)(NSString *code, NSString *message, NSError *error))reject;
+
 - (void)writeCharacteristicForService:(nonnull NSNumber *)serviceIdentifier
                    characteristicUUID:(NSString *)characteristicUUID
                           valueBase64:(NSString *)valueBase64
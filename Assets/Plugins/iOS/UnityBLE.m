@@ -7,6 +7,7 @@
 
 #import "UnityBLE.h"
 #import "UnityFramework/UnityFramework-Swift.h"
+#import <os/lock.h>
 
 BleModule *_bleModule = nil;
 NSMutableArray *uuids = nil;  // filtered service uuid
@@ -24,12 +25,22 @@ typedef void (*DisconnectedPeripheralActionCallback) (const char*);
 typedef void (*DidReadCharacteristicActionCallback) (const char*, const char*, const char*);
 typedef void (*DidWriteCharacteristicActionCallback) (const char*, const char*);
 typedef void (*NotifiedCharacteristicActionCallback) (const char*, const char*, const char*);
+typedef void (*DiscoveredBinaryActionCallback) (const char*, const char*, int, const unsigned char*, int);
+typedef void (*DidReadCharacteristicBinaryActionCallback) (const char*, const char*, const unsigned char*, int);
+typedef void (*NotifiedCharacteristicBinaryActionCallback) (const char*, const char*, const unsigned char*, int);
+typedef void (*DidReadCharacteristicByIdActionCallback) (int, int, const unsigned char*, int);
+typedef void (*DidWriteCharacteristicByIdActionCallback) (int, int);
+typedef void (*NotifiedCharacteristicByIdActionCallback) (int, int, const unsigned char*, int);
+typedef void (*DiscoveredGattTableActionCallback) (const char*, const unsigned char*, int);
 
 ErrorActionCallback errorActionCallback = nil;
 InitializedActionCallback initializedActionCallback = nil;
 DiscoveredActionCallback discoveredActionCallback = nil;
 PendingDisconnectedPeripheralActionCallback pendingDisconnectedPeripheralActionCallback = nil;
 NotifiedCharacteristicActionCallback notifiedCharacteristicActionCallback = nil;
+DiscoveredBinaryActionCallback discoveredBinaryActionCallback = nil;
+NotifiedCharacteristicBinaryActionCallback notifiedCharacteristicBinaryActionCallback = nil;
+NotifiedCharacteristicByIdActionCallback notifiedCharacteristicByIdActionCallback = nil;
 
 typedef void (^Rejection) (NSString *errorCode, NSString *errorMessage, NSError *error);
 
@@ -57,6 +68,199 @@ NSString* nextUniqueId() {
     return [NSString stringWithFormat:@"%d", uniqueId];
 }
 
+// Transaction ids for the id-based requests are recycled instead of formatted per request.
+// They use their own prefix so they never collide with nextUniqueId().
+NSMutableArray<NSString *> *transactionIdPool = nil;
+int transactionIdNum = 0;
+
+NSString* acquireTransactionId() {
+    NSString *transactionId = [transactionIdPool lastObject];
+    if (transactionId != nil) {
+        [transactionIdPool removeLastObject];
+        return transactionId;
+    }
+    transactionIdNum += 1;
+    return [NSString stringWithFormat:@"t%d", transactionIdNum];
+}
+
+void releaseTransactionId(NSString *transactionId) {
+    // the adapter drops the transaction only after the resolver returns, so recycle it on the next turn
+    dispatch_async(dispatch_get_main_queue(), ^{
+        if (transactionIdPool == nil) {
+            transactionIdPool = [NSMutableArray new];
+        }
+        [transactionIdPool addObject:transactionId];
+    });
+}
+
+// raw value attached by the adapter; NSNull when the peripheral has no value
+NSData* rawData(id value) {
+    return [value isKindOfClass:[NSData class]] ? (NSData *)value : nil;
+}
+
+// base64 of the raw value, built only for the string callbacks; NULL when there is no value
+const char* base64Value(NSDictionary *characteristic) {
+    NSData *data = rawData([characteristic valueForKey:@"rawValue"]);
+    return (data == nil) ? NULL : [[data base64EncodedStringWithOptions:0] UTF8String];
+}
+
+// Packed GATT table
+//   int32 serviceNum, int32 characteristicNum,
+//   serviceNum x { uint8 uuid[16] },
+//   characteristicNum x { uint8 uuid[16], uint16 serviceIndex, uint16 properties }
+// UUID bytes are in string order, integers are little endian and properties use the GATT bit values.
+void appendUUIDBytes(NSMutableData *table, NSString *uuidString) {
+    uuid_t bytes;
+    NSUUID *uuid = [[NSUUID alloc] initWithUUIDString:uuidString];
+    if (uuid != nil) {
+        [uuid getUUIDBytes:bytes];
+    } else {
+        memset(bytes, 0, sizeof(bytes));
+    }
+    [table appendBytes:bytes length:sizeof(bytes)];
+}
+
+unsigned short gattProperties(NSDictionary *characteristic) {
+    unsigned short properties = 0;
+    if ([[characteristic valueForKey:@"isReadable"] boolValue]) {
+        properties |= 0x02;
+    }
+    if ([[characteristic valueForKey:@"isWritableWithoutResponse"] boolValue]) {
+        properties |= 0x04;
+    }
+    if ([[characteristic valueForKey:@"isWritableWithResponse"] boolValue]) {
+        properties |= 0x08;
+    }
+    if ([[characteristic valueForKey:@"isNotifiable"] boolValue]) {
+        properties |= 0x10;
+    }
+    if ([[characteristic valueForKey:@"isIndicatable"] boolValue]) {
+        properties |= 0x20;
+    }
+    return properties;
+}
+
+// Intern table
+// Peripheral identifiers and (service, characteristic) UUID pairs are mapped to small integer ids,
+// which are shared by the id-based requests and the notification buffer. Ids are never reused.
+NSMutableDictionary<NSString *, NSNumber *> *deviceIds = nil;
+NSMutableArray<NSString *> *deviceIdentifiers = nil;
+NSMutableDictionary<NSString *, NSNumber *> *characteristicIds = nil;
+NSMutableArray<NSString *> *characteristicServiceUUIDs = nil;
+NSMutableArray<NSString *> *characteristicUUIDs = nil;
+NSMutableDictionary<NSString *, NSNumber *> *monitorSubscriptions = nil;  // transaction id -> packed ids
+NSMutableDictionary<NSNumber *, NSString *> *monitorTransactions = nil;   // packed ids -> transaction id
+
+int internDevice(NSString *identifier) {
+    if (deviceIds == nil) {
+        deviceIds = [NSMutableDictionary new];
+        deviceIdentifiers = [NSMutableArray new];
+    }
+    NSNumber *found = [deviceIds objectForKey:identifier];
+    if (found != nil) {
+        return [found intValue];
+    }
+    identifier = [identifier uppercaseString];
+    found = [deviceIds objectForKey:identifier];
+    if (found != nil) {
+        return [found intValue];
+    }
+    int newId = (int)deviceIdentifiers.count;
+    [deviceIdentifiers addObject:identifier];
+    [deviceIds setObject:@(newId) forKey:identifier];
+    return newId;
+}
+
+int internCharacteristic(NSString *serviceUUID, NSString *characteristicUUID) {
+    if (characteristicIds == nil) {
+        characteristicIds = [NSMutableDictionary new];
+        characteristicServiceUUIDs = [NSMutableArray new];
+        characteristicUUIDs = [NSMutableArray new];
+    }
+    serviceUUID = [serviceUUID uppercaseString];
+    characteristicUUID = [characteristicUUID uppercaseString];
+    NSString *key = [NSString stringWithFormat:@"%@/%@", serviceUUID, characteristicUUID];
+    NSNumber *found = [characteristicIds objectForKey:key];
+    if (found != nil) {
+        return [found intValue];
+    }
+    int newId = (int)characteristicUUIDs.count;
+    [characteristicServiceUUIDs addObject:serviceUUID];
+    [characteristicUUIDs addObject:characteristicUUID];
+    [characteristicIds setObject:@(newId) forKey:key];
+    return newId;
+}
+
+BOOL isInterned(int deviceId, int characteristicId) {
+    return deviceId >= 0 && deviceId < (int)deviceIdentifiers.count
+        && characteristicId >= 0 && characteristicId < (int)characteristicUUIDs.count;
+}
+
+NSNumber* packIds(int deviceId, int characteristicId) {
+    return @(((long long)deviceId << 32) | (unsigned int)characteristicId);
+}
+
+// Notification buffer
+// While buffering is enabled, notifications are queued here with interned ids instead of
+// calling back into managed code one by one, and managed code drains them once per frame.
+#define NOTIFICATION_BUFFER_CAPACITY 512
+#define NOTIFICATION_DATA_MAX_SIZE 512  // largest attribute value ATT allows
+
+typedef struct {
+    int deviceId;
+    int characteristicId;
+    double timestamp;
+    int length;
+    unsigned char data[NOTIFICATION_DATA_MAX_SIZE];
+} BufferedNotification;
+
+// layout shared with managed code; payloads are packed into a separate byte array
+typedef struct {
+    int deviceId;
+    int characteristicId;
+    double timestamp;   // seconds since system boot
+    int dataOffset;
+    int dataSize;
+} NotificationRecord;
+
+BufferedNotification notificationBuffer[NOTIFICATION_BUFFER_CAPACITY];
+int notificationHead = 0;
+int notificationCount = 0;
+int droppedNotificationNum = 0;
+BOOL notificationBuffering = NO;
+os_unfair_lock notificationLock = OS_UNFAIR_LOCK_INIT;
+
+void pushNotification(int deviceId, int characteristicId, NSData *value) {
+    // a slot holds the largest value a peripheral may send, so this never cuts a valid payload
+    int length = MIN((int)value.length, NOTIFICATION_DATA_MAX_SIZE);
+
+    os_unfair_lock_lock(&notificationLock);
+    if (notificationCount == NOTIFICATION_BUFFER_CAPACITY) {
+        // overwrite the oldest one
+        notificationHead = (notificationHead + 1) % NOTIFICATION_BUFFER_CAPACITY;
+        notificationCount--;
+        droppedNotificationNum++;
+    }
+    BufferedNotification *notification = &notificationBuffer[(notificationHead + notificationCount) % NOTIFICATION_BUFFER_CAPACITY];
+    notification->deviceId = deviceId;
+    notification->characteristicId = characteristicId;
+    notification->timestamp = [NSProcessInfo processInfo].systemUptime;
+    notification->length = length;
+    if (length > 0) {
+        memcpy(notification->data, value.bytes, length);
+    }
+    notificationCount++;
+    os_unfair_lock_unlock(&notificationLock);
+}
+
+void clearNotificationBuffer() {
+    os_unfair_lock_lock(&notificationLock);
+    notificationHead = 0;
+    notificationCount = 0;
+    droppedNotificationNum = 0;
+    os_unfair_lock_unlock(&notificationLock);
+}
+
 void _uiOSCreateClient(InitializedActionCallback initializedCallback, ErrorActionCallback errorCallback) {
     initializedActionCallback = initializedCallback;
     errorActionCallback = errorCallback;
@@ -67,6 +271,9 @@ void _uiOSCreateClient(InitializedActionCallback initializedCallback, ErrorActio
         [uuids removeAllObjects];
     }
     uniqueId = 0;
+    clearNotificationBuffer();
+    [monitorSubscriptions removeAllObjects];
+    [monitorTransactions removeAllObjects];
 }
 
 void _uiOSDestroyClient(FinalizedActionCallback finalizedCallback) {
@@ -83,6 +290,7 @@ void _uiOSDestroyClient(FinalizedActionCallback finalizedCallback) {
 void _uiOSStartDeviceScan(const char** filteredUUIDs, DiscoveredActionCallback discoveredCallback, BOOL allowDuplicates) {
     if (_bleModule != nil) {
         discoveredActionCallback = discoveredCallback;
+        discoveredBinaryActionCallback = nil;
 
         if (uuids == nil) {
             uuids = [[NSMutableArray alloc] init];
@@ -134,6 +342,52 @@ void _uiOSConnectToDevice(const char* identifier, ConnectedPeripheralActionCallb
     }
 }
 
+void _uiOSConnectToDeviceWithGattTable(const char* identifier, ConnectedPeripheralActionCallback connectedPeripheralCallback, DiscoveredGattTableActionCallback discoveredGattTableCallback, PendingDisconnectedPeripheralActionCallback pendingDisconnectedPeripheralCallback) {
+    if (_bleModule != nil) {
+        pendingDisconnectedPeripheralActionCallback = pendingDisconnectedPeripheralCallback;
+
+        [_bleModule connectToDevice:[NSString stringWithUTF8String:identifier] options:nil resolver:^(NSDictionary *peripheral) {
+            NSString *identifier = [peripheral valueForKey:@"id"];
+            if (connectedPeripheralCallback != nil) {
+                connectedPeripheralCallback([identifier UTF8String]);
+            }
+
+            // the getters resolve synchronously from the adapter's cache, so the table is complete
+            // once the enumeration returns
+            [_bleModule discoverAllServicesAndCharacteristicsForDevice:identifier transactionId:nextUniqueId() resolver:^(NSDictionary *peripheral) {
+                [_bleModule servicesForDevice:identifier resolver:^(NSArray<NSDictionary *> *services) {
+                    NSMutableData *serviceTable = [NSMutableData dataWithCapacity:services.count * 16];
+                    NSMutableData *characteristicTable = [NSMutableData data];
+                    __block int characteristicNum = 0;
+
+                    [services enumerateObjectsUsingBlock:^(NSDictionary * _Nonnull service, NSUInteger serviceIndex, BOOL * _Nonnull stop) {
+                        appendUUIDBytes(serviceTable, [service valueForKey:@"uuid"]);
+
+                        [_bleModule characteristicsForService:[service valueForKey:@"id"] resolver:^(NSArray<NSDictionary *> *characteristics) {
+                            for (NSDictionary *characteristic in characteristics) {
+                                unsigned short index = (unsigned short)serviceIndex;
+                                unsigned short properties = gattProperties(characteristic);
+                                appendUUIDBytes(characteristicTable, [characteristic valueForKey:@"uuid"]);
+                                [characteristicTable appendBytes:&index length:sizeof(index)];
+                                [characteristicTable appendBytes:&properties length:sizeof(properties)];
+                                characteristicNum++;
+                            }
+                        } rejecter:rejection];
+                    }];
+
+                    if (discoveredGattTableCallback != nil) {
+                        int header[2] = { (int)services.count, characteristicNum };
+                        NSMutableData *table = [NSMutableData dataWithBytes:header length:sizeof(header)];
+                        [table appendData:serviceTable];
+                        [table appendData:characteristicTable];
+                        discoveredGattTableCallback([identifier UTF8String], (const unsigned char *)table.bytes, (int)table.length);
+                    }
+                } rejecter:rejection];
+            } rejecter:rejection];
+        } rejecter:rejection];
+    }
+}
+
 void _uiOSCancelDeviceConnection(const char* identifier, DisconnectedPeripheralActionCallback disconnectedPeripheralCallback) {
     if (_bleModule != nil) {
         [_bleModule cancelDeviceConnection:[NSString stringWithFormat:@"%s", identifier] resolver:^(NSDictionary *peripheral) {
@@ -163,7 +417,7 @@ void _uiOSReadCharacteristicForDevice(const char* identifier, const char* servic
     if (_bleModule != nil) {
         [_bleModule readCharacteristicForDevice:[NSString stringWithUTF8String:identifier] serviceUUID:[NSString stringWithUTF8String:serviceUUID] characteristicUUID:[NSString stringWithUTF8String:characteristicUUID] transactionId:nextUniqueId() resolver:^(NSDictionary *characteristic) {
             if (didReadCharacteristicCallback != nil) {
-                didReadCharacteristicCallback([[characteristic valueForKey:@"deviceID"] UTF8String], [[characteristic valueForKey:@"uuid"] UTF8String], [[characteristic valueForKey:@"value"] UTF8String]);
+                didReadCharacteristicCallback([[characteristic valueForKey:@"deviceID"] UTF8String], [[characteristic valueForKey:@"uuid"] UTF8String], base64Value(characteristic));
             }
         } rejecter:rejection];
     }
@@ -182,6 +436,7 @@ void _uiOSWriteCharacteristicForDevice(const char* identifier, const char* servi
 void _uiOSMonitorCharacteristicForDevice(const char* identifier, const char* serviceUUID, const char* characteristicUUID, NotifiedCharacteristicActionCallback notifiedCharacteristicCallback) {
     if (_bleModule != nil) {
         notifiedCharacteristicActionCallback = notifiedCharacteristicCallback;
+        notifiedCharacteristicBinaryActionCallback = nil;
 
         [_bleModule monitorCharacteristicForDevice:[NSString stringWithUTF8String:identifier] serviceUUID:[NSString stringWithUTF8String:serviceUUID] characteristicUUID:[NSString stringWithUTF8String:characteristicUUID] transactionID:nextUniqueId() resolver:^(id value) {
             // no op
@@ -189,6 +444,154 @@ void _uiOSMonitorCharacteristicForDevice(const char* identifier, const char* ser
     }
 }
 
+void _uiOSStartDeviceScanBinary(const char** filteredUUIDs, DiscoveredBinaryActionCallback discoveredCallback, BOOL allowDuplicates) {
+    _uiOSStartDeviceScan(filteredUUIDs, nil, allowDuplicates);
+    discoveredBinaryActionCallback = discoveredCallback;
+}
+
+void _uiOSReadCharacteristicForDeviceBinary(const char* identifier, const char* serviceUUID, const char* characteristicUUID, DidReadCharacteristicBinaryActionCallback didReadCharacteristicCallback) {
+    if (_bleModule != nil) {
+        [_bleModule readCharacteristicForDevice:[NSString stringWithUTF8String:identifier] serviceUUID:[NSString stringWithUTF8String:serviceUUID] characteristicUUID:[NSString stringWithUTF8String:characteristicUUID] transactionId:nextUniqueId() resolver:^(NSDictionary *characteristic) {
+            if (didReadCharacteristicCallback != nil) {
+                NSData *value = rawData([characteristic valueForKey:@"rawValue"]);
+                didReadCharacteristicCallback([[characteristic valueForKey:@"deviceID"] UTF8String], [[characteristic valueForKey:@"uuid"] UTF8String], (const unsigned char *)value.bytes, (int)value.length);
+            }
+        } rejecter:rejection];
+    }
+}
+
+void _uiOSWriteCharacteristicForDeviceBinary(const char* identifier, const char* serviceUUID, const char* characteristicUUID, const unsigned char* data, int length, BOOL withResponse, DidWriteCharacteristicActionCallback didWriteCharacteristicCallback) {
+    if (_bleModule != nil) {
+        [_bleModule writeCharacteristicForDevice:[NSString stringWithUTF8String:identifier] serviceUUID:[NSString stringWithUTF8String:serviceUUID] characteristicUUID:[NSString stringWithUTF8String:characteristicUUID] value:[NSData dataWithBytes:data length:length] withResponse:withResponse transactionId:nextUniqueId() resolver:^(NSDictionary *characteristic) {
+            if (didWriteCharacteristicCallback != nil) {
+                didWriteCharacteristicCallback([[characteristic valueForKey:@"deviceID"] UTF8String], [[characteristic valueForKey:@"uuid"] UTF8String]);
+            }
+        } rejecter:rejection];
+    }
+}
+
+void _uiOSMonitorCharacteristicForDeviceBinary(const char* identifier, const char* serviceUUID, const char* characteristicUUID, NotifiedCharacteristicBinaryActionCallback notifiedCharacteristicCallback) {
+    _uiOSMonitorCharacteristicForDevice(identifier, serviceUUID, characteristicUUID, nil);
+    notifiedCharacteristicBinaryActionCallback = notifiedCharacteristicCallback;
+}
+
+int _uiOSInternDevice(const char* identifier) {
+    return internDevice([NSString stringWithUTF8String:identifier]);
+}
+
+int _uiOSInternCharacteristic(const char* serviceUUID, const char* characteristicUUID) {
+    return internCharacteristic([NSString stringWithUTF8String:serviceUUID], [NSString stringWithUTF8String:characteristicUUID]);
+}
+
+void _uiOSReadCharacteristicById(int deviceId, int characteristicId, DidReadCharacteristicByIdActionCallback didReadCharacteristicCallback) {
+    if (_bleModule != nil && isInterned(deviceId, characteristicId)) {
+        NSString *transactionId = acquireTransactionId();
+        [_bleModule readCharacteristicForDevice:deviceIdentifiers[deviceId] serviceUUID:characteristicServiceUUIDs[characteristicId] characteristicUUID:characteristicUUIDs[characteristicId] transactionId:transactionId resolver:^(NSDictionary *characteristic) {
+            releaseTransactionId(transactionId);
+            if (didReadCharacteristicCallback != nil) {
+                NSData *value = rawData([characteristic valueForKey:@"rawValue"]);
+                didReadCharacteristicCallback(deviceId, characteristicId, (const unsigned char *)value.bytes, (int)value.length);
+            }
+        } rejecter:^(NSString *errorCode, NSString *errorMessage, NSError *error) {
+            releaseTransactionId(transactionId);
+            rejection(errorCode, errorMessage, error);
+        }];
+    }
+}
+
+void _uiOSWriteCharacteristicById(int deviceId, int characteristicId, const unsigned char* data, int length, BOOL withResponse, DidWriteCharacteristicByIdActionCallback didWriteCharacteristicCallback) {
+    if (_bleModule != nil && isInterned(deviceId, characteristicId)) {
+        NSString *transactionId = acquireTransactionId();
+        [_bleModule writeCharacteristicForDevice:deviceIdentifiers[deviceId] serviceUUID:characteristicServiceUUIDs[characteristicId] characteristicUUID:characteristicUUIDs[characteristicId] value:[NSData dataWithBytes:data length:length] withResponse:withResponse transactionId:transactionId resolver:^(NSDictionary *characteristic) {
+            releaseTransactionId(transactionId);
+            if (didWriteCharacteristicCallback != nil) {
+                didWriteCharacteristicCallback(deviceId, characteristicId);
+            }
+        } rejecter:^(NSString *errorCode, NSString *errorMessage, NSError *error) {
+            releaseTransactionId(transactionId);
+            rejection(errorCode, errorMessage, error);
+        }];
+    }
+}
+
+void _uiOSMonitorCharacteristicById(int deviceId, int characteristicId, NotifiedCharacteristicByIdActionCallback notifiedCharacteristicCallback) {
+    if (_bleModule != nil && isInterned(deviceId, characteristicId)) {
+        notifiedCharacteristicByIdActionCallback = notifiedCharacteristicCallback;
+
+        NSNumber *packed = packIds(deviceId, characteristicId);
+        if ([monitorTransactions objectForKey:packed] != nil) {
+            return;
+        }
+        if (monitorSubscriptions == nil) {
+            monitorSubscriptions = [NSMutableDictionary new];
+            monitorTransactions = [NSMutableDictionary new];
+        }
+        // the transaction lives as long as the subscription, so its id is not recycled
+        NSString *transactionId = acquireTransactionId();
+        [monitorSubscriptions setObject:packed forKey:transactionId];
+        [monitorTransactions setObject:transactionId forKey:packed];
+
+        [_bleModule monitorCharacteristicForDevice:deviceIdentifiers[deviceId] serviceUUID:characteristicServiceUUIDs[characteristicId] characteristicUUID:characteristicUUIDs[characteristicId] transactionID:transactionId resolver:^(id value) {
+            // resolved when the subscription is disposed
+            [monitorSubscriptions removeObjectForKey:transactionId];
+            [monitorTransactions removeObjectForKey:packed];
+        } rejecter:rejection];
+    }
+}
+
+void _uiOSSetNotificationBuffering(BOOL enable) {
+    // turning buffering off keeps what is already queued; the managed side drains it right after,
+    // so nothing received while buffering is lost
+    notificationBuffering = enable;
+}
+
+int _uiOSDrainNotifications(NotificationRecord* records, int maxNum, unsigned char* payload, int payloadSize) {
+    int num = 0;
+    int offset = 0;
+
+    os_unfair_lock_lock(&notificationLock);
+    while (num < maxNum && notificationCount > 0) {
+        BufferedNotification *notification = &notificationBuffer[notificationHead];
+        if (offset + notification->length > payloadSize) {
+            break;
+        }
+        records[num].deviceId = notification->deviceId;
+        records[num].characteristicId = notification->characteristicId;
+        records[num].timestamp = notification->timestamp;
+        records[num].dataOffset = offset;
+        records[num].dataSize = notification->length;
+        memcpy(payload + offset, notification->data, notification->length);
+        offset += notification->length;
+        ++num;
+
+        notificationHead = (notificationHead + 1) % NOTIFICATION_BUFFER_CAPACITY;
+        notificationCount--;
+    }
+    os_unfair_lock_unlock(&notificationLock);
+    return num;
+}
+
+int _uiOSGetDroppedNotificationNum() {
+    os_unfair_lock_lock(&notificationLock);
+    int num = droppedNotificationNum;
+    os_unfair_lock_unlock(&notificationLock);
+    return num;
+}
+
+const char* _uiOSGetInternedDeviceIdentifier(int deviceId) {
+    if (deviceIdentifiers == nil || deviceId < 0 || deviceId >= (int)deviceIdentifiers.count) {
+        return NULL;
+    }
+    return [deviceIdentifiers[deviceId] UTF8String];
+}
+
+const char* _uiOSGetInternedCharacteristicUUID(int characteristicId) {
+    if (characteristicUUIDs == nil || characteristicId < 0 || characteristicId >= (int)characteristicUUIDs.count) {
+        return NULL;
+    }
+    return [characteristicUUIDs[characteristicId] UTF8String];
+}
+
 void _uiOSUnMonitorCharacteristicForDevice(const char* identifier, const char* serviceUUID, const char* characteristicUUID) {
     // no op
 }
@@ -224,12 +627,16 @@ void _uiOSUnMonitorCharacteristicForDevice(const char* identifier, const char* s
 
             const char *identifier = [[NSString stringWithFormat:@"%@", [item valueForKey:@"id"]] UTF8String];
             const char *name = [[NSString stringWithFormat:@"%@", [item valueForKey:@"name"]] UTF8String];
-            const char *rssi = [[NSString stringWithFormat:@"%@", [item valueForKey:@"rssi"]] UTF8String];
-            const char *manufacturerData = [[NSString stringWithFormat:@"%@", [item valueForKey:@"manufacturerData"]] UTF8String];
 
             if (discoveredActionCallback != nil) {
+                const char *rssi = [[NSString stringWithFormat:@"%@", [item valueForKey:@"rssi"]] UTF8String];
+                const char *manufacturerData = [[NSString stringWithFormat:@"%@", [item valueForKey:@"manufacturerData"]] UTF8String];
                 discoveredActionCallback(identifier, name, rssi, manufacturerData);
             }
+            if (discoveredBinaryActionCallback != nil) {
+                NSData *data = rawData([item valueForKey:@"rawManufacturerData"]);
+                discoveredBinaryActionCallback(identifier, name, [[item valueForKey:@"rssi"] intValue], (const unsigned char *)data.bytes, (int)data.length);
+            }
         }
         return;
     }
@@ -258,20 +665,42 @@ void _uiOSUnMonitorCharacteristicForDevice(const char* identifier, const char* s
     }
 
     if ([name isEqualToString:@"ReadEvent"]) {
-        if (notifiedCharacteristicActionCallback != nil) {
-            if ([value isKindOfClass:[NSArray class]]) {
-                NSObject *characteristic = [value objectAtIndex:1];
-                if ([characteristic isEqual:[NSNull null]]) {
-                    return;
+        if ([value isKindOfClass:[NSArray class]]) {
+            NSObject *characteristic = [value objectAtIndex:1];
+            if ([characteristic isEqual:[NSNull null]]) {
+                return;
+            }
+
+            // subscriptions made through the id-based export are resolved without touching strings
+            NSNumber *subscription = [monitorSubscriptions objectForKey:[value objectAtIndex:2]];
+            if (notificationBuffering || subscription != nil) {
+                int deviceId;
+                int characteristicId;
+                if (subscription != nil) {
+                    deviceId = (int)([subscription longLongValue] >> 32);
+                    characteristicId = (int)([subscription longLongValue] & 0xffffffff);
+                } else {
+                    deviceId = internDevice([characteristic valueForKey:@"deviceID"]);
+                    characteristicId = internCharacteristic([characteristic valueForKey:@"serviceUUID"], [characteristic valueForKey:@"uuid"]);
                 }
+                NSData *data = rawData([characteristic valueForKey:@"rawValue"]);
+                if (notificationBuffering) {
+                    pushNotification(deviceId, characteristicId, data);
+                } else if (notifiedCharacteristicByIdActionCallback != nil) {
+                    notifiedCharacteristicByIdActionCallback(deviceId, characteristicId, (const unsigned char *)data.bytes, (int)data.length);
+                }
+                return;
+            }
 
-                const char *identifier = [[characteristic valueForKey:@"deviceID"] UTF8String];
-                const char *characteristicUUID = [[characteristic valueForKey:@"uuid"] UTF8String];
-                const char *value = [[characteristic valueForKey:@"value"] UTF8String];
+            const char *identifier = [[characteristic valueForKey:@"deviceID"] UTF8String];
+            const char *characteristicUUID = [[characteristic valueForKey:@"uuid"] UTF8String];
 
-                if (notifiedCharacteristicActionCallback != nil) {
-                    notifiedCharacteristicActionCallback(identifier, characteristicUUID, value);
-                }
+            if (notifiedCharacteristicActionCallback != nil) {
+                notifiedCharacteristicActionCallback(identifier, characteristicUUID, base64Value(characteristic));
+            }
+            if (notifiedCharacteristicBinaryActionCallback != nil) {
+                NSData *data = rawData([characteristic valueForKey:@"rawValue"]);
+                notifiedCharacteristicBinaryActionCallback(identifier, characteristicUUID, (const unsigned char *)data.bytes, (int)data.length);
             }
         }
         return;
@@ -457,6 +886,24 @@ void _uiOSUnMonitorCharacteristicForDevice(const char* identifier, const char* s
                                     reject:reject];
 }
 
+- (void)writeCharacteristicForDevice:(NSString*)deviceIdentifier
+                         serviceUUID:(NSString*)serviceUUID
+                  characteristicUUID:(NSString*)characteristicUUID
+                               value:(NSData*)value
+                        withResponse:(BOOL)response
+                       transactionId:(NSString*)transactionId
+                            resolver:(void (^)(NSDictionary* characteristic))resolve
+                            rejecter:(void (^)(NSString* code, NSString* message, NSError* error))reject {
+    [_manager writeCharacteristicForDevice:deviceIdentifier
+                               serviceUUID:serviceUUID
+                        characteristicUUID:characteristicUUID
+                                     value:value
+                                  response:response
+                             transactionId:transactionId
+                                   resolve:resolve
+                                    reject:reject];
+}
+
 - (void)writeCharacteristicForService:(nonnull NSNumber*)serviceIdentifier
                    characteristicUUID:(NSString*)characteristicUUID
                           valueBase64:(NSString*)valueBase64
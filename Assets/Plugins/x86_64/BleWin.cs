@@ -8,7 +8,10 @@ using System;
 using System.Runtime.InteropServices;
 using System.Collections.Generic;
 using System.Collections;
+using System.Threading;
 using toio.Windows.Data;
+using Unity.Collections;
+using Unity.Collections.LowLevel.Unsafe;
 
 namespace toio.Windows
 {
@@ -19,34 +22,96 @@ namespace toio.Windows
 
         private static List<BleWriteRequestData> s_writeRequests = new List<BleWriteRequestData>();
         private static List<BleReadRequestData> s_readRequests = new List<BleReadRequestData>();
-        private static Dictionary<BleCharastericsKeyInfo, BleNotifyData> s_notifyEvents = new Dictionary<BleCharastericsKeyInfo, BleNotifyData>();
+        // subscriber id of each subscribed characteristic; the plugin tags notifications with it.
+        // the low bits index s_notifySubscribers, the high bits count how often the slot was reused,
+        // so records still tagged with an unsubscribed id don't reach the next subscriber of the slot
+        private const int SubscriberSlotMask = 0xFFFF;
+        private const int SubscriberGenerationShift = 16;
+        private static Dictionary<BleCharastericsKeyInfo, int> s_notifyEvents = new Dictionary<BleCharastericsKeyInfo, int>();
+        private static List<BleNotifyData> s_notifySubscribers = new List<BleNotifyData>();
+        private static Stack<int> s_freeSubscriberIds = new Stack<int>();
 
         private static HashSet<string> s_allreadyCallServiceBuffer = new HashSet<string>();
         private static List<int> s_removeIdxBuffer = new List<int>();
         private static List<string> s_removeKeyBuffer = new List<string>();
 
+        private class BulkTransfer
+        {
+            public ulong addr;
+            public BulkTransferHandler handle;
+            public bool isReceive;
+            public Action<BulkTransferProgress> progressAction;
+            public Action<bool, byte[]> completedAction;
+        }
+        private static List<BulkTransfer> s_bulkTransfers = new List<BulkTransfer>();
+
+        // NotificationRingHeader of the shared notification ring, zero while disabled
+        private static IntPtr s_notificationRing = IntPtr.Zero;
+
         private static bool s_isInitialized = false;
+        private static Action<bool> s_finalizedAction = null;
 
         public static void Initialize(Action initializedAction, Action<string> errorAction = null)
         {
-            // clear data
+            ClearData();
+            BehaviourProxy.Create(InitAction(initializedAction,errorAction),OnUpdate);
+        }
+
+        // the adapter and radio checks run on a native thread instead of one step per frame.
+        // with scanServiceUUIDs the scan starts right away, before the checks finish; devices found
+        // meanwhile are reported once initializedAction has run. called again while the checks still
+        // run, it waits for that startup instead of starting another (its scan request is ignored,
+        // and the running startup's scan filter is left as it is)
+        public static void InitializeAsync(Action initializedAction, Action<string> errorAction = null,
+            string[] scanServiceUUIDs = null, Action<string, string, int, byte[]> discoveredAction = null)
+        {
+            ClearData();
+            bool scanImmediately = (scanServiceUUIDs != null);
+            if (scanImmediately && !DllInterface.IsStartupRunning())
+            {
+                s_discoverAction = discoveredAction;
+                DllInterface.ClearScanFilter();
+                foreach (var uuid in scanServiceUUIDs)
+                {
+                    DllInterface.AddScanServiceUuid(UuidDatabase.GetUuid(uuid));
+                }
+            }
+            DllInterface.StartupAsync(scanImmediately);
+            BehaviourProxy.Create(WaitAdapterStatus(DllInterface.GetStartupStatus, initializedAction, errorAction), OnUpdate);
+        }
+
+        // time to adapter ready, first advertisement etc. of the last Initialize/InitializeAsync
+        public static StartupTimings GetStartupTimings()
+        {
+            return DllInterface.GetStartupTimings();
+        }
+
+        private static void ClearData()
+        {
             s_discoverAction = null;
             s_deviceDiscoverEvents.Clear();
             s_writeRequests.Clear();
             s_readRequests.Clear();
             s_notifyEvents.Clear();
+            s_notifySubscribers.Clear();
+            s_freeSubscriberIds.Clear();
+            s_bulkTransfers.Clear();
+            s_notificationRing = IntPtr.Zero;
             s_isInitialized = false;
-
-            BehaviourProxy.Create(InitAction(initializedAction,errorAction),OnUpdate);
         }
         private static IEnumerator InitAction(Action initializedAction, Action<string> errorAction)
         {
             DllInterface.BleAdapterStatusRequest();
+            return WaitAdapterStatus(DllInterface.BleAdapterUpdate, initializedAction, errorAction);
+        }
+        private static IEnumerator WaitAdapterStatus(Func<DllInterface.EBluetoothStatus> updateStatus,
+            Action initializedAction, Action<string> errorAction)
+        {
             DllInterface.EBluetoothStatus stat = DllInterface.EBluetoothStatus.None;
 
             while (stat == DllInterface.EBluetoothStatus.None)
             {
-                stat = DllInterface.BleAdapterUpdate();
+                stat = updateStatus();
                 yield return null;
             }
             switch (stat)
@@ -82,9 +147,75 @@ namespace toio.Windows
             if (!s_isInitialized) { return; }
             //Debug.Log("Finalize");
             DllInterface.FinalizePlugin();
+            s_notificationRing = IntPtr.Zero;
             if(finalizedAction != null) { finalizedAction(); }
         }
 
+        // closes every device in parallel without blocking the frame.
+        // finalizedAction gets false when some devices were still closing at the deadline
+        public static void FinalizeAsync(Action<bool> finalizedAction = null, int timeoutMs = 2000)
+        {
+            if (!s_isInitialized) { return; }
+            DllInterface.FinalizePluginAsync(timeoutMs);
+            s_notificationRing = IntPtr.Zero;
+            s_finalizedAction = (finalizedAction != null) ? finalizedAction : (result => { });
+        }
+
+        // close time of each device in the last finalize
+        public static FinalizeRecord[] GetFinalizeRecords()
+        {
+            return DllInterface.GetFinalizeRecords();
+        }
+
+        // keeps connections, subscriptions and buffered notifications alive across a domain reload:
+        // Finalize/FinalizeAsync only detach while it is on. Turn it off before a real shutdown.
+        public static void SetKeepAlive(bool enable)
+        {
+            DllInterface.SetKeepAlive(enable);
+        }
+
+        // after Initialize in the reloaded domain: the devices that stayed connected.
+        // call ConnectToPeripheral / SubscribeCharacteristic again to rebind callbacks;
+        // the native side already has them, so nothing goes over the air.
+        public static SessionDevice[] ReattachSession()
+        {
+            if (!s_isInitialized) { return new SessionDevice[0]; }
+            var snapshot = DllInterface.ReattachSession();
+            // SessionHeader { uint magic; ushort version; ushort deviceNum; }
+            if (snapshot.Length < 8 || BitConverter.ToUInt32(snapshot, 0) != 0x53454C42)
+            {
+                return new SessionDevice[0];
+            }
+            int deviceNum = BitConverter.ToUInt16(snapshot, 6);
+            var devices = new SessionDevice[deviceNum];
+            int offset = 8;
+            for (int i = 0; i < deviceNum; ++i)
+            {
+                // SessionDevice { ulong addr; ushort charastricsNum; ushort bufferedNotificationNum; uint droppedNotificationNum; }
+                var device = new SessionDevice();
+                device.identifier = DeviceAddressDatabase.GetAddressStr(BitConverter.ToUInt64(snapshot, offset));
+                int charastricsNum = BitConverter.ToUInt16(snapshot, offset + 8);
+                device.bufferedNotificationNum = BitConverter.ToUInt16(snapshot, offset + 10);
+                device.droppedNotificationNum = (int)BitConverter.ToUInt32(snapshot, offset + 12);
+                offset += 16;
+                device.characteristics = new SessionCharacteristic[charastricsNum];
+                for (int j = 0; j < charastricsNum; ++j)
+                {
+                    // SessionCharacteristic { ulong serviceUuid; ulong charastricsUuid; uint flags; uint reserved; }
+                    var characteristic = new SessionCharacteristic();
+                    characteristic.serviceUUID = UuidDatabase.GetUuidStr(
+                        new UuidHandler(new IntPtr(BitConverter.ToInt64(snapshot, offset))));
+                    characteristic.characteristicUUID = UuidDatabase.GetUuidStr(
+                        new UuidHandler(new IntPtr(BitConverter.ToInt64(snapshot, offset + 8))));
+                    characteristic.isSubscribed = (BitConverter.ToUInt32(snapshot, offset + 16) & 1) != 0;
+                    device.characteristics[j] = characteristic;
+                    offset += 24;
+                }
+                devices[i] = device;
+            }
+            return devices;
+        }
+
         public static void EnableBluetooth(bool enable)
         {
         }
@@ -118,6 +249,19 @@ namespace toio.Windows
             Action<string, string> discoveredServiceAction = null,
             Action<string, string, string> discoveredCharacteristicAction = null,
             Action<string> disconnectedPeripheralAction = null)
+        {
+            ConnectToPeripheral(identifier, null, connectedPeripheralAction,
+                discoveredServiceAction, discoveredCharacteristicAction,
+                disconnectedPeripheralAction);
+        }
+
+        // serviceUUIDs limits GATT discovery to the given services (null discovers all)
+        public static void ConnectToPeripheral(string identifier,
+            string[] serviceUUIDs,
+            Action<string> connectedPeripheralAction = null,
+            Action<string, string> discoveredServiceAction = null,
+            Action<string, string, string> discoveredCharacteristicAction = null,
+            Action<string> disconnectedPeripheralAction = null)
         {
             if (!s_isInitialized) { return; }
             //Debug.Log("Connect to peripheral " + identifier);
@@ -126,7 +270,19 @@ namespace toio.Windows
                 return;
             }
             var addr = DeviceAddressDatabase.GetAddressValue(identifier);
-            DllInterface.ConnectDevice(addr);
+            if (serviceUUIDs != null && serviceUUIDs.Length > 0)
+            {
+                var serviceHandles = new UuidHandler[serviceUUIDs.Length];
+                for (int i = 0; i < serviceUUIDs.Length; ++i)
+                {
+                    serviceHandles[i] = UuidDatabase.GetUuid(serviceUUIDs[i]);
+                }
+                DllInterface.ConnectDevice(addr, serviceHandles);
+            }
+            else
+            {
+                DllInterface.ConnectDevice(addr);
+            }
             var evt = new BleDiscoverEvents(connectedPeripheralAction,
                 discoveredServiceAction,
                 discoveredCharacteristicAction, 
@@ -151,6 +307,102 @@ namespace toio.Windows
             DllInterface.DisconnectAllDevice();
         }
 
+        // device objects left disconnected for timeoutSec are recycled (negative keeps them);
+        // poolSize of them are kept for reuse
+        public static void SetDeviceIdleEviction(float timeoutSec, int poolSize)
+        {
+            if (!s_isInitialized) { return; }
+            DllInterface.SetDeviceIdleEviction(timeoutSec, poolSize);
+        }
+
+        public static DeviceResidentStats GetDeviceResidentStats()
+        {
+            if (!s_isInitialized) { return default(DeviceResidentStats); }
+            return DllInterface.GetDeviceResidentStats();
+        }
+
+        // writes every advertisement, connection change, GATT request/response and notification to a binary trace
+        public static bool StartCapture(string path)
+        {
+            if (!s_isInitialized) { return false; }
+            return DllInterface.StartCapture(path);
+        }
+
+        public static void StopCapture()
+        {
+            if (!s_isInitialized) { return; }
+            DllInterface.StopCapture();
+        }
+
+        // feeds a captured trace back instead of the radio. speed 2.0 runs twice as fast, 0 as fast as possible
+        public static bool StartReplay(string path, float speed = 1.0f, bool loop = false)
+        {
+            if (!s_isInitialized) { return false; }
+            return DllInterface.StartReplay(path, speed, loop);
+        }
+
+        public static void StopReplay()
+        {
+            if (!s_isInitialized) { return; }
+            DllInterface.StopReplay();
+        }
+
+        // records plugin activity for chrome://tracing / Perfetto.
+        // returns false when the plugin was built without BLEPLUGIN_TIMELINE
+        public static bool StartTimeline()
+        {
+            if (!s_isInitialized) { return false; }
+            return DllInterface.TimelineStart();
+        }
+
+        public static void StopTimeline()
+        {
+            if (!s_isInitialized) { return; }
+            DllInterface.TimelineStop();
+        }
+
+        // writes Chrome trace-event JSON; call after StopTimeline
+        public static bool ExportTimeline(string path)
+        {
+            if (!s_isInitialized) { return false; }
+            return DllInterface.TimelineExport(path);
+        }
+
+        // Bluetooth adapters found at Initialize; connections are spread over them by the placement policy
+        public static int GetAdapterNum()
+        {
+            if (!s_isInitialized) { return 0; }
+            return DllInterface.GetAdapterNum();
+        }
+
+        public static bool GetAdapterStats(int adapterIdx, out AdapterStats stats)
+        {
+            if (!s_isInitialized) { stats = default(AdapterStats); return false; }
+            return DllInterface.GetAdapterStats(adapterIdx, out stats);
+        }
+
+        public static void SetAdapterPlacement(DllInterface.EAdapterPlacement placement)
+        {
+            if (!s_isInitialized) { return; }
+            DllInterface.SetAdapterPlacement(placement);
+        }
+
+        // used by EAdapterPlacement.Pinned. adapterIdx < 0 removes the pin
+        public static void PinDeviceToAdapter(string identifier, int adapterIdx)
+        {
+            if (!s_isInitialized) { return; }
+            var addr = DeviceAddressDatabase.GetAddressValue(identifier);
+            DllInterface.PinDeviceToAdapter(addr, adapterIdx);
+        }
+
+        // -1 while the device is not connecting/connected or no adapter was enumerated
+        public static int GetDeviceAdapter(string identifier)
+        {
+            if (!s_isInitialized) { return -1; }
+            var addr = DeviceAddressDatabase.GetAddressValue(identifier);
+            return DllInterface.GetDeviceAdapter(addr);
+        }
+
         public static void ReadCharacteristic(string identifier,
             string serviceUUID, 
             string characteristicUUID,
@@ -202,7 +454,25 @@ namespace toio.Windows
             var characteristicHandle = UuidDatabase.GetUuid(characteristicUUID);
             var charastricsItem = new BleCharastericsKeyInfo(identifier, serviceUUID, characteristicUUID);
 
-            s_notifyEvents[charastricsItem] = new BleNotifyData(notifiedCharacteristicAction);
+            int subscriberId;
+            if (!s_notifyEvents.TryGetValue(charastricsItem, out subscriberId))
+            {
+                if (s_freeSubscriberIds.Count > 0)
+                {
+                    int freeId = s_freeSubscriberIds.Pop();
+                    int generation = ((freeId >> SubscriberGenerationShift) + 1) & (int.MaxValue >> SubscriberGenerationShift);
+                    subscriberId = (freeId & SubscriberSlotMask) | (generation << SubscriberGenerationShift);
+                }
+                else
+                {
+                    subscriberId = s_notifySubscribers.Count;
+                    s_notifySubscribers.Add(new BleNotifyData());
+                }
+                s_notifyEvents[charastricsItem] = subscriberId;
+            }
+            s_notifySubscribers[subscriberId & SubscriberSlotMask] = new BleNotifyData(subscriberId, UuidDatabase.GetUuidStr(serviceHandle),
+                UuidDatabase.GetUuidStr(characteristicHandle), notifiedCharacteristicAction);
+            DllInterface.SetNotificationSubscriberId(addr, serviceHandle, characteristicHandle, subscriberId);
             DllInterface.SetNotificationRequest(addr, serviceHandle,characteristicHandle , true);
         }
 
@@ -217,11 +487,219 @@ namespace toio.Windows
             var characteristicHandle = UuidDatabase.GetUuid(characteristicUUID);
             var charastricsItem = new BleCharastericsKeyInfo(identifier, serviceUUID, characteristicUUID);
             DllInterface.SetNotificationRequest(addr, serviceHandle, characteristicHandle, false);
-            s_notifyEvents.Remove(charastricsItem);
+            int subscriberId;
+            if (s_notifyEvents.TryGetValue(charastricsItem, out subscriberId))
+            {
+                DllInterface.SetNotificationSubscriberId(addr, serviceHandle, characteristicHandle, -1);
+                s_notifySubscribers[subscriberId & SubscriberSlotMask] = new BleNotifyData();
+                s_freeSubscriberIds.Push(subscriberId);
+                s_notifyEvents.Remove(charastricsItem);
+            }
+        }
+
+        // keeps timestamped samples of a subscribed characteristic natively, decoded by fields.
+        // matchOffset >= 0 keeps only notifications whose byte there equals matchValue
+        public static bool EnableSampleHistory(string identifier,
+            string serviceUUID, string characteristicUUID,
+            int capacity, SampleField[] fields, int matchOffset = -1, int matchValue = 0)
+        {
+            if (!s_isInitialized) { return false; }
+            var addr = DeviceAddressDatabase.GetAddressValue(identifier);
+            return DllInterface.EnableSampleHistory(addr, UuidDatabase.GetUuid(serviceUUID),
+                UuidDatabase.GetUuid(characteristicUUID), capacity, fields, matchOffset, matchValue);
+        }
+
+        public static void DisableSampleHistory(string identifier,
+            string serviceUUID, string characteristicUUID)
+        {
+            if (!s_isInitialized) { return; }
+            var addr = DeviceAddressDatabase.GetAddressValue(identifier);
+            DllInterface.DisableSampleHistory(addr, UuidDatabase.GetUuid(serviceUUID),
+                UuidDatabase.GetUuid(characteristicUUID));
+        }
+
+        // the clock samples are stamped with (seconds); add the render latency to sample ahead
+        public static double GetHostTime()
+        {
+            return DllInterface.GetHostTime();
+        }
+
+        // fills samples with the newest ones, oldest first; returns the count
+        public static int GetSampleHistory(string identifier,
+            string serviceUUID, string characteristicUUID, HistorySample[] samples)
+        {
+            if (!s_isInitialized) { return 0; }
+            var addr = DeviceAddressDatabase.GetAddressValue(identifier);
+            return DllInterface.CopySampleHistory(addr, UuidDatabase.GetUuid(serviceUUID),
+                UuidDatabase.GetUuid(characteristicUUID), samples);
+        }
+
+        // field values at time, interpolated between samples or extrapolated past the newest
+        public static DllInterface.ESampleResult SampleHistoryAt(string identifier,
+            string serviceUUID, string characteristicUUID,
+            double time, float[] values, float maxExtrapolationSec = 0.1f)
+        {
+            if (!s_isInitialized) { return DllInterface.ESampleResult.None; }
+            var addr = DeviceAddressDatabase.GetAddressValue(identifier);
+            return DllInterface.SampleHistoryAt(addr, UuidDatabase.GetUuid(serviceUUID),
+                UuidDatabase.GetUuid(characteristicUUID), time, maxExtrapolationSec, values);
+        }
+
+        // decodes every notification of the characteristic natively into one float column per field.
+        // returns the schema id for GetDecodedColumn, or -1 when the layout doesn't fit a notification
+        public static int RegisterPayloadSchema(string serviceUUID, string characteristicUUID,
+            PayloadField[] fields, int matchOffset = -1, int matchValue = 0)
+        {
+            if (!s_isInitialized) { return -1; }
+            return DllInterface.RegisterPayloadSchema(UuidDatabase.GetUuid(serviceUUID),
+                UuidDatabase.GetUuid(characteristicUUID), fields, matchOffset, matchValue);
+        }
+
+        public static void UnregisterPayloadSchema(int schemaId)
+        {
+            if (!s_isInitialized) { return; }
+            DllInterface.UnregisterPayloadSchema(schemaId);
+        }
+
+        // rows decoded this frame; row i of every column came from device GetDecodedAddrs()[i]
+        public static int GetDecodedRowNum(int schemaId)
+        {
+            if (!s_isInitialized) { return 0; }
+            return DllInterface.GetDecodedRowNum(schemaId);
+        }
+
+        // views of native memory, valid until the next update: use them in jobs completed this frame
+        public static NativeArray<float> GetDecodedColumn(int schemaId, int fieldIdx)
+        {
+            return WrapNative<float>(DllInterface.GetDecodedColumn(schemaId, fieldIdx), GetDecodedRowNum(schemaId));
+        }
+
+        public static NativeArray<ulong> GetDecodedAddrs(int schemaId)
+        {
+            return WrapNative<ulong>(DllInterface.GetDecodedAddrs(schemaId), GetDecodedRowNum(schemaId));
+        }
+
+        // every notification is also written to a native ring that is read in place, without draining
+        // or copying. enabling it again with the same capacity keeps the ring (across a domain reload too)
+        public static bool EnableNotificationRing(int capacity = 1024)
+        {
+            if (!s_isInitialized) { return false; }
+            s_notificationRing = DllInterface.EnableNotificationRing(capacity);
+            return s_notificationRing != IntPtr.Zero;
+        }
+
+        public static void DisableNotificationRing()
+        {
+            if (!s_isInitialized) { return; }
+            s_notificationRing = IntPtr.Zero;
+            DllInterface.DisableNotificationRing();
+        }
+
+        // records not read yet, oldest first, up to the end of the ring (acquire again after releasing
+        // for the wrapped part). the view stays valid until ReleaseNotificationRecords
+        public static unsafe NativeArray<NotificationRecord> AcquireNotificationRecords()
+        {
+            if (s_notificationRing == IntPtr.Zero) { return WrapNative<NotificationRecord>(IntPtr.Zero, 0); }
+            var header = (NotificationRingHeader*)s_notificationRing.ToPointer();
+            // acquire: every record below writeCursor is complete
+            long write = Volatile.Read(ref header->writeCursor);
+            long read = header->readCursor;
+            long slot = read & (header->capacity - 1);
+            int num = (int)Math.Min(write - read, header->capacity - slot);
+            var records = (byte*)header + header->recordOffset + slot * header->recordSize;
+            return WrapNative<NotificationRecord>(new IntPtr(records), num);
+        }
+
+        // hands the oldest num records back to the plugin; views of them must not be used afterwards
+        public static unsafe void ReleaseNotificationRecords(int num)
+        {
+            if (s_notificationRing == IntPtr.Zero || num <= 0) { return; }
+            var header = (NotificationRingHeader*)s_notificationRing.ToPointer();
+            // never past writeCursor, or the plugin would see free slots that were never read
+            long read = header->readCursor;
+            long releaseNum = Math.Min(num, Volatile.Read(ref header->writeCursor) - read);
+            if (releaseNum <= 0) { return; }
+            // release: the plugin reuses the slots only after this store
+            Volatile.Write(ref header->readCursor, read + releaseNum);
+        }
+
+        // notifications lost because the ring was full
+        public static unsafe long GetDroppedNotificationNum()
+        {
+            if (s_notificationRing == IntPtr.Zero) { return 0; }
+            var header = (NotificationRingHeader*)s_notificationRing.ToPointer();
+            return Volatile.Read(ref header->droppedNum);
+        }
+
+        private static unsafe NativeArray<T> WrapNative<T>(IntPtr ptr, int length) where T : struct
+        {
+            if (ptr == IntPtr.Zero) { length = 0; }
+            var array = NativeArrayUnsafeUtility.ConvertExistingDataToNativeArray<T>(ptr.ToPointer(), length, Allocator.None);
+#if ENABLE_UNITY_COLLECTIONS_CHECKS
+            NativeArrayUnsafeUtility.SetAtomicSafetyHandle(ref array, AtomicSafetyHandle.GetTempMemoryHandle());
+#endif
+            return array;
+        }
+
+        // sends data as chunkSize writes (0: default ATT MTU payload), window of them in flight and
+        // every checkpointInterval-th acknowledged. progressAction runs every frame until completedAction
+        public static BulkTransferHandler BulkWrite(string identifier,
+            string serviceUUID, string characteristicUUID, byte[] data,
+            Action<bool, byte[]> completedAction = null, Action<BulkTransferProgress> progressAction = null,
+            int chunkSize = 0, int window = 16, int checkpointInterval = 64)
+        {
+            if (!s_isInitialized) { return new BulkTransferHandler(IntPtr.Zero); }
+            var addr = DeviceAddressDatabase.GetAddressValue(identifier);
+            var handle = DllInterface.StartBulkWrite(addr, UuidDatabase.GetUuid(serviceUUID),
+                UuidDatabase.GetUuid(characteristicUUID), data, chunkSize, window, checkpointInterval);
+            return AddBulkTransfer(addr, handle, false, completedAction, progressAction);
+        }
+
+        // reassembles notifications of the characteristic (already subscribed) into one buffer,
+        // dropping headerSize bytes of every packet. expectedSize 0 runs until CancelBulkTransfer
+        public static BulkTransferHandler BulkReceive(string identifier,
+            string serviceUUID, string characteristicUUID, int expectedSize, int headerSize,
+            Action<bool, byte[]> completedAction = null, Action<BulkTransferProgress> progressAction = null)
+        {
+            if (!s_isInitialized) { return new BulkTransferHandler(IntPtr.Zero); }
+            var addr = DeviceAddressDatabase.GetAddressValue(identifier);
+            var handle = DllInterface.StartBulkReceive(addr, UuidDatabase.GetUuid(serviceUUID),
+                UuidDatabase.GetUuid(characteristicUUID), expectedSize, headerSize);
+            return AddBulkTransfer(addr, handle, true, completedAction, progressAction);
+        }
+
+        // completedAction still runs (false, or the data received so far for a stream)
+        public static void CancelBulkTransfer(string identifier, BulkTransferHandler handle)
+        {
+            if (!s_isInitialized) { return; }
+            DllInterface.CancelBulkTransfer(DeviceAddressDatabase.GetAddressValue(identifier), handle);
+        }
+
+        private static BulkTransferHandler AddBulkTransfer(ulong addr, BulkTransferHandler handle, bool isReceive,
+            Action<bool, byte[]> completedAction, Action<BulkTransferProgress> progressAction)
+        {
+            if (handle.ptr == IntPtr.Zero)
+            {
+                if (completedAction != null) { completedAction(false, null); }
+                return handle;
+            }
+            var transfer = new BulkTransfer();
+            transfer.addr = addr;
+            transfer.handle = handle;
+            transfer.isReceive = isReceive;
+            transfer.progressAction = progressAction;
+            transfer.completedAction = completedAction;
+            s_bulkTransfers.Add(transfer);
+            return handle;
         }
 
         private static void OnUpdate()
         {
+            if (s_finalizedAction != null)
+            {
+                UpdateFinalize();
+                return;
+            }
             if (!s_isInitialized) { return; }
             DllInterface.UpdateFromMainThread();
             UpdateScanDeviceEvents();
@@ -229,9 +707,50 @@ namespace toio.Windows
             UpdateWriteRequests();
             UpdateReadRequests();
             UpdateNotification();
+            UpdateBulkTransfers();
             UpdateDisconnectedDevice();
         }
 
+        private static void UpdateFinalize()
+        {
+            var status = DllInterface.GetFinalizeStatus();
+            if (status == DllInterface.EFinalizeStatus.Running) { return; }
+            var action = s_finalizedAction;
+            s_finalizedAction = null;
+            // None: keep-alive only detached, nothing had to close
+            action(status != DllInterface.EFinalizeStatus.TimedOut);
+        }
+
+        private static void UpdateBulkTransfers()
+        {
+            for (int i = s_bulkTransfers.Count - 1; i >= 0; --i)
+            {
+                var transfer = s_bulkTransfers[i];
+                BulkTransferProgress progress;
+                if (!DllInterface.GetBulkTransferProgress(transfer.addr, transfer.handle, out progress))
+                {
+                    // the device object is gone
+                    s_bulkTransfers.RemoveAt(i);
+                    if (transfer.completedAction != null) { transfer.completedAction(false, null); }
+                    continue;
+                }
+                if (transfer.progressAction != null) { transfer.progressAction(progress); }
+                if (progress.status == DllInterface.EBulkStatus.Running) { continue; }
+
+                byte[] data = null;
+                if (transfer.isReceive)
+                {
+                    data = DllInterface.GetBulkReceiveData(transfer.addr, transfer.handle);
+                }
+                DllInterface.ReleaseBulkTransfer(transfer.addr, transfer.handle);
+                s_bulkTransfers.RemoveAt(i);
+                if (transfer.completedAction != null)
+                {
+                    transfer.completedAction(progress.status == DllInterface.EBulkStatus.Completed, data);
+                }
+            }
+        }
+
         private static void UpdateScanDeviceEvents()
         {
             if (!s_isInitialized) { return; }
@@ -377,27 +896,25 @@ namespace toio.Windows
             for(int i = 0; i < deviceNum; ++i)
             {
                 ulong addr = DllInterface.GetConnectDeviceAddr(i);
-                string identifier = DeviceAddressDatabase.GetAddressStr(addr);
 
                 int num = DllInterface.GetDeviceNotificateNum(addr);
-                //Debug.Log("UpdateNotification " + identifier + "::" +num + "  " + i + "/" + deviceNum );
+                //Debug.Log("UpdateNotification " + addr + "::" +num + "  " + i + "/" + deviceNum );
                 for (int j = 0; j < num; ++j)
                 {
-                    var data = DllInterface.GetDeviceNotificateData(addr, j);
-                    var serviceHandle = DllInterface.GetDeviceNotificateServiceUuid(addr, j);
-                    var charastricHandle = DllInterface.GetDeviceNotificateCharastricsUuid(addr, j);
-                    string serviceUUID = UuidDatabase.GetUuidStr(serviceHandle);
-                    string characteristicUUID = UuidDatabase.GetUuidStr(charastricHandle);
-
-                    var key = new BleCharastericsKeyInfo(identifier, serviceUUID, characteristicUUID);
-                    BleNotifyData bleNotifyData;
-                    if(s_notifyEvents.TryGetValue(key,out bleNotifyData))
+                    // tagged natively at subscribe time: no uuid strings or key lookups per notification
+                    int subscriberId = DllInterface.GetDeviceNotificateSubscriberId(addr, j);
+                    int slot = subscriberId & SubscriberSlotMask;
+                    if (subscriberId < 0 || slot >= s_notifySubscribers.Count)
                     {
-                        if (bleNotifyData.notifiedCharacteristicAction != null)
-                        {
-                            bleNotifyData.notifiedCharacteristicAction(serviceUUID, characteristicUUID, data);
-                        }
+                        continue;
                     }
+                    var bleNotifyData = s_notifySubscribers[slot];
+                    if (bleNotifyData.subscriberId != subscriberId || bleNotifyData.notifiedCharacteristicAction == null)
+                    {
+                        continue;
+                    }
+                    var data = DllInterface.GetDeviceNotificateData(addr, j);
+                    bleNotifyData.notifiedCharacteristicAction(bleNotifyData.serviceUUID, bleNotifyData.characteristicUUID, data);
                 }
             }
         }
@@ -36,9 +36,16 @@ namespace toio.Windows.Data {
     }
     internal struct BleNotifyData
     {
+        // full id (slot and generation) this entry answers to
+        public int subscriberId;
+        public string serviceUUID;
+        public string characteristicUUID;
         public Action<string, string, byte[]> notifiedCharacteristicAction;
-        public BleNotifyData(Action<string, string, byte[]> act)
+        public BleNotifyData(int id, string service, string ch, Action<string, string, byte[]> act)
         {
+            this.subscriberId = id;
+            this.serviceUUID = service;
+            this.characteristicUUID = ch;
             this.notifiedCharacteristicAction = act;
         }
     }
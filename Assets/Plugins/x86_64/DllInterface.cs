@@ -39,6 +39,257 @@ namespace toio.Windows
             ptr = p;
         }
     }
+    public struct WriteBatchHandler
+    {
+        public IntPtr ptr;
+        public WriteBatchHandler(IntPtr p)
+        {
+            ptr = p;
+        }
+    }
+    public struct OperationHandler
+    {
+        public IntPtr ptr;
+        public OperationHandler(IntPtr p)
+        {
+            ptr = p;
+        }
+    }
+    public struct BulkTransferHandler
+    {
+        public IntPtr ptr;
+        public BulkTransferHandler(IntPtr p)
+        {
+            ptr = p;
+        }
+    }
+    // same layout as BlePlugin::BulkTransferProgress
+    [StructLayout(LayoutKind.Sequential)]
+    public struct BulkTransferProgress
+    {
+        public DllInterface.EBulkStatus status;
+        public int reserved;
+        public ulong totalBytes;
+        // written and acknowledged, or received
+        public ulong doneBytes;
+        public ulong chunkNum;
+        public ulong doneChunkNum;
+        public double elapsedMs;
+        public double bytesPerSec;
+    }
+    // same layout as BlePlugin::OperationSchedulerStats
+    [StructLayout(LayoutKind.Sequential)]
+    public struct OperationSchedulerStats
+    {
+        public int controlQueueDepth;
+        public int bulkQueueDepth;
+        public int inFlightNum;
+        public int reserved;
+        public ulong dispatchedNum;
+        public double averageWaitMs;
+        public double maxWaitMs;
+        public ulong coalescedWriteNum;
+        public ulong coalescedReadNum;
+        public ulong readCacheHitNum;
+        public ulong readCacheMissNum;
+    }
+    // same layout as BlePlugin::BleAdapterStats
+    [StructLayout(LayoutKind.Sequential)]
+    public struct AdapterStats
+    {
+        public ulong address;
+        public int isDefault;
+        public int isSimulated;
+        public int maxConnections;
+        public int assignedNum;
+        public int connectedNum;
+        public int connectFailedNum;
+        public ulong writeBytes;
+        public ulong notificationNum;
+        public ulong notificationBytes;
+    }
+    // same layout as BlePlugin::DeviceResidentStats
+    [StructLayout(LayoutKind.Sequential)]
+    public struct DeviceResidentStats
+    {
+        public int residentNum;
+        public int activeNum;
+        public int idleNum;
+        public int pooledNum;
+        public ulong residentBytes;
+        public ulong pooledBytes;
+        public ulong evictedNum;
+    }
+    // same layout as BlePlugin::TeardownRecord
+    [StructLayout(LayoutKind.Sequential)]
+    public struct FinalizeRecord
+    {
+        public ulong addr;
+        public float closeMs;
+        public int isClosed;
+    }
+    // same layout as BlePlugin::StartupTimings; ms from the start, -1 while it hasn't happened
+    [StructLayout(LayoutKind.Sequential)]
+    public struct StartupTimings
+    {
+        public double apartmentReadyMs;
+        public double adapterReadyMs;
+        public double statusReadyMs;
+        public double scanStartedMs;
+        public double firstAdvertisementMs;
+        public double firstDeviceListedMs;
+        public DllInterface.EBluetoothStatus status;
+        public int isScanEarly;
+    }
+    // same layout as BlePlugin::SampleField
+    [StructLayout(LayoutKind.Sequential)]
+    public struct SampleField
+    {
+        public int offset;
+        public DllInterface.ESampleFieldType type;
+        // value = raw * scale
+        public float scale;
+        // > 0 for wrapping values (angles); interpolates the short way round [0, wrap)
+        public float wrap;
+
+        public SampleField(int offset, DllInterface.ESampleFieldType type, float scale = 1.0f, float wrap = 0.0f)
+        {
+            this.offset = offset;
+            this.type = type;
+            this.scale = scale;
+            this.wrap = wrap;
+        }
+    }
+    // same layout as BlePlugin::PayloadField
+    [StructLayout(LayoutKind.Sequential)]
+    public struct PayloadField
+    {
+        public int offset;
+        public DllInterface.ESampleFieldType type;
+        // value = raw * scale
+        public float scale;
+        public int isBigEndian;
+
+        public PayloadField(int offset, DllInterface.ESampleFieldType type, float scale = 1.0f, bool isBigEndian = false)
+        {
+            this.offset = offset;
+            this.type = type;
+            this.scale = scale;
+            this.isBigEndian = isBigEndian ? 1 : 0;
+        }
+    }
+    // same layout as BlePlugin::HistorySample
+    [StructLayout(LayoutKind.Sequential)]
+    public unsafe struct HistorySample
+    {
+        public const int MaxFieldNum = 8;
+        public const int MaxDataSize = 22;
+
+        // DllInterface.GetHostTime clock
+        public double time;
+        public fixed float values[MaxFieldNum];
+        public fixed byte data[MaxDataSize];
+        public byte size;
+        public byte reserved;
+
+        public float GetValue(int idx)
+        {
+            return values[idx];
+        }
+        public byte[] GetData()
+        {
+            var result = new byte[size];
+            for (int i = 0; i < size; ++i)
+            {
+                result[i] = data[i];
+            }
+            return result;
+        }
+    }
+    // same layout as BlePlugin::NotificationRecord
+    [StructLayout(LayoutKind.Sequential)]
+    public unsafe struct NotificationRecord
+    {
+        public const int MaxDataSize = 22;
+
+        public ulong addr;
+        // DllInterface.GetHostTime clock
+        public double time;
+        public Guid charastricsUuid;
+        // BleWin subscriber id, -1 when none
+        public int subscriberId;
+        public byte size;
+        public byte reserved0;
+        public fixed byte data[MaxDataSize];
+        public uint reserved1;
+
+        public byte[] GetData()
+        {
+            var result = new byte[size];
+            for (int i = 0; i < size; ++i)
+            {
+                result[i] = data[i];
+            }
+            return result;
+        }
+    }
+    // same layout as BlePlugin::NotificationRingHeader (memory ordering rules are in
+    // BleNotificationRing.h). read writeCursor with Volatile.Read, write readCursor with Volatile.Write
+    [StructLayout(LayoutKind.Explicit, Size = 192)]
+    public struct NotificationRingHeader
+    {
+        public const uint Magic = 0x474E5242;
+
+        [FieldOffset(0)] public uint magic;
+        [FieldOffset(4)] public uint version;
+        [FieldOffset(8)] public uint recordSize;
+        [FieldOffset(12)] public uint capacity;
+        [FieldOffset(16)] public long recordOffset;
+        [FieldOffset(64)] public long writeCursor;
+        [FieldOffset(72)] public long droppedNum;
+        [FieldOffset(128)] public long readCursor;
+    }
+    // a characteristic of a device kept alive across a domain reload (BleWin.ReattachSession)
+    public class SessionCharacteristic
+    {
+        public string serviceUUID;
+        public string characteristicUUID;
+        // notifications keep flowing once SubscribeCharacteristic registers the callback again
+        public bool isSubscribed;
+    }
+    public class SessionDevice
+    {
+        public string identifier;
+        // notifications that arrived while no domain was attached
+        public int bufferedNotificationNum;
+        // oldest ones dropped because the detached buffer was full (256 per device)
+        public int droppedNotificationNum;
+        public SessionCharacteristic[] characteristics;
+    }
+    // same layout as BlePlugin::WriteBatchRecord
+    [StructLayout(LayoutKind.Sequential)]
+    public struct WriteBatchRecord
+    {
+        public ulong addr;
+        public IntPtr serviceUuid;
+        public IntPtr charastricsUuid;
+        public int dataOffset;
+        public int dataSize;
+        public int withResponse;
+        public int reserved;
+
+        public WriteBatchRecord(ulong addr, UuidHandler serviceUuid, UuidHandler charastricsUuid,
+            int dataOffset, int dataSize, bool withResponse)
+        {
+            this.addr = addr;
+            this.serviceUuid = serviceUuid.ptr;
+            this.charastricsUuid = charastricsUuid.ptr;
+            this.dataOffset = dataOffset;
+            this.dataSize = dataSize;
+            this.withResponse = withResponse ? 1 : 0;
+            this.reserved = 0;
+        }
+    }
     public struct UuidData
     {
         public uint data1;
@@ -78,6 +329,65 @@ namespace toio.Windows
             UnknownError = 99
         };
 
+        public enum EFinalizeStatus : int
+        {
+            None = 0,
+            Running = 1,
+            Completed = 2,
+            TimedOut = 3
+        };
+
+        public enum EAdapterPlacement : int
+        {
+            LeastLoaded = 0,
+            RssiBest = 1,
+            Pinned = 2,
+            // the default: every device stays on the default adapter
+            DefaultOnly = 3
+        };
+
+        public enum EBulkStatus : int
+        {
+            Running = 0,
+            Completed = 1,
+            Error = 2,
+            Cancelled = 3
+        };
+
+        public enum ESampleFieldType : int
+        {
+            UInt8 = 0,
+            Int8 = 1,
+            UInt16 = 2,
+            Int16 = 3,
+            UInt32 = 4,
+            Int32 = 5,
+            Float32 = 6
+        };
+
+        public enum ESampleResult : int
+        {
+            None = 0,
+            Interpolated = 1,
+            Extrapolated = 2,
+            Held = 3
+        };
+
+        public enum EOperationPriority : int
+        {
+            Control = 0,
+            Bulk = 1
+        };
+
+        public enum EOperationStatus : int
+        {
+            Queued = 0,
+            InFlight = 1,
+            Completed = 2,
+            Error = 3,
+            Coalesced = 4
+        };
+
         [DllImport(pluginName)]
         private static extern void _BlePluginBleAdapterStatusRequest();
         public static void BleAdapterStatusRequest() {
@@ -93,6 +403,37 @@ namespace toio.Windows
             return status;
         }
 
+        [DllImport(pluginName)]
+        private static extern void _BlePluginStartupAsync(bool scanImmediately);
+        public static void StartupAsync(bool scanImmediately)
+        {
+            _BlePluginStartupAsync(scanImmediately);
+        }
+
+        [DllImport(pluginName)]
+        private static extern int _BlePluginGetStartupStatus();
+        public static EBluetoothStatus GetStartupStatus()
+        {
+            return (EBluetoothStatus)_BlePluginGetStartupStatus();
+        }
+
+        [DllImport(pluginName)]
+        [return: MarshalAs(UnmanagedType.U1)]
+        private static extern bool _BlePluginIsStartupRunning();
+        public static bool IsStartupRunning()
+        {
+            return _BlePluginIsStartupRunning();
+        }
+
+        [DllImport(pluginName)]
+        private static extern void _BlePluginGetStartupTimings(out StartupTimings timings);
+        public static StartupTimings GetStartupTimings()
+        {
+            StartupTimings timings;
+            _BlePluginGetStartupTimings(out timings);
+            return timings;
+        }
+
         [DllImport(pluginName)]
         private static extern void _BlePluginFinalize();
         public static void FinalizePlugin()
@@ -100,6 +441,150 @@ namespace toio.Windows
             _BlePluginFinalize();
         }
 
+        [DllImport(pluginName)]
+        private static extern void _BlePluginFinalizeAsync(int timeoutMs);
+        public static void FinalizePluginAsync(int timeoutMs)
+        {
+            _BlePluginFinalizeAsync(timeoutMs);
+        }
+
+        [DllImport(pluginName)]
+        private static extern int _BlePluginGetFinalizeStatus();
+        public static EFinalizeStatus GetFinalizeStatus()
+        {
+            return (EFinalizeStatus)_BlePluginGetFinalizeStatus();
+        }
+
+        [DllImport(pluginName)]
+        private static extern void _BlePluginSetKeepAlive(bool enable);
+        public static void SetKeepAlive(bool enable)
+        {
+            _BlePluginSetKeepAlive(enable);
+        }
+
+        [DllImport(pluginName)]
+        private static extern bool _BlePluginIsSessionDetached();
+        public static bool IsSessionDetached()
+        {
+            return _BlePluginIsSessionDetached();
+        }
+
+        [DllImport(pluginName)]
+        private static extern int _BlePluginReattachSession([Out] byte[] buffer, int capacity);
+        // raw BleSession snapshot (see BleSession.h)
+        public static byte[] ReattachSession()
+        {
+            int size = _BlePluginReattachSession(null, 0);
+            var buffer = new byte[size];
+            int written = _BlePluginReattachSession(buffer, buffer.Length);
+            // a device dropped in between; take the smaller snapshot
+            while (written != buffer.Length)
+            {
+                buffer = new byte[written];
+                written = _BlePluginReattachSession(buffer, buffer.Length);
+            }
+            return buffer;
+        }
+
+        [DllImport(pluginName)]
+        private static extern int _BlePluginGetFinalizeRecordNum();
+        [DllImport(pluginName)]
+        private static extern int _BlePluginCopyFinalizeRecords([Out] FinalizeRecord[] records, int maxNum);
+        public static FinalizeRecord[] GetFinalizeRecords()
+        {
+            var records = new FinalizeRecord[_BlePluginGetFinalizeRecordNum()];
+            int num = _BlePluginCopyFinalizeRecords(records, records.Length);
+            if (num < records.Length)
+            {
+                Array.Resize(ref records, num);
+            }
+            return records;
+        }
+
+        [DllImport(pluginName)]
+        private static extern int _BlePluginGetAdapterNum();
+        public static int GetAdapterNum()
+        {
+            return _BlePluginGetAdapterNum();
+        }
+
+        [DllImport(pluginName)]
+        private static extern bool _BlePluginGetAdapterStats(int idx, out AdapterStats stats);
+        public static bool GetAdapterStats(int idx, out AdapterStats stats)
+        {
+            return _BlePluginGetAdapterStats(idx, out stats);
+        }
+
+        [DllImport(pluginName)]
+        private static extern void _BlePluginSetAdapterPlacement(int placement);
+        public static void SetAdapterPlacement(EAdapterPlacement placement)
+        {
+            _BlePluginSetAdapterPlacement((int)placement);
+        }
+
+        [DllImport(pluginName)]
+        private static extern void _BlePluginPinDeviceToAdapter(ulong addr, int adapterIdx);
+        public static void PinDeviceToAdapter(ulong addr, int adapterIdx)
+        {
+            _BlePluginPinDeviceToAdapter(addr, adapterIdx);
+        }
+
+        [DllImport(pluginName)]
+        private static extern int _BlePluginGetDeviceAdapter(ulong addr);
+        public static int GetDeviceAdapter(ulong addr)
+        {
+            return _BlePluginGetDeviceAdapter(addr);
+        }
+
+        [DllImport(pluginName)]
+        private static extern bool _BlePluginStartCapture([MarshalAs(UnmanagedType.LPWStr)] string path);
+        public static bool StartCapture(string path)
+        {
+            return _BlePluginStartCapture(path);
+        }
+
+        [DllImport(pluginName)]
+        private static extern void _BlePluginStopCapture();
+        public static void StopCapture()
+        {
+            _BlePluginStopCapture();
+        }
+
+        [DllImport(pluginName)]
+        private static extern bool _BlePluginStartReplay([MarshalAs(UnmanagedType.LPWStr)] string path, float speed, bool loop);
+        public static bool StartReplay(string path, float speed, bool loop)
+        {
+            return _BlePluginStartReplay(path, speed, loop);
+        }
+
+        [DllImport(pluginName)]
+        private static extern void _BlePluginStopReplay();
+        public static void StopReplay()
+        {
+            _BlePluginStopReplay();
+        }
+
+
+        [DllImport(pluginName)]
+        private static extern bool _BlePluginTimelineStart();
+        public static bool TimelineStart()
+        {
+            return _BlePluginTimelineStart();
+        }
+
+        [DllImport(pluginName)]
+        private static extern void _BlePluginTimelineStop();
+        public static void TimelineStop()
+        {
+            _BlePluginTimelineStop();
+        }
+
+        [DllImport(pluginName)]
+        private static extern bool _BlePluginTimelineExport([MarshalAs(UnmanagedType.LPWStr)] string path);
+        public static bool TimelineExport(string path)
+        {
+            return _BlePluginTimelineExport(path);
+        }
 
         [DllImport(pluginName)]
         private static extern IntPtr _BlePluginGetOrCreateUuidObject(uint d1, uint d2, uint d3, uint d4);
@@ -126,6 +611,85 @@ namespace toio.Windows
             return data;
         }
 
+        public const int UuidStringLength = 36;
+
+        [DllImport(pluginName)]
+        private static extern IntPtr _BlePluginParseUuidString(byte[] str, int length);
+        public static UuidHandler ParseUuidString(string str)
+        {
+            var bytes = new byte[str.Length];
+            for (int i = 0; i < bytes.Length; ++i)
+            {
+                bytes[i] = (byte)str[i];
+            }
+            return new UuidHandler(_BlePluginParseUuidString(bytes, bytes.Length));
+        }
+
+        [DllImport(pluginName)]
+        private static extern void _BlePluginFormatUuidString(IntPtr uuid, IntPtr outStr);
+        public static unsafe string FormatUuidString(UuidHandler handle)
+        {
+            sbyte* buffer = stackalloc sbyte[UuidStringLength];
+            _BlePluginFormatUuidString(handle.ptr, new IntPtr(buffer));
+            return new string(buffer, 0, UuidStringLength);
+        }
+
+        [DllImport(pluginName)]
+        private static extern int _BlePluginParseUuidStrings(byte[] buffer, int[] lengths, int num, IntPtr[] outHandles);
+        // failed entries get a zero handle. returns the number parsed successfully
+        public static int ParseUuidStrings(string[] strs, UuidHandler[] outHandles)
+        {
+            int totalLength = 0;
+            var lengths = new int[strs.Length];
+            for (int i = 0; i < strs.Length; ++i)
+            {
+                lengths[i] = strs[i].Length;
+                totalLength += lengths[i];
+            }
+            var buffer = new byte[totalLength];
+            int offset = 0;
+            foreach (var str in strs)
+            {
+                for (int i = 0; i < str.Length; ++i)
+                {
+                    buffer[offset++] = (byte)str[i];
+                }
+            }
+            var ptrs = new IntPtr[strs.Length];
+            int parsedNum = _BlePluginParseUuidStrings(buffer, lengths, strs.Length, ptrs);
+            for (int i = 0; i < ptrs.Length; ++i)
+            {
+                outHandles[i] = new UuidHandler(ptrs[i]);
+            }
+            return parsedNum;
+        }
+
+        [DllImport(pluginName)]
+        private static extern void _BlePluginFormatUuidStrings(IntPtr[] uuids, int num, byte[] outStr);
+        public static void FormatUuidStrings(UuidHandler[] handles, string[] outStrs)
+        {
+            var ptrs = new IntPtr[handles.Length];
+            for (int i = 0; i < handles.Length; ++i)
+            {
+                ptrs[i] = handles[i].ptr;
+            }
+            var buffer = new byte[handles.Length * UuidStringLength];
+            _BlePluginFormatUuidStrings(ptrs, handles.Length, buffer);
+            for (int i = 0; i < handles.Length; ++i)
+            {
+                outStrs[i] = System.Text.Encoding.ASCII.GetString(buffer, i * UuidStringLength, UuidStringLength);
+            }
+        }
+
+        [DllImport(pluginName)]
+        [return: MarshalAs(UnmanagedType.U1)]
+        private static extern bool _BlePluginGetShortUuid(IntPtr uuid, out uint shortUuid);
+        // 16/32bit form of a Bluetooth Base UUID
+        public static bool GetShortUuid(UuidHandler handle, out uint shortUuid)
+        {
+            return _BlePluginGetShortUuid(handle.ptr, out shortUuid);
+        }
+
         [DllImport(pluginName)]
         private static extern void _BlePluginUpdateWatcher();
         [DllImport(pluginName)]
@@ -201,6 +765,18 @@ namespace toio.Windows
             _BlePluginConnectDevice(addr);
         }
 
+        [DllImport(pluginName)]
+        private static extern IntPtr _BlePluginConnectDeviceWithServices(ulong addr, IntPtr[] serviceUuids, int serviceNum);
+        public static void ConnectDevice(ulong addr, UuidHandler[] serviceUuids)
+        {
+            var ptrs = new IntPtr[serviceUuids.Length];
+            for (int i = 0; i < serviceUuids.Length; ++i)
+            {
+                ptrs[i] = serviceUuids[i].ptr;
+            }
+            _BlePluginConnectDeviceWithServices(addr, ptrs, ptrs.Length);
+        }
+
         [DllImport(pluginName)]
         private static extern void _BlePluginDisconnectDevice(ulong addr);
         public static void DisconnectDevice(ulong addr)
@@ -214,6 +790,22 @@ namespace toio.Windows
             _BlePluginDisconnectAllDevice();
         }
 
+        [DllImport(pluginName)]
+        private static extern void _BlePluginSetDeviceIdleEviction(float timeoutSec, int poolSize);
+        public static void SetDeviceIdleEviction(float timeoutSec, int poolSize)
+        {
+            _BlePluginSetDeviceIdleEviction(timeoutSec, poolSize);
+        }
+
+        [DllImport(pluginName)]
+        private static extern void _BlePluginGetDeviceResidentStats(out DeviceResidentStats stats);
+        public static DeviceResidentStats GetDeviceResidentStats()
+        {
+            DeviceResidentStats stats;
+            _BlePluginGetDeviceResidentStats(out stats);
+            return stats;
+        }
+
         [DllImport(pluginName)]
         private static extern bool _BlePluginIsDeviceConnectedByAddr(ulong addr);
         public static bool IsDeviceConnected(ulong addr)
@@ -383,6 +975,193 @@ namespace toio.Windows
             _BlePluginReleaseWriteRequest(deviceAddr, handle.ptr);
         }
 
+        // Batch Write
+        [DllImport(pluginName)]
+        private static extern IntPtr _BlePluginWriteCharacteristicBatch(IntPtr records, int recordNum, IntPtr payload, int payloadSize, bool needCompletion);
+        // records point into payload by dataOffset/dataSize. Returns an empty handle unless needCompletion.
+        public static unsafe WriteBatchHandler WriteCharastristicBatch(WriteBatchRecord[] records, int recordNum, byte[] payload, bool needCompletion)
+        {
+            if (records == null || recordNum > records.Length)
+            {
+                return new WriteBatchHandler(IntPtr.Zero);
+            }
+            int payloadSize = (payload != null) ? payload.Length : 0;
+            IntPtr resultPtr;
+            fixed (WriteBatchRecord* recordPtr = records)
+            fixed (byte* payloadPtr = payload)
+            {
+                resultPtr = _BlePluginWriteCharacteristicBatch(new IntPtr(recordPtr), recordNum,
+                    new IntPtr(payloadPtr), payloadSize, needCompletion);
+            }
+            return new WriteBatchHandler(resultPtr);
+        }
+
+        [DllImport(pluginName)]
+        private static extern bool _BlePluginIsWriteBatchComplete(IntPtr ptr);
+        public static bool IsWriteBatchComplete(WriteBatchHandler handle)
+        {
+            return _BlePluginIsWriteBatchComplete(handle.ptr);
+        }
+
+        [DllImport(pluginName)]
+        private static extern bool _BlePluginIsWriteBatchError(IntPtr ptr);
+        public static bool IsWriteBatchError(WriteBatchHandler handle)
+        {
+            return _BlePluginIsWriteBatchError(handle.ptr);
+        }
+
+        [DllImport(pluginName)]
+        private static extern void _BlePluginReleaseWriteBatch(IntPtr ptr);
+        public static void ReleaseWriteBatch(WriteBatchHandler handle)
+        {
+            _BlePluginReleaseWriteBatch(handle.ptr);
+        }
+
+        // Scheduled Read/Write
+        [DllImport(pluginName)]
+        private static extern void _BlePluginSetOperationSchedulerConfig(ulong addr, int maxInFlight, float connectionIntervalMs, int operationsPerInterval);
+        public static void SetOperationSchedulerConfig(ulong addr, int maxInFlight, float connectionIntervalMs, int operationsPerInterval)
+        {
+            _BlePluginSetOperationSchedulerConfig(addr, maxInFlight, connectionIntervalMs, operationsPerInterval);
+        }
+
+        [DllImport(pluginName)]
+        private static extern void _BlePluginSetWriteCoalescing(ulong addr, IntPtr serviceUuid, IntPtr charaUuid, bool enable);
+        // pending scheduled writes to this characteristic are replaced by newer ones
+        public static void SetWriteCoalescing(ulong addr, UuidHandler serviceUuid, UuidHandler charaUuid, bool enable)
+        {
+            _BlePluginSetWriteCoalescing(addr, serviceUuid.ptr, charaUuid.ptr, enable);
+        }
+
+        [DllImport(pluginName)]
+        private static extern void _BlePluginSetReadCache(ulong addr, IntPtr serviceUuid, IntPtr charaUuid, float ttlMs);
+        // scheduled reads within ttlMs of the last value are answered from the cache (0 disables)
+        public static void SetReadCache(ulong addr, UuidHandler serviceUuid, UuidHandler charaUuid, float ttlMs)
+        {
+            _BlePluginSetReadCache(addr, serviceUuid.ptr, charaUuid.ptr, ttlMs);
+        }
+
+        [DllImport(pluginName)]
+        private static extern IntPtr _BlePluginScheduleWriteRequest(ulong addr, IntPtr serviceUuid, IntPtr charaUuid, IntPtr data, int size, bool withResponse, int priority);
+        public static unsafe OperationHandler ScheduleWriteRequest(ulong addr, UuidHandler serviceUuid, UuidHandler charaUuid,
+            byte[] data, int idx, int size, bool withResponse, EOperationPriority priority)
+        {
+            IntPtr resultPtr;
+            fixed (void* ptr = &data[idx])
+            {
+                resultPtr = _BlePluginScheduleWriteRequest(addr, serviceUuid.ptr, charaUuid.ptr, new IntPtr(ptr), size, withResponse, (int)priority);
+            }
+            return new OperationHandler(resultPtr);
+        }
+
+        [DllImport(pluginName)]
+        private static extern IntPtr _BlePluginScheduleReadRequest(ulong addr, IntPtr serviceUuid, IntPtr charaUuid, int priority);
+        public static OperationHandler ScheduleReadRequest(ulong addr, UuidHandler serviceUuid, UuidHandler charaUuid, EOperationPriority priority)
+        {
+            var ptr = _BlePluginScheduleReadRequest(addr, serviceUuid.ptr, charaUuid.ptr, (int)priority);
+            return new OperationHandler(ptr);
+        }
+
+        [DllImport(pluginName)]
+        private static extern int _BlePluginGetOperationStatus(IntPtr ptr);
+        public static EOperationStatus GetOperationStatus(OperationHandler handle)
+        {
+            return (EOperationStatus)_BlePluginGetOperationStatus(handle.ptr);
+        }
+
+        [DllImport(pluginName)]
+        private static extern int _BlePluginCopyOperationData(IntPtr ptr, IntPtr data, int maxSize);
+        public static unsafe byte[] GetOperationData(OperationHandler handle)
+        {
+            var buffer = new CharastricsBuffer();
+            void* ptr = &buffer.fixedBuffer[0];
+            int size = _BlePluginCopyOperationData(handle.ptr, new IntPtr(ptr), CharastricsBuffer.BufferSize);
+            if (size > CharastricsBuffer.BufferSize)
+            {
+                size = CharastricsBuffer.BufferSize;
+            }
+            var retData = new byte[size];
+            for (int i = 0; i < size; ++i)
+            {
+                retData[i] = buffer.fixedBuffer[i];
+            }
+            return retData;
+        }
+
+        [DllImport(pluginName)]
+        private static extern void _BlePluginReleaseOperation(ulong deviceaddr, IntPtr ptr);
+        public static void ReleaseOperation(ulong deviceAddr, OperationHandler handle)
+        {
+            _BlePluginReleaseOperation(deviceAddr, handle.ptr);
+        }
+
+        [DllImport(pluginName)]
+        private static extern IntPtr _BlePluginStartBulkWrite(ulong addr, IntPtr serviceUuid, IntPtr charaUuid,
+            byte[] data, int size, int chunkSize, int window, int checkpointInterval);
+        public static BulkTransferHandler StartBulkWrite(ulong addr, UuidHandler serviceUuid, UuidHandler charaUuid,
+            byte[] data, int chunkSize, int window, int checkpointInterval)
+        {
+            var ptr = _BlePluginStartBulkWrite(addr, serviceUuid.ptr, charaUuid.ptr, data, data.Length,
+                chunkSize, window, checkpointInterval);
+            return new BulkTransferHandler(ptr);
+        }
+
+        [DllImport(pluginName)]
+        private static extern IntPtr _BlePluginStartBulkReceive(ulong addr, IntPtr serviceUuid, IntPtr charaUuid,
+            int expectedSize, int headerSize);
+        public static BulkTransferHandler StartBulkReceive(ulong addr, UuidHandler serviceUuid, UuidHandler charaUuid,
+            int expectedSize, int headerSize)
+        {
+            var ptr = _BlePluginStartBulkReceive(addr, serviceUuid.ptr, charaUuid.ptr, expectedSize, headerSize);
+            return new BulkTransferHandler(ptr);
+        }
+
+        [DllImport(pluginName)]
+        private static extern bool _BlePluginGetBulkTransferProgress(ulong addr, IntPtr transfer, out BulkTransferProgress progress);
+        public static bool GetBulkTransferProgress(ulong addr, BulkTransferHandler handle, out BulkTransferProgress progress)
+        {
+            return _BlePluginGetBulkTransferProgress(addr, handle.ptr, out progress);
+        }
+
+        [DllImport(pluginName)]
+        private static extern int _BlePluginCopyBulkReceiveData(ulong addr, IntPtr transfer, [Out] byte[] data, int maxSize);
+        public static byte[] GetBulkReceiveData(ulong addr, BulkTransferHandler handle)
+        {
+            BulkTransferProgress progress;
+            if (!_BlePluginGetBulkTransferProgress(addr, handle.ptr, out progress))
+            {
+                return new byte[0];
+            }
+            var data = new byte[progress.doneBytes];
+            int size = _BlePluginCopyBulkReceiveData(addr, handle.ptr, data, data.Length);
+            if (size < data.Length)
+            {
+                Array.Resize(ref data, size);
+            }
+            return data;
+        }
+
+        [DllImport(pluginName)]
+        private static extern void _BlePluginCancelBulkTransfer(ulong addr, IntPtr transfer);
+        public static void CancelBulkTransfer(ulong addr, BulkTransferHandler handle)
+        {
+            _BlePluginCancelBulkTransfer(addr, handle.ptr);
+        }
+
+        [DllImport(pluginName)]
+        private static extern void _BlePluginReleaseBulkTransfer(ulong addr, IntPtr transfer);
+        public static void ReleaseBulkTransfer(ulong addr, BulkTransferHandler handle)
+        {
+            _BlePluginReleaseBulkTransfer(addr, handle.ptr);
+        }
+
+        [DllImport(pluginName)]
+        private static extern bool _BlePluginGetOperationSchedulerStats(ulong addr, out OperationSchedulerStats stats);
+        public static bool GetOperationSchedulerStats(ulong addr, out OperationSchedulerStats stats)
+        {
+            return _BlePluginGetOperationSchedulerStats(addr, out stats);
+        }
+
         // Notificate
         [DllImport(pluginName)]
         private static extern void _BlePluginSetNotificateRequest(ulong addr, IntPtr serviceUuid, IntPtr charaUuid, bool enable);
@@ -434,6 +1213,113 @@ namespace toio.Windows
             return new UuidHandler(ptr);
         }
 
+        [DllImport(pluginName)]
+        private static extern bool _BlePluginSetNotificationSubscriberId(ulong addr, IntPtr serviceUuid, IntPtr charaUuid, int subscriberId);
+        public static bool SetNotificationSubscriberId(ulong addr, UuidHandler serviceUuid, UuidHandler charaUuid, int subscriberId)
+        {
+            return _BlePluginSetNotificationSubscriberId(addr, serviceUuid.ptr, charaUuid.ptr, subscriberId);
+        }
+
+        [DllImport(pluginName)]
+        private static extern int _BlePluginGetDeviceNotificateSubscriberId(ulong addr, int idx);
+        public static int GetDeviceNotificateSubscriberId(ulong addr, int idx)
+        {
+            return _BlePluginGetDeviceNotificateSubscriberId(addr, idx);
+        }
+
+        [DllImport(pluginName)]
+        private static extern IntPtr _BlePluginEnableNotificationRing(int capacity);
+        public static IntPtr EnableNotificationRing(int capacity)
+        {
+            return _BlePluginEnableNotificationRing(capacity);
+        }
+
+        [DllImport(pluginName)]
+        private static extern void _BlePluginDisableNotificationRing();
+        public static void DisableNotificationRing()
+        {
+            _BlePluginDisableNotificationRing();
+        }
+
+        [DllImport(pluginName)]
+        private static extern bool _BlePluginEnableSampleHistory(ulong addr, IntPtr serviceUuid, IntPtr charaUuid,
+            int capacity, SampleField[] fields, int fieldNum, int matchOffset, int matchValue);
+        public static bool EnableSampleHistory(ulong addr, UuidHandler serviceUuid, UuidHandler charaUuid,
+            int capacity, SampleField[] fields, int matchOffset, int matchValue)
+        {
+            return _BlePluginEnableSampleHistory(addr, serviceUuid.ptr, charaUuid.ptr, capacity,
+                fields, (fields != null) ? fields.Length : 0, matchOffset, matchValue);
+        }
+
+        [DllImport(pluginName)]
+        private static extern void _BlePluginDisableSampleHistory(ulong addr, IntPtr serviceUuid, IntPtr charaUuid);
+        public static void DisableSampleHistory(ulong addr, UuidHandler serviceUuid, UuidHandler charaUuid)
+        {
+            _BlePluginDisableSampleHistory(addr, serviceUuid.ptr, charaUuid.ptr);
+        }
+
+        [DllImport(pluginName)]
+        private static extern double _BlePluginGetHostTime();
+        public static double GetHostTime()
+        {
+            return _BlePluginGetHostTime();
+        }
+
+        [DllImport(pluginName)]
+        private static extern int _BlePluginCopySampleHistory(ulong addr, IntPtr serviceUuid, IntPtr charaUuid, [Out] HistorySample[] samples, int maxNum);
+        public static int CopySampleHistory(ulong addr, UuidHandler serviceUuid, UuidHandler charaUuid, HistorySample[] samples)
+        {
+            return _BlePluginCopySampleHistory(addr, serviceUuid.ptr, charaUuid.ptr, samples, samples.Length);
+        }
+
+        [DllImport(pluginName)]
+        private static extern int _BlePluginSampleHistoryAt(ulong addr, IntPtr serviceUuid, IntPtr charaUuid,
+            double time, float maxExtrapolationSec, [Out] float[] values, int maxValues);
+        public static ESampleResult SampleHistoryAt(ulong addr, UuidHandler serviceUuid, UuidHandler charaUuid,
+            double time, float maxExtrapolationSec, float[] values)
+        {
+            return (ESampleResult)_BlePluginSampleHistoryAt(addr, serviceUuid.ptr, charaUuid.ptr,
+                time, maxExtrapolationSec, values, values.Length);
+        }
+
+        [DllImport(pluginName)]
+        private static extern int _BlePluginRegisterPayloadSchema(IntPtr serviceUuid, IntPtr charaUuid,
+            PayloadField[] fields, int fieldNum, int matchOffset, int matchValue);
+        public static int RegisterPayloadSchema(UuidHandler serviceUuid, UuidHandler charaUuid,
+            PayloadField[] fields, int matchOffset, int matchValue)
+        {
+            return _BlePluginRegisterPayloadSchema(serviceUuid.ptr, charaUuid.ptr,
+                fields, (fields != null) ? fields.Length : 0, matchOffset, matchValue);
+        }
+
+        [DllImport(pluginName)]
+        private static extern void _BlePluginUnregisterPayloadSchema(int schemaId);
+        public static void UnregisterPayloadSchema(int schemaId)
+        {
+            _BlePluginUnregisterPayloadSchema(schemaId);
+        }
+
+        [DllImport(pluginName)]
+        private static extern int _BlePluginGetDecodedRowNum(int schemaId);
+        public static int GetDecodedRowNum(int schemaId)
+        {
+            return _BlePluginGetDecodedRowNum(schemaId);
+        }
+
+        [DllImport(pluginName)]
+        private static extern IntPtr _BlePluginGetDecodedColumn(int schemaId, int fieldIdx);
+        public static IntPtr GetDecodedColumn(int schemaId, int fieldIdx)
+        {
+            return _BlePluginGetDecodedColumn(schemaId, fieldIdx);
+        }
+
+        [DllImport(pluginName)]
+        private static extern IntPtr _BlePluginGetDecodedAddrs(int schemaId);
+        public static IntPtr GetDecodedAddrs(int schemaId)
+        {
+            return _BlePluginGetDecodedAddrs(schemaId);
+        }
+
 
     }
 }
@@ -25,13 +25,58 @@ namespace toio.Windows
             {
                 return handle;
             }
-            ParseUuid(str, out d1, out d2, out d3, out d4);
-            handle = DllInterface.GetOrCreateUuidObject(d1, d2, d3, d4);
+            handle = DllInterface.ParseUuidString(str);
+            if (handle.ptr == System.IntPtr.Zero)
+            {
+                // not the canonical form; pick up whatever hex digits it has
+                ParseUuid(str, out d1, out d2, out d3, out d4);
+                handle = DllInterface.GetOrCreateUuidObject(d1, d2, d3, d4);
+            }
             uuidDictByStr.Add(str, handle);
-            uuidDictByHandle.Add(handle,str);
+            if (!uuidDictByHandle.ContainsKey(handle))
+            {
+                uuidDictByHandle.Add(handle, str);
+            }
             return handle;
         }
 
+        // resolves every string not seen yet with a single native call
+        public static void GetUuids(string[] strs, UuidHandler[] handles)
+        {
+            List<string> missing = null;
+            foreach (var s in strs)
+            {
+                var str = s.ToUpper();
+                if (!uuidDictByStr.ContainsKey(str))
+                {
+                    if (missing == null) { missing = new List<string>(); }
+                    missing.Add(str);
+                }
+            }
+            if (missing != null)
+            {
+                var missingStrs = missing.ToArray();
+                var missingHandles = new UuidHandler[missingStrs.Length];
+                DllInterface.ParseUuidStrings(missingStrs, missingHandles);
+                for (int i = 0; i < missingStrs.Length; ++i)
+                {
+                    if (missingHandles[i].ptr == System.IntPtr.Zero || uuidDictByStr.ContainsKey(missingStrs[i]))
+                    {
+                        continue;
+                    }
+                    uuidDictByStr.Add(missingStrs[i], missingHandles[i]);
+                    if (!uuidDictByHandle.ContainsKey(missingHandles[i]))
+                    {
+                        uuidDictByHandle.Add(missingHandles[i], missingStrs[i]);
+                    }
+                }
+            }
+            for (int i = 0; i < strs.Length; ++i)
+            {
+                handles[i] = GetUuid(strs[i]);
+            }
+        }
+
         public static string GetUuidStr(UuidHandler handle)
         {
             string str;
@@ -39,9 +84,11 @@ namespace toio.Windows
             {
                 return str;
             }
-            var data = DllInterface.ConvertUuidData(handle);
-            str = data.ToString();
-            uuidDictByStr.Add(str, handle);
+            str = DllInterface.FormatUuidString(handle);
+            if (!uuidDictByStr.ContainsKey(str))
+            {
+                uuidDictByStr.Add(str, handle);
+            }
             uuidDictByHandle.Add(handle, str);
             return str;
 
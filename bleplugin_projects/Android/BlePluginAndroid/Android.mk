@@ -0,0 +1,7 @@
+LOCAL_PATH := $(call my-dir)
+
+include $(CLEAR_VARS)
+LOCAL_MODULE := blepluginandroid
+LOCAL_SRC_FILES := BlePackedBuffer.cpp BleJniBridge.cpp UnityInterface.cpp
+LOCAL_CPPFLAGS := -std=c++14 -fvisibility=hidden
+include $(BUILD_SHARED_LIBRARY)
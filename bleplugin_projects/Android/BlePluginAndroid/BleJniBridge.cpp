@@ -0,0 +1,161 @@
+#include "BleJniBridge.h"
+#include "BlePackedBuffer.h"
+
+namespace BlePlugin {
+	BleJniBridge BleJniBridge::s_instance;
+
+	BleJniBridge::BleJniBridge() :
+		m_javaVm(nullptr),
+		m_managerCls(nullptr),
+		m_scannerCls(nullptr),
+		m_getScannerMethod(nullptr),
+		m_packScanResultMethod(nullptr),
+		m_packDeviceDataMethod(nullptr),
+		m_commitDeviceDataMethod(nullptr),
+		m_scanByteBuffer(nullptr),
+		m_deviceDataByteBuffer(nullptr)
+	{
+	}
+
+	bool BleJniBridge::Initialize(JavaVM* vm) {
+		m_javaVm = vm;
+		JNIEnv* env = this->GetEnv();
+		if (env == nullptr) {
+			return false;
+		}
+		m_managerCls = this->GetGlobalRefClass(env, "com/toio/ble/BleManagerObj");
+		m_scannerCls = this->GetGlobalRefClass(env, "com/toio/ble/BleScannerObj");
+		if (m_managerCls == nullptr || m_scannerCls == nullptr) {
+			this->Finalize();
+			return false;
+		}
+		m_getScannerMethod = env->GetMethodID(m_managerCls, "getScanner", "()Lcom/toio/ble/BleScannerObj;");
+		m_packDeviceDataMethod = env->GetMethodID(m_managerCls, "packDeviceData", "(Ljava/nio/ByteBuffer;)I");
+		m_commitDeviceDataMethod = env->GetMethodID(m_managerCls, "commitDeviceData", "()V");
+		m_packScanResultMethod = env->GetMethodID(m_scannerCls, "packScanResult", "(Ljava/nio/ByteBuffer;)I");
+		if (env->ExceptionCheck()) {
+			env->ExceptionClear();
+			this->Finalize();
+			return false;
+		}
+		m_scanByteBuffer = this->CreateByteBuffer(env, m_scanBuffer);
+		m_deviceDataByteBuffer = this->CreateByteBuffer(env, m_deviceDataBuffer);
+		if (m_scanByteBuffer == nullptr || m_deviceDataByteBuffer == nullptr) {
+			this->Finalize();
+			return false;
+		}
+		return true;
+	}
+
+	void BleJniBridge::Finalize() {
+		JNIEnv* env = this->GetEnv();
+		if (env != nullptr) {
+			if (m_managerCls) { env->DeleteGlobalRef(m_managerCls); }
+			if (m_scannerCls) { env->DeleteGlobalRef(m_scannerCls); }
+			if (m_scanByteBuffer) { env->DeleteGlobalRef(m_scanByteBuffer); }
+			if (m_deviceDataByteBuffer) { env->DeleteGlobalRef(m_deviceDataByteBuffer); }
+		}
+		m_managerCls = nullptr;
+		m_scannerCls = nullptr;
+		m_scanByteBuffer = nullptr;
+		m_deviceDataByteBuffer = nullptr;
+		m_getScannerMethod = nullptr;
+		m_packScanResultMethod = nullptr;
+		m_packDeviceDataMethod = nullptr;
+		m_commitDeviceDataMethod = nullptr;
+	}
+
+	bool BleJniBridge::IsAvailable()const {
+		return (m_packScanResultMethod != nullptr && m_packDeviceDataMethod != nullptr && m_commitDeviceDataMethod != nullptr &&
+			m_scanByteBuffer != nullptr && m_deviceDataByteBuffer != nullptr);
+	}
+
+	int BleJniBridge::UpdateScanResult(jobject manager) {
+		JNIEnv* env = this->GetEnv();
+		if (env == nullptr || !this->IsAvailable() || manager == nullptr) {
+			return -1;
+		}
+		jobject scanner = env->CallObjectMethod(manager, m_getScannerMethod);
+		if (env->ExceptionCheck()) {
+			env->ExceptionClear();
+			return -1;
+		}
+		if (scanner == nullptr) {
+			return -1;
+		}
+		int size = this->CallPack(env, scanner, m_packScanResultMethod, m_scanByteBuffer);
+		env->DeleteLocalRef(scanner);
+		if (size < 0 || ValidateScanBuffer(m_scanBuffer.data(), size) < 0) {
+			return -1;
+		}
+		return size;
+	}
+
+	int BleJniBridge::UpdateDeviceData(jobject manager) {
+		JNIEnv* env = this->GetEnv();
+		if (env == nullptr || !this->IsAvailable() || manager == nullptr) {
+			return -1;
+		}
+		int size = this->CallPack(env, manager, m_packDeviceDataMethod, m_deviceDataByteBuffer);
+		if (size < 0 || ValidateDeviceDataBuffer(m_deviceDataBuffer.data(), size) < 0) {
+			return -1;
+		}
+		// only now may the Java side forget the records; a failed commit just repeats them next call
+		env->CallVoidMethod(manager, m_commitDeviceDataMethod);
+		if (env->ExceptionCheck()) {
+			env->ExceptionClear();
+		}
+		return size;
+	}
+
+	JNIEnv* BleJniBridge::GetEnv() {
+		if (m_javaVm == nullptr) {
+			return nullptr;
+		}
+		JNIEnv* env = nullptr;
+		jint result = m_javaVm->GetEnv(reinterpret_cast<void**>(&env), JNI_VERSION_1_6);
+		if (result == JNI_EDETACHED) {
+			if (m_javaVm->AttachCurrentThread(&env, nullptr) != JNI_OK) {
+				return nullptr;
+			}
+		} else if (result != JNI_OK) {
+			return nullptr;
+		}
+		return env;
+	}
+
+	jclass BleJniBridge::GetGlobalRefClass(JNIEnv* env, const char* name) {
+		jclass cls = env->FindClass(name);
+		if (cls == nullptr) {
+			env->ExceptionClear();
+			return nullptr;
+		}
+		jclass globalCls = static_cast<jclass>(env->NewGlobalRef(cls));
+		env->DeleteLocalRef(cls);
+		return globalCls;
+	}
+
+	jobject BleJniBridge::CreateByteBuffer(JNIEnv* env, std::vector<uint8_t>& buffer) {
+		buffer.resize(BufferSize);
+		jobject byteBuffer = env->NewDirectByteBuffer(buffer.data(), static_cast<jlong>(buffer.size()));
+		if (byteBuffer == nullptr) {
+			env->ExceptionClear();
+			return nullptr;
+		}
+		jobject globalBuffer = env->NewGlobalRef(byteBuffer);
+		env->DeleteLocalRef(byteBuffer);
+		return globalBuffer;
+	}
+
+	int BleJniBridge::CallPack(JNIEnv* env, jobject target, jmethodID method, jobject byteBuffer) {
+		jint size = env->CallIntMethod(target, method, byteBuffer);
+		if (env->ExceptionCheck()) {
+			env->ExceptionClear();
+			return -1;
+		}
+		if (size < 0 || static_cast<size_t>(size) > BufferSize) {
+			return -1;
+		}
+		return size;
+	}
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <jni.h>
+#include <cstdint>
+#include <vector>
+
+namespace BlePlugin {
+	// Caches the Java classes/method ids once at JNI_OnLoad and owns the
+	// direct ByteBuffers the Java side packs scan results and read data into.
+	class BleJniBridge {
+	private:
+		static BleJniBridge s_instance;
+
+		JavaVM* m_javaVm;
+		jclass m_managerCls;
+		jclass m_scannerCls;
+		jmethodID m_getScannerMethod;
+		jmethodID m_packScanResultMethod;
+		jmethodID m_packDeviceDataMethod;
+		jmethodID m_commitDeviceDataMethod;
+
+		std::vector<uint8_t> m_scanBuffer;
+		std::vector<uint8_t> m_deviceDataBuffer;
+		jobject m_scanByteBuffer;
+		jobject m_deviceDataByteBuffer;
+	public:
+		static const size_t BufferSize = 64 * 1024;
+
+		inline static BleJniBridge& GetInstance() {
+			return s_instance;
+		}
+
+		BleJniBridge();
+
+		bool Initialize(JavaVM* vm);
+		void Finalize();
+		bool IsAvailable()const;
+
+		// returns the packed byte size, or -1 if the Java side failed
+		int UpdateScanResult(jobject manager);
+		int UpdateDeviceData(jobject manager);
+
+		inline const uint8_t* GetScanBuffer()const {
+			return m_scanBuffer.data();
+		}
+		inline const uint8_t* GetDeviceDataBuffer()const {
+			return m_deviceDataBuffer.data();
+		}
+	private:
+		JNIEnv* GetEnv();
+		jclass GetGlobalRefClass(JNIEnv* env, const char* name);
+		jobject CreateByteBuffer(JNIEnv* env, std::vector<uint8_t>& buffer);
+		int CallPack(JNIEnv* env, jobject target, jmethodID method, jobject byteBuffer);
+	};
+}
@@ -0,0 +1,130 @@
+#include "BlePackedBuffer.h"
+
+namespace BlePlugin {
+	namespace {
+		inline uint16_t ReadUint16(const uint8_t* src) {
+			return static_cast<uint16_t>(src[0] | (src[1] << 8));
+		}
+		inline int32_t ReadInt32(const uint8_t* src) {
+			uint32_t val = static_cast<uint32_t>(src[0]) |
+				(static_cast<uint32_t>(src[1]) << 8) |
+				(static_cast<uint32_t>(src[2]) << 16) |
+				(static_cast<uint32_t>(src[3]) << 24);
+			return static_cast<int32_t>(val);
+		}
+	}
+
+	PackedBufferReader::PackedBufferReader(const uint8_t* buffer, size_t size) :
+		m_buffer(buffer),
+		m_size(size),
+		m_offset(0),
+		m_recordNum(0),
+		m_readNum(0)
+	{
+		this->Reset();
+	}
+
+	void PackedBufferReader::Reset() {
+		m_offset = 0;
+		m_readNum = 0;
+		m_recordNum = 0;
+		if (m_buffer == nullptr || m_size < PackedBufferHeaderSize) {
+			return;
+		}
+		int32_t num = ReadInt32(m_buffer);
+		m_recordNum = (num < 0) ? 0 : num;
+		m_offset = PackedBufferHeaderSize;
+	}
+
+	const uint8_t* PackedBufferReader::Take(size_t size) {
+		if (m_size - m_offset < size) {
+			return nullptr;
+		}
+		const uint8_t* ptr = m_buffer + m_offset;
+		m_offset += size;
+		return ptr;
+	}
+
+	bool PackedBufferReader::Next(ScanRecord& record) {
+		if (m_readNum >= m_recordNum) {
+			return false;
+		}
+		size_t start = m_offset;
+		const uint8_t* head = this->Take(PackedScanRecordSize);
+		if (head == nullptr) {
+			return false;
+		}
+		uint16_t nameLength = ReadUint16(head + 8);
+		const uint8_t* name = this->Take(nameLength);
+		if (name == nullptr) {
+			m_offset = start;
+			return false;
+		}
+		record.addr = ReadAddress(head);
+		record.rssi = static_cast<int16_t>(ReadUint16(head + 6));
+		record.nameLength = nameLength;
+		record.name = reinterpret_cast<const char*>(name);
+		++m_readNum;
+		return true;
+	}
+
+	bool PackedBufferReader::Next(DeviceDataRecord& record) {
+		if (m_readNum >= m_recordNum) {
+			return false;
+		}
+		size_t start = m_offset;
+		const uint8_t* head = this->Take(PackedDeviceDataRecordSize);
+		if (head == nullptr) {
+			return false;
+		}
+		uint16_t dataLength = ReadUint16(head + 40);
+		const uint8_t* data = this->Take(dataLength);
+		if (data == nullptr) {
+			m_offset = start;
+			return false;
+		}
+		record.addr = ReadAddress(head);
+		record.flags = head[6];
+		record.serviceUuid = head + 8;
+		record.charastricsUuid = head + 24;
+		record.dataLength = dataLength;
+		record.data = data;
+		++m_readNum;
+		return true;
+	}
+
+	int ValidateScanBuffer(const uint8_t* buffer, size_t size) {
+		PackedBufferReader reader(buffer, size);
+		ScanRecord record;
+		while (reader.Next(record)) {}
+		if (reader.GetReadNum() != reader.GetRecordNum()) {
+			return -1;
+		}
+		return reader.GetRecordNum();
+	}
+
+	int ValidateDeviceDataBuffer(const uint8_t* buffer, size_t size) {
+		PackedBufferReader reader(buffer, size);
+		DeviceDataRecord record;
+		while (reader.Next(record)) {}
+		if (reader.GetReadNum() != reader.GetRecordNum()) {
+			return -1;
+		}
+		return reader.GetRecordNum();
+	}
+
+	uint64_t ReadAddress(const uint8_t* src) {
+		uint64_t addr = 0;
+		for (int i = 0; i < 6; ++i) {
+			addr = (addr << 8) | src[i];
+		}
+		return addr;
+	}
+
+	void WriteAddress(uint64_t addr, uint8_t* dst) {
+		for (int i = 5; i >= 0; --i) {
+			dst[i] = static_cast<uint8_t>(addr & 0xff);
+			addr >>= 8;
+		}
+	}
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// no JNI here, so the packing rules can be checked on any host.
+namespace BlePlugin {
+	// Layouts written by the Java side into the shared direct ByteBuffer (little endian).
+	//
+	// scan result (BleScannerObj.packScanResult)
+	//   int32 recordNum
+	//   recordNum x { uint8 addr[6], int16 rssi, uint16 nameLength, uint8 name[nameLength] (UTF-8) }
+	//
+	// device data (BleManagerObj.packDeviceData : read results and notifications)
+	//   int32 recordNum
+	//   recordNum x { uint8 addr[6], uint8 flags, uint8 reserved,
+	//                 uint8 serviceUuid[16], uint8 charastricsUuid[16],
+	//                 uint16 dataLength, uint8 data[dataLength] }
+	//
+	// addresses and UUIDs are stored in the order they are written as text.
+	static const size_t PackedBufferHeaderSize = 4;
+	static const size_t PackedScanRecordSize = 10;
+	static const size_t PackedDeviceDataRecordSize = 42;
+
+	enum EDeviceDataFlag : uint8_t {
+		DeviceDataNotify = 0x01,
+	};
+
+	struct ScanRecord {
+		uint64_t addr;
+		int16_t rssi;
+		uint16_t nameLength;
+		const char* name;
+	};
+
+	struct DeviceDataRecord {
+		uint64_t addr;
+		uint8_t flags;
+		const uint8_t* serviceUuid;
+		const uint8_t* charastricsUuid;
+		uint16_t dataLength;
+		const uint8_t* data;
+	};
+
+	class PackedBufferReader {
+	private:
+		const uint8_t* m_buffer;
+		size_t m_size;
+		size_t m_offset;
+		int m_recordNum;
+		int m_readNum;
+	public:
+		PackedBufferReader(const uint8_t* buffer, size_t size);
+
+		inline int GetRecordNum()const {
+			return m_recordNum;
+		}
+		inline int GetReadNum()const {
+			return m_readNum;
+		}
+		inline size_t GetOffset()const {
+			return m_offset;
+		}
+
+		bool Next(ScanRecord& record);
+		bool Next(DeviceDataRecord& record);
+		void Reset();
+	private:
+		const uint8_t* Take(size_t size);
+	};
+
+	// returns the record count, or -1 when a record runs past the end of the buffer
+	int ValidateScanBuffer(const uint8_t* buffer, size_t size);
+	int ValidateDeviceDataBuffer(const uint8_t* buffer, size_t size);
+
+	uint64_t ReadAddress(const uint8_t* src);
+	void WriteAddress(uint64_t addr, uint8_t* dst);
+}
@@ -0,0 +1,35 @@
+#include "BleJniBridge.h"
+#include "UnityInterface.h"
+using namespace BlePlugin;
+
+JNIEXPORT jint JNICALL JNI_OnLoad(JavaVM* vm, void* reserved) {
+	BleJniBridge::GetInstance().Initialize(vm);
+	return JNI_VERSION_1_6;
+}
+
+JNIEXPORT void JNICALL JNI_OnUnload(JavaVM* vm, void* reserved) {
+	BleJniBridge::GetInstance().Finalize();
+}
+
+
+bool _BlePluginAndroidIsAvailable() {
+	return BleJniBridge::GetInstance().IsAvailable();
+}
+
+int _BlePluginAndroidUpdateScanResult(jobject manager, const uint8_t** buffer) {
+	auto& bridge = BleJniBridge::GetInstance();
+	int size = bridge.UpdateScanResult(manager);
+	if (buffer) {
+		*buffer = (size < 0) ? nullptr : bridge.GetScanBuffer();
+	}
+	return size;
+}
+
+int _BlePluginAndroidUpdateDeviceData(jobject manager, const uint8_t** buffer) {
+	auto& bridge = BleJniBridge::GetInstance();
+	int size = bridge.UpdateDeviceData(manager);
+	if (buffer) {
+		*buffer = (size < 0) ? nullptr : bridge.GetDeviceDataBuffer();
+	}
+	return size;
+}
@@ -0,0 +1,14 @@
+#pragma once
+#include <jni.h>
+#include <cstdint>
+
+#define DllExport  __attribute__((visibility("default")))
+
+extern "C" {
+	DllExport bool _BlePluginAndroidIsAvailable();
+
+	// manager is the BleManagerObj global ref held by BleJavaWrapper.
+	// returns the packed byte size (layout: BlePackedBuffer.h), or -1 when the caller should fall back to JNI.
+	DllExport int _BlePluginAndroidUpdateScanResult(jobject manager, const uint8_t** buffer);
+	DllExport int _BlePluginAndroidUpdateDeviceData(jobject manager, const uint8_t** buffer);
+}
@@ -0,0 +1,166 @@
+#include "BleLinkEmulator.h"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+using namespace BlePlugin;
+
+namespace {
+	int s_failedNum = 0;
+
+	void Check(bool isOk, const char* what) {
+		if (!isOk) {
+			std::cout << "NG " << what << std::endl;
+			++s_failedNum;
+		}
+	}
+
+	const uint8_t s_serviceUuid[BleLinkEmulator::UuidSize] = {
+		0x00, 0x01, 0xB2, 0x10, 0x71, 0x45, 0x3B, 0x5B, 0x3E, 0xCF, 0x08, 0x95, 0xAE, 0xBB, 0xD7, 0xFC };
+	const uint8_t s_charaUuid[BleLinkEmulator::UuidSize] = {
+		0x02, 0x01, 0xB2, 0x10, 0x71, 0x45, 0x3B, 0x5B, 0x3E, 0xCF, 0x08, 0x95, 0xAE, 0xBB, 0xD7, 0xFC };
+
+	// stands in for the devices: counts what arrives and checks it is what was sent
+	class CountingSink : public BleLinkSink {
+	public:
+		uint64_t connectedNum = 0;
+		uint64_t disconnectedNum = 0;
+		uint64_t receivedNum = 0;
+		uint64_t brokenNum = 0;
+		std::vector<uint64_t> lastSeq;
+
+		void OnConnected(uint64_t addr) override {
+			++connectedNum;
+		}
+		void OnDisconnected(uint64_t addr) override {
+			++disconnectedNum;
+		}
+		bool OnNotification(uint64_t addr, const uint8_t* serviceUuid, const uint8_t* charastricsUuid,
+			const uint8_t* data, int size) override {
+			uint32_t seq = 0;
+			bool isOk = size >= 4 && addr < lastSeq.size() &&
+				memcmp(serviceUuid, s_serviceUuid, sizeof(s_serviceUuid)) == 0 &&
+				memcmp(charastricsUuid, s_charaUuid, sizeof(s_charaUuid)) == 0;
+			if (isOk) {
+				memcpy(&seq, data, sizeof(seq));
+				// per link in order; lastSeq holds seq + 1
+				isOk = seq + 1 > lastSeq[addr];
+			}
+			if (isOk) {
+				lastSeq[addr] = seq + 1;
+			}
+			else {
+				++brokenNum;
+			}
+			++receivedNum;
+			return true;
+		}
+	};
+
+	struct RunResult {
+		LinkStats stats;
+		double p50Ms;
+		double p99Ms;
+		double maxMs;
+	};
+
+	// deviceNum x hz notifications for virtualSec, then until every link has settled
+	RunResult Run(int deviceNum, int hz, double virtualSec, const LinkParams& params, uint32_t seed, CountingSink& sink) {
+		const double settleSec = 5.0;
+		const double stepMs = 0.25;
+		sink.lastSeq.assign(deviceNum, 0);
+		BleLinkEmulator emulator(seed, sink);
+		std::vector<double> nextSampleMs(deviceNum);
+		std::vector<uint32_t> seqs(deviceNum, 0);
+		for (int i = 0; i < deviceNum; ++i) {
+			nextSampleMs[i] = 1000.0 * i / (static_cast<double>(hz) * deviceNum);
+			emulator.AddLink(static_cast<uint64_t>(i), params);
+		}
+		uint8_t payload[20] = {};
+		RunResult result;
+		for (double nowMs = 0.0; nowMs < (virtualSec + settleSec) * 1000.0; nowMs += stepMs) {
+			bool isProducing = nowMs < virtualSec * 1000.0;
+			for (int i = 0; i < deviceNum && isProducing; ++i) {
+				while (nextSampleMs[i] <= nowMs) {
+					memcpy(payload, &seqs[i], sizeof(seqs[i]));
+					++seqs[i];
+					emulator.Notify(static_cast<uint64_t>(i), s_serviceUuid, s_charaUuid, payload, sizeof(payload));
+					nextSampleMs[i] += 1000.0 / hz;
+				}
+			}
+			emulator.AdvanceTo(nowMs);
+			emulator.GetStats(result.stats);
+			if (!isProducing && result.stats.deliveredNum + result.stats.droppedNum == result.stats.queuedNum) {
+				break;
+			}
+		}
+		result.p50Ms = emulator.GetLatencyPercentileMs(0.5);
+		result.p99Ms = emulator.GetLatencyPercentileMs(0.99);
+		result.maxMs = emulator.GetMaxLatencyMs();
+		emulator.RemoveAll();
+		return result;
+	}
+
+	// the benchmark target: deviceNum x hz over the default links with p99 to the device under targetP99Ms
+	void TestLatencyGate(int deviceNum, int hz, double targetP99Ms) {
+		const double virtualSec = 60.0;
+		CountingSink sink;
+		auto start = std::chrono::steady_clock::now();
+		RunResult result = Run(deviceNum, hz, virtualSec, LinkParams::Default(), 0x5eed, sink);
+		double wallSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		const LinkStats& stats = result.stats;
+		std::cout << "link " << deviceNum << " devices x " << hz << "Hz, " << virtualSec << "s virtual in " <<
+			wallSec << "s" << std::endl <<
+			"  queued " << stats.queuedNum << " delivered " << stats.deliveredNum << " dropped " << stats.droppedNum <<
+			" retransmit " << stats.retransmitNum << " disconnect " << stats.disconnectNum << std::endl <<
+			"  p50 " << result.p50Ms << "ms p99 " << result.p99Ms << "ms max " << result.maxMs << "ms (target p99 " <<
+			targetP99Ms << "ms)" << std::endl;
+		Check(stats.queuedNum == static_cast<uint64_t>(deviceNum) * hz * static_cast<uint64_t>(virtualSec), "all queued");
+		Check(stats.deliveredNum + stats.droppedNum == stats.queuedNum, "links settled");
+		Check(sink.receivedNum == stats.deliveredNum, "every delivery reached the sink");
+		Check(sink.brokenNum == 0, "notifications arrive whole and in order per link");
+		Check(stats.retransmitNum > 0, "losses are resent");
+		Check(result.p99Ms <= targetP99Ms, "p99 under the target");
+	}
+
+	// the same seed replays the same run
+	void TestDeterministic() {
+		CountingSink sinkA;
+		CountingSink sinkB;
+		RunResult a = Run(4, 50, 2.0, LinkParams::Default(), 1234, sinkA);
+		RunResult b = Run(4, 50, 2.0, LinkParams::Default(), 1234, sinkB);
+		Check(a.stats.deliveredNum == b.stats.deliveredNum && a.stats.retransmitNum == b.stats.retransmitNum &&
+			a.stats.eventNum == b.stats.eventNum && a.p99Ms == b.p99Ms && a.maxMs == b.maxMs, "same seed, same run");
+	}
+
+	// a fade longer than the supervision timeout disconnects the link, drops what it held and
+	// reconnects after the delay
+	void TestSupervisionTimeout() {
+		LinkParams params = LinkParams::Default();
+		params.fadeRate = 0.01f;
+		params.fadeMs = 3000.0;
+		params.supervisionTimeoutMs = 500.0;
+		params.reconnectDelayMs = 200.0;
+		CountingSink sink;
+		RunResult result = Run(2, 20, 30.0, params, 77, sink);
+		Check(result.stats.disconnectNum > 0, "fade disconnects");
+		Check(sink.disconnectedNum >= result.stats.disconnectNum, "sink told of every disconnect");
+		Check(sink.connectedNum > 2, "links reconnect");
+		Check(result.stats.droppedNum > 0, "a disconnect drops");
+		Check(result.stats.deliveredNum + result.stats.droppedNum == result.stats.queuedNum, "faded links settled");
+	}
+}
+
+int main(int argc, char** argv) {
+	// BleLinkEmulatorTest [devices] [hz] [p99Ms]
+	int deviceNum = (argc > 1) ? atoi(argv[1]) : 40;
+	int hz = (argc > 2) ? atoi(argv[2]) : 100;
+	double targetP99Ms = (argc > 3) ? atof(argv[3]) : 20.0;
+	TestDeterministic();
+	TestSupervisionTimeout();
+	TestLatencyGate((deviceNum > 1) ? deviceNum : 1, (hz > 1) ? hz : 1, targetP99Ms);
+	std::cout << "link emulator " << (s_failedNum == 0 ? "ok" : "NG") << std::endl;
+	return (s_failedNum == 0) ? 0 : 1;
+}
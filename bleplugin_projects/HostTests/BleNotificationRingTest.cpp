@@ -0,0 +1,157 @@
+#include "BleNotificationRing.h"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace BlePlugin;
+
+namespace {
+	int s_failedNum = 0;
+
+	void Check(bool isOk, const char* what) {
+		if (!isOk) {
+			std::cout << "NG " << what << std::endl;
+			++s_failedNum;
+		}
+	}
+
+	const uint8_t s_uuid[NotificationRecord::UuidSize] = {
+		0x02, 0x01, 0xB2, 0x10, 0x71, 0x45, 0x3B, 0x5B, 0x3E, 0xCF, 0x08, 0x95, 0xAE, 0xBB, 0xD7, 0xFC };
+
+	void FillData(uint32_t seq, uint8_t* data) {
+		memcpy(data, &seq, sizeof(seq));
+		for (int i = 4; i < NotificationRecord::MaxDataSize; ++i) {
+			data[i] = static_cast<uint8_t>(seq * 31 + i);
+		}
+	}
+
+	// producers push through Push while one reader follows the documented protocol on the raw
+	// region, as the managed side does. every record must arrive whole, in order per producer,
+	// and received + dropped must add up to pushed. run the TSan build for the ordering itself
+	void TestConcurrent(int producerNum, uint32_t pushNum) {
+		BleNotificationRing& ring = BleNotificationRing::GetInstance();
+		NotificationRingHeader* header = ring.Enable(256);
+		Check(header != nullptr, "enable");
+		if (header == nullptr) {
+			return;
+		}
+		std::atomic<int> runningNum(producerNum);
+		std::vector<std::thread> producers;
+		auto start = std::chrono::steady_clock::now();
+		for (int p = 0; p < producerNum; ++p) {
+			producers.emplace_back([&ring, &runningNum, p, pushNum]() {
+				uint8_t data[NotificationRecord::MaxDataSize];
+				for (uint32_t seq = 0; seq < pushNum; ++seq) {
+					FillData(seq, data);
+					ring.Push(static_cast<uint64_t>(p), 0.0, s_uuid, static_cast<int32_t>(seq), data, 4 + seq % 19);
+					// bursts, so the ring both wraps and overflows
+					if (seq % 64 == 63) {
+						std::this_thread::yield();
+					}
+				}
+				--runningNum;
+			});
+		}
+		uint64_t receivedNum = 0;
+		uint64_t brokenNum = 0;
+		std::vector<int64_t> lastSeq(producerNum, -1);
+		while (true) {
+			bool isFinished = (runningNum.load() == 0);
+			const NotificationRecord* records;
+			int num = BleNotificationRing::Acquire(header, &records);
+			for (int i = 0; i < num; ++i) {
+				const NotificationRecord& record = records[i];
+				uint32_t seq;
+				memcpy(&seq, record.data, sizeof(seq));
+				bool isOk = record.addr < static_cast<uint64_t>(producerNum) &&
+					memcmp(record.charastricsUuid, s_uuid, sizeof(s_uuid)) == 0 &&
+					record.subscriberId == static_cast<int32_t>(seq) && record.size == 4 + seq % 19 &&
+					static_cast<int64_t>(seq) > lastSeq[record.addr];
+				for (int b = 4; isOk && b < record.size; ++b) {
+					isOk = record.data[b] == static_cast<uint8_t>(seq * 31 + b);
+				}
+				if (isOk) {
+					lastSeq[record.addr] = seq;
+				}
+				else {
+					++brokenNum;
+				}
+			}
+			BleNotificationRing::Release(header, num);
+			receivedNum += num;
+			if (num == 0 && isFinished) {
+				break;
+			}
+		}
+		for (auto it = producers.begin(); it != producers.end(); ++it) {
+			it->join();
+		}
+		double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		uint64_t droppedNum = header->droppedNum.load();
+		ring.Disable();
+		uint64_t pushedNum = static_cast<uint64_t>(producerNum) * pushNum;
+		std::cout << producerNum << " producers x " << pushNum << ": received " << receivedNum << " dropped " <<
+			droppedNum << " broken " << brokenNum << " in " << sec << "s" << std::endl;
+		Check(brokenNum == 0, "records arrive whole and in order");
+		Check(receivedNum + droppedNum == pushedNum, "received + dropped == pushed");
+	}
+
+	// releasing more than was published must not move readCursor past writeCursor
+	void TestReleaseClamp() {
+		BleNotificationRing& ring = BleNotificationRing::GetInstance();
+		NotificationRingHeader* header = ring.Enable(16);
+		uint8_t data[NotificationRecord::MaxDataSize];
+		for (uint32_t seq = 0; seq < 3; ++seq) {
+			FillData(seq, data);
+			ring.Push(1, 0.0, s_uuid, -1, data, sizeof(data));
+		}
+		BleNotificationRing::Release(header, 100);
+		Check(header->readCursor.load() == 3, "release clamped to writeCursor");
+		BleNotificationRing::Release(header, -5);
+		Check(header->readCursor.load() == 3, "negative release ignored");
+		// the full check still works afterwards: exactly capacity more fit
+		int pushedNum = 0;
+		for (uint32_t seq = 0; seq < header->capacity + 4; ++seq) {
+			FillData(seq, data);
+			pushedNum += ring.Push(1, 0.0, s_uuid, -1, data, sizeof(data)) ? 1 : 0;
+		}
+		Check(pushedNum == static_cast<int>(header->capacity), "capacity after an over-release");
+		Check(header->droppedNum.load() == 4, "overflow counted");
+		ring.Disable();
+	}
+
+	// unread records lose their id, read ones are left alone
+	void TestClearSubscriberIds() {
+		BleNotificationRing& ring = BleNotificationRing::GetInstance();
+		NotificationRingHeader* header = ring.Enable(16);
+		uint8_t data[NotificationRecord::MaxDataSize];
+		for (uint32_t seq = 0; seq < 4; ++seq) {
+			FillData(seq, data);
+			ring.Push(1, 0.0, s_uuid, 7, data, sizeof(data));
+		}
+		BleNotificationRing::Release(header, 1);
+		ring.ClearSubscriberIds();
+		const NotificationRecord* records;
+		int num = BleNotificationRing::Acquire(header, &records);
+		Check(num == 3, "unread records");
+		for (int i = 0; i < num; ++i) {
+			Check(records[i].subscriberId == -1, "unread record untagged");
+		}
+		Check((records - 1)->subscriberId == 7, "read record kept");
+		ring.Disable();
+	}
+}
+
+int main(int argc, char** argv) {
+	// BleNotificationRingTest [pushNum]
+	uint32_t pushNum = (argc > 1) ? static_cast<uint32_t>(atoi(argv[1])) : 50000;
+	TestReleaseClamp();
+	TestClearSubscriberIds();
+	TestConcurrent(4, pushNum);
+	std::cout << "notification ring " << (s_failedNum == 0 ? "ok" : "NG") << std::endl;
+	return (s_failedNum == 0) ? 0 : 1;
+}
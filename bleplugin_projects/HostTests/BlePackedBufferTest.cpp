@@ -0,0 +1,165 @@
+#include "BlePackedBuffer.h"
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace BlePlugin;
+
+namespace {
+	int s_failedNum = 0;
+
+	void Check(bool isOk, const char* what) {
+		if (!isOk) {
+			std::cout << "NG " << what << std::endl;
+			++s_failedNum;
+		}
+	}
+
+	// writes the way BleScannerObj.packScanResult / BleDeviceObj.packReadData do (ByteBuffer, little endian)
+	class JavaPacker {
+	public:
+		std::vector<uint8_t> buffer;
+
+		JavaPacker() : buffer(PackedBufferHeaderSize, 0) {}
+
+		void PutShort(uint16_t val) {
+			buffer.push_back(static_cast<uint8_t>(val & 0xff));
+			buffer.push_back(static_cast<uint8_t>(val >> 8));
+		}
+		void PutAddress(uint64_t addr) {
+			uint8_t bytes[6];
+			WriteAddress(addr, bytes);
+			buffer.insert(buffer.end(), bytes, bytes + 6);
+		}
+		// putUuid switches to big endian for the two longs
+		void PutUuid(uint64_t most, uint64_t least) {
+			for (int i = 7; i >= 0; --i) {
+				buffer.push_back(static_cast<uint8_t>(most >> (i * 8)));
+			}
+			for (int i = 7; i >= 0; --i) {
+				buffer.push_back(static_cast<uint8_t>(least >> (i * 8)));
+			}
+		}
+		void SetRecordNum(int32_t num) {
+			for (int i = 0; i < 4; ++i) {
+				buffer[i] = static_cast<uint8_t>(num >> (i * 8));
+			}
+		}
+	};
+
+	// the offsets BleNativeBridge.cs reads, relative to the record start
+	const size_t ScanRssiOffset = 6;
+	const size_t ScanNameLengthOffset = 8;
+	const size_t DeviceFlagsOffset = 6;
+	const size_t DeviceServiceOffset = 8;
+	const size_t DeviceCharastricsOffset = 24;
+	const size_t DeviceDataLengthOffset = 40;
+
+	void TestScanBuffer() {
+		const uint64_t addrs[] = { 0xAABBCCDDEEFFULL, 0x001122334455ULL, 0xF0E1D2C3B4A5ULL };
+		const int16_t rssis[] = { -40, -99, 0 };
+		const std::string names[] = { "toio Core Cube", "", "\xE3\x82\xAD\xE3\x83\xA5\xE3\x83\xBC\xE3\x83\x96" };
+		JavaPacker packer;
+		std::vector<size_t> starts;
+		for (int i = 0; i < 3; ++i) {
+			starts.push_back(packer.buffer.size());
+			packer.PutAddress(addrs[i]);
+			packer.PutShort(static_cast<uint16_t>(rssis[i]));
+			packer.PutShort(static_cast<uint16_t>(names[i].size()));
+			packer.buffer.insert(packer.buffer.end(), names[i].begin(), names[i].end());
+		}
+		packer.SetRecordNum(3);
+		const std::vector<uint8_t>& buffer = packer.buffer;
+
+		Check(ValidateScanBuffer(buffer.data(), buffer.size()) == 3, "scan: record count");
+		PackedBufferReader reader(buffer.data(), buffer.size());
+		ScanRecord record;
+		for (int i = 0; i < 3; ++i) {
+			size_t start = reader.GetOffset();
+			Check(start == starts[i], "scan: record start");
+			Check(reader.Next(record), "scan: next");
+			Check(record.addr == addrs[i], "scan: addr");
+			Check(record.rssi == rssis[i], "scan: rssi");
+			Check(std::string(record.name, record.nameLength) == names[i], "scan: name");
+			// what BleNativeBridge.UpdateScanResult reads at its fixed offsets
+			const uint8_t* head = buffer.data() + start;
+			Check(static_cast<int16_t>(head[ScanRssiOffset] | (head[ScanRssiOffset + 1] << 8)) == rssis[i], "scan: rssi offset");
+			Check((head[ScanNameLengthOffset] | (head[ScanNameLengthOffset + 1] << 8)) == static_cast<int>(names[i].size()), "scan: name length offset");
+			Check(reinterpret_cast<const uint8_t*>(record.name) == head + PackedScanRecordSize, "scan: name offset");
+			Check(head[0] == static_cast<uint8_t>(addrs[i] >> 40), "scan: addr is written as text order");
+		}
+		Check(!reader.Next(record), "scan: end");
+		Check(reader.GetOffset() == buffer.size(), "scan: consumed the whole buffer");
+
+		// a name running past the end is not read
+		Check(ValidateScanBuffer(buffer.data(), buffer.size() - 1) == -1, "scan: truncated");
+		Check(ValidateScanBuffer(buffer.data(), 2) == 0, "scan: no header");
+	}
+
+	void TestDeviceDataBuffer() {
+		const uint64_t addr = 0xD1D2D3D4D5D6ULL;
+		// 10b20100-5b3b-4571-9508-cf3efcd7bbae / 10b20102-5b3b-4571-9508-cf3efcd7bbae
+		const uint64_t serviceMost = 0x10B201005B3B4571ULL;
+		const uint64_t charastricsMost = 0x10B201025B3B4571ULL;
+		const uint64_t uuidLeast = 0x9508CF3EFCD7BBAEULL;
+		const std::vector<uint8_t> payloads[] = { { 0x01, 0x02, 0x03 }, {}, std::vector<uint8_t>(300, 0x5A) };
+		JavaPacker packer;
+		std::vector<size_t> starts;
+		for (int i = 0; i < 3; ++i) {
+			starts.push_back(packer.buffer.size());
+			packer.PutAddress(addr);
+			packer.buffer.push_back((i == 0) ? DeviceDataNotify : 0);
+			packer.buffer.push_back(0);
+			packer.PutUuid(serviceMost, uuidLeast);
+			packer.PutUuid(charastricsMost, uuidLeast);
+			packer.PutShort(static_cast<uint16_t>(payloads[i].size()));
+			packer.buffer.insert(packer.buffer.end(), payloads[i].begin(), payloads[i].end());
+		}
+		packer.SetRecordNum(3);
+		const std::vector<uint8_t>& buffer = packer.buffer;
+
+		Check(ValidateDeviceDataBuffer(buffer.data(), buffer.size()) == 3, "device data: record count");
+		PackedBufferReader reader(buffer.data(), buffer.size());
+		DeviceDataRecord record;
+		for (int i = 0; i < 3; ++i) {
+			const uint8_t* head = buffer.data() + reader.GetOffset();
+			Check(reader.GetOffset() == starts[i], "device data: record start");
+			Check(reader.Next(record), "device data: next");
+			Check(record.addr == addr, "device data: addr");
+			Check(((record.flags & DeviceDataNotify) != 0) == (i == 0), "device data: notify flag");
+			Check(record.flags == head[DeviceFlagsOffset], "device data: flags offset");
+			Check(record.serviceUuid == head + DeviceServiceOffset, "device data: service offset");
+			Check(record.charastricsUuid == head + DeviceCharastricsOffset, "device data: charastrics offset");
+			Check((head[DeviceDataLengthOffset] | (head[DeviceDataLengthOffset + 1] << 8)) == static_cast<int>(payloads[i].size()), "device data: length offset");
+			Check(record.data == head + PackedDeviceDataRecordSize, "device data: data offset");
+			Check(record.dataLength == payloads[i].size() &&
+				(payloads[i].empty() || memcmp(record.data, payloads[i].data(), record.dataLength) == 0), "device data: data");
+			// BleNativeBridge.GetUuid prints the 16 bytes in order, which is java.util.UUID.toString()
+			Check(record.serviceUuid[0] == 0x10 && record.serviceUuid[3] == 0x00 &&
+				record.serviceUuid[15] == 0xAE, "device data: service uuid byte order");
+			Check(record.charastricsUuid[3] == 0x02, "device data: charastrics uuid");
+		}
+		Check(!reader.Next(record), "device data: end");
+		Check(reader.GetOffset() == buffer.size(), "device data: consumed the whole buffer");
+
+		Check(ValidateDeviceDataBuffer(buffer.data(), buffer.size() - 1) == -1, "device data: truncated data");
+		Check(ValidateDeviceDataBuffer(buffer.data(), starts[1] + PackedDeviceDataRecordSize - 1) == -1, "device data: truncated head");
+	}
+
+	void TestAddress() {
+		uint8_t bytes[6];
+		WriteAddress(0x0123456789ABULL, bytes);
+		const uint8_t expected[6] = { 0x01, 0x23, 0x45, 0x67, 0x89, 0xAB };
+		Check(memcmp(bytes, expected, 6) == 0, "address: bytes");
+		Check(ReadAddress(bytes) == 0x0123456789ABULL, "address: round trip");
+	}
+}
+
+int main() {
+	TestScanBuffer();
+	TestDeviceDataBuffer();
+	TestAddress();
+	std::cout << "packed buffer " << (s_failedNum == 0 ? "ok" : "NG") << std::endl;
+	return (s_failedNum == 0) ? 0 : 1;
+}
@@ -0,0 +1,76 @@
+// replays a capture from _BlePluginStartCapture on the host with a virtual frame clock and
+// reports the load it puts on a frame. the same trace and arguments always give the same output.
+//   BleTraceReplay <trace> [speed] [frameMs]
+#include "BleTraceReader.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <set>
+
+using namespace BlePlugin;
+
+namespace {
+	class CountSink : public BleTraceSink {
+	public:
+		uint64_t advertisementNum = 0;
+		uint64_t connectedNum = 0;
+		uint64_t disconnectedNum = 0;
+		uint64_t notificationNum = 0;
+		uint64_t notificationBytes = 0;
+		std::set<uint64_t> devices;
+
+		void OnAdvertisement(uint64_t addr, int) override {
+			++advertisementNum;
+			devices.insert(addr);
+		}
+		void OnConnected(uint64_t) override {
+			++connectedNum;
+		}
+		void OnDisconnected(uint64_t) override {
+			++disconnectedNum;
+		}
+		void OnNotification(uint64_t, const uint8_t*, const uint8_t*, const uint8_t*, int size) override {
+			++notificationNum;
+			notificationBytes += size;
+		}
+	};
+}
+
+int main(int argc, char** argv) {
+	if (argc < 2) {
+		std::cout << "BleTraceReplay <trace> [speed] [frameMs]" << std::endl;
+		return 2;
+	}
+	float speed = (argc > 2) ? static_cast<float>(atof(argv[2])) : 1.0f;
+	double frameMs = (argc > 3) ? atof(argv[3]) : 16.0;
+	if (speed <= 0.0f || frameMs <= 0.0) {
+		std::cout << "speed and frameMs have to be positive" << std::endl;
+		return 2;
+	}
+	BleTraceReader reader;
+	if (!reader.Open(argv[1], speed, false)) {
+		std::cout << "can't open " << argv[1] << std::endl;
+		return 1;
+	}
+	CountSink sink;
+	uint64_t frameNum = 0;
+	int maxPerFrame = 0;
+	uint64_t busyFrameNum = 0;
+	auto start = std::chrono::steady_clock::now();
+	while (!reader.IsAtEnd()) {
+		int num = reader.Update(static_cast<double>(frameNum) * frameMs * 1000000.0, sink);
+		maxPerFrame = (std::max)(maxPerFrame, num);
+		busyFrameNum += (num > 0);
+		++frameNum;
+	}
+	double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	uint64_t recordNum = reader.GetDispatchedNum();
+	std::cout << "replayed " << recordNum << " records over " << frameNum << " frames of " << frameMs << "ms (x" << speed << ")" << std::endl <<
+		"  advertisements " << sink.advertisementNum << " from " << sink.devices.size() << " devices" << std::endl <<
+		"  connected " << sink.connectedNum << " disconnected " << sink.disconnectedNum << std::endl <<
+		"  notifications " << sink.notificationNum << " (" << sink.notificationBytes << " bytes)" << std::endl <<
+		"  records per frame max " << maxPerFrame << " frames with records " << busyFrameNum << std::endl <<
+		"  reader " << ((recordNum > 0) ? sec * 1e9 / recordNum : 0.0) << "ns per record" << std::endl;
+	return 0;
+}
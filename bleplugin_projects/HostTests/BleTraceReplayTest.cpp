@@ -0,0 +1,216 @@
+#include "BleTraceReader.h"
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace BlePlugin;
+
+namespace {
+	int s_failedNum = 0;
+
+	void Check(bool isOk, const char* what) {
+		if (!isOk) {
+			std::cout << "NG " << what << std::endl;
+			++s_failedNum;
+		}
+	}
+
+	// one line per event, so two replays can be compared as text
+	class LogSink : public BleTraceSink {
+	public:
+		std::vector<std::string> events;
+
+		void OnAdvertisement(uint64_t addr, int rssi) override {
+			this->Add("adv", addr, std::to_string(rssi));
+		}
+		void OnConnected(uint64_t addr) override {
+			this->Add("connected", addr, "");
+		}
+		void OnDisconnected(uint64_t addr) override {
+			this->Add("disconnected", addr, "");
+		}
+		void OnNotification(uint64_t addr, const uint8_t* serviceUuid, const uint8_t* charastricsUuid,
+			const uint8_t* data, int size) override {
+			std::ostringstream detail;
+			detail << static_cast<int>(serviceUuid[3]) << "/" << static_cast<int>(charastricsUuid[3]) << ":";
+			for (int i = 0; i < size; ++i) {
+				detail << static_cast<int>(data[i]) << ",";
+			}
+			this->Add("notify", addr, detail.str());
+		}
+	private:
+		void Add(const char* type, uint64_t addr, const std::string& detail) {
+			std::ostringstream line;
+			line << type << " " << std::hex << addr << " " << detail;
+			events.push_back(line.str());
+		}
+	};
+
+	// writes what BleTraceWriter writes
+	class TraceBuilder {
+	public:
+		std::vector<uint8_t> records;
+
+		void Add(ETraceEvent type, uint64_t timestampNs, uint64_t addr, const std::vector<uint8_t>& payload) {
+			TraceRecordHeader header = {};
+			header.timestampNs = timestampNs;
+			header.addr = addr;
+			header.type = static_cast<uint8_t>(type);
+			header.size = static_cast<uint16_t>(payload.size());
+			const uint8_t* src = reinterpret_cast<const uint8_t*>(&header);
+			records.insert(records.end(), src, src + sizeof(header));
+			records.insert(records.end(), payload.begin(), payload.end());
+		}
+		void AddAdvertisement(uint64_t timestampNs, uint64_t addr, int16_t rssi) {
+			std::vector<uint8_t> payload(sizeof(rssi));
+			memcpy(payload.data(), &rssi, sizeof(rssi));
+			this->Add(ETraceEvent::Advertisement, timestampNs, addr, payload);
+		}
+		void AddNotification(uint64_t timestampNs, uint64_t addr, uint8_t charastrics, const std::vector<uint8_t>& data) {
+			std::vector<uint8_t> payload(32, 0);
+			payload[3] = 0x00;
+			payload[16 + 3] = charastrics;
+			payload.insert(payload.end(), data.begin(), data.end());
+			this->Add(ETraceEvent::Notification, timestampNs, addr, payload);
+		}
+		// dataSize can be set past the records to look like a capture that was not closed
+		bool Save(const std::filesystem::path& path, uint64_t dataSize, size_t cutBytes = 0)const {
+			TraceFileHeader header;
+			header.magic = TraceFileHeader::Magic;
+			header.version = TraceFileHeader::CurrentVersion;
+			header.dataSize = dataSize;
+			FILE* file = fopen(path.string().c_str(), "wb");
+			if (file == nullptr) {
+				return false;
+			}
+			fwrite(&header, sizeof(header), 1, file);
+			fwrite(records.data(), 1, records.size() - cutBytes, file);
+			fclose(file);
+			return true;
+		}
+	};
+
+	const uint64_t MsNs = 1000000;
+
+	TraceBuilder CreateSession() {
+		TraceBuilder builder;
+		builder.AddAdvertisement(0, 0xA1, -40);
+		builder.AddAdvertisement(1 * MsNs, 0xA2, -70);
+		builder.Add(ETraceEvent::ConnectRequest, 2 * MsNs, 0xA1, {});
+		builder.Add(ETraceEvent::Connected, 5 * MsNs, 0xA1, {});
+		// the app's own write is not replayed
+		builder.Add(ETraceEvent::WriteRequest, 6 * MsNs, 0xA1, std::vector<uint8_t>(34, 1));
+		builder.AddNotification(10 * MsNs, 0xA1, 0x01, { 1, 2, 3 });
+		builder.AddNotification(10 * MsNs, 0xA1, 0x02, {});
+		builder.AddNotification(20 * MsNs, 0xA1, 0x01, { 4 });
+		builder.Add(ETraceEvent::Disconnected, 30 * MsNs, 0xA1, {});
+		return builder;
+	}
+
+	std::vector<std::string> ReplayFrames(const std::filesystem::path& path, float speed, double frameMs, int frameNum,
+		std::vector<int>* perFrame = nullptr) {
+		BleTraceReader reader;
+		LogSink sink;
+		if (!reader.Open(path, speed, false)) {
+			return {};
+		}
+		for (int i = 0; i < frameNum; ++i) {
+			int num = reader.Update(i * frameMs * MsNs, sink);
+			if (perFrame != nullptr) {
+				perFrame->push_back(num);
+			}
+		}
+		return sink.events;
+	}
+
+	void TestTiming(const std::filesystem::path& path) {
+		std::vector<int> perFrame;
+		std::vector<std::string> events = ReplayFrames(path, 1.0f, 5.0, 8, &perFrame);
+		const std::vector<std::string> expected = {
+			"adv a1 -40", "adv a2 -70", "connected a1 ",
+			"notify a1 0/1:1,2,3,", "notify a1 0/2:", "notify a1 0/1:4,", "disconnected a1 ",
+		};
+		Check(events == expected, "timing: events and order");
+		// frames at 0,5,10..35ms: a record is due once its timestamp is reached.
+		// the counts include the request records that are read but not replayed
+		const std::vector<int> expectedPerFrame = { 1, 3, 3, 0, 1, 0, 1, 0 };
+		Check(perFrame == expectedPerFrame, "timing: records per frame");
+
+		// 4x: the same records in a quarter of the time
+		perFrame.clear();
+		ReplayFrames(path, 4.0f, 1.25, 8, &perFrame);
+		Check(perFrame == expectedPerFrame, "timing: accelerated");
+
+		// 0: everything on the first update
+		perFrame.clear();
+		events = ReplayFrames(path, 0.0f, 5.0, 2, &perFrame);
+		Check(events == expected && perFrame[0] == 9 && perFrame[1] == 0, "timing: as fast as possible");
+	}
+
+	void TestDeterministic(const std::filesystem::path& path) {
+		std::vector<int> first;
+		std::vector<int> second;
+		std::vector<std::string> a = ReplayFrames(path, 2.0f, 16.6, 10, &first);
+		std::vector<std::string> b = ReplayFrames(path, 2.0f, 16.6, 10, &second);
+		Check(!a.empty() && a == b && first == second, "deterministic: same frames give the same replay");
+	}
+
+	void TestLoop(const std::filesystem::path& path) {
+		BleTraceReader reader;
+		LogSink sink;
+		Check(reader.Open(path, 1.0f, true), "loop: open");
+		reader.Update(30.0 * MsNs, sink);
+		Check(sink.events.size() == 7, "loop: first pass");
+		// the second pass starts at the time the first ended
+		int num = reader.Update(30.0 * MsNs, sink);
+		Check(num == 1 && sink.events.back() == "adv a1 -40", "loop: restarts at the pass end");
+		reader.Update(60.0 * MsNs, sink);
+		Check(sink.events.size() == 14 && reader.GetDispatchedNum() == 18, "loop: second pass");
+	}
+
+	void TestBrokenFiles(const std::filesystem::path& dir, const TraceBuilder& session) {
+		// not closed: dataSize was last written before the final records
+		std::filesystem::path unclosed = dir / "unclosed.bletrace";
+		size_t lastRecord = sizeof(TraceRecordHeader) + 0;
+		Check(session.Save(unclosed, session.records.size() - lastRecord), "broken: save unclosed");
+		std::vector<std::string> events = ReplayFrames(unclosed, 0.0f, 1.0, 1);
+		Check(events.size() == 6, "broken: stops at dataSize");
+
+		// cut in the middle of the last record
+		std::filesystem::path cut = dir / "cut.bletrace";
+		Check(session.Save(cut, session.records.size(), 3), "broken: save cut");
+		events = ReplayFrames(cut, 0.0f, 1.0, 1);
+		Check(events.size() == 6, "broken: drops the partial record");
+
+		std::filesystem::path bad = dir / "bad.bletrace";
+		FILE* file = fopen(bad.string().c_str(), "wb");
+		const char text[] = "not a trace file at all";
+		fwrite(text, 1, sizeof(text), file);
+		fclose(file);
+		BleTraceReader reader;
+		Check(!reader.Open(bad, 1.0f, false), "broken: bad magic");
+		Check(!reader.Open(dir / "missing.bletrace", 1.0f, false), "broken: missing file");
+	}
+}
+
+int main() {
+	std::filesystem::path dir = std::filesystem::temp_directory_path() / "bleplugin_trace_test";
+	std::filesystem::create_directories(dir);
+	TraceBuilder session = CreateSession();
+	std::filesystem::path path = dir / "session.bletrace";
+	if (!session.Save(path, session.records.size())) {
+		std::cout << "can't write " << path << std::endl;
+		return 1;
+	}
+	TestTiming(path);
+	TestDeterministic(path);
+	TestLoop(path);
+	TestBrokenFiles(dir, session);
+	std::filesystem::remove_all(dir);
+	std::cout << "trace replay " << (s_failedNum == 0 ? "ok" : "NG") << std::endl;
+	return (s_failedNum == 0) ? 0 : 1;
+}
@@ -0,0 +1,427 @@
+#include "BleAdapterPool.h"
+#include <climits>
+#include <cwchar>
+
+using namespace BlePlugin;
+using namespace winrt::Windows::Foundation;
+using namespace winrt::Windows::Devices::Bluetooth;
+using namespace winrt::Windows::Devices::Enumeration;
+
+namespace {
+	class LeastLoadedPolicy : public IAdapterPlacementPolicy {
+	public:
+		int Select(const BleAdapterPool& pool, uint64_t deviceAddr) override {
+			return pool.SelectLeastLoaded();
+		}
+	};
+
+	class RssiBestPolicy : public IAdapterPlacementPolicy {
+	public:
+		int Select(const BleAdapterPool& pool, uint64_t deviceAddr) override {
+			int best = -1;
+			int bestRssi = INT16_MIN;
+			int heardNum = 0;
+			for (int i = 0; i < pool.GetAdapterNum(); ++i) {
+				const BleAdapterSlot& slot = pool.GetAdapter(i);
+				int rssi = pool.GetRssi(i, deviceAddr);
+				if (!slot.isPresent || rssi == INT16_MIN) {
+					continue;
+				}
+				++heardNum;
+				if (slot.assignedNum < slot.maxConnections && rssi > bestRssi) {
+					best = i;
+					bestRssi = rssi;
+				}
+			}
+			// a single reading says nothing about the other adapters
+			return (heardNum >= 2) ? best : -1;
+		}
+	};
+
+	class PinnedPolicy : public IAdapterPlacementPolicy {
+	public:
+		int Select(const BleAdapterPool& pool, uint64_t deviceAddr) override {
+			return pool.GetPinned(deviceAddr);
+		}
+	};
+
+	class DefaultOnlyPolicy : public IAdapterPlacementPolicy {
+	public:
+		int Select(const BleAdapterPool& pool, uint64_t deviceAddr) override {
+			return pool.GetDefaultIndex();
+		}
+	};
+}
+
+// BleAdapterSlot
+BleAdapterSlot::BleAdapterSlot() :
+	adapter(nullptr)
+{
+	this->Reset();
+}
+
+void BleAdapterSlot::Reset() {
+	adapter = nullptr;
+	address = 0;
+	isDefault = false;
+	isSimulated = false;
+	isPresent = true;
+	maxConnections = BleAdapterPool::DefaultMaxConnections;
+	assignedNum = 0;
+	connectedNum = 0;
+	connectFailedNum = 0;
+	writeBytes = 0;
+	notificationNum = 0;
+	notificationBytes = 0;
+}
+
+// BleAdapterPool
+BleAdapterPool BleAdapterPool::s_instance;
+
+BleAdapterPool::BleAdapterPool() :
+	m_adapterNum(0), m_defaultIndex(-1), m_status(ESearchStatus::None),
+	m_deviceListAsync(nullptr), m_defaultAsync(nullptr),
+	m_policy(new DefaultOnlyPolicy())
+{
+}
+
+BleAdapterPool& BleAdapterPool::GetInstance() {
+	return s_instance;
+}
+
+void BleAdapterPool::Request() {
+	m_adapterAsyncs.clear();
+	m_deviceListAsync = DeviceInformation::FindAllAsync(BluetoothAdapter::GetDeviceSelector());
+	m_defaultAsync = BluetoothAdapter::GetDefaultAsync();
+	m_status = ESearchStatus::WaitingDeviceList;
+}
+
+void BleAdapterPool::Update() {
+	switch (m_status) {
+	case ESearchStatus::WaitingDeviceList:
+		UpdateWaitingDeviceList();
+		break;
+	case ESearchStatus::WaitingAdapters:
+		UpdateWaitingAdapters();
+		break;
+	}
+}
+
+void BleAdapterPool::UpdateWaitingDeviceList() {
+	if (m_deviceListAsync.Status() == AsyncStatus::Error) {
+		m_status = ESearchStatus::Complete;
+	}
+	else if (m_deviceListAsync.Status() == AsyncStatus::Completed) {
+		auto devices = m_deviceListAsync.get();
+		for (uint32_t i = 0; i < devices.Size() && i < MaxAdapterNum; ++i) {
+			m_adapterAsyncs.push_back(BluetoothAdapter::FromIdAsync(devices.GetAt(i).Id()));
+		}
+		m_status = ESearchStatus::WaitingAdapters;
+	}
+}
+
+void BleAdapterPool::UpdateWaitingAdapters() {
+	if (m_defaultAsync.Status() == AsyncStatus::Started) {
+		return;
+	}
+	for (auto it = m_adapterAsyncs.begin(); it != m_adapterAsyncs.end(); ++it) {
+		if (it->Status() == AsyncStatus::Started) {
+			return;
+		}
+	}
+	WinRtBluetoothAdapter defaultAdapter(nullptr);
+	if (m_defaultAsync.Status() == AsyncStatus::Completed) {
+		defaultAdapter = m_defaultAsync.get();
+	}
+	// slots are never removed: devices and WinRT callbacks hold their index
+	for (int i = 0; i < this->GetAdapterNum(); ++i) {
+		m_adapters[i].isDefault = false;
+		m_adapters[i].isPresent = m_adapters[i].isSimulated;
+	}
+	m_defaultIndex = -1;
+	for (auto it = m_adapterAsyncs.begin(); it != m_adapterAsyncs.end(); ++it) {
+		if (it->Status() != AsyncStatus::Completed) {
+			continue;
+		}
+		WinRtBluetoothAdapter adapter = it->get();
+		if (adapter == nullptr || !adapter.IsLowEnergySupported() || !adapter.IsCentralRoleSupported()) {
+			continue;
+		}
+		int idx = this->FindEnumeratedAdapter(adapter.BluetoothAddress());
+		if (idx >= 0) {
+			m_adapters[idx].adapter = adapter;
+			m_adapters[idx].isPresent = true;
+		}
+		else {
+			idx = this->AddAdapter(adapter, adapter.BluetoothAddress(), false, DefaultMaxConnections);
+		}
+		if (idx >= 0 && defaultAdapter != nullptr && adapter.DeviceId() == defaultAdapter.DeviceId()) {
+			m_adapters[idx].isDefault = true;
+			m_defaultIndex = idx;
+		}
+	}
+	for (int i = 0; i < this->GetAdapterNum() && m_defaultIndex < 0; ++i) {
+		if (m_adapters[i].isPresent) {
+			m_adapters[i].isDefault = true;
+			m_defaultIndex = i;
+		}
+	}
+	m_adapterAsyncs.clear();
+	m_status = ESearchStatus::Complete;
+}
+
+void BleAdapterPool::Clear() {
+	int num = this->GetAdapterNum();
+	m_adapterNum.store(0, std::memory_order_release);
+	for (int i = 0; i < num; ++i) {
+		m_adapters[i].Reset();
+	}
+	m_defaultIndex = -1;
+	m_status = ESearchStatus::None;
+	m_adapterAsyncs.clear();
+	m_pinned.clear();
+	m_assigned.clear();
+	std::lock_guard lock(m_rssiMutex);
+	m_rssi.clear();
+}
+
+int BleAdapterPool::FindEnumeratedAdapter(uint64_t address)const {
+	for (int i = 0; i < this->GetAdapterNum(); ++i) {
+		if (!m_adapters[i].isSimulated && m_adapters[i].address == address) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+int BleAdapterPool::AddSimulatedAdapter(uint64_t address, int maxConnections) {
+	int idx = this->AddAdapter(WinRtBluetoothAdapter(nullptr), address, true, maxConnections);
+	if (idx == 0) {
+		m_adapters[0].isDefault = true;
+		m_defaultIndex = 0;
+	}
+	return idx;
+}
+
+int BleAdapterPool::AddAdapter(const WinRtBluetoothAdapter& adapter, uint64_t address, bool isSimulated, int maxConnections) {
+	int idx = this->GetAdapterNum();
+	if (idx >= MaxAdapterNum) {
+		return -1;
+	}
+	BleAdapterSlot& slot = m_adapters[idx];
+	slot.Reset();
+	slot.adapter = adapter;
+	slot.address = address;
+	slot.isSimulated = isSimulated;
+	slot.maxConnections = (maxConnections > 0) ? maxConnections : DefaultMaxConnections;
+	m_adapterNum.store(idx + 1, std::memory_order_release);
+	return idx;
+}
+
+bool BleAdapterPool::GetStats(int idx, BleAdapterStats& out)const {
+	if (idx < 0 || idx >= this->GetAdapterNum()) {
+		return false;
+	}
+	const BleAdapterSlot& slot = m_adapters[idx];
+	out.address = slot.address;
+	out.isDefault = slot.isDefault ? 1 : 0;
+	out.isSimulated = slot.isSimulated ? 1 : 0;
+	out.maxConnections = slot.maxConnections;
+	out.assignedNum = slot.assignedNum;
+	out.connectedNum = slot.connectedNum;
+	out.connectFailedNum = slot.connectFailedNum;
+	out.writeBytes = slot.writeBytes.load(std::memory_order_relaxed);
+	out.notificationNum = slot.notificationNum.load(std::memory_order_relaxed);
+	out.notificationBytes = slot.notificationBytes.load(std::memory_order_relaxed);
+	return true;
+}
+
+void BleAdapterPool::SetPlacement(EAdapterPlacement placement) {
+	switch (placement) {
+	case EAdapterPlacement::RssiBest:
+		m_policy.reset(new RssiBestPolicy());
+		break;
+	case EAdapterPlacement::Pinned:
+		m_policy.reset(new PinnedPolicy());
+		break;
+	case EAdapterPlacement::LeastLoaded:
+		m_policy.reset(new LeastLoadedPolicy());
+		break;
+	default:
+		m_policy.reset(new DefaultOnlyPolicy());
+		break;
+	}
+}
+
+void BleAdapterPool::SetPlacementPolicy(std::unique_ptr<IAdapterPlacementPolicy> policy) {
+	if (policy == nullptr) {
+		policy.reset(new DefaultOnlyPolicy());
+	}
+	m_policy = std::move(policy);
+}
+
+void BleAdapterPool::Pin(uint64_t deviceAddr, int adapterIdx) {
+	if (adapterIdx < 0) {
+		m_pinned.erase(deviceAddr);
+		return;
+	}
+	m_pinned[deviceAddr] = adapterIdx;
+}
+
+int BleAdapterPool::GetPinned(uint64_t deviceAddr)const {
+	auto it = m_pinned.find(deviceAddr);
+	if (it == m_pinned.end() || it->second >= this->GetAdapterNum() || !m_adapters[it->second].isPresent) {
+		return -1;
+	}
+	return it->second;
+}
+
+void BleAdapterPool::ReportRssi(int adapterIdx, uint64_t deviceAddr, int rssi) {
+	if (adapterIdx < 0 || adapterIdx >= MaxAdapterNum) {
+		return;
+	}
+	std::lock_guard lock(m_rssiMutex);
+	std::vector<int16_t>& values = m_rssi[deviceAddr];
+	if (values.empty()) {
+		values.resize(MaxAdapterNum, INT16_MIN);
+	}
+	values[adapterIdx] = static_cast<int16_t>(rssi);
+}
+
+int BleAdapterPool::GetRssi(int adapterIdx, uint64_t deviceAddr)const {
+	std::lock_guard lock(m_rssiMutex);
+	auto it = m_rssi.find(deviceAddr);
+	if (it == m_rssi.end() || adapterIdx < 0 || adapterIdx >= MaxAdapterNum) {
+		return INT16_MIN;
+	}
+	return it->second[adapterIdx];
+}
+
+void BleAdapterPool::ForgetRssi(uint64_t deviceAddr) {
+	std::lock_guard lock(m_rssiMutex);
+	m_rssi.erase(deviceAddr);
+}
+
+int BleAdapterPool::SelectLeastLoaded()const {
+	// compare assigned / maxConnections without division; a full adapter only wins when all are full
+	int best = -1;
+	bool bestFull = true;
+	for (int i = 0; i < this->GetAdapterNum(); ++i) {
+		const BleAdapterSlot& slot = m_adapters[i];
+		if (!slot.isPresent) {
+			continue;
+		}
+		bool isFull = (slot.assignedNum >= slot.maxConnections);
+		if (best >= 0) {
+			const BleAdapterSlot& current = m_adapters[best];
+			if (isFull && !bestFull) {
+				continue;
+			}
+			if (isFull == bestFull &&
+				static_cast<int64_t>(slot.assignedNum) * current.maxConnections >=
+				static_cast<int64_t>(current.assignedNum) * slot.maxConnections) {
+				continue;
+			}
+		}
+		best = i;
+		bestFull = isFull;
+	}
+	return best;
+}
+
+int BleAdapterPool::Assign(uint64_t deviceAddr) {
+	auto it = m_assigned.find(deviceAddr);
+	if (it != m_assigned.end()) {
+		return it->second;
+	}
+	if (this->GetAdapterNum() == 0) {
+		return -1;
+	}
+	int idx = m_policy->Select(*this, deviceAddr);
+	if (idx < 0 || idx >= this->GetAdapterNum()) {
+		idx = this->SelectLeastLoaded();
+	}
+	if (idx < 0) {
+		// every known adapter went away
+		return -1;
+	}
+	m_assigned.emplace(deviceAddr, idx);
+	++m_adapters[idx].assignedNum;
+	return idx;
+}
+
+void BleAdapterPool::Release(uint64_t deviceAddr) {
+	auto it = m_assigned.find(deviceAddr);
+	if (it == m_assigned.end()) {
+		return;
+	}
+	if (it->second < this->GetAdapterNum()) {
+		--m_adapters[it->second].assignedNum;
+	}
+	m_assigned.erase(it);
+}
+
+int BleAdapterPool::GetAssigned(uint64_t deviceAddr)const {
+	auto it = m_assigned.find(deviceAddr);
+	if (it == m_assigned.end()) {
+		return -1;
+	}
+	return it->second;
+}
+
+WinRtAsyncOperation<WinRtBleDevice> BleAdapterPool::ConnectAsync(int adapterIdx, uint64_t deviceAddr)const {
+	if (adapterIdx < 0 || adapterIdx >= this->GetAdapterNum() || m_adapters[adapterIdx].isDefault) {
+		return WinRtBleDevice::FromBluetoothAddressAsync(deviceAddr);
+	}
+	uint64_t adapterAddr = m_adapters[adapterIdx].address;
+	wchar_t id[64];
+	swprintf_s(id, L"BluetoothLE#BluetoothLE%02llx:%02llx:%02llx:%02llx:%02llx:%02llx-%02llx:%02llx:%02llx:%02llx:%02llx:%02llx",
+		(adapterAddr >> 40) & 0xff, (adapterAddr >> 32) & 0xff, (adapterAddr >> 24) & 0xff,
+		(adapterAddr >> 16) & 0xff, (adapterAddr >> 8) & 0xff, adapterAddr & 0xff,
+		(deviceAddr >> 40) & 0xff, (deviceAddr >> 32) & 0xff, (deviceAddr >> 24) & 0xff,
+		(deviceAddr >> 16) & 0xff, (deviceAddr >> 8) & 0xff, deviceAddr & 0xff);
+	return WinRtBleDevice::FromIdAsync(id);
+}
+
+int BleAdapterPool::FallBackToDefault(uint64_t deviceAddr) {
+	auto it = m_assigned.find(deviceAddr);
+	if (it == m_assigned.end() || m_defaultIndex < 0 || it->second == m_defaultIndex) {
+		return -1;
+	}
+	if (it->second < this->GetAdapterNum()) {
+		--m_adapters[it->second].assignedNum;
+	}
+	it->second = m_defaultIndex;
+	++m_adapters[m_defaultIndex].assignedNum;
+	return m_defaultIndex;
+}
+
+void BleAdapterPool::SetConnectedNum(const int* connectedNum, int num) {
+	int adapterNum = this->GetAdapterNum();
+	for (int i = 0; i < adapterNum; ++i) {
+		m_adapters[i].connectedNum = (i < num) ? connectedNum[i] : 0;
+	}
+}
+
+void BleAdapterPool::OnConnectFailed(int adapterIdx) {
+	if (adapterIdx < 0 || adapterIdx >= this->GetAdapterNum()) {
+		return;
+	}
+	++m_adapters[adapterIdx].connectFailedNum;
+}
+
+void BleAdapterPool::OnWrite(int adapterIdx, int size) {
+	if (adapterIdx < 0 || adapterIdx >= this->GetAdapterNum()) {
+		return;
+	}
+	m_adapters[adapterIdx].writeBytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+void BleAdapterPool::OnNotification(int adapterIdx, int size) {
+	if (adapterIdx < 0 || adapterIdx >= this->GetAdapterNum()) {
+		return;
+	}
+	BleAdapterSlot& slot = m_adapters[adapterIdx];
+	slot.notificationNum.fetch_add(1, std::memory_order_relaxed);
+	slot.notificationBytes.fetch_add(size, std::memory_order_relaxed);
+}
@@ -0,0 +1,161 @@
+#pragma once
+
+#include "pch.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace BlePlugin {
+	enum class EAdapterPlacement : int {
+		// fewest assigned devices relative to the adapter's link budget
+		LeastLoaded = 0,
+		// adapter that heard the device loudest, least loaded unless two adapters or more reported it.
+		// BleDeviceWatcher only reports the default adapter (the WinRT watcher can't be bound to
+		// another one), so without ReportRssi from elsewhere this places like LeastLoaded
+		RssiBest = 1,
+		// Pin() table first, least loaded for everything else
+		Pinned = 2,
+		// every device on the default adapter through FromBluetoothAddressAsync (the default);
+		// the other placements are opt-in
+		DefaultOnly = 3,
+	};
+
+	// exported as is (same layout as AdapterStats in DllInterface.cs)
+	struct BleAdapterStats {
+		uint64_t address;
+		int32_t isDefault;
+		int32_t isSimulated;
+		int32_t maxConnections;
+		int32_t assignedNum;
+		int32_t connectedNum;
+		int32_t connectFailedNum;
+		uint64_t writeBytes;
+		uint64_t notificationNum;
+		uint64_t notificationBytes;
+	};
+
+	class BleAdapterSlot {
+	public:
+		WinRtBluetoothAdapter adapter;
+		uint64_t address;
+		bool isDefault;
+		bool isSimulated;
+		// found by the last enumeration (simulated adapters always are); placement skips the rest
+		bool isPresent;
+		int maxConnections;
+
+		// main thread
+		int assignedNum;
+		int connectedNum;
+		int connectFailedNum;
+		// notifications arrive on WinRT threads
+		std::atomic<uint64_t> writeBytes;
+		std::atomic<uint64_t> notificationNum;
+		std::atomic<uint64_t> notificationBytes;
+
+		BleAdapterSlot();
+		void Reset();
+	};
+
+	class BleAdapterPool;
+
+	// called on the main thread from BleAdapterPool::Assign; return -1 to fall back to least loaded
+	class IAdapterPlacementPolicy {
+	public:
+		virtual ~IAdapterPlacementPolicy() {}
+		virtual int Select(const BleAdapterPool& pool, uint64_t deviceAddr) = 0;
+	};
+
+	// every Bluetooth adapter on the machine and which devices were placed on which.
+	// WinRT has no "connect through adapter X" call, so a device on a non default adapter
+	// is opened by its adapter scoped device id (BluetoothLE#BluetoothLE<adapter>-<device>).
+	class BleAdapterPool {
+	public:
+		static const int MaxAdapterNum = 8;
+		// Windows stacks start refusing LE links somewhere around here
+		static const int DefaultMaxConnections = 7;
+	private:
+		enum class ESearchStatus {
+			None,
+			WaitingDeviceList,
+			WaitingAdapters,
+			Complete
+		};
+		static BleAdapterPool s_instance;
+
+		// fixed storage so counters can be bumped from WinRT threads while adapters are added
+		BleAdapterSlot m_adapters[MaxAdapterNum];
+		std::atomic<int> m_adapterNum;
+		int m_defaultIndex;
+
+		ESearchStatus m_status;
+		WinRtAsyncOperation<winrt::Windows::Devices::Enumeration::DeviceInformationCollection> m_deviceListAsync;
+		std::vector<WinRtAsyncOperation<WinRtBluetoothAdapter> > m_adapterAsyncs;
+		WinRtAsyncOperation<WinRtBluetoothAdapter> m_defaultAsync;
+
+		std::unique_ptr<IAdapterPlacementPolicy> m_policy;
+		std::unordered_map<uint64_t, int> m_pinned;
+		std::unordered_map<uint64_t, int> m_assigned;
+		// device addr -> rssi per adapter (INT16_MIN when not heard), fed from the watcher thread
+		mutable std::mutex m_rssiMutex;
+		std::unordered_map<uint64_t, std::vector<int16_t> > m_rssi;
+
+		BleAdapterPool();
+	public:
+		static BleAdapterPool& GetInstance();
+
+		// enumerate the adapters; poll Update until IsRequestComplete.
+		// adapters already known keep their index, so connected devices keep their placement
+		void Request();
+		void Update();
+		inline bool IsRequestComplete()const {
+			return (m_status == ESearchStatus::Complete);
+		}
+		// forget adapters, placements and statistics
+		void Clear();
+		// an adapter without a radio behind it, for placement/throughput simulation
+		int AddSimulatedAdapter(uint64_t address, int maxConnections);
+
+		inline int GetAdapterNum()const {
+			return m_adapterNum.load(std::memory_order_acquire);
+		}
+		inline int GetDefaultIndex()const {
+			return m_defaultIndex;
+		}
+		inline const BleAdapterSlot& GetAdapter(int idx)const {
+			return m_adapters[idx];
+		}
+		bool GetStats(int idx, BleAdapterStats& out)const;
+
+		void SetPlacement(EAdapterPlacement placement);
+		void SetPlacementPolicy(std::unique_ptr<IAdapterPlacementPolicy> policy);
+		void Pin(uint64_t deviceAddr, int adapterIdx);
+		int GetPinned(uint64_t deviceAddr)const;
+		void ReportRssi(int adapterIdx, uint64_t deviceAddr, int rssi);
+		int GetRssi(int adapterIdx, uint64_t deviceAddr)const;
+		// the device stopped advertising
+		void ForgetRssi(uint64_t deviceAddr);
+		int SelectLeastLoaded()const;
+
+		// picks an adapter for the device (-1 when nothing was enumerated: use the default path)
+		int Assign(uint64_t deviceAddr);
+		void Release(uint64_t deviceAddr);
+		int GetAssigned(uint64_t deviceAddr)const;
+		// FromBluetoothAddressAsync on the default adapter, FromIdAsync with the scoped id elsewhere
+		WinRtAsyncOperation<WinRtBleDevice> ConnectAsync(int adapterIdx, uint64_t deviceAddr)const;
+		// the scoped id found nothing: moves the device to the default adapter and returns its index,
+		// -1 when it already was there
+		int FallBackToDefault(uint64_t deviceAddr);
+
+		void SetConnectedNum(const int* connectedNum, int num);
+		void OnConnectFailed(int adapterIdx);
+		void OnWrite(int adapterIdx, int size);
+		void OnNotification(int adapterIdx, int size);
+	private:
+		void UpdateWaitingDeviceList();
+		void UpdateWaitingAdapters();
+		int AddAdapter(const WinRtBluetoothAdapter& adapter, uint64_t address, bool isSimulated, int maxConnections);
+		int FindEnumeratedAdapter(uint64_t address)const;
+	};
+}
@@ -0,0 +1,182 @@
+#include "BleBulkTransfer.h"
+#include <algorithm>
+
+using namespace BlePlugin;
+
+static double GetBytesPerSec(uint64_t bytes, double elapsedMs) {
+	return (elapsedMs > 0.0) ? static_cast<double>(bytes) * 1000.0 / elapsedMs : 0.0;
+}
+
+// BleBulkWriter
+BleBulkWriter::BleBulkWriter(const uint8_t* data, int size, int chunkSize, int window, int checkpointInterval, double nowMs) :
+	m_data(data, data + size), m_totalBytes(static_cast<uint64_t>(size)), m_chunkSize((std::max)(chunkSize, 1)), m_window((std::max)(window, 1)),
+	m_checkpointInterval(checkpointInterval),
+	m_nextChunk(0), m_inFlightNum(0), m_doneChunkNum(0), m_pendingCheckpoint(-1), m_doneBytes(0),
+	m_status(EBulkStatus::Running), m_startMs(nowMs), m_lastMs(nowMs)
+{
+	m_chunkNum = (size + m_chunkSize - 1) / m_chunkSize;
+	if (m_chunkNum == 0) {
+		m_status = EBulkStatus::Completed;
+	}
+}
+
+bool BleBulkWriter::PeekNext(Chunk& out)const {
+	if (m_status != EBulkStatus::Running || m_nextChunk >= m_chunkNum ||
+		m_inFlightNum >= m_window || m_pendingCheckpoint >= 0) {
+		return false;
+	}
+	int offset = m_nextChunk * m_chunkSize;
+	out.index = m_nextChunk;
+	out.data = m_data.data() + offset;
+	out.size = (std::min)(m_chunkSize, static_cast<int>(m_data.size()) - offset);
+	out.withResponse = (m_nextChunk == m_chunkNum - 1) ||
+		(m_checkpointInterval > 0 && (m_nextChunk + 1) % m_checkpointInterval == 0);
+	return true;
+}
+
+void BleBulkWriter::MarkIssued(const Chunk& chunk) {
+	++m_nextChunk;
+	++m_inFlightNum;
+	if (chunk.withResponse) {
+		m_pendingCheckpoint = chunk.index;
+	}
+}
+
+void BleBulkWriter::OnChunkDone(int index, bool isSucceeded, double nowMs) {
+	--m_inFlightNum;
+	if (m_status != EBulkStatus::Running) {
+		return;
+	}
+	if (!isSucceeded) {
+		this->Fail(nowMs);
+		return;
+	}
+	++m_doneChunkNum;
+	m_doneBytes += (std::min)(static_cast<uint64_t>(m_chunkSize), m_totalBytes - static_cast<uint64_t>(index) * m_chunkSize);
+	m_lastMs = nowMs;
+	if (index == m_pendingCheckpoint) {
+		m_pendingCheckpoint = -1;
+	}
+	if (m_doneChunkNum == m_chunkNum) {
+		m_status = EBulkStatus::Completed;
+		// nothing to resend, the source buffer can go
+		std::vector<uint8_t>().swap(m_data);
+	}
+}
+
+void BleBulkWriter::Cancel(double nowMs) {
+	if (m_status == EBulkStatus::Running) {
+		m_status = EBulkStatus::Cancelled;
+		m_lastMs = nowMs;
+	}
+}
+
+void BleBulkWriter::Fail(double nowMs) {
+	if (m_status == EBulkStatus::Running) {
+		m_status = EBulkStatus::Error;
+		m_lastMs = nowMs;
+	}
+}
+
+void BleBulkWriter::GetProgress(BulkTransferProgress& out, double nowMs)const {
+	out.status = m_status;
+	out.reserved = 0;
+	out.totalBytes = m_totalBytes;
+	out.doneBytes = m_doneBytes;
+	out.chunkNum = static_cast<uint64_t>(m_chunkNum);
+	out.doneChunkNum = static_cast<uint64_t>(m_doneChunkNum);
+	out.elapsedMs = ((m_status == EBulkStatus::Running) ? nowMs : m_lastMs) - m_startMs;
+	out.bytesPerSec = GetBytesPerSec(m_doneBytes, out.elapsedMs);
+}
+
+// BleBulkReceiver
+BleBulkReceiver::BleBulkReceiver(const WinRtGuid& serviceUuid, const WinRtGuid& charastricsUuid,
+	int expectedSize, int headerSize, double nowMs) :
+	m_serviceUuid(serviceUuid), m_charastricsUuid(charastricsUuid),
+	m_expectedSize((std::max)(expectedSize, 0)), m_headerSize((std::max)(headerSize, 0)),
+	m_packetNum(0), m_status(EBulkStatus::Running), m_startMs(nowMs), m_lastMs(nowMs)
+{
+	m_data.reserve(m_expectedSize);
+}
+
+void BleBulkReceiver::OnPacket(const uint8_t* data, int size, double nowMs) {
+	if (m_status != EBulkStatus::Running || size <= m_headerSize) {
+		return;
+	}
+	int payloadSize = size - m_headerSize;
+	if (m_expectedSize > 0) {
+		payloadSize = (std::min)(payloadSize, m_expectedSize - static_cast<int>(m_data.size()));
+	}
+	m_data.insert(m_data.end(), data + m_headerSize, data + m_headerSize + payloadSize);
+	++m_packetNum;
+	m_lastMs = nowMs;
+	if (m_expectedSize > 0 && static_cast<int>(m_data.size()) >= m_expectedSize) {
+		m_status = EBulkStatus::Completed;
+	}
+}
+
+void BleBulkReceiver::Finish(EBulkStatus status, double nowMs) {
+	if (m_status == EBulkStatus::Running) {
+		m_status = status;
+		m_lastMs = nowMs;
+	}
+}
+
+void BleBulkReceiver::GetProgress(BulkTransferProgress& out, double nowMs)const {
+	out.status = m_status;
+	out.reserved = 0;
+	out.totalBytes = static_cast<uint64_t>(m_expectedSize);
+	out.doneBytes = m_data.size();
+	out.chunkNum = m_packetNum;
+	out.doneChunkNum = m_packetNum;
+	out.elapsedMs = ((m_status == EBulkStatus::Running) ? nowMs : m_lastMs) - m_startMs;
+	out.bytesPerSec = GetBytesPerSec(m_data.size(), out.elapsedMs);
+}
+
+// BleBulkWriteTransfer
+BleBulkWriteTransfer::BleBulkWriteTransfer(const WinRtBleCharacteristic& charastrics, const uint8_t* data, int size,
+	int chunkSize, int window, int checkpointInterval, double nowMs) :
+	m_charastrics(charastrics), m_writer(data, size, chunkSize, window, checkpointInterval, nowMs)
+{
+}
+
+int BleBulkWriteTransfer::Update(BleOperationScheduler& scheduler, double nowMs) {
+	for (auto it = m_operations.begin(); it != m_operations.end(); ) {
+		BleGattOperation* operation = it->second;
+		if (!operation->IsDone()) {
+			++it;
+			continue;
+		}
+		m_writer.OnChunkDone(it->first, operation->GetStatus() == BleGattOperation::EStatus::Completed, nowMs);
+		scheduler.Release(operation);
+		it = m_operations.erase(it);
+	}
+	int issuedBytes = 0;
+	BleBulkWriter::Chunk chunk;
+	while (m_writer.PeekNext(chunk)) {
+		auto option = chunk.withResponse ? WinRtGattWriteOption::WriteWithResponse : WinRtGattWriteOption::WriteWithoutResponse;
+		BleGattOperation* operation = scheduler.EnqueueWrite(m_charastrics, chunk.data, chunk.size, option, EOperationPriority::Bulk);
+		m_writer.MarkIssued(chunk);
+		m_operations.emplace_back(chunk.index, operation);
+		issuedBytes += chunk.size;
+	}
+	return issuedBytes;
+}
+
+void BleBulkWriteTransfer::Cancel(BleOperationScheduler& scheduler, double nowMs) {
+	m_writer.Cancel(nowMs);
+	this->ReleaseOperations(scheduler);
+}
+
+void BleBulkWriteTransfer::Abort(BleOperationScheduler& scheduler, double nowMs) {
+	m_writer.Fail(nowMs);
+	this->ReleaseOperations(scheduler);
+}
+
+void BleBulkWriteTransfer::ReleaseOperations(BleOperationScheduler& scheduler) {
+	for (auto it = m_operations.begin(); it != m_operations.end(); ++it) {
+		m_writer.OnChunkDone(it->first, false, 0.0);
+		scheduler.Release(it->second);
+	}
+	m_operations.clear();
+}
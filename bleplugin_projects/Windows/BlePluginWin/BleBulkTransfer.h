@@ -0,0 +1,130 @@
+#pragma once
+
+#include "pch.h"
+#include "BleOperationScheduler.h"
+#include <vector>
+
+namespace BlePlugin {
+	enum class EBulkStatus : int32_t {
+		Running = 0,
+		Completed = 1,
+		Error = 2,
+		Cancelled = 3,
+	};
+
+	// exported as is (same layout as BulkTransferProgress in DllInterface.cs)
+	struct BulkTransferProgress {
+		EBulkStatus status;
+		int32_t reserved;
+		uint64_t totalBytes;
+		// written and completed, or received
+		uint64_t doneBytes;
+		uint64_t chunkNum;
+		uint64_t doneChunkNum;
+		double elapsedMs;
+		double bytesPerSec;
+	};
+
+	// host -> device flow control, no I/O: hands out chunks and takes their completions.
+	// chunks go out as writes without response, at most window of them outstanding. every
+	// checkpointInterval-th chunk and the last one are written with response, and nothing past a
+	// checkpoint is issued until the device acknowledged it.
+	class BleBulkWriter {
+	public:
+		struct Chunk {
+			int index;
+			const uint8_t* data;
+			int size;
+			bool withResponse;
+		};
+	private:
+		std::vector<uint8_t> m_data;
+		uint64_t m_totalBytes;
+		int m_chunkSize;
+		int m_window;
+		int m_checkpointInterval;
+
+		int m_chunkNum;
+		int m_nextChunk;
+		int m_inFlightNum;
+		int m_doneChunkNum;
+		// checkpoint in flight, -1 when none
+		int m_pendingCheckpoint;
+		uint64_t m_doneBytes;
+		EBulkStatus m_status;
+		double m_startMs;
+		double m_lastMs;
+	public:
+		BleBulkWriter(const uint8_t* data, int size, int chunkSize, int window, int checkpointInterval, double nowMs);
+
+		// next chunk allowed out now; call MarkIssued once it is handed to the stack
+		bool PeekNext(Chunk& out)const;
+		void MarkIssued(const Chunk& chunk);
+		void OnChunkDone(int index, bool isSucceeded, double nowMs);
+		void Cancel(double nowMs);
+		void Fail(double nowMs);
+
+		inline EBulkStatus GetStatus()const {
+			return m_status;
+		}
+		inline int GetInFlightNum()const {
+			return m_inFlightNum;
+		}
+		void GetProgress(BulkTransferProgress& out, double nowMs)const;
+	};
+
+	// device -> host stream reassembled from notifications of one characteristic.
+	// headerSize bytes (sequence numbers and such) are dropped from every packet; the stream
+	// completes once expectedSize bytes arrived (0: runs until cancelled).
+	class BleBulkReceiver {
+	private:
+		WinRtGuid m_serviceUuid;
+		WinRtGuid m_charastricsUuid;
+		int m_expectedSize;
+		int m_headerSize;
+		std::vector<uint8_t> m_data;
+		uint64_t m_packetNum;
+		EBulkStatus m_status;
+		double m_startMs;
+		double m_lastMs;
+	public:
+		BleBulkReceiver(const WinRtGuid& serviceUuid, const WinRtGuid& charastricsUuid,
+			int expectedSize, int headerSize, double nowMs);
+
+		inline bool IsTarget(const WinRtGuid& serviceUuid, const WinRtGuid& charastricsUuid)const {
+			return m_status == EBulkStatus::Running &&
+				m_serviceUuid == serviceUuid && m_charastricsUuid == charastricsUuid;
+		}
+		void OnPacket(const uint8_t* data, int size, double nowMs);
+		void Finish(EBulkStatus status, double nowMs);
+
+		inline const std::vector<uint8_t>& GetData()const {
+			return m_data;
+		}
+		void GetProgress(BulkTransferProgress& out, double nowMs)const;
+	};
+
+	// BleBulkWriter driven through a device's BleOperationScheduler (Bulk priority, so Control
+	// traffic keeps overtaking it). don't enable write coalescing on the target characteristic.
+	class BleBulkWriteTransfer {
+	private:
+		WinRtBleCharacteristic m_charastrics;
+		BleBulkWriter m_writer;
+		std::vector<std::pair<int, BleGattOperation*> > m_operations;
+	public:
+		BleBulkWriteTransfer(const WinRtBleCharacteristic& charastrics, const uint8_t* data, int size,
+			int chunkSize, int window, int checkpointInterval, double nowMs);
+
+		// returns the bytes handed to the scheduler
+		int Update(BleOperationScheduler& scheduler, double nowMs);
+		void Cancel(BleOperationScheduler& scheduler, double nowMs);
+		// the device went away
+		void Abort(BleOperationScheduler& scheduler, double nowMs);
+
+		inline const BleBulkWriter& GetWriter()const {
+			return m_writer;
+		}
+	private:
+		void ReleaseOperations(BleOperationScheduler& scheduler);
+	};
+}
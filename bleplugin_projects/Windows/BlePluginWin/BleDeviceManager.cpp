@@ -1,5 +1,10 @@
 #include "BleDeviceManager.h"
 #include "BleDeviceObject.h"
+#include "BleTraceReplayer.h"
+#include "BleAdapterPool.h"
+#include "BleTeardown.h"
+#include "BlePayloadDecoder.h"
+#include <algorithm>
 
 using namespace BlePlugin;
 
@@ -9,27 +14,66 @@ BleDeviceManager& BleDeviceManager::GetInstance() {
 	return s_instance;
 }
 
+BleDeviceManager::BleDeviceManager() :
+	m_idleTimeoutSec(DefaultIdleTimeoutSec), m_poolSize(DefaultPoolSize), m_evictedNum(0)
+{
+}
+
 BleDeviceObject* BleDeviceManager::ConnectDevice(uint64_t addr) {
 
-	BleDeviceObject* deviceObj = this->GetDeviceByAddr(addr);
-	if (deviceObj == nullptr) {
-		deviceObj = new BleDeviceObject(addr);
-		m_devices.push_back(deviceObj);
+	BleDeviceObject* deviceObj = this->AcquireDevice(addr);
+	// while replaying, the trace decides when the device connects
+	if (BleTraceReplayer::GetInstance().IsReplaying()) {
+		return nullptr;
 	}
 	deviceObj->ConnectRequest();
 	return nullptr;
 }
+BleDeviceObject* BleDeviceManager::ConnectDevice(uint64_t addr, const std::vector<WinRtGuid>& serviceFilter) {
+	BleDeviceObject* deviceObj = this->AcquireDevice(addr);
+	if (BleTraceReplayer::GetInstance().IsReplaying()) {
+		return deviceObj;
+	}
+	deviceObj->ConnectRequest(serviceFilter);
+	return deviceObj;
+}
 BleDeviceObject* BleDeviceManager::GetDeviceByAddr(uint64_t addr) {
-	for (auto it = m_devices.begin(); it != m_devices.end(); ++it) {
-		BleDeviceObject* devicePtr = (*it);
-		if (devicePtr  == nullptr) {
-			continue;
+	std::lock_guard lock(m_devicesMutex);
+	auto it = m_devices.find(addr);
+	if (it == m_devices.end()) {
+		return nullptr;
+	}
+	return it->second;
+}
+
+BleDeviceObject* BleDeviceManager::AcquireDevice(uint64_t addr) {
+	BleDeviceObject* deviceObj = this->GetDeviceByAddr(addr);
+	if (deviceObj == nullptr) {
+		if (!m_pooledDevices.empty()) {
+			deviceObj = m_pooledDevices.back();
+			m_pooledDevices.pop_back();
+			deviceObj->Reuse(addr);
 		}
-		if (devicePtr->GetAddr() == addr) {
-			return devicePtr;
+		else {
+			deviceObj = new BleDeviceObject(addr);
 		}
+		std::lock_guard lock(m_devicesMutex);
+		m_devices.emplace(addr, deviceObj);
 	}
-	return nullptr;
+	this->Activate(deviceObj);
+	return deviceObj;
+}
+
+void BleDeviceManager::Activate(BleDeviceObject* deviceObj) {
+	if (deviceObj->m_isActive) {
+		return;
+	}
+	auto it = std::find(m_idleDevices.begin(), m_idleDevices.end(), deviceObj);
+	if (it != m_idleDevices.end()) {
+		m_idleDevices.erase(it);
+	}
+	deviceObj->m_isActive = true;
+	m_activeDevices.push_back(deviceObj);
 }
 void BleDeviceManager::DisconnectDevice(uint64_t addr) {
 	BleDeviceObject* deviceObj = this->GetDeviceByAddr(addr);
@@ -38,30 +82,93 @@ void BleDeviceManager::DisconnectDevice(uint64_t addr) {
 	}
 }
 
+void BleDeviceManager::AttachReplayDevice(uint64_t addr) {
+	BleDeviceObject* deviceObj = this->AcquireDevice(addr);
+	deviceObj->SetReplayConnected(true);
+}
+void BleDeviceManager::DetachReplayDevice(uint64_t addr) {
+	BleDeviceObject* deviceObj = this->GetDeviceByAddr(addr);
+	if (deviceObj != nullptr && deviceObj->IsReplayConnected()) {
+		deviceObj->SetReplayConnected(false);
+	}
+}
+
+void BleDeviceManager::ClearNotificationSubscriberIds() {
+	for (auto it = m_activeDevices.begin(); it != m_activeDevices.end(); ++it) {
+		(*it)->ClearNotificationSubscriberIds();
+	}
+}
 
 void BleDeviceManager::DisconnectAll() {
-	for (auto it = m_devices.begin(); it != m_devices.end(); ++it) {
+	for (auto it = m_activeDevices.begin(); it != m_activeDevices.end(); ++it) {
 		BleDeviceObject* deviceObj = *it;
-		if (deviceObj == nullptr) {
-			continue;
-		}
 		if (deviceObj->IsConnected()) {
 			deviceObj->Disconnect();
 		}
 	}
 }
 void BleDeviceManager::ResetAll() {
-	this->DisconnectAll();
+	this->ResetAllAsync(BleTeardown::DefaultTimeoutMs);
+	BleTeardown::GetInstance().Wait();
+}
+
+void BleDeviceManager::ResetAllAsync(int timeoutMs) {
+	BleTeardown& teardown = BleTeardown::GetInstance();
+	for (auto it = m_activeDevices.begin(); it != m_activeDevices.end(); ++it) {
+		std::vector<WinRtBleGattService> services;
+		WinRtBleDevice device(nullptr);
+		(*it)->DetachConnection(services, device);
+		if (device != nullptr || !services.empty()) {
+			teardown.Add((*it)->GetAddr(), std::move(services), device);
+		}
+	}
+	teardown.Start(timeoutMs);
 	m_connectDevices.clear();
+	// unpublish first: notifications may still arrive while the services close
+	std::unordered_map<uint64_t, BleDeviceObject*> devices;
+	{
+		std::lock_guard lock(m_devicesMutex);
+		devices.swap(m_devices);
+	}
     // clear all device memory
-    for (auto it = m_devices.begin(); it != m_devices.end(); ++it) {
-        BleDeviceObject* devicePtr = (*it);
-        if (devicePtr == nullptr) {
-            continue;
-        }
-        delete devicePtr;
+    for (auto it = devices.begin(); it != devices.end(); ++it) {
+        delete it->second;
+    }
+    for (auto it = m_pooledDevices.begin(); it != m_pooledDevices.end(); ++it) {
+        delete *it;
     }
-	m_devices.clear();
+	m_activeDevices.clear();
+	m_idleDevices.clear();
+	m_pooledDevices.clear();
+	m_evictedNum = 0;
+}
+
+void BleDeviceManager::SetIdleEviction(float timeoutSec, int poolSize) {
+	m_idleTimeoutSec = timeoutSec;
+	m_poolSize = (std::max)(poolSize, 0);
+	while (static_cast<int>(m_pooledDevices.size()) > m_poolSize) {
+		delete m_pooledDevices.back();
+		m_pooledDevices.pop_back();
+	}
+}
+
+void BleDeviceManager::GetResidentStats(DeviceResidentStats& out)const {
+	out.activeNum = static_cast<int32_t>(m_activeDevices.size());
+	out.idleNum = static_cast<int32_t>(m_idleDevices.size());
+	out.pooledNum = static_cast<int32_t>(m_pooledDevices.size());
+	out.residentBytes = 0;
+	out.pooledBytes = 0;
+	out.evictedNum = m_evictedNum;
+	{
+		std::lock_guard lock(m_devicesMutex);
+		out.residentNum = static_cast<int32_t>(m_devices.size());
+		for (auto it = m_devices.begin(); it != m_devices.end(); ++it) {
+			out.residentBytes += it->second->GetResidentBytes();
+		}
+	}
+	for (auto it = m_pooledDevices.begin(); it != m_pooledDevices.end(); ++it) {
+		out.pooledBytes += (*it)->GetResidentBytes();
+	}
 }
 
 
@@ -74,15 +181,69 @@ BleDeviceObject* BleDeviceManager::GetConnectedDeviceByIndex(int idx) {
 }
 
 void BleDeviceManager::Update() {
+	int adapterConnectedNum[BleAdapterPool::MaxAdapterNum] = {};
+	Clock::time_point now = Clock::now();
 	m_connectDevices.clear();
-	for (auto it = m_devices.begin(); it != m_devices.end(); ++it) {
-		BleDeviceObject* deviceObj = *it;
-		if (deviceObj == nullptr) {
-			continue;
-		}
+	// compacts the active list in place so the connected order stays stable
+	size_t activeNum = 0;
+	for (size_t i = 0; i < m_activeDevices.size(); ++i) {
+		BleDeviceObject* deviceObj = m_activeDevices[i];
 		deviceObj->Update();
 		if (deviceObj->IsConnected()) {
 			m_connectDevices.push_back(deviceObj);
+			if (deviceObj->GetAdapterIndex() >= 0) {
+				++adapterConnectedNum[deviceObj->GetAdapterIndex()];
+			}
+		}
+		if (deviceObj->IsIdle()) {
+			deviceObj->m_isActive = false;
+			deviceObj->m_idleSince = now;
+			m_idleDevices.push_back(deviceObj);
+			continue;
+		}
+		m_activeDevices[activeNum++] = deviceObj;
+	}
+	m_activeDevices.resize(activeNum);
+	BleAdapterPool::GetInstance().SetConnectedNum(adapterConnectedNum, BleAdapterPool::MaxAdapterNum);
+	this->DecodeNotifications();
+	this->EvictIdleDevices(now);
+}
+
+void BleDeviceManager::DecodeNotifications() {
+	BlePayloadDecoder& decoder = BlePayloadDecoder::GetInstance();
+	if (!decoder.HasSchema()) {
+		return;
+	}
+	decoder.BeginFrame();
+	for (auto it = m_connectDevices.begin(); it != m_connectDevices.end(); ++it) {
+		BleDeviceObject* deviceObj = *it;
+		int notificateNum = deviceObj->GetNofiticateNum();
+		for (int i = 0; i < notificateNum; ++i) {
+			decoder.Gather(deviceObj->GetAddr(), deviceObj->GetNotificateData(i));
+		}
+	}
+	decoder.EndFrame();
+}
+
+void BleDeviceManager::EvictIdleDevices(Clock::time_point now) {
+	if (m_idleTimeoutSec < 0.0f) {
+		return;
+	}
+	auto timeout = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(m_idleTimeoutSec));
+	while (!m_idleDevices.empty() && now - m_idleDevices.front()->m_idleSince >= timeout) {
+		BleDeviceObject* deviceObj = m_idleDevices.front();
+		m_idleDevices.pop_front();
+		{
+			std::lock_guard lock(m_devicesMutex);
+			m_devices.erase(deviceObj->GetAddr());
+		}
+		++m_evictedNum;
+		if (static_cast<int>(m_pooledDevices.size()) < m_poolSize) {
+			deviceObj->Recycle();
+			m_pooledDevices.push_back(deviceObj);
+		}
+		else {
+			delete deviceObj;
 		}
 	}
 }
@@ -91,14 +252,19 @@ void BleDeviceManager::Update() {
 winrt::fire_and_forget BleDeviceManager::Characteristic_ValueChanged(WinRtBleCharacteristic const& charastrics, WinRtBleValueChangedEventArgs args) {
 	winrt::fire_and_forget ret;
 	uint64_t addr = charastrics.Service().Device().BluetoothAddress();
-	BleDeviceObject* obj = BleDeviceManager::GetInstance().GetDeviceByAddr(addr);
-	if (obj == nullptr) {
-		return ret;
-	}
 	WinRtGuid serviceUuid = charastrics.Service().Uuid();
 	WinRtGuid charastricsUuid = charastrics.Uuid();
 	uint8_t* data = args.CharacteristicValue().data();
 	int length = args.CharacteristicValue().Length();
-	obj->OnChangeValue(serviceUuid, charastricsUuid, data, length);
+
+	// held across OnChangeValue: EvictIdleDevices and ResetAllAsync unpublish under this lock
+	// before they recycle or delete, so the object can't go away under the handler
+	BleDeviceManager& manager = BleDeviceManager::GetInstance();
+	std::lock_guard lock(manager.m_devicesMutex);
+	auto it = manager.m_devices.find(addr);
+	if (it == manager.m_devices.end()) {
+		return ret;
+	}
+	it->second->OnChangeValue(serviceUuid, charastricsUuid, data, length);
 	return ret;
 }
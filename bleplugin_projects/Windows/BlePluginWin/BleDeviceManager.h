@@ -1,28 +1,83 @@
 #pragma once
 #include "pch.h"
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
 
 
 
 namespace BlePlugin {
 	class BleDeviceObject;
+
+	// exported as is (same layout as DeviceResidentStats in DllInterface.cs)
+	struct DeviceResidentStats {
+		int32_t residentNum;
+		int32_t activeNum;
+		int32_t idleNum;
+		int32_t pooledNum;
+		uint64_t residentBytes;
+		uint64_t pooledBytes;
+		uint64_t evictedNum;
+	};
+
 	class BleDeviceManager {
+	public:
+		static constexpr float DefaultIdleTimeoutSec = 30.0f;
+		static const int DefaultPoolSize = 8;
+	private:
+		using Clock = std::chrono::steady_clock;
+
 		static BleDeviceManager s_instance;
-		std::vector <  BleDeviceObject*> m_devices;
+		// every resident object; looked up from the WinRT notification thread too, which keeps
+		// the lock while it hands the value over. an object is deleted or recycled only after
+		// it was erased from here
+		std::unordered_map<uint64_t, BleDeviceObject*> m_devices;
+		mutable std::mutex m_devicesMutex;
+		// connecting, connected or still holding operations: the only ones Update visits
+		std::vector<BleDeviceObject*> m_activeDevices;
+		// disconnected and idle, oldest first
+		std::deque<BleDeviceObject*> m_idleDevices;
+		// evicted objects kept for reuse
+		std::vector<BleDeviceObject*> m_pooledDevices;
 		std::vector <  BleDeviceObject*> m_connectDevices;
 
+		float m_idleTimeoutSec;
+		int m_poolSize;
+		uint64_t m_evictedNum;
+
+		BleDeviceManager();
 	public:
 		static BleDeviceManager& GetInstance();
 
 		BleDeviceObject* ConnectDevice(uint64_t addr);
+		BleDeviceObject* ConnectDevice(uint64_t addr, const std::vector<WinRtGuid>& serviceFilter);
 		BleDeviceObject* GetDeviceByAddr(uint64_t addr);
 		void DisconnectDevice(uint64_t addr);
 		void DisconnectAll();
+		// BleTraceReplayer connection events
+		void AttachReplayDevice(uint64_t addr);
+		void DetachReplayDevice(uint64_t addr);
+		// BleSession detach / reattach: the managed subscriber ids of the old domain mean nothing after it
+		void ClearNotificationSubscriberIds();
 		void ResetAll();
+		// ResetAll with the connections handed to BleTeardown instead of closed here
+		void ResetAllAsync(int timeoutMs);
+
+		// idle objects are recycled after timeoutSec (< 0 keeps them forever); up to poolSize are kept for reuse
+		void SetIdleEviction(float timeoutSec, int poolSize);
+		void GetResidentStats(DeviceResidentStats& out)const;
 
 		int GetConnectedDeviceNum()const;
 		BleDeviceObject* GetConnectedDeviceByIndex(int idx);
 		void Update();
-
+	private:
+		BleDeviceObject* AcquireDevice(uint64_t addr);
+		void Activate(BleDeviceObject* deviceObj);
+		void EvictIdleDevices(Clock::time_point now);
+		// drained notifications of every connected device through BlePayloadDecoder
+		void DecodeNotifications();
+	public:
 		static winrt::fire_and_forget Characteristic_ValueChanged(WinRtBleCharacteristic const&, WinRtBleValueChangedEventArgs args);
 
 
@@ -1,67 +1,176 @@
 #include "BleDeviceObject.h"
 #include "BleDeviceManager.h"
 #include "Utility.h"
+#include "BleTrace.h"
+#include "BleAdapterPool.h"
+#include "BleTimeline.h"
+#include "BleNotificationRing.h"
+#include "BleSession.h"
+#include <algorithm>
+#include <cstring>
 
 
 using namespace BlePlugin;
 using namespace winrt::Windows::Foundation;
 using namespace winrt::Windows::Devices::Bluetooth;
 
+static double GetNowMs() {
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
 BleDeviceObject::BleDeviceObject(uint64_t addr) :
-m_addr(addr), m_device(nullptr),m_connectState(EConnectState::None)
+m_addr(addr), m_device(nullptr),m_connectState(EConnectState::None),
+m_droppedNotificationNum(0),
+m_replayConnected(false), m_adapterIndex(-1),
+m_isActive(false)
 {
 }
 
 bool BleDeviceObject::IsConnected()const {
-	return (m_connectState == EConnectState::GattServiceComplete);
+	return m_replayConnected || (m_connectState == EConnectState::GattServiceComplete);
+}
+bool BleDeviceObject::IsLinkAlive()const {
+	if (m_replayConnected) {
+		return true;
+	}
+	return m_connectState == EConnectState::GattServiceComplete &&
+		m_device != nullptr && m_device.ConnectionStatus() == WinRtBleConnectStatus::Connected;
 }
 
 
 void BleDeviceObject::ConnectRequest() {
+	std::vector<WinRtGuid> noFilter;
+	this->ConnectRequest(noFilter);
+}
+void BleDeviceObject::ConnectRequest(const std::vector<WinRtGuid>& serviceFilter) {
 	UpdateDisconectCheck();
 	if (m_connectState == EConnectState::None) {
-		m_connectAsync = BluetoothLEDevice::FromBluetoothAddressAsync(m_addr);
+		m_serviceFilter = serviceFilter;
+		BleAdapterPool& pool = BleAdapterPool::GetInstance();
+		m_adapterIndex = pool.Assign(m_addr);
+		m_connectAsync = pool.ConnectAsync(m_adapterIndex, m_addr);
 		m_connectState = EConnectState::Connecting;
+		BLE_TIMELINE_ASYNC_BEGIN("connect", m_addr);
+		BleTrace::GetInstance().RecordConnection(ETraceEvent::ConnectRequest, m_addr);
 	}
 }
 void BleDeviceObject::Disconnect() {
-	for (auto it = m_services.begin(); it != m_services.end(); ++it) {
+	std::vector<WinRtBleGattService> services;
+	WinRtBleDevice device(nullptr);
+	this->DetachConnection(services, device);
+	for (auto it = services.begin(); it != services.end(); ++it) {
 		it->Close();
 	}
-    if (m_device != nullptr) {
-        m_device.Close();
+    if (device != nullptr) {
+        device.Close();
     }
+}
+void BleDeviceObject::DetachConnection(std::vector<WinRtBleGattService>& services, WinRtBleDevice& device) {
+	services.swap(m_services);
+	device = m_device;
+	if (m_connectState != EConnectState::None || m_replayConnected) {
+		BleTrace::GetInstance().RecordConnection(ETraceEvent::Disconnected, m_addr);
+	}
+	this->EndTimelineStage();
+	m_replayConnected = false;
     this->ClearDeviceInfo();
+	this->ReleaseAdapter();
+	// lets a failed attempt retry instead of reporting the same error every frame
+	m_connectState = EConnectState::None;
+}
+
+bool BleDeviceObject::IsIdle()const {
+	return !m_replayConnected && m_connectState == EConnectState::None &&
+		m_readRequest.empty() && m_writeRequest.empty() && m_scheduler.IsEmpty() &&
+		m_bulkWrites.empty() && m_bulkReceivers.empty();
+}
+
+void BleDeviceObject::Recycle() {
+	this->Disconnect();
+	m_connectAsync = nullptr;
+	std::vector<WinRtAsyncOperation<WinRtBleGattServiceResult> >().swap(m_serviceRequests);
+	std::vector<WinRtBleGattService>().swap(m_services);
+	std::vector<WinRtBleCharacteristic>().swap(m_charastrictics);
+	std::vector<WinRtGuid>().swap(m_serviceFilter);
+	std::vector<WinRtAsyncOperation<WinRtBleCharacteristicsResult> >().swap(m_charastricsRequests);
+	std::vector<std::pair<int, winrt::event_token> >().swap(m_subscriptions);
+	{
+		std::lock_guard lock(m_notificateMutex);
+		std::vector<NotificateData>().swap(m_NotificateBuffer);
+		m_histories.clear();
+		std::vector<NotificationSubscriber>().swap(m_subscriberIds);
+		m_bulkReceivers.clear();
+	}
+	std::vector<NotificateData>().swap(m_NotificateResult);
+	m_bulkWrites.clear();
+	m_scheduler.Reset();
+}
+
+void BleDeviceObject::Reuse(uint64_t addr) {
+	m_addr = addr;
+}
+
+size_t BleDeviceObject::GetResidentBytes() {
+	size_t bufferCapacity;
+	{
+		std::lock_guard lock(m_notificateMutex);
+		bufferCapacity = m_NotificateBuffer.capacity();
+	}
+	return sizeof(BleDeviceObject) +
+		m_services.capacity() * sizeof(WinRtBleGattService) +
+		m_charastrictics.capacity() * sizeof(WinRtBleCharacteristic) +
+		m_serviceFilter.capacity() * sizeof(WinRtGuid) +
+		m_charastricsRequests.capacity() * sizeof(WinRtAsyncOperation<WinRtBleCharacteristicsResult>) +
+		(bufferCapacity + m_NotificateResult.capacity()) * sizeof(NotificateData) +
+		m_scheduler.GetResidentBytes();
 }
 
 void BleDeviceObject::Update() {
+	if (m_replayConnected) {
+		this->UpdateNotification();
+		return;
+	}
 	// DeviceRequest
 	switch (m_connectState) {
 	case EConnectState::Connecting:
 		if (m_connectAsync.Status() == AsyncStatus::Completed) {
 			m_device = m_connectAsync.get();
-			m_connectGattAsync = m_device.GetGattServicesAsync();
+			// FromIdAsync on a secondary adapter yields null when that adapter can't see the device;
+			// that is no failure yet, the default adapter gets its turn
+			if (m_device == nullptr) {
+				BleAdapterPool& pool = BleAdapterPool::GetInstance();
+				int defaultIdx = pool.FallBackToDefault(m_addr);
+				if (defaultIdx >= 0) {
+					m_adapterIndex = defaultIdx;
+					m_connectAsync = pool.ConnectAsync(m_adapterIndex, m_addr);
+					break;
+				}
+				pool.OnConnectFailed(m_adapterIndex);
+				Disconnect();
+				break;
+			}
+			this->RequestGattServices();
+			BLE_TIMELINE_ASYNC_END("connect", m_addr);
+			BLE_TIMELINE_ASYNC_BEGIN("discoverServices", m_addr);
 			this->m_connectState = EConnectState::GattServiceRequesting;
 		}
 		else if (m_connectAsync.Status() == AsyncStatus::Error) {
+			BleAdapterPool::GetInstance().OnConnectFailed(m_adapterIndex);
 			Disconnect();
 		}
 		break;
 	case EConnectState::GattServiceRequesting:
-		if (m_connectGattAsync.Status() == AsyncStatus::Completed) {
-			auto gattResult = m_connectGattAsync.get();
-			this->SetupGattServices(gattResult);
-			this->m_connectState = EConnectState::GattCharastricsRequesting;
-		}
-		else if (m_connectGattAsync.Status() == AsyncStatus::Error) {
-			Disconnect();
-		}
+		UpdateGattServices();
 		break;
 	case EConnectState::GattCharastricsRequesting:
 		UpdateCharacterisc();
 		break;
 	}
 	this->UpdateDisconectCheck();
+	if (IsConnected()) {
+		m_scheduler.Update();
+	}
+	this->UpdateBulkTransfers();
 	this->UpdateNotification();
 }
 void BleDeviceObject::UpdateCharacterisc() {
@@ -85,6 +194,8 @@ void BleDeviceObject::UpdateCharacterisc() {
 	}
 	if (m_charastricsRequests.size() == 0) {
 		m_connectState = EConnectState::GattServiceComplete;
+		BLE_TIMELINE_ASYNC_END("discoverCharacteristics", m_addr);
+		BleTrace::GetInstance().RecordConnection(ETraceEvent::Connected, m_addr);
 	}
 }	
 
@@ -104,24 +215,69 @@ void BleDeviceObject::SetupCharacterisc(const WinRtBleCharacteristicsResult& res
 
 
 
-void BleDeviceObject::SetupGattServices(const WinRtBleGattServiceResult& result) {
+// with a service filter only those services are discovered, not the whole database
+void BleDeviceObject::RequestGattServices() {
+	m_serviceRequests.clear();
+	if (m_serviceFilter.empty()) {
+		m_serviceRequests.push_back(m_device.GetGattServicesAsync());
+		return;
+	}
+	for (auto it = m_serviceFilter.begin(); it != m_serviceFilter.end(); ++it) {
+		m_serviceRequests.push_back(m_device.GetGattServicesForUuidAsync(*it));
+	}
+}
+
+void BleDeviceObject::UpdateGattServices() {
+	for (auto it = m_serviceRequests.begin(); it != m_serviceRequests.end(); ++it) {
+		if (it->Status() == AsyncStatus::Error) {
+			Disconnect();
+			return;
+		}
+		if (it->Status() != AsyncStatus::Completed) {
+			return;
+		}
+	}
 	this->m_services.clear();
-	auto services = result.Services();
-	int size = services.Size();
-	for (int i = 0; i < size; ++i) {
-		m_services.push_back( services.GetAt(i) );
+	for (auto it = m_serviceRequests.begin(); it != m_serviceRequests.end(); ++it) {
+		this->SetupGattServices(it->get());
 	}
+	m_serviceRequests.clear();
 
 	this->m_charastricsRequests.clear();
 	for (auto it = m_services.begin(); it != m_services.end(); ++it) {
-		WinRtAsyncOperation<WinRtBleCharacteristicsResult> request
-			=it->GetCharacteristicsAsync();
-		WinRtGuid guid = it->Uuid();
+		m_charastricsRequests.push_back(it->GetCharacteristicsAsync());
+	}
+	BLE_TIMELINE_ASYNC_END("discoverServices", m_addr);
+	BLE_TIMELINE_ASYNC_BEGIN("discoverCharacteristics", m_addr);
+	this->m_connectState = EConnectState::GattCharastricsRequesting;
+}
 
-		m_charastricsRequests.push_back(request);
+void BleDeviceObject::SetupGattServices(const WinRtBleGattServiceResult& result) {
+	auto services = result.Services();
+	int size = services.Size();
+	for (int i = 0; i < size; ++i) {
+		auto service = services.GetAt(i);
+		// the unfiltered request lists every service; skip the ones nobody asked for (Generic Access, DFU...)
+		if (!IsTargetService(service.Uuid())) {
+			service.Close();
+			continue;
+		}
+		m_services.push_back( service );
 	}
 }
 
+bool BleDeviceObject::IsTargetService(const WinRtGuid& serviceUuid)const {
+	if (m_serviceFilter.empty()) {
+		return true;
+	}
+	for (auto it = m_serviceFilter.begin(); it != m_serviceFilter.end(); ++it) {
+		if (*it == serviceUuid) {
+			return true;
+		}
+	}
+	return false;
+}
+
 WinRtBleCharacteristic* BleDeviceObject::GetCharastric(const WinRtGuid& serviceUuid, const WinRtGuid& charastricsUuid) {
 	for (auto it = m_charastrictics.begin();it != m_charastrictics.end(); ++it) {
 		if (it->Uuid() == charastricsUuid &&
@@ -134,6 +290,11 @@ WinRtBleCharacteristic* BleDeviceObject::GetCharastric(const WinRtGuid& serviceU
 
 WinRtAsyncOperation< WinRtGattWriteResult>* BleDeviceObject::WriteRequest(const WinRtGuid& serviceUuid, const WinRtGuid& charastricsUuid,
 	const uint8_t* src, int size) {
+	return this->WriteRequest(serviceUuid, charastricsUuid, src, size, WinRtGattWriteOption::WriteWithResponse);
+}
+
+WinRtAsyncOperation< WinRtGattWriteResult>* BleDeviceObject::WriteRequest(const WinRtGuid& serviceUuid, const WinRtGuid& charastricsUuid,
+	const uint8_t* src, int size, WinRtGattWriteOption option) {
 	WinRtBleCharacteristic* charastrics = this->GetCharastric(serviceUuid, charastricsUuid);
 	if (charastrics == nullptr) {
 		return nullptr;
@@ -146,7 +307,10 @@ WinRtAsyncOperation< WinRtGattWriteResult>* BleDeviceObject::WriteRequest(const
 		++ptr;
 		++src;
 	}
-	auto result = charastrics->WriteValueWithResultAsync(buf);
+	BLE_TIMELINE_INSTANT("writeRequest", size);
+	auto result = charastrics->WriteValueWithResultAsync(buf, option);
+	BleAdapterPool::GetInstance().OnWrite(m_adapterIndex, size);
+	BleTrace::GetInstance().WatchWrite(*charastrics, result, buf.data(), size);
 	auto it = m_writeRequest.insert(m_writeRequest.begin(), result);
 	return &(*it);
 }
@@ -156,7 +320,9 @@ WinRtAsyncOperation< WinRtGattReadResult>* BleDeviceObject::ReadRequest(const Wi
 	if (charastrics == nullptr) {
 		return nullptr;
 	}
+	BLE_TIMELINE_INSTANT("readRequest", 0);
 	auto result = charastrics->ReadValueAsync();
+	BleTrace::GetInstance().WatchRead(*charastrics, result);
 
 	auto it = m_readRequest.insert(m_readRequest.begin(),result);
 	return &(*it);
@@ -179,35 +345,336 @@ void BleDeviceObject::RemoveReadOperation(WinRtAsyncOperation< WinRtGattReadResu
 	}
 }
 
+BleGattOperation* BleDeviceObject::ScheduleWrite(const WinRtGuid& serviceUuid, const WinRtGuid& charastricsUuid,
+	const uint8_t* src, int size, WinRtGattWriteOption option, EOperationPriority priority) {
+	WinRtBleCharacteristic* charastrics = this->GetCharastric(serviceUuid, charastricsUuid);
+	if (charastrics == nullptr || src == nullptr || size < 0) {
+		return nullptr;
+	}
+	BleAdapterPool::GetInstance().OnWrite(m_adapterIndex, size);
+	return m_scheduler.EnqueueWrite(*charastrics, src, size, option, priority);
+}
+BleGattOperation* BleDeviceObject::ScheduleRead(const WinRtGuid& serviceUuid, const WinRtGuid& charastricsUuid, EOperationPriority priority) {
+	WinRtBleCharacteristic* charastrics = this->GetCharastric(serviceUuid, charastricsUuid);
+	if (charastrics == nullptr) {
+		return nullptr;
+	}
+	return m_scheduler.EnqueueRead(*charastrics, priority);
+}
+void BleDeviceObject::ReleaseOperation(BleGattOperation* operation) {
+	m_scheduler.Release(operation);
+}
+void BleDeviceObject::SetWriteCoalescing(const WinRtGuid& serviceUuid, const WinRtGuid& charastricsUuid, bool enable) {
+	WinRtBleCharacteristic* charastrics = this->GetCharastric(serviceUuid, charastricsUuid);
+	if (charastrics == nullptr) {
+		return;
+	}
+	m_scheduler.SetWriteCoalescing(*charastrics, enable);
+}
+void BleDeviceObject::SetReadCache(const WinRtGuid& serviceUuid, const WinRtGuid& charastricsUuid, float ttlMs) {
+	WinRtBleCharacteristic* charastrics = this->GetCharastric(serviceUuid, charastricsUuid);
+	if (charastrics == nullptr) {
+		return;
+	}
+	m_scheduler.SetReadCache(*charastrics, ttlMs);
+}
 
 void BleDeviceObject::SetValueChangeNotification(const WinRtGuid& serviceUuid, const WinRtGuid& charastricsUuid, bool isnotificate) {
 	WinRtBleCharacteristic* charastrics = this->GetCharastric(serviceUuid, charastricsUuid);
 	if (charastrics == nullptr) {
 		return;
 	}
+	int idx = static_cast<int>(charastrics - m_charastrictics.data());
+	auto subscription = std::find_if(m_subscriptions.begin(), m_subscriptions.end(),
+		[idx](const std::pair<int, winrt::event_token>& item) { return item.first == idx; });
 	if (isnotificate) {
+		// kept alive across a domain reload; the handler is already registered
+		if (subscription != m_subscriptions.end()) {
+			return;
+		}
 		charastrics->WriteClientCharacteristicConfigurationDescriptorAsync(WinRtCharacteristicConfigValue::Notify);
-		charastrics->ValueChanged(BleDeviceManager::Characteristic_ValueChanged);
+		m_subscriptions.emplace_back(idx, charastrics->ValueChanged(BleDeviceManager::Characteristic_ValueChanged));
 	}
 	else {
 		charastrics->WriteClientCharacteristicConfigurationDescriptorAsync(WinRtCharacteristicConfigValue::None);
-		charastrics->ValueChanged(nullptr);
+		if (subscription != m_subscriptions.end()) {
+			charastrics->ValueChanged(subscription->second);
+			m_subscriptions.erase(subscription);
+		}
+	}
+}
+
+bool BleDeviceObject::IsSubscribed(int charastricsIdx)const {
+	for (auto it = m_subscriptions.begin(); it != m_subscriptions.end(); ++it) {
+		if (it->first == charastricsIdx) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void BleDeviceObject::SetNotificationSubscriberId(const WinRtGuid& serviceUuid, const WinRtGuid& charastricsUuid, int32_t subscriberId) {
+	std::lock_guard lock(m_notificateMutex);
+	for (auto it = m_subscriberIds.begin(); it != m_subscriberIds.end(); ++it) {
+		if (it->serviceUuid == serviceUuid && it->charastricsUuid == charastricsUuid) {
+			if (subscriberId < 0) {
+				m_subscriberIds.erase(it);
+			}
+			else {
+				it->id = subscriberId;
+			}
+			return;
+		}
 	}
+	if (subscriberId >= 0) {
+		m_subscriberIds.push_back({ serviceUuid, charastricsUuid, subscriberId });
+	}
+	// this frame's drained notifications follow the change too (the app may resubscribe from a callback)
+	for (auto it = m_NotificateResult.begin(); it != m_NotificateResult.end(); ++it) {
+		if (it->GetCharastricsUuid() == charastricsUuid && it->GetServiceUuid() == serviceUuid) {
+			it->SetSubscriberId(subscriberId);
+		}
+	}
+}
+
+void BleDeviceObject::ClearNotificationSubscriberIds() {
+	std::lock_guard lock(m_notificateMutex);
+	m_subscriberIds.clear();
 }
 
-void BleDeviceObject::OnChangeValue(const WinRtGuid& serviceUuid, const WinRtGuid& charastricsUuid, uint8_t* data, int size) {
-	NotificateData notificateData(serviceUuid, charastricsUuid, data, size);
+int BleDeviceObject::GetBufferedNotificationNum() {
+	std::lock_guard lock(m_notificateMutex);
+	return static_cast<int>(m_NotificateBuffer.size());
+}
+uint32_t BleDeviceObject::GetDroppedNotificationNum() {
+	std::lock_guard lock(m_notificateMutex);
+	return m_droppedNotificationNum;
+}
+
+void BleDeviceObject::OnChangeValue(const WinRtGuid& serviceUuid, const WinRtGuid& charastricsUuid, const uint8_t* data, int size) {
+	BleTrace::GetInstance().RecordGatt(ETraceEvent::Notification, m_addr, serviceUuid, charastricsUuid, data, size);
+	BleAdapterPool::GetInstance().OnNotification(m_adapterIndex, size);
+	BLE_TIMELINE_INSTANT("notification", size);
+	int32_t subscriberId = -1;
 	{
 		std::lock_guard lock(m_notificateMutex);
-		this->m_NotificateBuffer.push_back(notificateData);
+		subscriberId = this->FindSubscriberId(serviceUuid, charastricsUuid);
+		if (!m_bulkReceivers.empty()) {
+			double nowMs = GetNowMs();
+			for (auto it = m_bulkReceivers.begin(); it != m_bulkReceivers.end(); ++it) {
+				if (it->IsTarget(serviceUuid, charastricsUuid)) {
+					it->OnPacket(data, size, nowMs);
+				}
+			}
+		}
+		if (!m_histories.empty()) {
+			BleSampleHistory* history = this->FindHistory(serviceUuid, charastricsUuid);
+			if (history != nullptr) {
+				history->Push(BleSampleHistory::GetHostTime(), data, size);
+			}
+		}
+		if (m_NotificateBuffer.size() >= MaxBufferedNotificationNum && BleSession::GetInstance().IsDetached()) {
+			m_NotificateBuffer.erase(m_NotificateBuffer.begin());
+			++m_droppedNotificationNum;
+		}
+		this->m_NotificateBuffer.emplace_back(serviceUuid, charastricsUuid, data, size);
+	}
+	static_assert(sizeof(WinRtGuid) == NotificationRecord::UuidSize, "the ring stores the guid bytes as is");
+	BleNotificationRing& ring = BleNotificationRing::GetInstance();
+	if (ring.IsEnabled()) {
+		ring.Push(m_addr, BleSampleHistory::GetHostTime(), reinterpret_cast<const uint8_t*>(&charastricsUuid),
+			subscriberId, data, size);
+	}
+}
+
+void BleDeviceObject::EnableSampleHistory(const WinRtGuid& serviceUuid, const WinRtGuid& charastricsUuid, int capacity,
+	const SampleField* fields, int fieldNum, int matchOffset, int matchValue) {
+	std::unique_ptr<BleSampleHistory> history(new BleSampleHistory(serviceUuid, charastricsUuid, capacity,
+		fields, fieldNum, matchOffset, matchValue));
+	std::lock_guard lock(m_notificateMutex);
+	for (auto it = m_histories.begin(); it != m_histories.end(); ++it) {
+		if ((*it)->IsTarget(serviceUuid, charastricsUuid)) {
+			*it = std::move(history);
+			return;
+		}
+	}
+	m_histories.push_back(std::move(history));
+}
+
+void BleDeviceObject::DisableSampleHistory(const WinRtGuid& serviceUuid, const WinRtGuid& charastricsUuid) {
+	std::lock_guard lock(m_notificateMutex);
+	m_histories.erase(std::remove_if(m_histories.begin(), m_histories.end(),
+		[&](const std::unique_ptr<BleSampleHistory>& history) { return history->IsTarget(serviceUuid, charastricsUuid); }),
+		m_histories.end());
+}
+
+int BleDeviceObject::CopySampleHistory(const WinRtGuid& serviceUuid, const WinRtGuid& charastricsUuid, HistorySample* out, int maxNum) {
+	std::lock_guard lock(m_notificateMutex);
+	BleSampleHistory* history = this->FindHistory(serviceUuid, charastricsUuid);
+	if (history == nullptr) {
+		return 0;
+	}
+	return history->CopyLatest(out, maxNum);
+}
+
+ESampleResult BleDeviceObject::SampleHistoryAt(const WinRtGuid& serviceUuid, const WinRtGuid& charastricsUuid,
+	double time, float maxExtrapolationSec, float* outValues, int maxValues) {
+	std::lock_guard lock(m_notificateMutex);
+	BleSampleHistory* history = this->FindHistory(serviceUuid, charastricsUuid);
+	if (history == nullptr) {
+		return ESampleResult::None;
+	}
+	return history->Sample(time, maxExtrapolationSec, outValues, maxValues);
+}
+
+BleSampleHistory* BleDeviceObject::FindHistory(const WinRtGuid& serviceUuid, const WinRtGuid& charastricsUuid) {
+	for (auto it = m_histories.begin(); it != m_histories.end(); ++it) {
+		if ((*it)->IsTarget(serviceUuid, charastricsUuid)) {
+			return it->get();
+		}
+	}
+	return nullptr;
+}
+
+int32_t BleDeviceObject::FindSubscriberId(const WinRtGuid& serviceUuid, const WinRtGuid& charastricsUuid)const {
+	for (auto it = m_subscriberIds.begin(); it != m_subscriberIds.end(); ++it) {
+		if (it->charastricsUuid == charastricsUuid && it->serviceUuid == serviceUuid) {
+			return it->id;
+		}
 	}
+	return -1;
+}
+
+BleBulkWriteTransfer* BleDeviceObject::StartBulkWrite(const WinRtGuid& serviceUuid, const WinRtGuid& charastricsUuid,
+	const uint8_t* src, int size, int chunkSize, int window, int checkpointInterval) {
+	WinRtBleCharacteristic* charastrics = this->GetCharastric(serviceUuid, charastricsUuid);
+	if (charastrics == nullptr || src == nullptr || size < 0 || !this->IsConnected()) {
+		return nullptr;
+	}
+	m_bulkWrites.emplace_back(*charastrics, src, size, (chunkSize > 0) ? chunkSize : DefaultBulkChunkSize,
+		window, checkpointInterval, GetNowMs());
+	BleBulkWriteTransfer* transfer = &m_bulkWrites.back();
+	// first window goes out with this frame's scheduler update
+	BleAdapterPool::GetInstance().OnWrite(m_adapterIndex, transfer->Update(m_scheduler, GetNowMs()));
+	return transfer;
+}
+
+BleBulkReceiver* BleDeviceObject::StartBulkReceive(const WinRtGuid& serviceUuid, const WinRtGuid& charastricsUuid,
+	int expectedSize, int headerSize) {
+	std::lock_guard lock(m_notificateMutex);
+	m_bulkReceivers.emplace_back(serviceUuid, charastricsUuid, expectedSize, headerSize, GetNowMs());
+	return &m_bulkReceivers.back();
+}
+
+bool BleDeviceObject::GetBulkTransferProgress(const void* transfer, BulkTransferProgress& out) {
+	double nowMs = GetNowMs();
+	for (auto it = m_bulkWrites.begin(); it != m_bulkWrites.end(); ++it) {
+		if (&(*it) == transfer) {
+			it->GetWriter().GetProgress(out, nowMs);
+			return true;
+		}
+	}
+	std::lock_guard lock(m_notificateMutex);
+	for (auto it = m_bulkReceivers.begin(); it != m_bulkReceivers.end(); ++it) {
+		if (&(*it) == transfer) {
+			it->GetProgress(out, nowMs);
+			return true;
+		}
+	}
+	return false;
+}
+
+int BleDeviceObject::CopyBulkReceiveData(const void* transfer, uint8_t* out, int maxSize) {
+	std::lock_guard lock(m_notificateMutex);
+	for (auto it = m_bulkReceivers.begin(); it != m_bulkReceivers.end(); ++it) {
+		if (&(*it) == transfer) {
+			const std::vector<uint8_t>& data = it->GetData();
+			int size = (std::min)(maxSize, static_cast<int>(data.size()));
+			if (out != nullptr && size > 0) {
+				memcpy(out, data.data(), size);
+			}
+			return size;
+		}
+	}
+	return 0;
+}
+
+void BleDeviceObject::CancelBulkTransfer(const void* transfer) {
+	double nowMs = GetNowMs();
+	for (auto it = m_bulkWrites.begin(); it != m_bulkWrites.end(); ++it) {
+		if (&(*it) == transfer) {
+			it->Cancel(m_scheduler, nowMs);
+			return;
+		}
+	}
+	std::lock_guard lock(m_notificateMutex);
+	for (auto it = m_bulkReceivers.begin(); it != m_bulkReceivers.end(); ++it) {
+		if (&(*it) == transfer) {
+			it->Finish(EBulkStatus::Cancelled, nowMs);
+			return;
+		}
+	}
+}
+
+void BleDeviceObject::ReleaseBulkTransfer(const void* transfer) {
+	for (auto it = m_bulkWrites.begin(); it != m_bulkWrites.end(); ++it) {
+		if (&(*it) == transfer) {
+			it->Cancel(m_scheduler, GetNowMs());
+			m_bulkWrites.erase(it);
+			return;
+		}
+	}
+	std::lock_guard lock(m_notificateMutex);
+	for (auto it = m_bulkReceivers.begin(); it != m_bulkReceivers.end(); ++it) {
+		if (&(*it) == transfer) {
+			m_bulkReceivers.erase(it);
+			return;
+		}
+	}
+}
+
+void BleDeviceObject::UpdateBulkTransfers() {
+	if (m_bulkWrites.empty()) {
+		return;
+	}
+	double nowMs = GetNowMs();
+	bool isConnected = this->IsConnected();
+	int issuedBytes = 0;
+	for (auto it = m_bulkWrites.begin(); it != m_bulkWrites.end(); ++it) {
+		if (it->GetWriter().GetStatus() != EBulkStatus::Running) {
+			continue;
+		}
+		if (!isConnected) {
+			it->Abort(m_scheduler, nowMs);
+			continue;
+		}
+		issuedBytes += it->Update(m_scheduler, nowMs);
+	}
+	if (issuedBytes > 0) {
+		BleAdapterPool::GetInstance().OnWrite(m_adapterIndex, issuedBytes);
+	}
+}
+
+void BleDeviceObject::SetReplayConnected(bool isConnected) {
+	if (!isConnected) {
+		this->Disconnect();
+		return;
+	}
+	// placed like a real connect, so the adapter counters see replayed traffic too
+	if (!m_replayConnected && m_adapterIndex < 0) {
+		m_adapterIndex = BleAdapterPool::GetInstance().Assign(m_addr);
+	}
+	m_replayConnected = true;
 }
 
 void BleDeviceObject::UpdateNotification() {
+	BLE_TIMELINE_SCOPE("drainNotification");
 	m_NotificateResult.clear();
 	std::lock_guard lock(m_notificateMutex);
 	for (auto it = m_NotificateBuffer.begin(); it != m_NotificateBuffer.end(); ++it) {
 		m_NotificateResult.push_back(*it);
+		// the current subscriber, not the one at arrival: ids are reused and a reloaded domain starts over
+		m_NotificateResult.back().SetSubscriberId(this->FindSubscriberId(it->GetServiceUuid(), it->GetCharastricsUuid()));
 	}
 	m_NotificateBuffer.clear();
 }
@@ -217,21 +684,71 @@ void BleDeviceObject::UpdateDisconectCheck() {
 		return;
 	}
 	if( this->m_device.ConnectionStatus() != WinRtBleConnectStatus::Connected){
+		BleTrace::GetInstance().RecordConnection(ETraceEvent::Disconnected, m_addr);
 		ClearDeviceInfo();
+		ReleaseAdapter();
         this->m_connectState = EConnectState::None;
     }
 }
+// closes the connect stage span a failed or cancelled connection was in
+void BleDeviceObject::EndTimelineStage() {
+	switch (m_connectState) {
+	case EConnectState::Connecting:
+		BLE_TIMELINE_ASYNC_END("connect", m_addr);
+		break;
+	case EConnectState::GattServiceRequesting:
+		BLE_TIMELINE_ASYNC_END("discoverServices", m_addr);
+		break;
+	case EConnectState::GattCharastricsRequesting:
+		BLE_TIMELINE_ASYNC_END("discoverCharacteristics", m_addr);
+		break;
+	default:
+		break;
+	}
+}
 void BleDeviceObject::ClearDeviceInfo() {
+	// the characteristics may outlive this object (BleTeardown closes them later), so nothing may
+	// call back into it once it is unpublished
+	for (auto it = m_subscriptions.begin(); it != m_subscriptions.end(); ++it) {
+		if (it->first < static_cast<int>(m_charastrictics.size())) {
+			m_charastrictics[it->first].ValueChanged(it->second);
+		}
+	}
+	m_subscriptions.clear();
 	m_services.clear();
 	m_charastrictics.clear();
 
+	m_serviceRequests.clear();
 	m_charastricsRequests.clear();
 
 	m_readRequest.clear();
 	m_writeRequest.clear();
+	m_scheduler.FailAll();
 
-	m_NotificateBuffer.clear();
 	m_NotificateResult.clear();
+	{
+		std::lock_guard lock(m_notificateMutex);
+		m_NotificateBuffer.clear();
+		m_droppedNotificationNum = 0;
+	}
+	{
+		// samples of the last connection would blend into the next one
+		std::lock_guard lock(m_notificateMutex);
+		for (auto it = m_histories.begin(); it != m_histories.end(); ++it) {
+			(*it)->Clear();
+		}
+		double nowMs = GetNowMs();
+		for (auto it = m_bulkReceivers.begin(); it != m_bulkReceivers.end(); ++it) {
+			it->Finish(EBulkStatus::Error, nowMs);
+		}
+	}
 
     m_device = WinRtBleDevice(nullptr);
 }
+void BleDeviceObject::ReleaseAdapter() {
+	if (m_adapterIndex < 0) {
+		return;
+	}
+	BleAdapterPool::GetInstance().Release(m_addr);
+	m_adapterIndex = -1;
+}
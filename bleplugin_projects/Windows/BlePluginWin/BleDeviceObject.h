@@ -1,6 +1,11 @@
 #pragma once
 
 #include "pch.h"
+#include "BleOperationScheduler.h"
+#include "BleSampleHistory.h"
+#include "BleBulkTransfer.h"
+#include <chrono>
+#include <memory>
 
 namespace BlePlugin {
 	class NotificateData {
@@ -12,6 +17,9 @@ namespace BlePlugin {
 		WinRtGuid charastrics;
 		uint8_t data[MaxDataSize];
 		int size;
+		// set by the app per characteristic, -1 when none. resolved when drained, so an id the app
+		// reused for another characteristic never reaches notifications of the old one
+		int32_t subscriberId;
 	private:
 		void SetData(const uint8_t* src, int length) {
 			for (int i = 0; i < length && i < sizeof(data); ++i) {
@@ -20,20 +28,22 @@ namespace BlePlugin {
 		}
 	public:
 		NotificateData(const WinRtGuid &_service,
-			const WinRtGuid& _charastrics,uint8_t* _data,int _size) :
-			service(_service), charastrics(_charastrics),size(_size),data()
+			const WinRtGuid& _charastrics,const uint8_t* _data,int _size, int32_t _subscriberId = -1) :
+			service(_service), charastrics(_charastrics),size(_size),subscriberId(_subscriberId),data()
 		{
 			SetData(_data, _size);
 		}
 		NotificateData(const NotificateData& src) :
 			service (src.service),charastrics(src.charastrics),
-			size(src.size), data()
+			size(src.size), subscriberId(src.subscriberId), data()
 		{
 			SetData(src.data, src.size);
 		}
 		NotificateData& operator =(const NotificateData& src) {
 			this->service = src.service;
 			this->charastrics = src.charastrics;
+			this->size = src.size;
+			this->subscriberId = src.subscriberId;
 			SetData(src.data, src.size);
 			return *this;
 		}
@@ -49,10 +59,22 @@ namespace BlePlugin {
 		inline int GetSize()const {
 			return size;
 		}
+		inline int32_t GetSubscriberId()const {
+			return subscriberId;
+		}
+		inline void SetSubscriberId(int32_t id) {
+			subscriberId = id;
+		}
 
 	};
 
 	class BleDeviceObject {
+	public:
+		// while the session is detached nobody drains the buffer: the oldest notifications are dropped past this.
+		// attached, the app drains every frame and nothing is dropped however bursty the link is
+		static const int MaxBufferedNotificationNum = 256;
+		// payload of a write on the default 23 byte ATT MTU
+		static const int DefaultBulkChunkSize = 20;
 	private:
 		enum class EConnectState {
 			None = 0,
@@ -64,13 +86,16 @@ namespace BlePlugin {
 
 
 		WinRtAsyncOperation<WinRtBleDevice> m_connectAsync;
-		WinRtAsyncOperation<WinRtBleGattServiceResult> m_connectGattAsync;
+		// one GetGattServicesForUuidAsync per filtered service, or a single GetGattServicesAsync without a filter
+		std::vector<WinRtAsyncOperation<WinRtBleGattServiceResult> > m_serviceRequests;
 
 		uint64_t m_addr;
 		WinRtBleDevice m_device;
 
 		std::vector<WinRtBleGattService> m_services;
 		std::vector<WinRtBleCharacteristic> m_charastrictics;
+		// empty means discover every service on the device
+		std::vector<WinRtGuid> m_serviceFilter;
 
 		std::vector<WinRtAsyncOperation<WinRtBleCharacteristicsResult> > m_charastricsRequests;
 		EConnectState m_connectState;
@@ -80,24 +105,105 @@ namespace BlePlugin {
 		std::vector< NotificateData> m_NotificateBuffer;
 		std::vector< NotificateData> m_NotificateResult;
 		std::mutex m_notificateMutex;
+		// dropped by the detached cap since connect, guarded by m_notificateMutex
+		uint32_t m_droppedNotificationNum;
+		// bulk receivers are guarded by m_notificateMutex (fed from the notification thread)
+		std::list<BleBulkWriteTransfer> m_bulkWrites;
+		std::list<BleBulkReceiver> m_bulkReceivers;
+		// characteristic index and ValueChanged registration of every subscription
+		std::vector<std::pair<int, winrt::event_token> > m_subscriptions;
+		// opt-in per characteristic, guarded by m_notificateMutex
+		std::vector<std::unique_ptr<BleSampleHistory> > m_histories;
+		struct NotificationSubscriber {
+			WinRtGuid serviceUuid;
+			WinRtGuid charastricsUuid;
+			int32_t id;
+		};
+		// stamped on every notification of the characteristic, guarded by m_notificateMutex
+		std::vector<NotificationSubscriber> m_subscriberIds;
+
+		BleOperationScheduler m_scheduler;
+		// connected by BleTraceReplayer instead of the radio
+		bool m_replayConnected;
+		// BleAdapterPool slot, -1 while unassigned
+		int m_adapterIndex;
+
+		// BleDeviceManager bookkeeping
+		bool m_isActive;
+		std::chrono::steady_clock::time_point m_idleSince;
+		friend class BleDeviceManager;
 
 	public:
 		BleDeviceObject(uint64_t addr);
 
 		bool IsConnected()const;
+		// still connected at the radio, checked without waiting for Update
+		bool IsLinkAlive()const;
 		void ConnectRequest();
+		void ConnectRequest(const std::vector<WinRtGuid>& serviceFilter);
 		void Disconnect();
+		// Disconnect without closing: the caller gets the services and device to close
+		void DetachConnection(std::vector<WinRtBleGattService>& services, WinRtBleDevice& device);
 		void Update();
+		// disconnected with nothing pending; the manager stops updating it
+		bool IsIdle()const;
+		// drop everything and free the buffers before the object goes to the pool
+		void Recycle();
+		// a pooled object takes over another address
+		void Reuse(uint64_t addr);
+		size_t GetResidentBytes();
 
 		WinRtAsyncOperation< WinRtGattWriteResult>* WriteRequest(const WinRtGuid& serviceUuid, const WinRtGuid& charastricsUuid,
 			const uint8_t* src, int size);
+		WinRtAsyncOperation< WinRtGattWriteResult>* WriteRequest(const WinRtGuid& serviceUuid, const WinRtGuid& charastricsUuid,
+			const uint8_t* src, int size, WinRtGattWriteOption option);
 		WinRtAsyncOperation< WinRtGattReadResult>* ReadRequest(const WinRtGuid& serviceUuid, const WinRtGuid& charastricsUuid);
 
 		void RemoveWriteOperation(WinRtAsyncOperation< WinRtGattWriteResult>* operation);
 		void RemoveReadOperation(WinRtAsyncOperation< WinRtGattReadResult>* operation);
 
+		// paced operations through the per device scheduler
+		BleGattOperation* ScheduleWrite(const WinRtGuid& serviceUuid, const WinRtGuid& charastricsUuid,
+			const uint8_t* src, int size, WinRtGattWriteOption option, EOperationPriority priority);
+		BleGattOperation* ScheduleRead(const WinRtGuid& serviceUuid, const WinRtGuid& charastricsUuid, EOperationPriority priority);
+		void ReleaseOperation(BleGattOperation* operation);
+		void SetWriteCoalescing(const WinRtGuid& serviceUuid, const WinRtGuid& charastricsUuid, bool enable);
+		void SetReadCache(const WinRtGuid& serviceUuid, const WinRtGuid& charastricsUuid, float ttlMs);
+		inline BleOperationScheduler& GetScheduler() {
+			return m_scheduler;
+		}
+
+		// bulk transfers; the returned handle stays valid until ReleaseBulkTransfer (or Recycle)
+		BleBulkWriteTransfer* StartBulkWrite(const WinRtGuid& serviceUuid, const WinRtGuid& charastricsUuid,
+			const uint8_t* src, int size, int chunkSize, int window, int checkpointInterval);
+		BleBulkReceiver* StartBulkReceive(const WinRtGuid& serviceUuid, const WinRtGuid& charastricsUuid,
+			int expectedSize, int headerSize);
+		bool GetBulkTransferProgress(const void* transfer, BulkTransferProgress& out);
+		int CopyBulkReceiveData(const void* transfer, uint8_t* out, int maxSize);
+		void CancelBulkTransfer(const void* transfer);
+		void ReleaseBulkTransfer(const void* transfer);
+
 		void SetValueChangeNotification(const WinRtGuid& serviceUuid, const WinRtGuid& charastricsUuid,bool isnotificate);
-		void OnChangeValue(const WinRtGuid& serviceUuid, const WinRtGuid& charastricsUuid,uint8_t *data, int length);
+		void OnChangeValue(const WinRtGuid& serviceUuid, const WinRtGuid& charastricsUuid,const uint8_t *data, int length);
+		bool IsSubscribed(int charastricsIdx)const;
+		// the app's own id for the characteristic (index into its handler table); < 0 removes it
+		void SetNotificationSubscriberId(const WinRtGuid& serviceUuid, const WinRtGuid& charastricsUuid, int32_t subscriberId);
+		// the ids belong to one managed domain; dropped when the session detaches or reattaches
+		void ClearNotificationSubscriberIds();
+
+		// timestamped notification history of one characteristic (replaces an existing one)
+		void EnableSampleHistory(const WinRtGuid& serviceUuid, const WinRtGuid& charastricsUuid, int capacity,
+			const SampleField* fields, int fieldNum, int matchOffset, int matchValue);
+		void DisableSampleHistory(const WinRtGuid& serviceUuid, const WinRtGuid& charastricsUuid);
+		int CopySampleHistory(const WinRtGuid& serviceUuid, const WinRtGuid& charastricsUuid, HistorySample* out, int maxNum);
+		ESampleResult SampleHistoryAt(const WinRtGuid& serviceUuid, const WinRtGuid& charastricsUuid,
+			double time, float maxExtrapolationSec, float* outValues, int maxValues);
+		int GetBufferedNotificationNum();
+		uint32_t GetDroppedNotificationNum();
+		void SetReplayConnected(bool isConnected);
+		inline bool IsReplayConnected()const {
+			return m_replayConnected;
+		}
 
 		int GetNofiticateNum()const {
 			return static_cast<int>(m_NotificateResult.size());
@@ -109,6 +215,9 @@ namespace BlePlugin {
 		inline uint64_t GetAddr()const {
 			return this->m_addr;
 		}
+		inline int GetAdapterIndex()const {
+			return this->m_adapterIndex;
+		}
 
 		inline int GetCharastricsNum()const {
 			return static_cast<int>( this->m_charastrictics.size());
@@ -118,12 +227,21 @@ namespace BlePlugin {
 		}
 	private:
 		WinRtBleCharacteristic* GetCharastric(const WinRtGuid& serviceUuid, const WinRtGuid& charastricsUuid);
+		void RequestGattServices();
+		void UpdateGattServices();
 		void SetupGattServices(const WinRtBleGattServiceResult& result);
+		bool IsTargetService(const WinRtGuid& serviceUuid)const;
 		void UpdateCharacterisc();
 		void SetupCharacterisc(const WinRtBleCharacteristicsResult& result);
 
 		void UpdateNotification();
+		void UpdateBulkTransfers();
 		void UpdateDisconectCheck();
 		void ClearDeviceInfo();
+		void ReleaseAdapter();
+		BleSampleHistory* FindHistory(const WinRtGuid& serviceUuid, const WinRtGuid& charastricsUuid);
+		// m_notificateMutex held
+		int32_t FindSubscriberId(const WinRtGuid& serviceUuid, const WinRtGuid& charastricsUuid)const;
+		void EndTimelineStage();
 	};
 }
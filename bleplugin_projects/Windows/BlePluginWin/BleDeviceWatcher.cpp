@@ -1,5 +1,8 @@
 #include "BleDeviceWatcher.h"
 #include "Utility.h"
+#include "BleTrace.h"
+#include "BleAdapterPool.h"
+#include "BleStartup.h"
 #include <time.h>
 
 using namespace BlePlugin;
@@ -71,6 +74,7 @@ void BleDeviceWatcher::Start() {
     m_watcher.ScanningMode(WinRtBleScanMode::Passive);
     m_watcher.Received(BleDeviceWatcher::ReceiveCallBack);
     m_watcher.Start();
+    BleStartup::GetInstance().Mark(EStartupEvent::ScanStarted);
 
 }
 void BleDeviceWatcher::Stop() {
@@ -80,14 +84,28 @@ void BleDeviceWatcher::Stop() {
 void BleDeviceWatcher::UpdateCache() {
 
 	clock_t current = clock();
-	std::lock_guard lock(mtx);
-	m_cacheData.clear();
-	for (auto it = m_DeviceMap.begin();
-		it != m_DeviceMap.end(); ++it) {
-		if (it->second.IsTimeout(current)) {
-			continue;
+	std::vector<uint64_t> expired;
+	{
+		std::lock_guard lock(mtx);
+		m_cacheData.clear();
+		for (auto it = m_DeviceMap.begin();
+			it != m_DeviceMap.end(); ) {
+			// a device that stops advertising comes back through OnAdvertisement
+			if (it->second.IsTimeout(current)) {
+				expired.push_back(it->first);
+				it = m_DeviceMap.erase(it);
+				continue;
+			}
+			m_cacheData.push_back(it->second);
+			++it;
 		}
-		m_cacheData.push_back(it->second);
+	}
+	if (!m_cacheData.empty()) {
+		BleStartup::GetInstance().Mark(EStartupEvent::FirstDeviceListed);
+	}
+	BleAdapterPool& pool = BleAdapterPool::GetInstance();
+	for (auto it = expired.begin(); it != expired.end(); ++it) {
+		pool.ForgetRssi(*it);
 	}
 }
 
@@ -134,7 +152,6 @@ void BleDeviceWatcher::OnReceive(
 	WinRtBleAdvertiseWatcher sender,
 	WinRtBleAdvertiseRecieveEventArg args)
 {
-	std::lock_guard lock(mtx);
 	int rssi = args.RawSignalStrengthInDBm();
 	uint64_t addr = args.BluetoothAddress();
 	auto advertisement = args.Advertisement();
@@ -160,6 +177,16 @@ void BleDeviceWatcher::OnReceive(
     int nameSize = advertisement.LocalName().size();
 #endif
 
+    BleTrace::GetInstance().RecordAdvertisement(addr, rssi);
+    this->OnAdvertisement(addr, rssi);
+}
+
+void BleDeviceWatcher::OnAdvertisement(uint64_t addr, int rssi) {
+    // the WinRT watcher only listens on the default adapter
+    BleStartup::GetInstance().Mark(EStartupEvent::FirstAdvertisement);
+    BleAdapterPool& pool = BleAdapterPool::GetInstance();
+    pool.ReportRssi(pool.GetDefaultIndex(), addr, rssi);
+    std::lock_guard lock(mtx);
     auto findIt = m_DeviceMap.find(addr);
     if (findIt == m_DeviceMap.end()) {
         DeviceInfo deviceInfo("", addr, rssi);
@@ -59,6 +59,8 @@ namespace BlePlugin {
 		int GetRssi(int idx)const;
 
 		void OnConnectDevice(uint64_t addr);
+		// also used by BleTraceReplayer
+		void OnAdvertisement(uint64_t addr, int rssi);
 
 	private:
 
@@ -0,0 +1,221 @@
+#include "BleLinkEmulator.h"
+#include <algorithm>
+#include <cstring>
+
+using namespace BlePlugin;
+
+// LinkParams
+LinkParams LinkParams::Default() {
+	LinkParams params;
+	params.connectionIntervalMs = 7.5;
+	params.packetsPerEvent = 4;
+	params.attMtu = 23;
+	params.linkPayloadSize = 27;
+	params.lossRate = 0.02f;
+	params.fadeRate = 0.0f;
+	params.fadeMs = 0.0;
+	params.supervisionTimeoutMs = 2000.0;
+	params.reconnectDelayMs = 500.0;
+	params.txQueueSize = 32;
+	return params;
+}
+
+// BleLinkEmulator
+BleLinkEmulator::BleLinkEmulator(uint32_t seed, BleLinkSink& sink) :
+	m_sink(sink), m_nowMs(0.0), m_random((seed != 0) ? seed : 1), m_latencyBins(LatencyBinNum, 0),
+	m_latencyNum(0), m_maxLatencyMs(0.0)
+{
+}
+
+BleLinkEmulator::~BleLinkEmulator() {
+	this->RemoveAll();
+}
+
+void BleLinkEmulator::AddLink(uint64_t addr, const LinkParams& params) {
+	if (this->FindLink(addr) != nullptr) {
+		return;
+	}
+	Link link;
+	link.addr = addr;
+	link.params = params;
+	link.params.connectionIntervalMs = (std::max)(params.connectionIntervalMs, 1.25);
+	link.params.packetsPerEvent = (std::max)(params.packetsPerEvent, 1);
+	link.params.attMtu = (std::max)(params.attMtu, 23);
+	link.params.linkPayloadSize = (std::max)(params.linkPayloadSize, 27);
+	link.params.txQueueSize = (std::max)(params.txQueueSize, 1);
+	link.isConnected = true;
+	link.nextEventMs = m_nowMs + this->NextRandom() * link.params.connectionIntervalMs;
+	link.lastGoodEventMs = m_nowMs;
+	link.fadeUntilMs = 0.0;
+	link.reconnectAtMs = 0.0;
+	link.stats = {};
+	m_links.push_back(link);
+	m_sink.OnConnected(addr);
+}
+
+void BleLinkEmulator::RemoveAll() {
+	for (auto it = m_links.begin(); it != m_links.end(); ++it) {
+		if (it->isConnected) {
+			m_sink.OnDisconnected(it->addr);
+		}
+	}
+	m_links.clear();
+}
+
+bool BleLinkEmulator::Notify(uint64_t addr, const uint8_t* serviceUuid, const uint8_t* charastricsUuid,
+	const uint8_t* data, int size) {
+	Link* link = this->FindLink(addr);
+	if (link == nullptr) {
+		return false;
+	}
+	++link->stats.queuedNum;
+	if (!link->isConnected || static_cast<int>(link->txQueue.size()) >= link->params.txQueueSize) {
+		++link->stats.droppedNum;
+		return false;
+	}
+	Pending pending;
+	memcpy(pending.serviceUuid, serviceUuid, UuidSize);
+	memcpy(pending.charastricsUuid, charastricsUuid, UuidSize);
+	pending.size = (std::min)((std::min)(size, link->params.attMtu - 3), MaxDataSize);
+	pending.size = (std::max)(pending.size, 0);
+	memcpy(pending.data, data, pending.size);
+	// ATT opcode + handle, then the L2CAP header
+	pending.fragmentNum = (pending.size + 3 + 4 + link->params.linkPayloadSize - 1) / link->params.linkPayloadSize;
+	pending.sentFragmentNum = 0;
+	pending.queuedMs = m_nowMs;
+	link->txQueue.push_back(pending);
+	return true;
+}
+
+void BleLinkEmulator::AdvanceTo(double nowMs) {
+	for (auto it = m_links.begin(); it != m_links.end(); ++it) {
+		Link& link = *it;
+		if (!link.isConnected) {
+			if (link.params.reconnectDelayMs < 0.0 || link.reconnectAtMs > nowMs) {
+				continue;
+			}
+			link.isConnected = true;
+			link.lastGoodEventMs = link.reconnectAtMs;
+			link.nextEventMs = link.reconnectAtMs + link.params.connectionIntervalMs;
+			m_sink.OnConnected(link.addr);
+		}
+		while (link.isConnected && link.nextEventMs <= nowMs) {
+			double eventMs = link.nextEventMs;
+			link.nextEventMs += link.params.connectionIntervalMs;
+			this->RunEvent(link, eventMs);
+		}
+	}
+	m_nowMs = (std::max)(m_nowMs, nowMs);
+}
+
+void BleLinkEmulator::RunEvent(Link& link, double eventMs) {
+	++link.stats.eventNum;
+	if (eventMs >= link.fadeUntilMs && link.params.fadeRate > 0.0f && this->NextRandom() < link.params.fadeRate) {
+		link.fadeUntilMs = eventMs + link.params.fadeMs;
+	}
+	bool isFading = eventMs < link.fadeUntilMs;
+	// an event with nothing to send still exchanges empty packets, which can be lost as well
+	bool isGood = !isFading && this->NextRandom() >= link.params.lossRate;
+	for (int i = 0; i < link.params.packetsPerEvent && !link.txQueue.empty() && !isFading; ++i) {
+		if (this->NextRandom() < link.params.lossRate) {
+			// not acknowledged: the event closes and the same packet goes first next time
+			++link.stats.retransmitNum;
+			break;
+		}
+		isGood = true;
+		Pending& front = link.txQueue.front();
+		if (++front.sentFragmentNum < front.fragmentNum) {
+			continue;
+		}
+		this->Deliver(link, front, eventMs);
+		link.txQueue.pop_front();
+	}
+	if (isGood) {
+		link.lastGoodEventMs = eventMs;
+	}
+	else if (eventMs - link.lastGoodEventMs >= link.params.supervisionTimeoutMs) {
+		this->Disconnect(link, eventMs);
+	}
+}
+
+void BleLinkEmulator::Deliver(Link& link, const Pending& pending, double eventMs) {
+	if (!m_sink.OnNotification(link.addr, pending.serviceUuid, pending.charastricsUuid, pending.data, pending.size)) {
+		++link.stats.droppedNum;
+		return;
+	}
+	++link.stats.deliveredNum;
+	double latencyMs = eventMs - pending.queuedMs;
+	int bin = (std::min)(static_cast<int>(latencyMs), LatencyBinNum - 1);
+	++m_latencyBins[(std::max)(bin, 0)];
+	++m_latencyNum;
+	m_maxLatencyMs = (std::max)(m_maxLatencyMs, latencyMs);
+}
+
+void BleLinkEmulator::Disconnect(Link& link, double eventMs) {
+	link.isConnected = false;
+	link.stats.droppedNum += link.txQueue.size();
+	link.txQueue.clear();
+	link.fadeUntilMs = 0.0;
+	link.reconnectAtMs = eventMs + link.params.reconnectDelayMs;
+	++link.stats.disconnectNum;
+	m_sink.OnDisconnected(link.addr);
+}
+
+bool BleLinkEmulator::IsConnected(uint64_t addr)const {
+	const Link* link = this->FindLink(addr);
+	return (link != nullptr && link->isConnected);
+}
+
+void BleLinkEmulator::GetStats(LinkStats& out)const {
+	out = {};
+	for (auto it = m_links.begin(); it != m_links.end(); ++it) {
+		out.queuedNum += it->stats.queuedNum;
+		out.deliveredNum += it->stats.deliveredNum;
+		out.droppedNum += it->stats.droppedNum;
+		out.retransmitNum += it->stats.retransmitNum;
+		out.eventNum += it->stats.eventNum;
+		out.disconnectNum += it->stats.disconnectNum;
+	}
+}
+
+double BleLinkEmulator::GetLatencyPercentileMs(double percentile)const {
+	if (m_latencyNum == 0) {
+		return 0.0;
+	}
+	uint64_t target = static_cast<uint64_t>(percentile * static_cast<double>(m_latencyNum - 1));
+	uint64_t count = 0;
+	for (int i = 0; i < LatencyBinNum; ++i) {
+		count += m_latencyBins[i];
+		if (count > target) {
+			// upper edge of the bin, so a target is never met by rounding down
+			return static_cast<double>(i + 1);
+		}
+	}
+	return m_maxLatencyMs;
+}
+
+BleLinkEmulator::Link* BleLinkEmulator::FindLink(uint64_t addr) {
+	for (auto it = m_links.begin(); it != m_links.end(); ++it) {
+		if (it->addr == addr) {
+			return &(*it);
+		}
+	}
+	return nullptr;
+}
+
+const BleLinkEmulator::Link* BleLinkEmulator::FindLink(uint64_t addr)const {
+	for (auto it = m_links.begin(); it != m_links.end(); ++it) {
+		if (it->addr == addr) {
+			return &(*it);
+		}
+	}
+	return nullptr;
+}
+
+float BleLinkEmulator::NextRandom() {
+	// xorshift32, fixed per seed
+	m_random ^= m_random << 13;
+	m_random ^= m_random >> 17;
+	m_random ^= m_random << 5;
+	return static_cast<float>(m_random >> 8) / 16777216.0f;
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+namespace BlePlugin {
+	// receives what the links hand over. uuids are in UuidCodec::ToBytes order.
+	class BleLinkSink {
+	public:
+		virtual ~BleLinkSink() {}
+		virtual void OnConnected(uint64_t addr) = 0;
+		virtual void OnDisconnected(uint64_t addr) = 0;
+		// false when nobody took it (no such device); counted as dropped
+		virtual bool OnNotification(uint64_t addr, const uint8_t* serviceUuid, const uint8_t* charastricsUuid,
+			const uint8_t* data, int size) = 0;
+	};
+
+	struct LinkParams {
+		double connectionIntervalMs;
+		// link layer packets the central polls per connection event
+		int packetsPerEvent;
+		int attMtu;
+		// link layer payload, 27 without data length extension
+		int linkPayloadSize;
+		// chance a packet is not acknowledged; it is resent on the next event
+		float lossRate;
+		// chance per event of a fade that drops every packet for fadeMs
+		float fadeRate;
+		double fadeMs;
+		double supervisionTimeoutMs;
+		// < 0: stay disconnected
+		double reconnectDelayMs;
+		// notifications the peripheral can hold, newer ones are dropped
+		int txQueueSize;
+
+		static LinkParams Default();
+	};
+
+	struct LinkStats {
+		uint64_t queuedNum;
+		uint64_t deliveredNum;
+		// dropped by a full tx queue, a disconnected link or a supervision timeout
+		uint64_t droppedNum;
+		uint64_t retransmitNum;
+		uint64_t eventNum;
+		uint64_t disconnectNum;
+	};
+
+	// radio link model between simulated peripherals and the plugin, on a virtual clock.
+	// every link runs its own connection events (staggered anchors); notifications queued by
+	// Notify are fragmented into link layer packets, resent on loss and handed to the sink once
+	// the last fragment got through. a link that has no good event for the supervision timeout
+	// disconnects. the model itself knows nothing of the plugin, so it builds off Windows; the
+	// plugin side is a sink that feeds the replay path (AttachReplayDevice / OnChangeValue).
+	// nothing sleeps: AdvanceTo runs as fast as the host can, and a fixed seed replays the same run.
+	class BleLinkEmulator {
+	public:
+		static constexpr int LatencyBinNum = 1000;
+		static constexpr int UuidSize = 16;
+		// NotificateData::MaxDataSize
+		static constexpr int MaxDataSize = 22;
+	private:
+		struct Pending {
+			uint8_t serviceUuid[UuidSize];
+			uint8_t charastricsUuid[UuidSize];
+			uint8_t data[MaxDataSize];
+			int size;
+			int fragmentNum;
+			int sentFragmentNum;
+			double queuedMs;
+		};
+		struct Link {
+			uint64_t addr;
+			LinkParams params;
+			bool isConnected;
+			double nextEventMs;
+			double lastGoodEventMs;
+			double fadeUntilMs;
+			double reconnectAtMs;
+			std::deque<Pending> txQueue;
+			LinkStats stats;
+		};
+
+		BleLinkSink& m_sink;
+		std::vector<Link> m_links;
+		double m_nowMs;
+		uint32_t m_random;
+		// queued -> handed to the device, 1ms bins, the last one catches everything slower
+		std::vector<uint64_t> m_latencyBins;
+		uint64_t m_latencyNum;
+		double m_maxLatencyMs;
+	public:
+		BleLinkEmulator(uint32_t seed, BleLinkSink& sink);
+		~BleLinkEmulator();
+
+		// connects right away
+		void AddLink(uint64_t addr, const LinkParams& params);
+		void RemoveAll();
+
+		// peripheral side; truncated to the ATT MTU like the stack would. false when dropped
+		bool Notify(uint64_t addr, const uint8_t* serviceUuid, const uint8_t* charastricsUuid,
+			const uint8_t* data, int size);
+		// runs every connection event due up to nowMs
+		void AdvanceTo(double nowMs);
+
+		inline double GetNowMs()const {
+			return m_nowMs;
+		}
+		bool IsConnected(uint64_t addr)const;
+		// all links summed
+		void GetStats(LinkStats& out)const;
+		// percentile in [0,1] of queued -> delivered
+		double GetLatencyPercentileMs(double percentile)const;
+		inline double GetMaxLatencyMs()const {
+			return m_maxLatencyMs;
+		}
+	private:
+		Link* FindLink(uint64_t addr);
+		const Link* FindLink(uint64_t addr)const;
+		void RunEvent(Link& link, double eventMs);
+		void Deliver(Link& link, const Pending& pending, double eventMs);
+		void Disconnect(Link& link, double eventMs);
+		float NextRandom();
+	};
+}
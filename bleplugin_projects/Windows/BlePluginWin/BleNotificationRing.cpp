@@ -0,0 +1,156 @@
+#include "BleNotificationRing.h"
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cstdlib>
+#endif
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+using namespace BlePlugin;
+
+BleNotificationRing BleNotificationRing::s_instance;
+
+namespace {
+	const size_t RegionAlignment = 4096;
+
+	// zeroed and page aligned; it never moves until FreeRegion
+	void* AllocateRegion(size_t size) {
+#ifdef _WIN32
+		return VirtualAlloc(nullptr, size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+#else
+		size = (size + RegionAlignment - 1) / RegionAlignment * RegionAlignment;
+		void* region = std::aligned_alloc(RegionAlignment, size);
+		if (region != nullptr) {
+			memset(region, 0, size);
+		}
+		return region;
+#endif
+	}
+
+	void FreeRegion(void* region) {
+#ifdef _WIN32
+		VirtualFree(region, 0, MEM_RELEASE);
+#else
+		std::free(region);
+#endif
+	}
+}
+
+BleNotificationRing::BleNotificationRing() :
+	m_isEnabled(false), m_header(nullptr), m_records(nullptr)
+{
+}
+
+BleNotificationRing& BleNotificationRing::GetInstance() {
+	return s_instance;
+}
+
+NotificationRingHeader* BleNotificationRing::Enable(int capacity) {
+	uint32_t recordNum = 16;
+	while (recordNum < static_cast<uint32_t>((std::min)(capacity, MaxCapacity))) {
+		recordNum <<= 1;
+	}
+	std::lock_guard lock(m_producerMutex);
+	if (m_header != nullptr) {
+		if (m_header->capacity == recordNum) {
+			return m_header;
+		}
+		m_isEnabled.store(false, std::memory_order_relaxed);
+		FreeRegion(m_header);
+		m_header = nullptr;
+		m_records = nullptr;
+	}
+	// the region never moves, so the reader can keep raw pointers
+	size_t regionSize = sizeof(NotificationRingHeader) + static_cast<size_t>(recordNum) * sizeof(NotificationRecord);
+	void* region = AllocateRegion(regionSize);
+	if (region == nullptr) {
+		return nullptr;
+	}
+	m_header = new(region) NotificationRingHeader();
+	m_header->magic = NotificationRingHeader::Magic;
+	m_header->version = NotificationRingHeader::CurrentVersion;
+	m_header->recordSize = sizeof(NotificationRecord);
+	m_header->capacity = recordNum;
+	m_header->recordOffset = sizeof(NotificationRingHeader);
+	m_header->writeCursor.store(0, std::memory_order_relaxed);
+	m_header->droppedNum.store(0, std::memory_order_relaxed);
+	m_header->readCursor.store(0, std::memory_order_relaxed);
+	m_records = reinterpret_cast<NotificationRecord*>(reinterpret_cast<uint8_t*>(region) + m_header->recordOffset);
+	m_isEnabled.store(true, std::memory_order_release);
+	return m_header;
+}
+
+void BleNotificationRing::Disable() {
+	m_isEnabled.store(false, std::memory_order_relaxed);
+	std::lock_guard lock(m_producerMutex);
+	if (m_header == nullptr) {
+		return;
+	}
+	FreeRegion(m_header);
+	m_header = nullptr;
+	m_records = nullptr;
+}
+
+bool BleNotificationRing::Push(uint64_t addr, double time, const uint8_t* charastricsUuid, int32_t subscriberId,
+	const uint8_t* data, int size) {
+	if (!m_isEnabled.load(std::memory_order_acquire)) {
+		return false;
+	}
+	std::lock_guard lock(m_producerMutex);
+	if (m_header == nullptr) {
+		return false;
+	}
+	// only this side writes writeCursor, the mutex orders the producers
+	uint64_t write = m_header->writeCursor.load(std::memory_order_relaxed);
+	uint64_t read = m_header->readCursor.load(std::memory_order_acquire);
+	if (write - read >= m_header->capacity) {
+		m_header->droppedNum.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+	NotificationRecord& record = m_records[write & (m_header->capacity - 1)];
+	size = (std::max)((std::min)(size, static_cast<int>(NotificationRecord::MaxDataSize)), 0);
+	record.addr = addr;
+	record.time = time;
+	memcpy(record.charastricsUuid, charastricsUuid, NotificationRecord::UuidSize);
+	record.subscriberId = subscriberId;
+	record.size = static_cast<uint8_t>(size);
+	record.reserved0 = 0;
+	memcpy(record.data, data, size);
+	record.reserved1 = 0;
+	m_header->writeCursor.store(write + 1, std::memory_order_release);
+	return true;
+}
+
+void BleNotificationRing::ClearSubscriberIds() {
+	std::lock_guard lock(m_producerMutex);
+	if (m_header == nullptr) {
+		return;
+	}
+	uint64_t write = m_header->writeCursor.load(std::memory_order_relaxed);
+	for (uint64_t i = m_header->readCursor.load(std::memory_order_acquire); i < write; ++i) {
+		m_records[i & (m_header->capacity - 1)].subscriberId = -1;
+	}
+}
+
+int BleNotificationRing::Acquire(NotificationRingHeader* header, const NotificationRecord** out) {
+	uint64_t write = header->writeCursor.load(std::memory_order_acquire);
+	uint64_t read = header->readCursor.load(std::memory_order_relaxed);
+	uint64_t slot = read & (header->capacity - 1);
+	uint64_t num = (std::min)(write - read, header->capacity - slot);
+	*out = reinterpret_cast<const NotificationRecord*>(reinterpret_cast<const uint8_t*>(header) + header->recordOffset) + slot;
+	return static_cast<int>(num);
+}
+
+void BleNotificationRing::Release(NotificationRingHeader* header, int num) {
+	if (num <= 0) {
+		return;
+	}
+	// never past what was published: a read cursor ahead of the write cursor would hand the
+	// producers slots the reader still holds
+	uint64_t write = header->writeCursor.load(std::memory_order_acquire);
+	uint64_t read = header->readCursor.load(std::memory_order_relaxed);
+	uint64_t releaseNum = (std::min)(static_cast<uint64_t>(num), write - read);
+	header->readCursor.store(read + releaseNum, std::memory_order_release);
+}
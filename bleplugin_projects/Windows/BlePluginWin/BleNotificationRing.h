@@ -0,0 +1,97 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+namespace BlePlugin {
+	// one notification (same layout as NotificationRecord in DllInterface.cs), a cache line each
+	struct NotificationRecord {
+		static const int MaxDataSize = 22;
+		static const int UuidSize = 16;
+
+		uint64_t addr;
+		// BleSampleHistory::GetHostTime when it arrived
+		double time;
+		// WinRtGuid bytes (System.Guid on the managed side); kept raw so the ring builds off Windows
+		uint8_t charastricsUuid[UuidSize];
+		// _BlePluginSetNotificationSubscriberId, -1 when none
+		int32_t subscriberId;
+		uint8_t size;
+		uint8_t reserved0;
+		uint8_t data[MaxDataSize];
+		uint32_t reserved1;
+	};
+	static_assert(sizeof(NotificationRecord) == 64, "NotificationRecord layout is shared with C#");
+
+	// start of the shared region (same layout as NotificationRingHeader in DllInterface.cs).
+	// the cursors count records from 0 and never wrap; record i lives at
+	// recordOffset + (i & (capacity - 1)) * recordSize. each cursor sits on its own cache line.
+	struct NotificationRingHeader {
+		static const uint32_t Magic = 0x474E5242; // "BRNG"
+		static const uint32_t CurrentVersion = 1;
+
+		uint32_t magic;
+		uint32_t version;
+		uint32_t recordSize;
+		// power of two
+		uint32_t capacity;
+		uint64_t recordOffset;
+		uint8_t reserved0[40];
+		// written by the plugin only
+		std::atomic<uint64_t> writeCursor;
+		// records lost because the ring was full
+		std::atomic<uint64_t> droppedNum;
+		uint8_t reserved1[48];
+		// written by the reader only
+		std::atomic<uint64_t> readCursor;
+		uint8_t reserved2[56];
+	};
+	static_assert(sizeof(NotificationRingHeader) == 192, "NotificationRingHeader layout is shared with C#");
+	static_assert(sizeof(std::atomic<uint64_t>) == sizeof(uint64_t), "cursors must be plain 64 bit words");
+
+	// every notification copied once into a fixed region the app reads in place (no drain, no copy).
+	// memory ordering:
+	//  - the plugin fills records [writeCursor, readCursor + capacity), then publishes them with a
+	//    release store of writeCursor. notification threads serialize among themselves.
+	//  - the reader loads writeCursor with acquire (C#: Volatile.Read) and may then read every
+	//    record below it. when done with them it stores readCursor with release (Volatile.Write);
+	//    records below readCursor may be overwritten right after.
+	//  - the plugin loads readCursor with acquire before reusing a slot. a full ring drops the new
+	//    notification and counts it in droppedNum; nothing the reader holds is ever overwritten.
+	//  - one reader at a time.
+	class BleNotificationRing {
+	public:
+		static constexpr int DefaultCapacity = 1024;
+		static constexpr int MaxCapacity = 1 << 20;
+	private:
+		static BleNotificationRing s_instance;
+
+		std::atomic<bool> m_isEnabled;
+		std::mutex m_producerMutex;
+		NotificationRingHeader* m_header;
+		NotificationRecord* m_records;
+
+		BleNotificationRing();
+	public:
+		static BleNotificationRing& GetInstance();
+
+		// returns the region (header first). it stays at the same address until Disable; a ring
+		// that is already enabled with the same capacity is kept as is, records included
+		NotificationRingHeader* Enable(int capacity);
+		void Disable();
+		inline bool IsEnabled()const {
+			return m_isEnabled.load(std::memory_order_relaxed);
+		}
+		// producer side, any thread. charastricsUuid is UuidSize bytes. false when disabled or full
+		bool Push(uint64_t addr, double time, const uint8_t* charastricsUuid, int32_t subscriberId,
+			const uint8_t* data, int size);
+		// unread records lose their subscriber id (-1), for a domain reload when no reader is attached
+		void ClearSubscriberIds();
+
+		// reader side for native code, following the rules above: records ready up to the wrap
+		static int Acquire(NotificationRingHeader* header, const NotificationRecord** out);
+		// num is clamped to the records below writeCursor
+		static void Release(NotificationRingHeader* header, int num);
+	};
+}
@@ -0,0 +1,501 @@
+#include "BleOperationScheduler.h"
+#include "BleTrace.h"
+#include "BleTimeline.h"
+#include <algorithm>
+#include <atomic>
+
+using namespace BlePlugin;
+using namespace winrt::Windows::Foundation;
+
+static std::atomic<uint64_t> s_nextSpanId(1);
+
+// BleGattOperation
+BleGattOperation::BleGattOperation(EType type, EOperationPriority priority, const WinRtBleCharacteristic& charastrics) :
+	m_type(type), m_priority(priority), m_status(EStatus::Queued),
+	m_charastrics(charastrics), m_attributeHandle(charastrics.AttributeHandle()),
+	m_writeOption(WinRtGattWriteOption::WriteWithResponse),
+	m_data(), m_readAsync(nullptr), m_writeAsync(nullptr),
+	m_enqueueTime(Clock::now()), m_isJoinable(true), m_spanId(0)
+{
+}
+
+void BleGattOperation::Start() {
+	m_status = EStatus::InFlight;
+	m_spanId = s_nextSpanId.fetch_add(1, std::memory_order_relaxed);
+	if (m_type == EType::Read) {
+		BLE_TIMELINE_ASYNC_BEGIN("gattRead", m_spanId);
+		m_readAsync = m_charastrics.ReadValueAsync();
+		BleTrace::GetInstance().WatchRead(m_charastrics, m_readAsync);
+		return;
+	}
+	BLE_TIMELINE_ASYNC_BEGIN("gattWrite", m_spanId);
+	int size = static_cast<int>(m_data.size());
+	auto buf = winrt::Windows::Storage::Streams::Buffer(size);
+	buf.Length(size);
+	std::copy(m_data.begin(), m_data.end(), buf.data());
+	m_writeAsync = m_charastrics.WriteValueWithResultAsync(buf, m_writeOption);
+	BleTrace::GetInstance().WatchWrite(m_charastrics, m_writeAsync, m_data.data(), size);
+}
+
+// returns true when the operation left the InFlight state
+bool BleGattOperation::UpdateInFlight() {
+	if (m_type == EType::Read) {
+		auto status = m_readAsync.Status();
+		if (status == AsyncStatus::Started) {
+			return false;
+		}
+		if (status != AsyncStatus::Completed ||
+			m_readAsync.get().Status() != WinRtGattCommunicateState::Success) {
+			m_status = EStatus::Error;
+		}
+		else {
+			auto value = m_readAsync.get().Value();
+			m_data.assign(value.data(), value.data() + value.Length());
+			m_status = EStatus::Completed;
+		}
+		m_readAsync = nullptr;
+		BLE_TIMELINE_ASYNC_END("gattRead", m_spanId);
+		return true;
+	}
+	auto status = m_writeAsync.Status();
+	if (status == AsyncStatus::Started) {
+		return false;
+	}
+	if (status != AsyncStatus::Completed ||
+		m_writeAsync.get().Status() != WinRtGattCommunicateState::Success) {
+		m_status = EStatus::Error;
+	}
+	else {
+		m_status = EStatus::Completed;
+	}
+	m_writeAsync = nullptr;
+	BLE_TIMELINE_ASYNC_END("gattWrite", m_spanId);
+	return true;
+}
+
+// BleOperationScheduler
+BleOperationScheduler::BleOperationScheduler() :
+	m_maxInFlight(DefaultMaxInFlight),
+	m_tokens(0.0), m_tokenCapacity(0.0), m_tokenPerMs(0.0),
+	m_lastRefill(Clock::now()),
+	m_dispatchedNum(0), m_totalWaitMs(0.0), m_maxWaitMs(0.0),
+	m_coalescedWriteNum(0), m_coalescedReadNum(0),
+	m_readCacheHitNum(0), m_readCacheMissNum(0)
+{
+	SetConfig(DefaultMaxInFlight, DefaultConnectionIntervalMs, DefaultOperationsPerInterval);
+}
+
+void BleOperationScheduler::SetConfig(int maxInFlight, float connectionIntervalMs, int operationsPerInterval) {
+	if (maxInFlight < 1) {
+		maxInFlight = 1;
+	}
+	if (connectionIntervalMs < 1.0f) {
+		connectionIntervalMs = 1.0f;
+	}
+	if (operationsPerInterval < 1) {
+		operationsPerInterval = 1;
+	}
+	m_maxInFlight = maxInFlight;
+	m_tokenCapacity = static_cast<double>(operationsPerInterval);
+	m_tokenPerMs = m_tokenCapacity / connectionIntervalMs;
+	m_tokens = m_tokenCapacity;
+	m_lastRefill = Clock::now();
+}
+
+void BleOperationScheduler::SetWriteCoalescing(const WinRtBleCharacteristic& charastrics, bool enable) {
+	uint16_t attributeHandle = charastrics.AttributeHandle();
+	auto it = std::find(m_coalesceHandles.begin(), m_coalesceHandles.end(), attributeHandle);
+	if (enable && it == m_coalesceHandles.end()) {
+		m_coalesceHandles.push_back(attributeHandle);
+	}
+	else if (!enable && it != m_coalesceHandles.end()) {
+		m_coalesceHandles.erase(it);
+	}
+}
+
+void BleOperationScheduler::SetReadCache(const WinRtBleCharacteristic& charastrics, float ttlMs) {
+	uint16_t attributeHandle = charastrics.AttributeHandle();
+	for (auto it = m_readCaches.begin(); it != m_readCaches.end(); ++it) {
+		if (it->attributeHandle != attributeHandle) {
+			continue;
+		}
+		if (ttlMs <= 0.0f) {
+			m_readCaches.erase(it);
+		}
+		else {
+			it->ttlMs = ttlMs;
+		}
+		return;
+	}
+	if (ttlMs <= 0.0f) {
+		return;
+	}
+	ReadCacheEntry entry;
+	entry.attributeHandle = attributeHandle;
+	entry.ttlMs = ttlMs;
+	entry.isValid = false;
+	m_readCaches.push_back(entry);
+}
+
+BleOperationScheduler::ReadCacheEntry* BleOperationScheduler::FindReadCache(uint16_t attributeHandle) {
+	for (auto it = m_readCaches.begin(); it != m_readCaches.end(); ++it) {
+		if (it->attributeHandle == attributeHandle) {
+			return &(*it);
+		}
+	}
+	return nullptr;
+}
+
+bool BleOperationScheduler::IsWriteCoalescing(uint16_t attributeHandle)const {
+	return (std::find(m_coalesceHandles.begin(), m_coalesceHandles.end(), attributeHandle) != m_coalesceHandles.end());
+}
+
+BleGattOperation* BleOperationScheduler::Create(BleGattOperation::EType type, const WinRtBleCharacteristic& charastrics, EOperationPriority priority) {
+	int priorityIdx = static_cast<int>(priority);
+	if (priorityIdx < 0 || priorityIdx >= static_cast<int>(EOperationPriority::Num)) {
+		priority = EOperationPriority::Bulk;
+		priorityIdx = static_cast<int>(priority);
+	}
+	auto it = m_operations.emplace(m_operations.begin(), type, priority, charastrics);
+	return &(*it);
+}
+
+void BleOperationScheduler::Enqueue(BleGattOperation* operation) {
+	m_queues[static_cast<int>(operation->m_priority)].push_back(operation);
+}
+
+// takes over the queue slot of the writes to the same characteristic that are not sent yet, in
+// every priority queue: a stale value left in another queue could go out after this one.
+// the write keeps the more urgent of the priorities, unless that would send it before a read
+// of the characteristic that is still queued
+bool BleOperationScheduler::ReplacePendingWrite(BleGattOperation* operation) {
+	BleGattOperation** slot = nullptr;
+	int slotPriority = static_cast<int>(EOperationPriority::Num);
+	for (int i = 0; i < static_cast<int>(EOperationPriority::Num); ++i) {
+		for (auto it = m_queues[i].begin(); it != m_queues[i].end(); ++it) {
+			BleGattOperation* pending = *it;
+			if (pending->m_type != BleGattOperation::EType::Write ||
+				pending->m_attributeHandle != operation->m_attributeHandle) {
+				continue;
+			}
+			pending->m_status = BleGattOperation::EStatus::Coalesced;
+			++m_coalescedWriteNum;
+			if (slot == nullptr) {
+				slot = &(*it);
+				slotPriority = i;
+			}
+		}
+	}
+	if (slot == nullptr) {
+		return false;
+	}
+	int priority = static_cast<int>(operation->m_priority);
+	if (priority < slotPriority && !HasQueuedRead(operation->m_attributeHandle)) {
+		m_queues[priority].push_back(operation);
+	}
+	else {
+		*slot = operation;
+		operation->m_priority = static_cast<EOperationPriority>(slotPriority);
+	}
+	for (int i = 0; i < static_cast<int>(EOperationPriority::Num); ++i) {
+		auto& queue = m_queues[i];
+		queue.erase(std::remove_if(queue.begin(), queue.end(), [](const BleGattOperation* pending) {
+			return pending->m_status == BleGattOperation::EStatus::Coalesced;
+		}), queue.end());
+	}
+	return true;
+}
+
+BleGattOperation* BleOperationScheduler::EnqueueWrite(const WinRtBleCharacteristic& charastrics,
+	const uint8_t* src, int size, WinRtGattWriteOption option, EOperationPriority priority) {
+	BleGattOperation* operation = Create(BleGattOperation::EType::Write, charastrics, priority);
+	operation->m_data.assign(src, src + size);
+	operation->m_writeOption = option;
+	if (!IsWriteCoalescing(operation->m_attributeHandle) ||
+		!ReplacePendingWrite(operation)) {
+		Enqueue(operation);
+	}
+	// reads requested from now on have to see this write
+	ClosePendingReads(operation->m_attributeHandle);
+	// the cached value is stale once a write is requested
+	ReadCacheEntry* cache = FindReadCache(operation->m_attributeHandle);
+	if (cache != nullptr) {
+		cache->isValid = false;
+	}
+	return operation;
+}
+
+BleGattOperation* BleOperationScheduler::EnqueueRead(const WinRtBleCharacteristic& charastrics, EOperationPriority priority) {
+	BleGattOperation* operation = Create(BleGattOperation::EType::Read, charastrics, priority);
+
+	ReadCacheEntry* cache = FindReadCache(operation->m_attributeHandle);
+	if (cache != nullptr) {
+		double ageMs = std::chrono::duration<double, std::milli>(Clock::now() - cache->updateTime).count();
+		if (cache->isValid && ageMs < cache->ttlMs) {
+			operation->m_data = cache->value;
+			operation->m_status = BleGattOperation::EStatus::Completed;
+			++m_readCacheHitNum;
+			return operation;
+		}
+		++m_readCacheMissNum;
+	}
+
+	BleGattOperation* leader = FindPendingRead(operation->m_attributeHandle);
+	if (leader != nullptr) {
+		// a queued leader is promoted when a more urgent read joins it,
+		// unless that would send it before an earlier write to the same characteristic
+		if (leader->m_status == BleGattOperation::EStatus::Queued &&
+			leader->m_priority > operation->m_priority &&
+			!HasQueuedWrite(leader->m_attributeHandle)) {
+			RemoveFromQueue(leader);
+			leader->m_priority = operation->m_priority;
+			Enqueue(leader);
+		}
+		operation->m_status = leader->m_status;
+		leader->m_followers.push_back(operation);
+		++m_coalescedReadNum;
+		return operation;
+	}
+	Enqueue(operation);
+	return operation;
+}
+
+// a queued or in flight read of the characteristic with no write requested after it
+BleGattOperation* BleOperationScheduler::FindPendingRead(uint16_t attributeHandle) {
+	for (auto it = m_inFlight.begin(); it != m_inFlight.end(); ++it) {
+		if ((*it)->m_type == BleGattOperation::EType::Read &&
+			(*it)->m_attributeHandle == attributeHandle && (*it)->m_isJoinable) {
+			return *it;
+		}
+	}
+	for (int i = 0; i < static_cast<int>(EOperationPriority::Num); ++i) {
+		for (auto it = m_queues[i].begin(); it != m_queues[i].end(); ++it) {
+			if ((*it)->m_type == BleGattOperation::EType::Read &&
+				(*it)->m_attributeHandle == attributeHandle && (*it)->m_isJoinable) {
+				return *it;
+			}
+		}
+	}
+	return nullptr;
+}
+
+void BleOperationScheduler::ClosePendingReads(uint16_t attributeHandle) {
+	for (auto it = m_inFlight.begin(); it != m_inFlight.end(); ++it) {
+		if ((*it)->m_type == BleGattOperation::EType::Read && (*it)->m_attributeHandle == attributeHandle) {
+			(*it)->m_isJoinable = false;
+		}
+	}
+	for (int i = 0; i < static_cast<int>(EOperationPriority::Num); ++i) {
+		for (auto it = m_queues[i].begin(); it != m_queues[i].end(); ++it) {
+			if ((*it)->m_type == BleGattOperation::EType::Read && (*it)->m_attributeHandle == attributeHandle) {
+				(*it)->m_isJoinable = false;
+			}
+		}
+	}
+}
+
+bool BleOperationScheduler::HasQueuedWrite(uint16_t attributeHandle)const {
+	for (int i = 0; i < static_cast<int>(EOperationPriority::Num); ++i) {
+		for (auto it = m_queues[i].begin(); it != m_queues[i].end(); ++it) {
+			if ((*it)->m_type == BleGattOperation::EType::Write && (*it)->m_attributeHandle == attributeHandle) {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+bool BleOperationScheduler::HasQueuedRead(uint16_t attributeHandle)const {
+	for (int i = 0; i < static_cast<int>(EOperationPriority::Num); ++i) {
+		for (auto it = m_queues[i].begin(); it != m_queues[i].end(); ++it) {
+			if ((*it)->m_type == BleGattOperation::EType::Read && (*it)->m_attributeHandle == attributeHandle) {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+void BleOperationScheduler::OnOperationFinished(BleGattOperation* operation) {
+	if (operation->m_type != BleGattOperation::EType::Read) {
+		return;
+	}
+	if (operation->m_status == BleGattOperation::EStatus::Completed) {
+		ReadCacheEntry* cache = FindReadCache(operation->m_attributeHandle);
+		if (cache != nullptr) {
+			cache->value = operation->m_data;
+			cache->updateTime = Clock::now();
+			cache->isValid = true;
+		}
+	}
+	for (auto it = operation->m_followers.begin(); it != operation->m_followers.end(); ++it) {
+		(*it)->m_status = operation->m_status;
+		(*it)->m_data = operation->m_data;
+	}
+	operation->m_followers.clear();
+}
+
+// a read is released before it finished. the first follower takes over its place.
+void BleOperationScheduler::HandOverFollowers(BleGattOperation* operation) {
+	if (operation->m_followers.empty()) {
+		return;
+	}
+	BleGattOperation* successor = operation->m_followers.front();
+	successor->m_followers.assign(operation->m_followers.begin() + 1, operation->m_followers.end());
+	successor->m_readAsync = operation->m_readAsync;
+	successor->m_status = operation->m_status;
+	successor->m_isJoinable = operation->m_isJoinable;
+	// the span began under the leader's id and has to end under it
+	successor->m_spanId = operation->m_spanId;
+	operation->m_followers.clear();
+
+	for (int i = 0; i < static_cast<int>(EOperationPriority::Num); ++i) {
+		std::replace(m_queues[i].begin(), m_queues[i].end(), operation, successor);
+	}
+	std::replace(m_inFlight.begin(), m_inFlight.end(), operation, successor);
+}
+
+void BleOperationScheduler::RefillTokens() {
+	auto now = Clock::now();
+	double elapsedMs = std::chrono::duration<double, std::milli>(now - m_lastRefill).count();
+	m_lastRefill = now;
+	m_tokens = (std::min)(m_tokenCapacity, m_tokens + elapsedMs * m_tokenPerMs);
+}
+
+BleGattOperation* BleOperationScheduler::PopNext() {
+	for (int i = 0; i < static_cast<int>(EOperationPriority::Num); ++i) {
+		if (!m_queues[i].empty()) {
+			BleGattOperation* operation = m_queues[i].front();
+			m_queues[i].pop_front();
+			return operation;
+		}
+	}
+	return nullptr;
+}
+
+void BleOperationScheduler::Update() {
+	for (auto it = m_inFlight.begin(); it != m_inFlight.end(); ) {
+		if ((*it)->UpdateInFlight()) {
+			OnOperationFinished(*it);
+			it = m_inFlight.erase(it);
+		}
+		else {
+			++it;
+		}
+	}
+
+	RefillTokens();
+	auto now = Clock::now();
+	while (static_cast<int>(m_inFlight.size()) < m_maxInFlight && m_tokens >= 1.0) {
+		BleGattOperation* operation = PopNext();
+		if (operation == nullptr) {
+			break;
+		}
+		double waitMs = std::chrono::duration<double, std::milli>(now - operation->m_enqueueTime).count();
+		m_totalWaitMs += waitMs;
+		m_maxWaitMs = (std::max)(m_maxWaitMs, waitMs);
+		++m_dispatchedNum;
+		m_tokens -= 1.0;
+
+		operation->Start();
+		for (auto it = operation->m_followers.begin(); it != operation->m_followers.end(); ++it) {
+			(*it)->m_status = operation->m_status;
+		}
+		m_inFlight.push_back(operation);
+	}
+}
+
+void BleOperationScheduler::RemoveFromQueue(BleGattOperation* operation) {
+	for (int i = 0; i < static_cast<int>(EOperationPriority::Num); ++i) {
+		auto& queue = m_queues[i];
+		queue.erase(std::remove(queue.begin(), queue.end(), operation), queue.end());
+	}
+	m_inFlight.erase(std::remove(m_inFlight.begin(), m_inFlight.end(), operation), m_inFlight.end());
+}
+
+void BleOperationScheduler::Release(BleGattOperation* operation) {
+	if (!operation->IsDone()) {
+		HandOverFollowers(operation);
+		for (auto it = m_operations.begin(); it != m_operations.end(); ++it) {
+			auto& followers = it->m_followers;
+			followers.erase(std::remove(followers.begin(), followers.end(), operation), followers.end());
+		}
+	}
+	RemoveFromQueue(operation);
+	for (auto it = m_operations.begin(); it != m_operations.end(); ++it) {
+		if (&(*it) == operation) {
+			m_operations.erase(it);
+			break;
+		}
+	}
+}
+
+// the device went away. handles stay valid until released.
+void BleOperationScheduler::FailAll() {
+	for (auto it = m_operations.begin(); it != m_operations.end(); ++it) {
+		if (!it->IsDone()) {
+			if (it->m_status == BleGattOperation::EStatus::InFlight) {
+				BLE_TIMELINE_ASYNC_END((it->m_type == BleGattOperation::EType::Read) ? "gattRead" : "gattWrite", it->m_spanId);
+			}
+			it->m_status = BleGattOperation::EStatus::Error;
+			it->m_readAsync = nullptr;
+			it->m_writeAsync = nullptr;
+		}
+		it->m_followers.clear();
+	}
+	for (int i = 0; i < static_cast<int>(EOperationPriority::Num); ++i) {
+		m_queues[i].clear();
+	}
+	m_inFlight.clear();
+	for (auto it = m_readCaches.begin(); it != m_readCaches.end(); ++it) {
+		it->isValid = false;
+	}
+}
+
+void BleOperationScheduler::Reset() {
+	this->FailAll();
+	m_operations.clear();
+	for (int i = 0; i < static_cast<int>(EOperationPriority::Num); ++i) {
+		std::deque<BleGattOperation*>().swap(m_queues[i]);
+	}
+	std::vector<BleGattOperation*>().swap(m_inFlight);
+	std::vector<uint16_t>().swap(m_coalesceHandles);
+	std::vector<ReadCacheEntry>().swap(m_readCaches);
+	m_dispatchedNum = 0;
+	m_totalWaitMs = 0.0;
+	m_maxWaitMs = 0.0;
+	m_coalescedWriteNum = 0;
+	m_coalescedReadNum = 0;
+	m_readCacheHitNum = 0;
+	m_readCacheMissNum = 0;
+	SetConfig(DefaultMaxInFlight, DefaultConnectionIntervalMs, DefaultOperationsPerInterval);
+}
+
+size_t BleOperationScheduler::GetResidentBytes()const {
+	size_t bytes = m_operations.size() * sizeof(BleGattOperation) +
+		m_inFlight.capacity() * sizeof(BleGattOperation*) +
+		m_coalesceHandles.capacity() * sizeof(uint16_t) +
+		m_readCaches.capacity() * sizeof(ReadCacheEntry);
+	for (auto it = m_operations.begin(); it != m_operations.end(); ++it) {
+		bytes += it->m_data.capacity() + it->m_followers.capacity() * sizeof(BleGattOperation*);
+	}
+	for (auto it = m_readCaches.begin(); it != m_readCaches.end(); ++it) {
+		bytes += it->value.capacity();
+	}
+	return bytes;
+}
+
+void BleOperationScheduler::GetStats(OperationSchedulerStats* stats)const {
+	for (int i = 0; i < static_cast<int>(EOperationPriority::Num); ++i) {
+		stats->queueDepth[i] = static_cast<int32_t>(m_queues[i].size());
+	}
+	stats->inFlightNum = static_cast<int32_t>(m_inFlight.size());
+	stats->reserved = 0;
+	stats->dispatchedNum = m_dispatchedNum;
+	stats->averageWaitMs = (m_dispatchedNum > 0) ? (m_totalWaitMs / m_dispatchedNum) : 0.0;
+	stats->maxWaitMs = m_maxWaitMs;
+	stats->coalescedWriteNum = m_coalescedWriteNum;
+	stats->coalescedReadNum = m_coalescedReadNum;
+	stats->readCacheHitNum = m_readCacheHitNum;
+	stats->readCacheMissNum = m_readCacheMissNum;
+}
@@ -0,0 +1,168 @@
+#pragma once
+
+#include "pch.h"
+#include <chrono>
+#include <deque>
+#include <list>
+#include <vector>
+
+namespace BlePlugin {
+	enum class EOperationPriority : int {
+		Control = 0,	// latency critical (motor commands etc.)
+		Bulk = 1,		// config reads, large transfers
+		Num = 2
+	};
+
+	// statistics of BleOperationScheduler (layout shared with C#)
+	struct OperationSchedulerStats {
+		int32_t queueDepth[static_cast<int>(EOperationPriority::Num)];
+		int32_t inFlightNum;
+		int32_t reserved;
+		uint64_t dispatchedNum;
+		double averageWaitMs;
+		double maxWaitMs;
+		// writes that were replaced by a newer one before being sent
+		uint64_t coalescedWriteNum;
+		// reads that shared an operation already queued or in flight
+		uint64_t coalescedReadNum;
+		uint64_t readCacheHitNum;
+		uint64_t readCacheMissNum;
+	};
+
+	class BleGattOperation {
+	public:
+		using Clock = std::chrono::steady_clock;
+		enum class EType {
+			Read,
+			Write
+		};
+		enum class EStatus : int {
+			Queued = 0,
+			InFlight = 1,
+			Completed = 2,
+			Error = 3,
+			// superseded by a newer write to the same characteristic
+			Coalesced = 4,
+		};
+	private:
+		EType m_type;
+		EOperationPriority m_priority;
+		EStatus m_status;
+		WinRtBleCharacteristic m_charastrics;
+		uint16_t m_attributeHandle;
+		WinRtGattWriteOption m_writeOption;
+		// write payload, or the read result after completion
+		std::vector<uint8_t> m_data;
+
+		WinRtAsyncOperation<WinRtGattReadResult> m_readAsync;
+		WinRtAsyncOperation<WinRtGattWriteResult> m_writeAsync;
+		Clock::time_point m_enqueueTime;
+		// reads of the same characteristic waiting on this one
+		std::vector<BleGattOperation*> m_followers;
+		// read only: no write to the same characteristic was requested after it,
+		// so a new read may still share its result
+		bool m_isJoinable;
+		// pairs the timeline span of the request on the wire; moves with a handed over read
+		uint64_t m_spanId;
+
+		friend class BleOperationScheduler;
+	public:
+		BleGattOperation(EType type, EOperationPriority priority, const WinRtBleCharacteristic& charastrics);
+
+		inline EType GetType()const {
+			return m_type;
+		}
+		inline EStatus GetStatus()const {
+			return m_status;
+		}
+		inline bool IsDone()const {
+			return (m_status != EStatus::Queued && m_status != EStatus::InFlight);
+		}
+		inline const std::vector<uint8_t>& GetData()const {
+			return m_data;
+		}
+	private:
+		void Start();
+		bool UpdateInFlight();
+	};
+
+	// per device queue of GATT operations.
+	// caps the operations in flight, paces dispatch with a token bucket sized to the
+	// connection interval and lets Control traffic overtake Bulk traffic.
+	class BleOperationScheduler {
+	public:
+		static const int DefaultMaxInFlight = 4;
+		static constexpr float DefaultConnectionIntervalMs = 30.0f;
+		static const int DefaultOperationsPerInterval = 4;
+	private:
+		using Clock = BleGattOperation::Clock;
+
+		struct ReadCacheEntry {
+			uint16_t attributeHandle;
+			double ttlMs;
+			bool isValid;
+			Clock::time_point updateTime;
+			std::vector<uint8_t> value;
+		};
+
+		std::list<BleGattOperation> m_operations;
+		std::deque<BleGattOperation*> m_queues[static_cast<int>(EOperationPriority::Num)];
+		std::vector<BleGattOperation*> m_inFlight;
+		// characteristics whose pending writes are replaced by newer ones
+		std::vector<uint16_t> m_coalesceHandles;
+		std::vector<ReadCacheEntry> m_readCaches;
+
+		int m_maxInFlight;
+		double m_tokens;
+		double m_tokenCapacity;
+		double m_tokenPerMs;
+		Clock::time_point m_lastRefill;
+
+		uint64_t m_dispatchedNum;
+		double m_totalWaitMs;
+		double m_maxWaitMs;
+		uint64_t m_coalescedWriteNum;
+		uint64_t m_coalescedReadNum;
+		uint64_t m_readCacheHitNum;
+		uint64_t m_readCacheMissNum;
+	public:
+		BleOperationScheduler();
+
+		void SetConfig(int maxInFlight, float connectionIntervalMs, int operationsPerInterval);
+		void SetWriteCoalescing(const WinRtBleCharacteristic& charastrics, bool enable);
+		// reads within ttlMs of the last result complete without radio traffic. 0 disables.
+		void SetReadCache(const WinRtBleCharacteristic& charastrics, float ttlMs);
+
+		BleGattOperation* EnqueueWrite(const WinRtBleCharacteristic& charastrics,
+			const uint8_t* src, int size, WinRtGattWriteOption option, EOperationPriority priority);
+		BleGattOperation* EnqueueRead(const WinRtBleCharacteristic& charastrics, EOperationPriority priority);
+
+		void Update();
+		void Release(BleGattOperation* operation);
+		void FailAll();
+		// no operation handle is outstanding
+		inline bool IsEmpty()const {
+			return m_operations.empty();
+		}
+		// back to a freshly constructed scheduler, freeing its buffers
+		void Reset();
+		size_t GetResidentBytes()const;
+
+		void GetStats(OperationSchedulerStats* stats)const;
+	private:
+		BleGattOperation* Create(BleGattOperation::EType type, const WinRtBleCharacteristic& charastrics, EOperationPriority priority);
+		void Enqueue(BleGattOperation* operation);
+		bool IsWriteCoalescing(uint16_t attributeHandle)const;
+		bool ReplacePendingWrite(BleGattOperation* operation);
+		ReadCacheEntry* FindReadCache(uint16_t attributeHandle);
+		BleGattOperation* FindPendingRead(uint16_t attributeHandle);
+		void ClosePendingReads(uint16_t attributeHandle);
+		bool HasQueuedWrite(uint16_t attributeHandle)const;
+		bool HasQueuedRead(uint16_t attributeHandle)const;
+		void OnOperationFinished(BleGattOperation* operation);
+		void HandOverFollowers(BleGattOperation* operation);
+		void RefillTokens();
+		BleGattOperation* PopNext();
+		void RemoveFromQueue(BleGattOperation* operation);
+	};
+}
@@ -0,0 +1,220 @@
+#include "BlePayloadDecoder.h"
+#include "BleDeviceObject.h"
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+using namespace BlePlugin;
+
+static int GetFieldSize(ESampleFieldType type) {
+	switch (type) {
+	case ESampleFieldType::UInt8:
+	case ESampleFieldType::Int8:
+		return 1;
+	case ESampleFieldType::UInt16:
+	case ESampleFieldType::Int16:
+		return 2;
+	case ESampleFieldType::UInt32:
+	case ESampleFieldType::Int32:
+	case ESampleFieldType::Float32:
+		return 4;
+	default:
+		return 0;
+	}
+}
+
+template <typename T>
+static inline T LoadValue(const uint8_t* src, bool isBigEndian) {
+	using UInt = typename std::conditional<sizeof(T) == 1, uint8_t,
+		typename std::conditional<sizeof(T) == 2, uint16_t, uint32_t>::type>::type;
+	UInt raw = 0;
+	for (size_t b = 0; b < sizeof(T); ++b) {
+		size_t shift = isBigEndian ? (sizeof(T) - 1 - b) * 8 : b * 8;
+		raw |= static_cast<UInt>(static_cast<UInt>(src[b]) << shift);
+	}
+	T value;
+	memcpy(&value, &raw, sizeof(T));
+	return value;
+}
+
+// one type, one stride, no branches inside: the loop the compiler vectorizes
+template <typename T, bool IsBigEndian>
+static void DecodeRows(const uint8_t* src, int rowNum, float scale, float* out) {
+	for (int i = 0; i < rowNum; ++i) {
+		out[i] = static_cast<float>(LoadValue<T>(src + i * BlePayloadDecoder::RowStride, IsBigEndian)) * scale;
+	}
+}
+
+template <typename T>
+static void DecodeRows(const uint8_t* src, int rowNum, const PayloadField& field, float* out) {
+	if (field.isBigEndian) {
+		DecodeRows<T, true>(src, rowNum, field.scale, out);
+	}
+	else {
+		DecodeRows<T, false>(src, rowNum, field.scale, out);
+	}
+}
+
+// Schema
+BlePayloadDecoder::Schema::Schema(const WinRtGuid& service, const WinRtGuid& charastrics,
+	const PayloadField* src, int fieldNum, int _matchOffset, int _matchValue) :
+	serviceUuid(service), charastricsUuid(charastrics), fields(src, src + fieldNum),
+	matchOffset(_matchOffset), matchValue(static_cast<uint8_t>(_matchValue)), minSize(0), rowNum(0)
+{
+	for (auto it = fields.begin(); it != fields.end(); ++it) {
+		minSize = (std::max)(minSize, it->offset + GetFieldSize(it->type));
+	}
+	minSize = (std::max)(minSize, matchOffset + 1);
+}
+
+// BlePayloadDecoder
+BlePayloadDecoder BlePayloadDecoder::s_instance;
+
+BlePayloadDecoder::BlePayloadDecoder() :
+	m_schemaNum(0)
+{
+}
+
+BlePayloadDecoder& BlePayloadDecoder::GetInstance() {
+	return s_instance;
+}
+
+int BlePayloadDecoder::Register(const WinRtGuid& serviceUuid, const WinRtGuid& charastricsUuid,
+	const PayloadField* fields, int fieldNum, int matchOffset, int matchValue) {
+	if (fields == nullptr || fieldNum <= 0 || fieldNum > MaxFieldNum) {
+		return -1;
+	}
+	for (int i = 0; i < fieldNum; ++i) {
+		int size = GetFieldSize(fields[i].type);
+		if (size == 0 || fields[i].offset < 0 || fields[i].offset + size > NotificateData::MaxDataSize) {
+			return -1;
+		}
+	}
+	if (matchOffset >= NotificateData::MaxDataSize) {
+		return -1;
+	}
+	std::unique_ptr<Schema> schema(new Schema(serviceUuid, charastricsUuid, fields, fieldNum, matchOffset, matchValue));
+	++m_schemaNum;
+	for (size_t i = 0; i < m_schemas.size(); ++i) {
+		if (m_schemas[i] == nullptr) {
+			m_schemas[i] = std::move(schema);
+			return static_cast<int>(i);
+		}
+	}
+	m_schemas.push_back(std::move(schema));
+	return static_cast<int>(m_schemas.size()) - 1;
+}
+
+void BlePayloadDecoder::Unregister(int schemaId) {
+	if (schemaId < 0 || schemaId >= static_cast<int>(m_schemas.size()) || m_schemas[schemaId] == nullptr) {
+		return;
+	}
+	m_schemas[schemaId].reset();
+	--m_schemaNum;
+}
+
+void BlePayloadDecoder::Clear() {
+	m_schemas.clear();
+	m_schemaNum = 0;
+}
+
+void BlePayloadDecoder::BeginFrame() {
+	for (auto it = m_schemas.begin(); it != m_schemas.end(); ++it) {
+		Schema* schema = it->get();
+		if (schema == nullptr) {
+			continue;
+		}
+		schema->rows.clear();
+		schema->addrs.clear();
+		schema->rowNum = 0;
+	}
+}
+
+void BlePayloadDecoder::Gather(uint64_t addr, const NotificateData& data) {
+	const uint8_t* src = data.GetData();
+	int size = (std::min)(data.GetSize(), static_cast<int>(NotificateData::MaxDataSize));
+	for (auto it = m_schemas.begin(); it != m_schemas.end(); ++it) {
+		Schema* schema = it->get();
+		if (schema == nullptr || size < schema->minSize ||
+			schema->charastricsUuid != data.GetCharastricsUuid() || schema->serviceUuid != data.GetServiceUuid()) {
+			continue;
+		}
+		if (schema->matchOffset >= 0 && src[schema->matchOffset] != schema->matchValue) {
+			continue;
+		}
+		size_t offset = schema->rows.size();
+		schema->rows.resize(offset + RowStride);
+		memcpy(schema->rows.data() + offset, src, size);
+		schema->addrs.push_back(addr);
+		++schema->rowNum;
+	}
+}
+
+void BlePayloadDecoder::EndFrame() {
+	for (auto it = m_schemas.begin(); it != m_schemas.end(); ++it) {
+		Schema* schema = it->get();
+		if (schema == nullptr) {
+			continue;
+		}
+		schema->columns.resize(schema->fields.size() * schema->rowNum);
+		for (size_t i = 0; i < schema->fields.size(); ++i) {
+			DecodeColumn(schema->rows.data(), schema->rowNum, schema->fields[i],
+				schema->columns.data() + i * schema->rowNum);
+		}
+	}
+}
+
+void BlePayloadDecoder::DecodeColumn(const uint8_t* rows, int rowNum, const PayloadField& field, float* out) {
+	if (rowNum == 0) {
+		return;
+	}
+	const uint8_t* src = rows + field.offset;
+	switch (field.type) {
+	case ESampleFieldType::UInt8:
+		DecodeRows<uint8_t>(src, rowNum, field, out);
+		break;
+	case ESampleFieldType::Int8:
+		DecodeRows<int8_t>(src, rowNum, field, out);
+		break;
+	case ESampleFieldType::UInt16:
+		DecodeRows<uint16_t>(src, rowNum, field, out);
+		break;
+	case ESampleFieldType::Int16:
+		DecodeRows<int16_t>(src, rowNum, field, out);
+		break;
+	case ESampleFieldType::UInt32:
+		DecodeRows<uint32_t>(src, rowNum, field, out);
+		break;
+	case ESampleFieldType::Int32:
+		DecodeRows<int32_t>(src, rowNum, field, out);
+		break;
+	case ESampleFieldType::Float32:
+		DecodeRows<float>(src, rowNum, field, out);
+		break;
+	}
+}
+
+const BlePayloadDecoder::Schema* BlePayloadDecoder::GetSchema(int schemaId)const {
+	if (schemaId < 0 || schemaId >= static_cast<int>(m_schemas.size())) {
+		return nullptr;
+	}
+	return m_schemas[schemaId].get();
+}
+
+int BlePayloadDecoder::GetRowNum(int schemaId)const {
+	const Schema* schema = this->GetSchema(schemaId);
+	return (schema != nullptr) ? schema->rowNum : 0;
+}
+
+const float* BlePayloadDecoder::GetColumn(int schemaId, int fieldIdx)const {
+	const Schema* schema = this->GetSchema(schemaId);
+	if (schema == nullptr || fieldIdx < 0 || fieldIdx >= static_cast<int>(schema->fields.size())) {
+		return nullptr;
+	}
+	return schema->columns.data() + fieldIdx * schema->rowNum;
+}
+
+const uint64_t* BlePayloadDecoder::GetAddrs(int schemaId)const {
+	const Schema* schema = this->GetSchema(schemaId);
+	return (schema != nullptr) ? schema->addrs.data() : nullptr;
+}
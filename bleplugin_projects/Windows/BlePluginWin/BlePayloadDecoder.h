@@ -0,0 +1,82 @@
+#pragma once
+
+#include "pch.h"
+#include "BleSampleHistory.h"
+#include <memory>
+#include <vector>
+
+namespace BlePlugin {
+	class NotificateData;
+
+	// exported as is (same layout as PayloadField in DllInterface.cs)
+	struct PayloadField {
+		int32_t offset;
+		ESampleFieldType type;
+		// value = raw * scale
+		float scale;
+		int32_t isBigEndian;
+	};
+
+	// decodes the notifications drained each update into struct-of-arrays buffers, one float
+	// column per registered field plus the device address of every row. the columns are
+	// contiguous native memory, so the managed side wraps them as NativeArray for Jobs/Burst.
+	// packets are gathered into fixed stride rows first, then every field is decoded in its own
+	// tight loop over all rows (one type and stride per loop, which the compiler vectorizes).
+	class BlePayloadDecoder {
+	public:
+		static const int RowStride = 24;
+		static const int MaxFieldNum = 16;
+	private:
+		class Schema {
+		public:
+			WinRtGuid serviceUuid;
+			WinRtGuid charastricsUuid;
+			std::vector<PayloadField> fields;
+			int matchOffset;
+			uint8_t matchValue;
+			// shortest packet holding every field
+			int minSize;
+
+			std::vector<uint8_t> rows;
+			std::vector<uint64_t> addrs;
+			// field major, rowNum floats per field
+			std::vector<float> columns;
+			int rowNum;
+
+			Schema(const WinRtGuid& service, const WinRtGuid& charastrics,
+				const PayloadField* src, int fieldNum, int _matchOffset, int _matchValue);
+		};
+
+		static BlePayloadDecoder s_instance;
+
+		// index is the schema id; unregistered ids stay null so the others keep theirs
+		std::vector<std::unique_ptr<Schema> > m_schemas;
+		int m_schemaNum;
+
+		BlePayloadDecoder();
+		static void DecodeColumn(const uint8_t* rows, int rowNum, const PayloadField& field, float* out);
+	public:
+		static BlePayloadDecoder& GetInstance();
+
+		// returns the schema id, or -1 when the layout is invalid
+		int Register(const WinRtGuid& serviceUuid, const WinRtGuid& charastricsUuid,
+			const PayloadField* fields, int fieldNum, int matchOffset, int matchValue);
+		void Unregister(int schemaId);
+		void Clear();
+		inline bool HasSchema()const {
+			return m_schemaNum > 0;
+		}
+
+		// once per update: BeginFrame, Gather every drained notification, EndFrame
+		void BeginFrame();
+		void Gather(uint64_t addr, const NotificateData& data);
+		void EndFrame();
+
+		// valid until the next BeginFrame
+		int GetRowNum(int schemaId)const;
+		const float* GetColumn(int schemaId, int fieldIdx)const;
+		const uint64_t* GetAddrs(int schemaId)const;
+	private:
+		const Schema* GetSchema(int schemaId)const;
+	};
+}
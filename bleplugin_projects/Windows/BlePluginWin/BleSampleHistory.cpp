@@ -0,0 +1,173 @@
+#include "BleSampleHistory.h"
+#include <windows.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+using namespace BlePlugin;
+
+static double InitSecPerTick() {
+	LARGE_INTEGER frequency;
+	QueryPerformanceFrequency(&frequency);
+	return 1.0 / static_cast<double>(frequency.QuadPart);
+}
+double BleSampleHistory::s_secPerTick = InitSecPerTick();
+
+BleSampleHistory::BleSampleHistory(const WinRtGuid& serviceUuid, const WinRtGuid& charastricsUuid, int capacity,
+	const SampleField* fields, int fieldNum, int matchOffset, int matchValue) :
+	m_serviceUuid(serviceUuid), m_charastricsUuid(charastricsUuid),
+	m_matchOffset(matchOffset), m_matchValue(static_cast<uint8_t>(matchValue)),
+	m_samples((std::max)(capacity, 2)), m_writeNum(0)
+{
+	fieldNum = (std::min)(fieldNum, static_cast<int>(HistorySample::MaxFieldNum));
+	if (fields != nullptr && fieldNum > 0) {
+		m_fields.assign(fields, fields + fieldNum);
+	}
+}
+
+double BleSampleHistory::GetHostTime() {
+	LARGE_INTEGER counter;
+	QueryPerformanceCounter(&counter);
+	return static_cast<double>(counter.QuadPart) * s_secPerTick;
+}
+
+void BleSampleHistory::Push(double time, const uint8_t* data, int size) {
+	if (m_matchOffset >= 0 && (m_matchOffset >= size || data[m_matchOffset] != m_matchValue)) {
+		return;
+	}
+	float values[HistorySample::MaxFieldNum] = {};
+	if (!this->Decode(data, size, values)) {
+		return;
+	}
+	HistorySample& sample = m_samples[m_writeNum % m_samples.size()];
+	memcpy(sample.values, values, sizeof(values));
+	size = (std::min)(size, static_cast<int>(HistorySample::MaxDataSize));
+	sample.time = time;
+	memcpy(sample.data, data, size);
+	sample.size = static_cast<uint8_t>(size);
+	sample.reserved = 0;
+	++m_writeNum;
+}
+
+void BleSampleHistory::Clear() {
+	m_writeNum = 0;
+}
+
+const HistorySample& BleSampleHistory::GetFromNewest(int idx)const {
+	return m_samples[(m_writeNum - 1 - idx) % m_samples.size()];
+}
+
+int BleSampleHistory::CopyLatest(HistorySample* out, int maxNum)const {
+	if (out == nullptr) {
+		return 0;
+	}
+	int num = (std::min)(maxNum, this->GetSampleNum());
+	for (int i = 0; i < num; ++i) {
+		out[i] = this->GetFromNewest(num - 1 - i);
+	}
+	return num;
+}
+
+ESampleResult BleSampleHistory::Sample(double time, float maxExtrapolationSec, float* outValues, int maxValues)const {
+	int sampleNum = this->GetSampleNum();
+	int valueNum = (std::min)(maxValues, this->GetFieldNum());
+	if (sampleNum == 0 || outValues == nullptr) {
+		return ESampleResult::None;
+	}
+	const HistorySample& newest = this->GetFromNewest(0);
+	if (sampleNum == 1 || time < this->GetFromNewest(sampleNum - 1).time) {
+		const HistorySample& held = (sampleNum == 1) ? newest : this->GetFromNewest(sampleNum - 1);
+		memcpy(outValues, held.values, valueNum * sizeof(float));
+		return ESampleResult::Held;
+	}
+	if (time >= newest.time) {
+		const HistorySample& prev = this->GetFromNewest(1);
+		double span = newest.time - prev.time;
+		if (span <= 0.0) {
+			memcpy(outValues, newest.values, valueNum * sizeof(float));
+			return ESampleResult::Held;
+		}
+		double ahead = (std::min)(time - newest.time, static_cast<double>((std::max)(maxExtrapolationSec, 0.0f)));
+		this->Blend(prev, newest, 1.0 + ahead / span, outValues, valueNum);
+		return ESampleResult::Extrapolated;
+	}
+	// newest first; samples are few, a linear walk back is enough
+	for (int i = 1; i < sampleNum; ++i) {
+		const HistorySample& from = this->GetFromNewest(i);
+		if (from.time <= time) {
+			const HistorySample& to = this->GetFromNewest(i - 1);
+			double span = to.time - from.time;
+			this->Blend(from, to, (span > 0.0) ? (time - from.time) / span : 1.0, outValues, valueNum);
+			return ESampleResult::Interpolated;
+		}
+	}
+	return ESampleResult::None;
+}
+
+void BleSampleHistory::Blend(const HistorySample& from, const HistorySample& to, double rate, float* outValues, int valueNum)const {
+	for (int i = 0; i < valueNum; ++i) {
+		double wrap = m_fields[i].wrap;
+		double delta = static_cast<double>(to.values[i]) - from.values[i];
+		if (wrap > 0.0) {
+			delta = delta - wrap * std::floor(delta / wrap + 0.5);
+			double value = std::fmod(from.values[i] + delta * rate, wrap);
+			outValues[i] = static_cast<float>((value < 0.0) ? value + wrap : value);
+		}
+		else {
+			outValues[i] = static_cast<float>(from.values[i] + delta * rate);
+		}
+	}
+}
+
+bool BleSampleHistory::Decode(const uint8_t* data, int size, float* outValues)const {
+	for (size_t i = 0; i < m_fields.size(); ++i) {
+		const SampleField& field = m_fields[i];
+		int fieldSize = 0;
+		switch (field.type) {
+		case ESampleFieldType::UInt8:
+		case ESampleFieldType::Int8:
+			fieldSize = 1;
+			break;
+		case ESampleFieldType::UInt16:
+		case ESampleFieldType::Int16:
+			fieldSize = 2;
+			break;
+		default:
+			fieldSize = 4;
+			break;
+		}
+		if (field.offset < 0 || field.offset + fieldSize > size) {
+			return false;
+		}
+		const uint8_t* src = data + field.offset;
+		uint32_t raw = 0;
+		for (int b = 0; b < fieldSize; ++b) {
+			raw |= static_cast<uint32_t>(src[b]) << (b * 8);
+		}
+		double value;
+		switch (field.type) {
+		case ESampleFieldType::UInt8:
+		case ESampleFieldType::UInt16:
+		case ESampleFieldType::UInt32:
+			value = static_cast<double>(raw);
+			break;
+		case ESampleFieldType::Int8:
+			value = static_cast<int8_t>(raw);
+			break;
+		case ESampleFieldType::Int16:
+			value = static_cast<int16_t>(raw);
+			break;
+		case ESampleFieldType::Int32:
+			value = static_cast<int32_t>(raw);
+			break;
+		default: {
+			float f;
+			memcpy(&f, &raw, sizeof(f));
+			value = f;
+			break;
+		}
+		}
+		outValues[i] = static_cast<float>(value * field.scale);
+	}
+	return true;
+}
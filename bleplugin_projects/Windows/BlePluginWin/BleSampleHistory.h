@@ -0,0 +1,93 @@
+#pragma once
+
+#include "pch.h"
+#include <vector>
+
+namespace BlePlugin {
+	enum class ESampleFieldType : int32_t {
+		UInt8 = 0,
+		Int8 = 1,
+		UInt16 = 2,
+		Int16 = 3,
+		UInt32 = 4,
+		Int32 = 5,
+		Float32 = 6,
+	};
+
+	// numeric field decoded from every notification (little endian).
+	// exported as is (same layout as SampleField in DllInterface.cs)
+	struct SampleField {
+		int32_t offset;
+		ESampleFieldType type;
+		// value = raw * scale
+		float scale;
+		// > 0 for angles and other wrapping values: interpolates the short way round [0, wrap)
+		float wrap;
+	};
+
+	// exported as is (same layout as HistorySample in DllInterface.cs)
+	struct HistorySample {
+		static const int MaxFieldNum = 8;
+		static const int MaxDataSize = 22;
+
+		// host clock seconds (BleSampleHistory::GetHostTime)
+		double time;
+		float values[MaxFieldNum];
+		uint8_t data[MaxDataSize];
+		uint8_t size;
+		uint8_t reserved;
+	};
+
+	enum class ESampleResult : int {
+		None = 0,
+		// between two samples
+		Interpolated = 1,
+		// past the newest sample, limited to the extrapolation window
+		Extrapolated = 2,
+		// a single sample, or a time before the oldest one
+		Held = 3,
+	};
+
+	// timestamped ring of one subscribed characteristic. written on the notification thread,
+	// read on the main thread; the owner (BleDeviceObject) serializes both with its notification mutex.
+	class BleSampleHistory {
+	private:
+		WinRtGuid m_serviceUuid;
+		WinRtGuid m_charastricsUuid;
+		std::vector<SampleField> m_fields;
+		// only notifications whose byte at m_matchOffset equals m_matchValue (m_matchOffset < 0: all)
+		int m_matchOffset;
+		uint8_t m_matchValue;
+
+		std::vector<HistorySample> m_samples;
+		uint64_t m_writeNum;
+
+		static double s_secPerTick;
+	public:
+		BleSampleHistory(const WinRtGuid& serviceUuid, const WinRtGuid& charastricsUuid, int capacity,
+			const SampleField* fields, int fieldNum, int matchOffset, int matchValue);
+
+		static double GetHostTime();
+
+		inline bool IsTarget(const WinRtGuid& serviceUuid, const WinRtGuid& charastricsUuid)const {
+			return m_serviceUuid == serviceUuid && m_charastricsUuid == charastricsUuid;
+		}
+		inline int GetFieldNum()const {
+			return static_cast<int>(m_fields.size());
+		}
+		inline int GetSampleNum()const {
+			return static_cast<int>((m_writeNum < m_samples.size()) ? m_writeNum : m_samples.size());
+		}
+
+		void Push(double time, const uint8_t* data, int size);
+		void Clear();
+		// newest maxNum samples, oldest first
+		int CopyLatest(HistorySample* out, int maxNum)const;
+		// field values at time; extrapolates at most maxExtrapolationSec past the newest sample
+		ESampleResult Sample(double time, float maxExtrapolationSec, float* outValues, int maxValues)const;
+	private:
+		const HistorySample& GetFromNewest(int idx)const;
+		bool Decode(const uint8_t* data, int size, float* outValues)const;
+		void Blend(const HistorySample& from, const HistorySample& to, double rate, float* outValues, int valueNum)const;
+	};
+}
@@ -0,0 +1,85 @@
+#include "BleSession.h"
+#include "BleDeviceManager.h"
+#include "BleDeviceObject.h"
+#include "BleDeviceWatcher.h"
+#include "BleNotificationRing.h"
+#include "UuidManager.h"
+#include <cstring>
+
+using namespace BlePlugin;
+
+BleSession BleSession::s_instance;
+
+BleSession::BleSession() :
+	m_isKeepAlive(false), m_isDetached(false)
+{
+}
+
+BleSession& BleSession::GetInstance() {
+	return s_instance;
+}
+
+void BleSession::Detach() {
+	BleDeviceWatcher& watcher = BleDeviceWatcher::GetInstance();
+	watcher.Stop();
+	watcher.ClearFilterServiceUUID();
+	// notifications arriving meanwhile stay untagged and get the new domain's ids when drained
+	BleDeviceManager::GetInstance().ClearNotificationSubscriberIds();
+	BleNotificationRing::GetInstance().ClearSubscriberIds();
+	m_isDetached = true;
+}
+
+int BleSession::Reattach(uint8_t* out, int capacity) {
+	this->BuildSnapshot();
+	int size = static_cast<int>(m_snapshot.size());
+	if (out != nullptr && capacity >= size) {
+		memcpy(out, m_snapshot.data(), size);
+		// the new domain subscribes again with ids of its own
+		BleDeviceManager::GetInstance().ClearNotificationSubscriberIds();
+		BleNotificationRing::GetInstance().ClearSubscriberIds();
+		m_isDetached = false;
+	}
+	return size;
+}
+
+void BleSession::BuildSnapshot() {
+	m_snapshot.clear();
+	m_snapshot.resize(sizeof(SessionHeader));
+	BleDeviceManager& manager = BleDeviceManager::GetInstance();
+	UuidManager& uuidMgr = UuidManager::GetInstance();
+	uint16_t deviceNum = 0;
+	int connectedNum = manager.GetConnectedDeviceNum();
+	for (int i = 0; i < connectedNum; ++i) {
+		BleDeviceObject* deviceObj = manager.GetConnectedDeviceByIndex(i);
+		// dropped while nobody was updating; the next update reports it as disconnected
+		if (deviceObj == nullptr || !deviceObj->IsLinkAlive()) {
+			continue;
+		}
+		int charastricsNum = deviceObj->GetCharastricsNum();
+		SessionDevice device = {};
+		device.addr = deviceObj->GetAddr();
+		device.charastricsNum = static_cast<uint16_t>(charastricsNum);
+		device.bufferedNotificationNum = static_cast<uint16_t>(deviceObj->GetBufferedNotificationNum());
+		device.droppedNotificationNum = deviceObj->GetDroppedNotificationNum();
+
+		size_t offset = m_snapshot.size();
+		m_snapshot.resize(offset + sizeof(SessionDevice) + charastricsNum * sizeof(SessionCharacteristic));
+		memcpy(m_snapshot.data() + offset, &device, sizeof(device));
+		offset += sizeof(SessionDevice);
+		for (int j = 0; j < charastricsNum; ++j) {
+			const WinRtBleCharacteristic& charastrics = deviceObj->GetCharastrics(j);
+			SessionCharacteristic entry = {};
+			entry.serviceUuid = reinterpret_cast<uint64_t>(uuidMgr.GetOrCreate(charastrics.Service().Uuid()));
+			entry.charastricsUuid = reinterpret_cast<uint64_t>(uuidMgr.GetOrCreate(charastrics.Uuid()));
+			entry.flags = deviceObj->IsSubscribed(j) ? FlagSubscribed : 0;
+			memcpy(m_snapshot.data() + offset, &entry, sizeof(entry));
+			offset += sizeof(SessionCharacteristic);
+		}
+		++deviceNum;
+	}
+	SessionHeader header = {};
+	header.magic = SnapshotMagic;
+	header.version = SnapshotVersion;
+	header.deviceNum = deviceNum;
+	memcpy(m_snapshot.data(), &header, sizeof(header));
+}
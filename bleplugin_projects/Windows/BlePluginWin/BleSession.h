@@ -0,0 +1,66 @@
+#pragma once
+
+#include "pch.h"
+#include <atomic>
+#include <vector>
+
+namespace BlePlugin {
+	// snapshot handed to the managed side by _BlePluginReattachSession (parsed in BleWin.ReattachSession).
+	// layout: SessionHeader, then per device SessionDevice followed by its SessionCharacteristic entries
+	struct SessionHeader {
+		uint32_t magic;
+		uint16_t version;
+		uint16_t deviceNum;
+	};
+	struct SessionDevice {
+		uint64_t addr;
+		uint16_t charastricsNum;
+		// notifications that arrived while detached, delivered by the next update
+		uint16_t bufferedNotificationNum;
+		// oldest ones dropped past BleDeviceObject::MaxBufferedNotificationNum while detached
+		uint32_t droppedNotificationNum;
+	};
+	struct SessionCharacteristic {
+		// UuidManager handles
+		uint64_t serviceUuid;
+		uint64_t charastricsUuid;
+		uint32_t flags;
+		uint32_t reserved;
+	};
+
+	// keeps the connections alive while the managed side goes away (Unity editor domain reload).
+	// with keep-alive on, Finalize only detaches: the scan stops, but devices, subscriptions and
+	// buffered notifications stay until the next domain reattaches.
+	class BleSession {
+	public:
+		static const uint32_t SnapshotMagic = 0x53454C42; // "BLES"
+		static const uint16_t SnapshotVersion = 1;
+		static const uint32_t FlagSubscribed = 1 << 0;
+	private:
+		static BleSession s_instance;
+
+		bool m_isKeepAlive;
+		// read by the notification threads
+		std::atomic<bool> m_isDetached;
+		std::vector<uint8_t> m_snapshot;
+
+		BleSession();
+		void BuildSnapshot();
+	public:
+		static BleSession& GetInstance();
+
+		inline void SetKeepAlive(bool enable) {
+			m_isKeepAlive = enable;
+		}
+		inline bool IsKeepAlive()const {
+			return m_isKeepAlive;
+		}
+		inline bool IsDetached()const {
+			return m_isDetached;
+		}
+		void Detach();
+		// copies the snapshot of the live session when it fits and ends the detached state.
+		// returns the snapshot size either way
+		int Reattach(uint8_t* out, int capacity);
+	};
+}
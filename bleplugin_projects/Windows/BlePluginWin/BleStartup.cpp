@@ -0,0 +1,134 @@
+#include "BleStartup.h"
+#include "BleDeviceWatcher.h"
+#include <algorithm>
+
+using namespace BlePlugin;
+
+BleStartup BleStartup::s_instance;
+
+BleStartup::BleStartup() :
+	m_isRunning(false), m_status(static_cast<int>(BluetoothAdapterChecker::EBluetoothStatus::None)), m_isAsync(false), m_isScanEarly(false),
+	m_isScanPending(false), m_isScanOwned(false)
+{
+	QueryPerformanceFrequency(&m_frequency);
+	this->RestartClock();
+}
+
+BleStartup::~BleStartup() {
+	// never join under the loader lock; a thread still checking at unload just goes away
+	if (m_thread.joinable()) {
+		m_thread.detach();
+	}
+}
+
+BleStartup& BleStartup::GetInstance() {
+	return s_instance;
+}
+
+bool BleStartup::Start(bool isScanEarly) {
+	if (m_isRunning.load(std::memory_order_acquire)) {
+		return false;
+	}
+	// already done, so this join doesn't block
+	this->Wait();
+	this->RestartClock();
+	m_isAsync = true;
+	m_isScanEarly = isScanEarly;
+	m_isScanPending = isScanEarly;
+	m_isScanOwned = false;
+	m_status.store(static_cast<int>(BluetoothAdapterChecker::EBluetoothStatus::None), std::memory_order_relaxed);
+	m_isRunning.store(true, std::memory_order_release);
+	m_thread = std::thread(&BleStartup::Run, this);
+	return true;
+}
+
+void BleStartup::Wait() {
+	if (m_thread.joinable()) {
+		m_thread.join();
+	}
+}
+
+void BleStartup::Run() {
+	using EBluetoothStatus = BluetoothAdapterChecker::EBluetoothStatus;
+	winrt::init_apartment(winrt::apartment_type::multi_threaded);
+	this->Mark(EStartupEvent::ApartmentReady);
+	EBluetoothStatus status = EBluetoothStatus::UnknownError;
+	try {
+		WinRtBluetoothAdapter adapter = WinRtBluetoothAdapter::GetDefaultAsync().get();
+		status = BluetoothAdapterChecker::CheckAdapter(adapter);
+		if (status == EBluetoothStatus::None) {
+			this->Mark(EStartupEvent::AdapterReady);
+			status = BluetoothAdapterChecker::CheckRadio(adapter.GetRadioAsync().get());
+		}
+	}
+	catch (winrt::hresult_error const&) {
+		status = EBluetoothStatus::UnknownError;
+	}
+	this->Mark(EStartupEvent::StatusReady);
+	m_status.store(static_cast<int>(status), std::memory_order_release);
+	m_isRunning.store(false, std::memory_order_release);
+}
+
+void BleStartup::Poll() {
+	BleDeviceWatcher& watcher = BleDeviceWatcher::GetInstance();
+	if (m_isScanPending) {
+		m_isScanPending = false;
+		m_isScanOwned = true;
+		watcher.Start();
+	}
+	if (!m_isScanOwned || this->IsRunning()) {
+		return;
+	}
+	m_isScanOwned = false;
+	if (this->GetStatus() != BluetoothAdapterChecker::EBluetoothStatus::Fine) {
+		watcher.Stop();
+	}
+}
+
+void BleStartup::OnScanControlled() {
+	m_isScanPending = false;
+	m_isScanOwned = false;
+}
+
+void BleStartup::Cancel() {
+	// the thread only checks the adapter; it finishes on its own and the next Start joins it
+	this->OnScanControlled();
+}
+
+void BleStartup::ResetTimings() {
+	if (m_isRunning.load(std::memory_order_acquire)) {
+		return;
+	}
+	this->RestartClock();
+}
+
+void BleStartup::RestartClock() {
+	QueryPerformanceCounter(&m_startCounter);
+	m_isAsync = false;
+	for (int i = 0; i < static_cast<int>(EStartupEvent::Num); ++i) {
+		m_eventTicks[i].store(0, std::memory_order_relaxed);
+	}
+}
+
+void BleStartup::MarkNow(std::atomic<int64_t>& ticks) {
+	LARGE_INTEGER now;
+	QueryPerformanceCounter(&now);
+	// never 0, which means unset
+	int64_t elapsed = (std::max)(now.QuadPart - m_startCounter.QuadPart, static_cast<int64_t>(1));
+	int64_t expected = 0;
+	ticks.compare_exchange_strong(expected, elapsed, std::memory_order_relaxed);
+}
+
+void BleStartup::GetTimings(StartupTimings& out)const {
+	double* fields[static_cast<int>(EStartupEvent::Num)] = {
+		&out.apartmentReadyMs, &out.adapterReadyMs, &out.statusReadyMs,
+		&out.scanStartedMs, &out.firstAdvertisementMs, &out.firstDeviceListedMs,
+	};
+	for (int i = 0; i < static_cast<int>(EStartupEvent::Num); ++i) {
+		int64_t ticks = m_eventTicks[i].load(std::memory_order_relaxed);
+		*fields[i] = (ticks == 0) ? -1.0 : static_cast<double>(ticks) * 1000.0 / static_cast<double>(m_frequency.QuadPart);
+	}
+	out.status = m_isAsync ? m_status.load(std::memory_order_acquire) :
+		static_cast<int32_t>(BluetoothAdapterChecker::GetInstance().GetStatus());
+	out.isScanEarly = m_isScanEarly ? 1 : 0;
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "pch.h"
+#include "BluetoothAdapterChecker.h"
+#include <windows.h>
+#include <atomic>
+#include <thread>
+
+namespace BlePlugin {
+	enum class EStartupEvent : int {
+		// WinRT initialized on the startup thread
+		ApartmentReady = 0,
+		// default adapter found and able to be a BLE central
+		AdapterReady,
+		// radio checked, the final status is known
+		StatusReady,
+		ScanStarted,
+		FirstAdvertisement,
+		// first UpdateCache that lists a device
+		FirstDeviceListed,
+		Num,
+	};
+
+	// exported as is (same layout as StartupTimings in DllInterface.cs).
+	// ms from the start request, -1 while it hasn't happened
+	struct StartupTimings {
+		double apartmentReadyMs;
+		double adapterReadyMs;
+		double statusReadyMs;
+		double scanStartedMs;
+		double firstAdvertisementMs;
+		double firstDeviceListedMs;
+		// BluetoothAdapterChecker::EBluetoothStatus, None (-1) while checking
+		int32_t status;
+		int32_t isScanEarly;
+	};
+
+	// startup without per-frame polling: one thread initializes WinRT, requests the adapter and
+	// blocks on the adapter and radio checks. the watcher is never touched from that thread:
+	// an early scan is started by the first Poll on the main thread, and stopped there again if
+	// the checks fail, unless the app has driven the watcher itself since. the scan filter has to
+	// be set before Start. also keeps the startup timings of the polled path
+	// (_BlePluginBleAdapterStatusRequest) so both can be compared.
+	class BleStartup {
+	private:
+		static BleStartup s_instance;
+
+		std::thread m_thread;
+		// from Start until Run is done; the thread is only joined once this is false
+		std::atomic<bool> m_isRunning;
+		std::atomic<int> m_status;
+		// started by Start rather than the polled path
+		bool m_isAsync;
+		bool m_isScanEarly;
+		// main thread: the early scan is still to be started / was started by Poll and is still ours
+		bool m_isScanPending;
+		bool m_isScanOwned;
+		LARGE_INTEGER m_frequency;
+		LARGE_INTEGER m_startCounter;
+		// counter ticks of each event, 0 until it happened
+		std::atomic<int64_t> m_eventTicks[static_cast<int>(EStartupEvent::Num)];
+
+		BleStartup();
+		~BleStartup();
+		void Run();
+		void RestartClock();
+		// only once IsRunning is false, so it never blocks
+		void Wait();
+	public:
+		static BleStartup& GetInstance();
+
+		// returns immediately; poll GetStatus. ignored (false) while a startup is still running:
+		// that one reports the status, and the frame never waits on its thread
+		bool Start(bool isScanEarly);
+		inline bool IsRunning()const {
+			return m_isRunning.load(std::memory_order_acquire);
+		}
+		// main thread, every status poll: starts the early scan, stops it when the checks failed
+		void Poll();
+		// the app started, stopped or refiltered the scan; the startup leaves the watcher alone
+		void OnScanControlled();
+		// finalize: drops the early scan without waiting for the checks
+		void Cancel();
+		inline BluetoothAdapterChecker::EBluetoothStatus GetStatus()const {
+			return static_cast<BluetoothAdapterChecker::EBluetoothStatus>(m_status.load(std::memory_order_acquire));
+		}
+
+		// restart the clock (polled path). left alone while the startup thread runs,
+		// whose timings and status it would clear
+		void ResetTimings();
+		// keeps the first occurrence; cheap once it is set
+		inline void Mark(EStartupEvent startupEvent) {
+			std::atomic<int64_t>& ticks = m_eventTicks[static_cast<int>(startupEvent)];
+			if (ticks.load(std::memory_order_relaxed) != 0) {
+				return;
+			}
+			this->MarkNow(ticks);
+		}
+		void GetTimings(StartupTimings& out)const;
+	private:
+		void MarkNow(std::atomic<int64_t>& ticks);
+	};
+}
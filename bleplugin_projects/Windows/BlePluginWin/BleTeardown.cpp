@@ -0,0 +1,146 @@
+#include "BleTeardown.h"
+#include "BleTimeline.h"
+#include <algorithm>
+
+using namespace BlePlugin;
+
+// Job / Batch
+BleTeardown::Job::Job(uint64_t _addr, std::vector<WinRtBleGattService>&& _services, const WinRtBleDevice& _device) :
+	addr(_addr), services(std::move(_services)), device(_device), closeTicks(0), isClosed(false)
+{
+}
+
+BleTeardown::Batch::Batch() :
+	remainingNum(0), doneEvent(CreateEventW(nullptr, TRUE, FALSE, nullptr))
+{
+	startCounter.QuadPart = 0;
+	deadlineCounter.QuadPart = 0;
+}
+
+BleTeardown::Batch::~Batch() {
+	if (doneEvent != nullptr) {
+		CloseHandle(doneEvent);
+	}
+}
+
+// BleTeardown
+BleTeardown BleTeardown::s_instance;
+
+BleTeardown::BleTeardown() {
+	QueryPerformanceFrequency(&m_frequency);
+}
+
+BleTeardown& BleTeardown::GetInstance() {
+	return s_instance;
+}
+
+void BleTeardown::Add(uint64_t addr, std::vector<WinRtBleGattService>&& services, const WinRtBleDevice& device) {
+	if (m_pending == nullptr) {
+		m_pending = std::make_shared<Batch>();
+	}
+	m_pending->jobs.emplace_back(new Job(addr, std::move(services), device));
+}
+
+void BleTeardown::Start(int timeoutMs) {
+	std::shared_ptr<Batch> batch = std::move(m_pending);
+	if (batch == nullptr) {
+		batch = std::make_shared<Batch>();
+	}
+	QueryPerformanceCounter(&batch->startCounter);
+	batch->deadlineCounter.QuadPart = batch->startCounter.QuadPart +
+		m_frequency.QuadPart * (timeoutMs > 0 ? timeoutMs : 0) / 1000;
+	batch->remainingNum.store(static_cast<int>(batch->jobs.size()));
+	if (batch->jobs.empty()) {
+		SetEvent(batch->doneEvent);
+	}
+	for (auto it = batch->jobs.begin(); it != batch->jobs.end(); ++it) {
+		CallbackContext* context = new CallbackContext{ batch, it->get() };
+		if (!TrySubmitThreadpoolCallback(CloseCallback, context, nullptr)) {
+			// no pool thread available: close here rather than leak the connection
+			CloseCallback(nullptr, context);
+		}
+	}
+	m_running = std::move(batch);
+}
+
+void CALLBACK BleTeardown::CloseCallback(PTP_CALLBACK_INSTANCE instance, void* context) {
+	std::unique_ptr<CallbackContext> ctx(reinterpret_cast<CallbackContext*>(context));
+	Job* job = ctx->job;
+	BLE_TIMELINE_ASYNC_BEGIN("teardown", job->addr);
+	try {
+		for (auto it = job->services.begin(); it != job->services.end(); ++it) {
+			it->Close();
+		}
+		if (job->device != nullptr) {
+			job->device.Close();
+		}
+	}
+	catch (const winrt::hresult_error&) {
+		// already gone; nothing left to release
+	}
+	job->services.clear();
+	job->device = nullptr;
+	LARGE_INTEGER now;
+	QueryPerformanceCounter(&now);
+	job->closeTicks = now.QuadPart - ctx->batch->startCounter.QuadPart;
+	job->isClosed.store(true, std::memory_order_release);
+	BLE_TIMELINE_ASYNC_END("teardown", job->addr);
+	if (ctx->batch->remainingNum.fetch_sub(1) == 1) {
+		SetEvent(ctx->batch->doneEvent);
+	}
+}
+
+BleTeardown::EStatus BleTeardown::Wait() {
+	if (m_running == nullptr) {
+		return EStatus::None;
+	}
+	LARGE_INTEGER now;
+	QueryPerformanceCounter(&now);
+	int64_t remainingTicks = m_running->deadlineCounter.QuadPart - now.QuadPart;
+	if (remainingTicks > 0) {
+		DWORD waitMs = static_cast<DWORD>(remainingTicks * 1000 / m_frequency.QuadPart) + 1;
+		WaitForSingleObject(m_running->doneEvent, waitMs);
+	}
+	return this->GetStatus();
+}
+
+BleTeardown::EStatus BleTeardown::GetStatus()const {
+	if (m_running == nullptr) {
+		return EStatus::None;
+	}
+	if (m_running->remainingNum.load() == 0) {
+		return EStatus::Completed;
+	}
+	LARGE_INTEGER now;
+	QueryPerformanceCounter(&now);
+	if (now.QuadPart >= m_running->deadlineCounter.QuadPart) {
+		return EStatus::TimedOut;
+	}
+	return EStatus::Running;
+}
+
+int BleTeardown::GetRecordNum()const {
+	if (m_running == nullptr) {
+		return 0;
+	}
+	return static_cast<int>(m_running->jobs.size());
+}
+
+int BleTeardown::CopyRecords(TeardownRecord* out, int maxNum)const {
+	if (m_running == nullptr || out == nullptr) {
+		return 0;
+	}
+	LARGE_INTEGER now;
+	QueryPerformanceCounter(&now);
+	const double msPerTick = 1000.0 / static_cast<double>(m_frequency.QuadPart);
+	int num = (std::min)(maxNum, static_cast<int>(m_running->jobs.size()));
+	for (int i = 0; i < num; ++i) {
+		const Job& job = *m_running->jobs[i];
+		bool isClosed = job.isClosed.load(std::memory_order_acquire);
+		int64_t closeTicks = isClosed ? job.closeTicks : (now.QuadPart - m_running->startCounter.QuadPart);
+		out[i].addr = job.addr;
+		out[i].isClosed = isClosed ? 1 : 0;
+		out[i].closeMs = static_cast<float>(closeTicks * msPerTick);
+	}
+	return num;
+}
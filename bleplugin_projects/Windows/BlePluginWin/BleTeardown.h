@@ -0,0 +1,80 @@
+#pragma once
+
+#include "pch.h"
+#include <windows.h>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace BlePlugin {
+	// exported as is (same layout as FinalizeRecord in DllInterface.cs)
+	struct TeardownRecord {
+		uint64_t addr;
+		// time the close took, or the time waited so far while isClosed is 0
+		float closeMs;
+		int32_t isClosed;
+	};
+
+	// closes the WinRT objects of disconnected devices on the thread pool, all devices in parallel.
+	// the caller only waits as long as it wants to; whatever misses the deadline keeps closing
+	// in the background.
+	class BleTeardown {
+	public:
+		enum class EStatus : int {
+			None = 0,
+			Running = 1,
+			Completed = 2,
+			// deadline passed with devices still closing
+			TimedOut = 3,
+		};
+		static const int DefaultTimeoutMs = 2000;
+	private:
+		struct Job {
+			uint64_t addr;
+			std::vector<WinRtBleGattService> services;
+			WinRtBleDevice device;
+			// counter ticks from the batch start, valid once isClosed is set
+			int64_t closeTicks;
+			std::atomic<bool> isClosed;
+
+			Job(uint64_t _addr, std::vector<WinRtBleGattService>&& _services, const WinRtBleDevice& _device);
+		};
+		// shared with the pool callbacks so a batch that missed its deadline stays alive
+		struct Batch {
+			std::vector<std::unique_ptr<Job> > jobs;
+			std::atomic<int> remainingNum;
+			HANDLE doneEvent;
+			LARGE_INTEGER startCounter;
+			LARGE_INTEGER deadlineCounter;
+
+			Batch();
+			~Batch();
+		};
+		struct CallbackContext {
+			std::shared_ptr<Batch> batch;
+			Job* job;
+		};
+
+		static BleTeardown s_instance;
+
+		std::shared_ptr<Batch> m_pending;
+		std::shared_ptr<Batch> m_running;
+		LARGE_INTEGER m_frequency;
+
+		BleTeardown();
+		static void CALLBACK CloseCallback(PTP_CALLBACK_INSTANCE instance, void* context);
+	public:
+		static BleTeardown& GetInstance();
+
+		// queue a device for the next Start
+		void Add(uint64_t addr, std::vector<WinRtBleGattService>&& services, const WinRtBleDevice& device);
+		// submit everything queued; returns immediately
+		void Start(int timeoutMs);
+		// blocks until the running batch completes or its deadline passes
+		EStatus Wait();
+		EStatus GetStatus()const;
+
+		int GetRecordNum()const;
+		int CopyRecords(TeardownRecord* out, int maxNum)const;
+	};
+}
@@ -0,0 +1,96 @@
+#include "BleTimeline.h"
+
+#if defined(BLEPLUGIN_TIMELINE)
+#include <cstdio>
+#include <algorithm>
+
+using namespace BlePlugin;
+
+TimelineRing::TimelineRing(uint32_t threadId) :
+	m_writeIndex(0), m_startIndex(0), m_threadId(threadId)
+{
+}
+
+Timeline Timeline::s_instance;
+thread_local TimelineRing* Timeline::t_ring = nullptr;
+
+Timeline::Timeline() :
+	m_isEnabled(false)
+{
+	QueryPerformanceFrequency(&m_frequency);
+	QueryPerformanceCounter(&m_startCounter);
+}
+
+Timeline& Timeline::GetInstance() {
+	return s_instance;
+}
+
+TimelineRing* Timeline::CreateRing() {
+	std::lock_guard lock(m_ringMutex);
+	m_rings.emplace_back(new TimelineRing(GetCurrentThreadId()));
+	t_ring = m_rings.back().get();
+	return t_ring;
+}
+
+void Timeline::Start() {
+	m_isEnabled.store(false);
+	{
+		std::lock_guard lock(m_ringMutex);
+		for (auto it = m_rings.begin(); it != m_rings.end(); ++it) {
+			// an event pushed concurrently may land before the mark; its ticks predate the new
+			// start counter, so Export drops it
+			(*it)->m_startIndex.store((*it)->m_writeIndex.load(std::memory_order_acquire), std::memory_order_relaxed);
+		}
+	}
+	QueryPerformanceCounter(&m_startCounter);
+	m_isEnabled.store(true);
+}
+
+void Timeline::Stop() {
+	m_isEnabled.store(false);
+}
+
+bool Timeline::Export(const wchar_t* path) {
+	FILE* fp = nullptr;
+	if (_wfopen_s(&fp, path, L"wb") != 0 || fp == nullptr) {
+		return false;
+	}
+	const double usPerTick = 1000000.0 / static_cast<double>(m_frequency.QuadPart);
+	fputs("{\"traceEvents\":[\n", fp);
+	bool isFirst = true;
+	std::lock_guard lock(m_ringMutex);
+	for (auto it = m_rings.begin(); it != m_rings.end(); ++it) {
+		const TimelineRing& ring = **it;
+		uint32_t end = ring.m_writeIndex.load(std::memory_order_acquire);
+		uint32_t begin = ring.m_startIndex.load(std::memory_order_relaxed);
+		if (end - begin > TimelineRing::Capacity) {
+			begin = end - TimelineRing::Capacity;
+		}
+		for (uint32_t i = begin; i != end; ++i) {
+			const TimelineEvent& ev = ring.m_events[i & (TimelineRing::Capacity - 1)];
+			double ts = static_cast<double>(ev.ticks - m_startCounter.QuadPart) * usPerTick;
+			if (ts < 0.0) {
+				continue;
+			}
+			fprintf(fp, "%s{\"name\":\"%s\",\"cat\":\"ble\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,\"tid\":%u",
+				isFirst ? "" : ",\n", ev.name, ev.phase, ts, ring.m_threadId);
+			switch (ev.phase) {
+			case 'b':
+			case 'e':
+				fprintf(fp, ",\"id\":\"0x%llx\"}", static_cast<unsigned long long>(ev.arg));
+				break;
+			case 'i':
+				fprintf(fp, ",\"s\":\"t\",\"args\":{\"value\":%llu}}", static_cast<unsigned long long>(ev.arg));
+				break;
+			default:
+				fputc('}', fp);
+				break;
+			}
+			isFirst = false;
+		}
+	}
+	fputs("\n]}\n", fp);
+	fclose(fp);
+	return true;
+}
+#endif
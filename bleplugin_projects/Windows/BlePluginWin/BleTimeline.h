@@ -0,0 +1,114 @@
+#pragma once
+
+#include "pch.h"
+
+// timeline of plugin activity exported as Chrome trace-event JSON
+// (chrome://tracing, ui.perfetto.dev). Define BLEPLUGIN_TIMELINE (pch.h) to build it in;
+// without it every BLE_TIMELINE_* macro expands to nothing.
+//   BLE_TIMELINE_SCOPE(name)          : begin/end span on the calling thread
+//   BLE_TIMELINE_INSTANT(name, arg)   : single point
+//   BLE_TIMELINE_ASYNC_BEGIN/END(name, id) : span that ends on another call or thread (id pairs them)
+// name must be a string literal (only the pointer is stored).
+
+#if defined(BLEPLUGIN_TIMELINE)
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <memory>
+#include <windows.h>
+
+namespace BlePlugin {
+	struct TimelineEvent {
+		int64_t ticks;
+		const char* name;
+		uint64_t arg;
+		char phase;
+	};
+
+	// single writer (its thread), read by Export. only the writer moves m_writeIndex;
+	// Start marks where the current recording begins instead of rewinding it
+	class TimelineRing {
+	public:
+		static const uint32_t Capacity = 1 << 14;
+	private:
+		TimelineEvent m_events[Capacity];
+		std::atomic<uint32_t> m_writeIndex;
+		std::atomic<uint32_t> m_startIndex;
+		uint32_t m_threadId;
+
+		friend class Timeline;
+	public:
+		TimelineRing(uint32_t threadId);
+		inline void Push(char phase, const char* name, uint64_t arg, int64_t ticks) {
+			uint32_t idx = m_writeIndex.load(std::memory_order_relaxed);
+			TimelineEvent& ev = m_events[idx & (Capacity - 1)];
+			ev.ticks = ticks;
+			ev.name = name;
+			ev.arg = arg;
+			ev.phase = phase;
+			m_writeIndex.store(idx + 1, std::memory_order_release);
+		}
+	};
+
+	class Timeline {
+	private:
+		static Timeline s_instance;
+		static thread_local TimelineRing* t_ring;
+
+		std::atomic<bool> m_isEnabled;
+		std::mutex m_ringMutex;
+		// rings outlive their threads (WinRT pool threads are reused anyway)
+		std::vector<std::unique_ptr<TimelineRing> > m_rings;
+		LARGE_INTEGER m_frequency;
+		LARGE_INTEGER m_startCounter;
+
+		Timeline();
+		TimelineRing* CreateRing();
+	public:
+		static Timeline& GetInstance();
+
+		void Start();
+		void Stop();
+		// call while the plugin is quiet; events written during the export may be torn
+		bool Export(const wchar_t* path);
+
+		inline static void Record(char phase, const char* name, uint64_t arg) {
+			Timeline& timeline = s_instance;
+			if (!timeline.m_isEnabled.load(std::memory_order_relaxed)) {
+				return;
+			}
+			TimelineRing* ring = t_ring;
+			if (ring == nullptr) {
+				ring = timeline.CreateRing();
+			}
+			LARGE_INTEGER counter;
+			QueryPerformanceCounter(&counter);
+			ring->Push(phase, name, arg, counter.QuadPart);
+		}
+	};
+
+	class TimelineScope {
+	private:
+		const char* m_name;
+	public:
+		inline TimelineScope(const char* name) : m_name(name) {
+			Timeline::Record('B', m_name, 0);
+		}
+		inline ~TimelineScope() {
+			Timeline::Record('E', m_name, 0);
+		}
+	};
+}
+
+#define BLE_TIMELINE_CONCAT_(a, b) a##b
+#define BLE_TIMELINE_CONCAT(a, b) BLE_TIMELINE_CONCAT_(a, b)
+#define BLE_TIMELINE_SCOPE(name) BlePlugin::TimelineScope BLE_TIMELINE_CONCAT(bleTimelineScope, __LINE__)(name)
+#define BLE_TIMELINE_INSTANT(name, arg) BlePlugin::Timeline::Record('i', name, static_cast<uint64_t>(arg))
+#define BLE_TIMELINE_ASYNC_BEGIN(name, id) BlePlugin::Timeline::Record('b', name, static_cast<uint64_t>(id))
+#define BLE_TIMELINE_ASYNC_END(name, id) BlePlugin::Timeline::Record('e', name, static_cast<uint64_t>(id))
+#else
+#define BLE_TIMELINE_SCOPE(name) ((void)0)
+#define BLE_TIMELINE_INSTANT(name, arg) ((void)0)
+#define BLE_TIMELINE_ASYNC_BEGIN(name, id) ((void)0)
+#define BLE_TIMELINE_ASYNC_END(name, id) ((void)0)
+#endif
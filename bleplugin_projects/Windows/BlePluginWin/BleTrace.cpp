@@ -0,0 +1,231 @@
+#include "BleTrace.h"
+#include "UuidCodec.h"
+#include <algorithm>
+
+using namespace BlePlugin;
+using namespace winrt::Windows::Foundation;
+
+// BleTraceWriter
+BleTraceWriter::BleTraceWriter() :
+	m_file(INVALID_HANDLE_VALUE), m_mapping(nullptr), m_view(nullptr),
+	m_capacity(0), m_offset(0)
+{
+}
+BleTraceWriter::~BleTraceWriter() {
+	this->Close();
+}
+
+bool BleTraceWriter::Open(const wchar_t* path) {
+	this->Close();
+	m_file = CreateFileW(path, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+		CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (m_file == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+	if (!this->Map(ChunkSize)) {
+		this->Close();
+		return false;
+	}
+	TraceFileHeader* header = reinterpret_cast<TraceFileHeader*>(m_view);
+	header->magic = TraceFileHeader::Magic;
+	header->version = TraceFileHeader::CurrentVersion;
+	header->dataSize = 0;
+	m_offset = sizeof(TraceFileHeader);
+	return true;
+}
+
+void BleTraceWriter::Close() {
+	if (m_view != nullptr) {
+		reinterpret_cast<TraceFileHeader*>(m_view)->dataSize = m_offset - sizeof(TraceFileHeader);
+	}
+	this->Unmap();
+	if (m_file != INVALID_HANDLE_VALUE) {
+		// drop the unused tail of the last chunk
+		LARGE_INTEGER size;
+		size.QuadPart = static_cast<LONGLONG>(m_offset);
+		SetFilePointerEx(m_file, size, nullptr, FILE_BEGIN);
+		SetEndOfFile(m_file);
+		CloseHandle(m_file);
+		m_file = INVALID_HANDLE_VALUE;
+	}
+	m_capacity = 0;
+	m_offset = 0;
+}
+
+bool BleTraceWriter::Append(const TraceRecordHeader& header, const void* payload0, int size0, const void* payload1, int size1) {
+	if (m_view == nullptr) {
+		return false;
+	}
+	uint64_t need = sizeof(TraceRecordHeader) + size0 + size1;
+	if (m_offset + need > m_capacity) {
+		reinterpret_cast<TraceFileHeader*>(m_view)->dataSize = m_offset - sizeof(TraceFileHeader);
+		uint64_t capacity = m_capacity + (std::max)(ChunkSize, need);
+		this->Unmap();
+		if (!this->Map(capacity)) {
+			return false;
+		}
+	}
+	uint8_t* dst = m_view + m_offset;
+	memcpy(dst, &header, sizeof(TraceRecordHeader));
+	dst += sizeof(TraceRecordHeader);
+	if (size0 > 0) {
+		memcpy(dst, payload0, size0);
+		dst += size0;
+	}
+	if (size1 > 0) {
+		memcpy(dst, payload1, size1);
+	}
+	m_offset += need;
+	reinterpret_cast<TraceFileHeader*>(m_view)->dataSize = m_offset - sizeof(TraceFileHeader);
+	return true;
+}
+
+bool BleTraceWriter::Map(uint64_t capacity) {
+	m_mapping = CreateFileMappingW(m_file, nullptr, PAGE_READWRITE,
+		static_cast<DWORD>(capacity >> 32), static_cast<DWORD>(capacity & 0xffffffff), nullptr);
+	if (m_mapping == nullptr) {
+		return false;
+	}
+	m_view = reinterpret_cast<uint8_t*>(MapViewOfFile(m_mapping, FILE_MAP_WRITE, 0, 0, 0));
+	if (m_view == nullptr) {
+		CloseHandle(m_mapping);
+		m_mapping = nullptr;
+		return false;
+	}
+	m_capacity = capacity;
+	return true;
+}
+
+void BleTraceWriter::Unmap() {
+	if (m_view != nullptr) {
+		UnmapViewOfFile(m_view);
+		m_view = nullptr;
+	}
+	if (m_mapping != nullptr) {
+		CloseHandle(m_mapping);
+		m_mapping = nullptr;
+	}
+}
+
+// BleTrace
+BleTrace BleTrace::s_instance;
+
+BleTrace::BleTrace() :
+	m_isCapturing(false)
+{
+	m_startCounter.QuadPart = 0;
+	QueryPerformanceFrequency(&m_frequency);
+}
+
+BleTrace& BleTrace::GetInstance() {
+	return s_instance;
+}
+
+bool BleTrace::StartCapture(const wchar_t* path) {
+	std::lock_guard lock(m_mutex);
+	if (!m_writer.Open(path)) {
+		m_isCapturing = false;
+		return false;
+	}
+	QueryPerformanceCounter(&m_startCounter);
+	m_isCapturing = true;
+	return true;
+}
+
+void BleTrace::StopCapture() {
+	std::lock_guard lock(m_mutex);
+	m_isCapturing = false;
+	m_writer.Close();
+}
+
+void BleTrace::RecordAdvertisement(uint64_t addr, int rssi) {
+	if (!this->IsCapturing()) {
+		return;
+	}
+	int16_t value = static_cast<int16_t>(rssi);
+	this->Record(ETraceEvent::Advertisement, addr, 0, &value, sizeof(value), nullptr, 0);
+}
+
+void BleTrace::RecordConnection(ETraceEvent type, uint64_t addr) {
+	if (!this->IsCapturing()) {
+		return;
+	}
+	this->Record(type, addr, 0, nullptr, 0, nullptr, 0);
+}
+
+void BleTrace::RecordGatt(ETraceEvent type, uint64_t addr, const WinRtGuid& serviceUuid, const WinRtGuid& charastricsUuid,
+	const uint8_t* data, int size, uint8_t status) {
+	if (!this->IsCapturing()) {
+		return;
+	}
+	uint8_t uuids[32];
+	UuidCodec::ToBytes(serviceUuid, uuids);
+	UuidCodec::ToBytes(charastricsUuid, uuids + 16);
+	this->Record(type, addr, status, uuids, sizeof(uuids), data, (data != nullptr) ? size : 0);
+}
+
+void BleTrace::WatchWrite(const WinRtBleCharacteristic& charastrics, WinRtAsyncOperation<WinRtGattWriteResult>& operation,
+	const uint8_t* data, int size) {
+	if (!this->IsCapturing()) {
+		return;
+	}
+	uint64_t addr = charastrics.Service().Device().BluetoothAddress();
+	WinRtGuid serviceUuid = charastrics.Service().Uuid();
+	WinRtGuid charastricsUuid = charastrics.Uuid();
+	this->RecordGatt(ETraceEvent::WriteRequest, addr, serviceUuid, charastricsUuid, data, size);
+	operation.Completed([addr, serviceUuid, charastricsUuid](const WinRtAsyncOperation<WinRtGattWriteResult>& op, AsyncStatus status) {
+		uint8_t result = static_cast<uint8_t>(WinRtGattCommunicateState::Unreachable);
+		if (status == AsyncStatus::Completed) {
+			result = static_cast<uint8_t>(op.GetResults().Status());
+		}
+		BleTrace::GetInstance().RecordGatt(ETraceEvent::WriteResponse, addr, serviceUuid, charastricsUuid, nullptr, 0, result);
+	});
+}
+
+void BleTrace::WatchRead(const WinRtBleCharacteristic& charastrics, WinRtAsyncOperation<WinRtGattReadResult>& operation) {
+	if (!this->IsCapturing()) {
+		return;
+	}
+	uint64_t addr = charastrics.Service().Device().BluetoothAddress();
+	WinRtGuid serviceUuid = charastrics.Service().Uuid();
+	WinRtGuid charastricsUuid = charastrics.Uuid();
+	this->RecordGatt(ETraceEvent::ReadRequest, addr, serviceUuid, charastricsUuid, nullptr, 0);
+	operation.Completed([addr, serviceUuid, charastricsUuid](const WinRtAsyncOperation<WinRtGattReadResult>& op, AsyncStatus status) {
+		if (status != AsyncStatus::Completed) {
+			BleTrace::GetInstance().RecordGatt(ETraceEvent::ReadResponse, addr, serviceUuid, charastricsUuid, nullptr, 0,
+				static_cast<uint8_t>(WinRtGattCommunicateState::Unreachable));
+			return;
+		}
+		auto result = op.GetResults();
+		auto value = result.Value();
+		const uint8_t* data = (value != nullptr) ? value.data() : nullptr;
+		int size = (value != nullptr) ? static_cast<int>(value.Length()) : 0;
+		BleTrace::GetInstance().RecordGatt(ETraceEvent::ReadResponse, addr, serviceUuid, charastricsUuid, data, size,
+			static_cast<uint8_t>(result.Status()));
+	});
+}
+
+uint64_t BleTrace::GetTimestampNs()const {
+	LARGE_INTEGER counter;
+	QueryPerformanceCounter(&counter);
+	uint64_t delta = static_cast<uint64_t>(counter.QuadPart - m_startCounter.QuadPart);
+	uint64_t frequency = static_cast<uint64_t>(m_frequency.QuadPart);
+	return (delta / frequency) * 1000000000ULL + (delta % frequency) * 1000000000ULL / frequency;
+}
+
+void BleTrace::Record(ETraceEvent type, uint64_t addr, uint8_t status, const void* payload0, int size0, const void* payload1, int size1) {
+	TraceRecordHeader header;
+	header.addr = addr;
+	header.type = static_cast<uint8_t>(type);
+	header.status = status;
+	header.size = static_cast<uint16_t>(size0 + size1);
+	header.reserved = 0;
+
+	std::lock_guard lock(m_mutex);
+	if (!m_isCapturing) {
+		return;
+	}
+	// taken under the lock so records stay in timestamp order
+	header.timestampNs = this->GetTimestampNs();
+	m_writer.Append(header, payload0, size0, payload1, size1);
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "pch.h"
+#include "BleTraceFormat.h"
+#include <windows.h>
+#include <atomic>
+#include <mutex>
+
+namespace BlePlugin {
+	// append-only writer over a memory mapped file that grows in ChunkSize steps
+	class BleTraceWriter {
+	private:
+		HANDLE m_file;
+		HANDLE m_mapping;
+		uint8_t* m_view;
+		uint64_t m_capacity;
+		uint64_t m_offset;
+	public:
+		static const uint64_t ChunkSize = 4 * 1024 * 1024;
+
+		BleTraceWriter();
+		~BleTraceWriter();
+
+		bool Open(const wchar_t* path);
+		void Close();
+		inline bool IsOpen()const {
+			return (m_view != nullptr);
+		}
+		bool Append(const TraceRecordHeader& header, const void* payload0, int size0, const void* payload1, int size1);
+	private:
+		bool Map(uint64_t capacity);
+		void Unmap();
+	};
+
+	// records every BLE event while a capture is running
+	class BleTrace {
+	private:
+		static BleTrace s_instance;
+
+		BleTraceWriter m_writer;
+		std::mutex m_mutex;
+		std::atomic<bool> m_isCapturing;
+		LARGE_INTEGER m_startCounter;
+		LARGE_INTEGER m_frequency;
+
+		BleTrace();
+	public:
+		static BleTrace& GetInstance();
+
+		bool StartCapture(const wchar_t* path);
+		void StopCapture();
+		inline bool IsCapturing()const {
+			return m_isCapturing.load(std::memory_order_relaxed);
+		}
+
+		void RecordAdvertisement(uint64_t addr, int rssi);
+		void RecordConnection(ETraceEvent type, uint64_t addr);
+		void RecordGatt(ETraceEvent type, uint64_t addr, const WinRtGuid& serviceUuid, const WinRtGuid& charastricsUuid,
+			const uint8_t* data, int size, uint8_t status = 0);
+
+		// records the request and its response once the operation completes
+		void WatchWrite(const WinRtBleCharacteristic& charastrics, WinRtAsyncOperation<WinRtGattWriteResult>& operation,
+			const uint8_t* data, int size);
+		void WatchRead(const WinRtBleCharacteristic& charastrics, WinRtAsyncOperation<WinRtGattReadResult>& operation);
+	private:
+		uint64_t GetTimestampNs()const;
+		void Record(ETraceEvent type, uint64_t addr, uint8_t status, const void* payload0, int size0, const void* payload1, int size1);
+	};
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+
+// no platform headers here: the reader side also builds on the host (bleplugin_projects/HostTests)
+namespace BlePlugin {
+	// binary trace file
+	//   TraceFileHeader
+	//   { TraceRecordHeader, payload[size] } ...
+	// payload
+	//   Advertisement : int16 rssi
+	//   Connect* / Disconnected : none
+	//   Gatt events : uint8 serviceUuid[16], uint8 charastricsUuid[16], data (UuidCodec::ToBytes order)
+	enum class ETraceEvent : uint8_t {
+		Advertisement = 1,
+		ConnectRequest = 2,
+		Connected = 3,
+		Disconnected = 4,
+		WriteRequest = 5,
+		WriteResponse = 6,
+		ReadRequest = 7,
+		ReadResponse = 8,
+		Notification = 9,
+	};
+
+#pragma pack(push, 1)
+	struct TraceFileHeader {
+		static const uint32_t Magic = 0x54454C42; // "BLET"
+		static const uint32_t CurrentVersion = 1;
+		uint32_t magic;
+		uint32_t version;
+		// bytes of records following the header (written on close and on every remap)
+		uint64_t dataSize;
+	};
+	struct TraceRecordHeader {
+		uint64_t timestampNs;
+		uint64_t addr;
+		uint8_t type;
+		// GattCommunicationStatus for responses
+		uint8_t status;
+		uint16_t size;
+		uint32_t reserved;
+	};
+#pragma pack(pop)
+}
@@ -0,0 +1,118 @@
+#include "BleTraceReader.h"
+#include <algorithm>
+#include <cstring>
+
+using namespace BlePlugin;
+
+BleTraceReader::BleTraceReader() :
+	m_end(0), m_offset(0), m_hasPending(false), m_pending(),
+	m_speed(1.0), m_isLoop(false), m_passStartNs(0.0), m_dispatchedNum(0)
+{
+}
+
+bool BleTraceReader::Open(const std::filesystem::path& path, float speed, bool loop) {
+	this->Close();
+	std::error_code error;
+	uint64_t fileSize = std::filesystem::file_size(path, error);
+	if (error || fileSize < sizeof(TraceFileHeader)) {
+		return false;
+	}
+	m_stream.open(path, std::ios::binary);
+	if (!m_stream.is_open()) {
+		return false;
+	}
+	TraceFileHeader header;
+	if (!m_stream.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+		header.magic != TraceFileHeader::Magic || header.version != TraceFileHeader::CurrentVersion) {
+		this->Close();
+		return false;
+	}
+	// a capture that was not closed still has a valid dataSize up to its last record
+	m_end = (std::min)(sizeof(TraceFileHeader) + header.dataSize, fileSize);
+	m_offset = sizeof(TraceFileHeader);
+	m_speed = speed;
+	m_isLoop = loop;
+	m_passStartNs = 0.0;
+	m_dispatchedNum = 0;
+	return true;
+}
+
+void BleTraceReader::Close() {
+	if (m_stream.is_open()) {
+		m_stream.close();
+	}
+	m_stream.clear();
+	m_end = 0;
+	m_offset = 0;
+	m_hasPending = false;
+}
+
+bool BleTraceReader::ReadNext() {
+	if (m_offset + sizeof(TraceRecordHeader) > m_end) {
+		return false;
+	}
+	// a record cut off at the end of the file (or a failed read) ends the trace there
+	TraceRecordHeader header;
+	if (!m_stream.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+		m_offset + sizeof(header) + header.size > m_end) {
+		m_end = m_offset;
+		return false;
+	}
+	m_payload.resize(header.size);
+	if (header.size > 0 && !m_stream.read(reinterpret_cast<char*>(m_payload.data()), header.size)) {
+		m_end = m_offset;
+		return false;
+	}
+	m_offset += sizeof(header) + header.size;
+	m_pending = header;
+	m_hasPending = true;
+	return true;
+}
+
+int BleTraceReader::Update(double elapsedNs, BleTraceSink& sink) {
+	if (!m_stream.is_open()) {
+		return 0;
+	}
+	int num = 0;
+	while (m_hasPending || this->ReadNext()) {
+		if (m_speed > 0.0 && static_cast<double>(m_pending.timestampNs) > (elapsedNs - m_passStartNs) * m_speed) {
+			return num;
+		}
+		Dispatch(m_pending, m_payload.data(), sink);
+		m_hasPending = false;
+		++m_dispatchedNum;
+		++num;
+	}
+	if (m_isLoop) {
+		m_stream.clear();
+		m_stream.seekg(static_cast<std::streamoff>(sizeof(TraceFileHeader)));
+		m_offset = sizeof(TraceFileHeader);
+		m_passStartNs = elapsedNs;
+	}
+	return num;
+}
+
+void BleTraceReader::Dispatch(const TraceRecordHeader& header, const uint8_t* payload, BleTraceSink& sink) {
+	switch (static_cast<ETraceEvent>(header.type)) {
+	case ETraceEvent::Advertisement:
+		if (header.size >= sizeof(int16_t)) {
+			int16_t rssi;
+			memcpy(&rssi, payload, sizeof(rssi));
+			sink.OnAdvertisement(header.addr, rssi);
+		}
+		break;
+	case ETraceEvent::Connected:
+		sink.OnConnected(header.addr);
+		break;
+	case ETraceEvent::Disconnected:
+		sink.OnDisconnected(header.addr);
+		break;
+	case ETraceEvent::Notification:
+		if (header.size >= 32) {
+			sink.OnNotification(header.addr, payload, payload + 16, payload + 32, header.size - 32);
+		}
+		break;
+	default:
+		break;
+	}
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "BleTraceFormat.h"
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace BlePlugin {
+	// receives the events of a replayed trace. uuids are in UuidCodec::ToBytes order.
+	class BleTraceSink {
+	public:
+		virtual ~BleTraceSink() {}
+		virtual void OnAdvertisement(uint64_t addr, int rssi) = 0;
+		virtual void OnConnected(uint64_t addr) = 0;
+		virtual void OnDisconnected(uint64_t addr) = 0;
+		virtual void OnNotification(uint64_t addr, const uint8_t* serviceUuid, const uint8_t* charastricsUuid,
+			const uint8_t* data, int size) = 0;
+	};
+
+	// streams a trace written by BleTrace and hands every record that is due to a sink.
+	// advertisements, connection changes and notifications are replayed; the request/response
+	// records are the app's own traffic and are skipped.
+	// it has no clock of its own: the caller passes the time since Open, so a replay driven by a
+	// virtual clock gives the same dispatch order and batching every run.
+	class BleTraceReader {
+	private:
+		std::ifstream m_stream;
+		uint64_t m_end;
+		uint64_t m_offset;
+		// read ahead, not dispatched yet
+		bool m_hasPending;
+		TraceRecordHeader m_pending;
+		std::vector<uint8_t> m_payload;
+		double m_speed;
+		bool m_isLoop;
+		// elapsed time the current pass started at
+		double m_passStartNs;
+		uint64_t m_dispatchedNum;
+	public:
+		BleTraceReader();
+
+		// speed 1.0 keeps the original timing, 0 (or less) replays everything on the next Update
+		bool Open(const std::filesystem::path& path, float speed, bool loop);
+		void Close();
+		inline bool IsOpen()const {
+			return m_stream.is_open();
+		}
+		inline uint64_t GetDispatchedNum()const {
+			return m_dispatchedNum;
+		}
+		// every record was dispatched (a looping reader starts over on the next Update)
+		inline bool IsAtEnd()const {
+			return !m_hasPending && m_offset + sizeof(TraceRecordHeader) > m_end;
+		}
+		// dispatches the records due at elapsedNs after Open. returns how many records were
+		// consumed, the skipped request/response records included
+		int Update(double elapsedNs, BleTraceSink& sink);
+
+		static void Dispatch(const TraceRecordHeader& header, const uint8_t* payload, BleTraceSink& sink);
+	private:
+		bool ReadNext();
+	};
+}
@@ -0,0 +1,58 @@
+#include "BleTraceReplayer.h"
+#include "BleDeviceWatcher.h"
+#include "BleDeviceManager.h"
+#include "BleDeviceObject.h"
+#include "UuidCodec.h"
+
+using namespace BlePlugin;
+
+BleTraceReplayer BleTraceReplayer::s_instance;
+
+BleTraceReplayer::BleTraceReplayer()
+{
+}
+
+BleTraceReplayer& BleTraceReplayer::GetInstance() {
+	return s_instance;
+}
+
+bool BleTraceReplayer::Start(const wchar_t* path, float speed, bool loop) {
+	this->Stop();
+	if (path == nullptr || !m_reader.Open(path, speed, loop)) {
+		return false;
+	}
+	m_startTime = Clock::now();
+	return true;
+}
+
+void BleTraceReplayer::Stop() {
+	m_reader.Close();
+}
+
+void BleTraceReplayer::Update() {
+	if (!m_reader.IsOpen()) {
+		return;
+	}
+	double elapsedNs = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - m_startTime).count());
+	m_reader.Update(elapsedNs, *this);
+}
+
+void BleTraceReplayer::OnAdvertisement(uint64_t addr, int rssi) {
+	BleDeviceWatcher::GetInstance().OnAdvertisement(addr, rssi);
+}
+
+void BleTraceReplayer::OnConnected(uint64_t addr) {
+	BleDeviceManager::GetInstance().AttachReplayDevice(addr);
+}
+
+void BleTraceReplayer::OnDisconnected(uint64_t addr) {
+	BleDeviceManager::GetInstance().DetachReplayDevice(addr);
+}
+
+void BleTraceReplayer::OnNotification(uint64_t addr, const uint8_t* serviceUuid, const uint8_t* charastricsUuid,
+	const uint8_t* data, int size) {
+	BleDeviceObject* device = BleDeviceManager::GetInstance().GetDeviceByAddr(addr);
+	if (device != nullptr) {
+		device->OnChangeValue(UuidCodec::FromBytes(serviceUuid), UuidCodec::FromBytes(charastricsUuid), data, size);
+	}
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "pch.h"
+#include "BleTraceReader.h"
+#include <chrono>
+
+namespace BlePlugin {
+	// feeds a trace written by BleTrace back into BleDeviceWatcher/BleDeviceManager in real time.
+	// reading and timing live in BleTraceReader, this only pushes the events into the plugin.
+	class BleTraceReplayer : private BleTraceSink {
+	private:
+		using Clock = std::chrono::steady_clock;
+
+		static BleTraceReplayer s_instance;
+
+		BleTraceReader m_reader;
+		Clock::time_point m_startTime;
+
+		BleTraceReplayer();
+	public:
+		static BleTraceReplayer& GetInstance();
+
+		// speed 1.0 keeps the original timing, 0 (or less) replays everything on the next Update
+		bool Start(const wchar_t* path, float speed, bool loop);
+		void Stop();
+		inline bool IsReplaying()const {
+			return m_reader.IsOpen();
+		}
+		inline int GetReplayedNum()const {
+			return static_cast<int>(m_reader.GetDispatchedNum());
+		}
+		// dispatch every record that is due; call once per frame before the watcher/manager update
+		void Update();
+	private:
+		void OnAdvertisement(uint64_t addr, int rssi) override;
+		void OnConnected(uint64_t addr) override;
+		void OnDisconnected(uint64_t addr) override;
+		void OnNotification(uint64_t addr, const uint8_t* serviceUuid, const uint8_t* charastricsUuid,
+			const uint8_t* data, int size) override;
+	};
+}
@@ -0,0 +1,71 @@
+#include "BleWriteBatch.h"
+#include "BleDeviceManager.h"
+#include "BleDeviceObject.h"
+
+using namespace BlePlugin;
+using namespace winrt::Windows::Foundation;
+
+BleWriteBatch::BleWriteBatch() :
+	m_failedNum(0)
+{
+}
+
+void BleWriteBatch::Submit(const WriteBatchRecord* records, int recordNum, const uint8_t* payload, int payloadSize, bool keepOperation) {
+	BleDeviceManager& manager = BleDeviceManager::GetInstance();
+	m_operations.reserve(m_operations.size() + recordNum);
+
+	// records are issued in array order, so the order per device is kept
+	for (int i = 0; i < recordNum; ++i) {
+		const WriteBatchRecord& record = records[i];
+		BleDeviceObject* deviceObj = manager.GetDeviceByAddr(record.addr);
+		WinRtGuid* serviceUuidObj = reinterpret_cast<WinRtGuid*>(record.serviceUuid);
+		WinRtGuid* charaUuidObj = reinterpret_cast<WinRtGuid*>(record.charastricsUuid);
+		// compared in 64 bit so dataOffset + dataSize can't overflow
+		bool isInPayload = record.dataOffset >= 0 && record.dataSize >= 0 &&
+			static_cast<int64_t>(record.dataOffset) + record.dataSize <= payloadSize;
+		if (deviceObj == nullptr || serviceUuidObj == nullptr ||
+			charaUuidObj == nullptr || !isInPayload) {
+			++m_failedNum;
+			continue;
+		}
+		auto option = (record.withResponse != 0) ?
+			WinRtGattWriteOption::WriteWithResponse :
+			WinRtGattWriteOption::WriteWithoutResponse;
+		auto operation = deviceObj->WriteRequest(*serviceUuidObj, *charaUuidObj,
+			payload + record.dataOffset, record.dataSize, option);
+		if (operation == nullptr) {
+			++m_failedNum;
+			continue;
+		}
+		if (keepOperation) {
+			m_operations.push_back(*operation);
+		}
+		// the batch holds its own reference, so the device does not need to keep it
+		deviceObj->RemoveWriteOperation(operation);
+	}
+}
+
+bool BleWriteBatch::IsComplete()const {
+	for (auto it = m_operations.begin(); it != m_operations.end(); ++it) {
+		if (it->Status() == AsyncStatus::Started) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool BleWriteBatch::IsError()const {
+	if (m_failedNum > 0) {
+		return true;
+	}
+	for (auto it = m_operations.begin(); it != m_operations.end(); ++it) {
+		if (it->Status() == AsyncStatus::Error) {
+			return true;
+		}
+		if (it->Status() == AsyncStatus::Completed &&
+			it->get().Status() != WinRtGattCommunicateState::Success) {
+			return true;
+		}
+	}
+	return false;
+}
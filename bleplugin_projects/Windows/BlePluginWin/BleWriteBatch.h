@@ -0,0 +1,35 @@
+#pragma once
+
+#include "pch.h"
+#include <vector>
+
+namespace BlePlugin {
+	// one record of _BlePluginWriteCharacteristicBatch (layout shared with C#)
+	struct WriteBatchRecord {
+		uint64_t addr;
+		void* serviceUuid;
+		void* charastricsUuid;
+		int32_t dataOffset;
+		int32_t dataSize;
+		int32_t withResponse;
+		int32_t reserved;
+	};
+
+	// aggregate completion of a batch write
+	class BleWriteBatch {
+	private:
+		std::vector< WinRtAsyncOperation< WinRtGattWriteResult> > m_operations;
+		int m_failedNum;
+	public:
+		BleWriteBatch();
+
+		// records outside [0, payloadSize) of the payload fail without being sent
+		void Submit(const WriteBatchRecord* records, int recordNum, const uint8_t* payload, int payloadSize, bool keepOperation);
+
+		bool IsComplete()const;
+		bool IsError()const;
+		inline int GetFailedNum()const {
+			return m_failedNum;
+		}
+	};
+}
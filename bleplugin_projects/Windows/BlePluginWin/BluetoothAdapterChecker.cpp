@@ -1,4 +1,5 @@
 #include "BluetoothAdapterChecker.h"
+#include "BleStartup.h"
 
 using namespace BlePlugin;
 using namespace winrt::Windows::Foundation;
@@ -40,15 +41,12 @@ void BluetoothAdapterChecker::UpdateWaitingAdapter() {
     }
     else if (asyncBluetoothAdapter.Status() == AsyncStatus::Completed) {
         this->adapter = asyncBluetoothAdapter.get();
-        if (this->adapter == nullptr) {
-            SetBluetoothStatus(EBluetoothStatus::UnknownError);
-            return;
-        }
-        if (!this->adapter.IsLowEnergySupported() ||
-            !this->adapter.IsCentralRoleSupported()) {
-            SetBluetoothStatus(EBluetoothStatus::NotSupportBle);
+        EBluetoothStatus adapterStatus = CheckAdapter(this->adapter);
+        if (adapterStatus != EBluetoothStatus::None) {
+            SetBluetoothStatus(adapterStatus);
             return;
         }
+        BleStartup::GetInstance().Mark(EStartupEvent::AdapterReady);
         this->asyncRadio = this->adapter.GetRadioAsync();
         status = ESearchStatus::WaitingRadio;
     }
@@ -59,19 +57,30 @@ void BluetoothAdapterChecker::UpdateWaitingRadio() {
     }
     else if (asyncRadio.Status() == AsyncStatus::Completed) {
         this->radio = asyncRadio.get();
-        if (this->radio == nullptr) {
-            SetBluetoothStatus(EBluetoothStatus::UnknownError);
-            return;
-        }
-        auto radioState = this->radio.State();
-        if (radioState  == RadioState::On) {
-            SetBluetoothStatus(EBluetoothStatus::Fine);
-            return;
-        }
-        else {
-            SetBluetoothStatus(EBluetoothStatus::BluetoothDisable);
-        }
+        SetBluetoothStatus(CheckRadio(this->radio));
+        BleStartup::GetInstance().Mark(EStartupEvent::StatusReady);
+    }
+}
+
+BluetoothAdapterChecker::EBluetoothStatus BluetoothAdapterChecker::CheckAdapter(const WinRtBluetoothAdapter& adapter) {
+    if (adapter == nullptr) {
+        return EBluetoothStatus::UnknownError;
+    }
+    if (!adapter.IsLowEnergySupported() ||
+        !adapter.IsCentralRoleSupported()) {
+        return EBluetoothStatus::NotSupportBle;
+    }
+    return EBluetoothStatus::None;
+}
+
+BluetoothAdapterChecker::EBluetoothStatus BluetoothAdapterChecker::CheckRadio(const WinRtRadio& radio) {
+    if (radio == nullptr) {
+        return EBluetoothStatus::UnknownError;
+    }
+    if (radio.State() == RadioState::On) {
+        return EBluetoothStatus::Fine;
     }
+    return EBluetoothStatus::BluetoothDisable;
 }
 
 bool supportBle(){
@@ -42,6 +42,11 @@ namespace BlePlugin {
         EBluetoothStatus GetStatus()const {
             return this->bluetoothStatus;
         }
+
+        // one step of the check each; None while the next step can go on.
+        // BleStartup runs the same steps blocking on its own thread
+        static EBluetoothStatus CheckAdapter(const WinRtBluetoothAdapter& adapter);
+        static EBluetoothStatus CheckRadio(const WinRtRadio& radio);
     private:
 
         void UpdateWaitingAdapter();
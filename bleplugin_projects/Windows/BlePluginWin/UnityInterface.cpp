@@ -3,7 +3,19 @@
 #include "BleDeviceWatcher.h"
 #include "BleDeviceManager.h"
 #include "BluetoothAdapterChecker.h"
+#include "BleAdapterPool.h"
+#include "BleWriteBatch.h"
 #include "UUidManager.h"
+#include "UuidCodec.h"
+#include "BleTrace.h"
+#include "BleTraceReplayer.h"
+#include "BleTimeline.h"
+#include "BleTeardown.h"
+#include "BleSession.h"
+#include "BleSampleHistory.h"
+#include "BlePayloadDecoder.h"
+#include "BleNotificationRing.h"
+#include "BleStartup.h"
 #include "Utility.h"
 #include <windows.h>
 #include "UnityInterface.h"
@@ -29,30 +41,163 @@ BOOL APIENTRY DllMain(HMODULE hModule,
 }
 
 DllExport void _BlePluginBleAdapterStatusRequest() {
+    BleStartup::GetInstance().ResetTimings();
     BluetoothAdapterChecker &checker = BluetoothAdapterChecker::GetInstance();
     checker.Request();
+    // a detached session still holds its adapter assignments
+    if (!BleSession::GetInstance().IsDetached()) {
+        BleAdapterPool::GetInstance().Request();
+    }
 }
 DllExport int _BlePluginBleAdapterUpdate() {
     BluetoothAdapterChecker& checker = BluetoothAdapterChecker::GetInstance();
     checker.Update();
+    BleAdapterPool::GetInstance().Update();
     return static_cast<int>( checker.GetStatus() );
 }
+DllExport void _BlePluginStartupAsync(bool scanImmediately) {
+	BLE_TIMELINE_SCOPE(__FUNCTION__);
+	BleStartup& startup = BleStartup::GetInstance();
+	// a second request while the first one checks: that one reports the status, nothing blocks
+	if (startup.IsRunning()) {
+		return;
+	}
+	if (!BleSession::GetInstance().IsDetached()) {
+		BleAdapterPool::GetInstance().Request();
+	}
+	startup.Start(scanImmediately);
+}
+DllExport int _BlePluginGetStartupStatus() {
+	// adapter enumeration and the early scan are still driven from here, on the main thread
+	BleAdapterPool::GetInstance().Update();
+	BleStartup& startup = BleStartup::GetInstance();
+	startup.Poll();
+	return static_cast<int>(startup.GetStatus());
+}
+DllExport bool _BlePluginIsStartupRunning() {
+	return BleStartup::GetInstance().IsRunning();
+}
+DllExport void _BlePluginGetStartupTimings(void* out) {
+	if (out == nullptr) {
+		return;
+	}
+	BleStartup::GetInstance().GetTimings(*reinterpret_cast<StartupTimings*>(out));
+}
+
+DllExport int _BlePluginGetAdapterNum() {
+	return BleAdapterPool::GetInstance().GetAdapterNum();
+}
+DllExport bool _BlePluginGetAdapterStats(int idx, void* out) {
+	if (out == nullptr) {
+		return false;
+	}
+	return BleAdapterPool::GetInstance().GetStats(idx, *reinterpret_cast<BleAdapterStats*>(out));
+}
+DllExport void _BlePluginSetAdapterPlacement(int placement) {
+	BleAdapterPool::GetInstance().SetPlacement(static_cast<EAdapterPlacement>(placement));
+}
+DllExport void _BlePluginPinDeviceToAdapter(uint64_t addr, int adapterIdx) {
+	BleAdapterPool::GetInstance().Pin(addr, adapterIdx);
+}
+DllExport int _BlePluginGetDeviceAdapter(uint64_t addr) {
+	return BleAdapterPool::GetInstance().GetAssigned(addr);
+}
 
 DllExport void _BlePluginFinalize() {
+	BLE_TIMELINE_SCOPE(__FUNCTION__);
+	_BlePluginFinalizeAsync(BleTeardown::DefaultTimeoutMs);
+	BleTeardown::GetInstance().Wait();
+}
+DllExport void _BlePluginFinalizeAsync(int timeoutMs) {
+	BLE_TIMELINE_SCOPE(__FUNCTION__);
+	BleSession& session = BleSession::GetInstance();
+	if (session.IsKeepAlive()) {
+		session.Detach();
+		return;
+	}
+	// a startup still checking is left to finish on its own; it never touches the watcher
+	BleStartup::GetInstance().Cancel();
 	BleDeviceWatcher& watcher = BleDeviceWatcher::GetInstance();
 	watcher.Stop();
 	watcher.ClearFilterServiceUUID();
 	BleDeviceManager& manager = BleDeviceManager::GetInstance();
-	manager.ResetAll();
+	manager.ResetAllAsync(timeoutMs);
+	BleAdapterPool::GetInstance().Clear();
+	BlePayloadDecoder::GetInstance().Clear();
+	BleNotificationRing::GetInstance().Disable();
+	BleTraceReplayer::GetInstance().Stop();
+	BleTrace::GetInstance().StopCapture();
+}
+DllExport int _BlePluginGetFinalizeStatus() {
+	return static_cast<int>(BleTeardown::GetInstance().GetStatus());
+}
+DllExport int _BlePluginGetFinalizeRecordNum() {
+	return BleTeardown::GetInstance().GetRecordNum();
+}
+DllExport int _BlePluginCopyFinalizeRecords(void* out, int maxNum) {
+	return BleTeardown::GetInstance().CopyRecords(reinterpret_cast<TeardownRecord*>(out), maxNum);
+}
+
+DllExport void _BlePluginSetKeepAlive(bool enable) {
+	BleSession::GetInstance().SetKeepAlive(enable);
+}
+DllExport bool _BlePluginIsSessionDetached() {
+	return BleSession::GetInstance().IsDetached();
+}
+DllExport int _BlePluginReattachSession(void* out, int capacity) {
+	BLE_TIMELINE_SCOPE(__FUNCTION__);
+	return BleSession::GetInstance().Reattach(reinterpret_cast<uint8_t*>(out), capacity);
+}
+
+DllExport bool _BlePluginStartCapture(const wchar_t* path) {
+	return BleTrace::GetInstance().StartCapture(path);
+}
+DllExport void _BlePluginStopCapture() {
+	BleTrace::GetInstance().StopCapture();
+}
+DllExport bool _BlePluginStartReplay(const wchar_t* path, float speed, bool loop) {
+	return BleTraceReplayer::GetInstance().Start(path, speed, loop);
+}
+DllExport void _BlePluginStopReplay() {
+	BleTraceReplayer::GetInstance().Stop();
+}
+DllExport bool _BlePluginIsReplaying() {
+	return BleTraceReplayer::GetInstance().IsReplaying();
+}
+
+DllExport bool _BlePluginTimelineStart() {
+#if defined(BLEPLUGIN_TIMELINE)
+	Timeline::GetInstance().Start();
+	return true;
+#else
+	return false;
+#endif
+}
+DllExport void _BlePluginTimelineStop() {
+#if defined(BLEPLUGIN_TIMELINE)
+	Timeline::GetInstance().Stop();
+#endif
+}
+DllExport bool _BlePluginTimelineExport(const wchar_t* path) {
+#if defined(BLEPLUGIN_TIMELINE)
+	return Timeline::GetInstance().Export(path);
+#else
+	return false;
+#endif
 }
 
 DllExport void _BlePluginUpdateWatcher() {
+	BLE_TIMELINE_SCOPE(__FUNCTION__);
+	BleTraceReplayer::GetInstance().Update();
 	BleDeviceWatcher& watcher = BleDeviceWatcher::GetInstance();
 	watcher.UpdateCache();
 }
 
 
 DllExport void _BlePluginUpdateDevicdeManger() {
+	BLE_TIMELINE_SCOPE(__FUNCTION__);
+	// adapters still enumerating after the status check finished
+	BleAdapterPool::GetInstance().Update();
 	BleDeviceManager& manager = BleDeviceManager::GetInstance();
 	manager.Update();
 }
@@ -67,22 +212,77 @@ DllExport void _BlePluginConvertUuidUint128(UuidHandle ptr, void* out) {
 	Utility::ConvertFromGUID(*guid, reinterpret_cast<uint32_t*>(out));
 }
 
+DllExport UuidHandle _BlePluginParseUuidString(const char* str, int length) {
+	WinRtGuid guid;
+	if (!UuidCodec::Parse(str, length, guid)) {
+		return nullptr;
+	}
+	return UuidManager::GetInstance().GetOrCreate(guid);
+}
+// a null handle is formatted as the nil uuid, so the caller always gets StringLength characters
+static const WinRtGuid& GetGuidOrNil(UuidHandle uuid) {
+	static const WinRtGuid s_nilGuid{};
+	return (uuid != nullptr) ? *reinterpret_cast<WinRtGuid*>(uuid) : s_nilGuid;
+}
+DllExport void _BlePluginFormatUuidString(UuidHandle uuid, char* out) {
+	if (out == nullptr) {
+		return;
+	}
+	UuidCodec::Format(GetGuidOrNil(uuid), out);
+}
+DllExport int _BlePluginParseUuidStrings(const char* buffer, const int* lengths, int num, UuidHandle* out) {
+	UuidManager& manager = UuidManager::GetInstance();
+	int parsedNum = 0;
+	WinRtGuid guid;
+	for (int i = 0; i < num; ++i) {
+		if (UuidCodec::Parse(buffer, lengths[i], guid)) {
+			out[i] = manager.GetOrCreate(guid);
+			++parsedNum;
+		}
+		else {
+			out[i] = nullptr;
+		}
+		buffer += lengths[i];
+	}
+	return parsedNum;
+}
+DllExport void _BlePluginFormatUuidStrings(const UuidHandle* uuids, int num, char* out) {
+	if (uuids == nullptr || out == nullptr) {
+		return;
+	}
+	for (int i = 0; i < num; ++i) {
+		UuidCodec::Format(GetGuidOrNil(uuids[i]), out + i * UuidCodec::StringLength);
+	}
+}
+DllExport bool _BlePluginGetShortUuid(UuidHandle uuid, uint32_t* out) {
+	if (uuid == nullptr || out == nullptr) {
+		return false;
+	}
+	return UuidCodec::TryGetShortUuid(*reinterpret_cast<WinRtGuid*>(uuid), *out);
+}
+
 
 DllExport void _BlePluginAddScanServiceUuid(UuidHandle uuid) {
 	auto guid = reinterpret_cast<WinRtGuid*>(uuid);
+	BleStartup::GetInstance().OnScanControlled();
 	BleDeviceWatcher& watcher = BleDeviceWatcher::GetInstance();
 	watcher.AddServiceUUID(*guid);
 }
 DllExport void _BlePluginStartScan() {
+	BLE_TIMELINE_SCOPE(__FUNCTION__);
+	BleStartup::GetInstance().OnScanControlled();
 	BleDeviceWatcher& watcher = BleDeviceWatcher::GetInstance();
 	watcher.Start();
 }
 DllExport void _BlePluginStopScan() {
+	BLE_TIMELINE_SCOPE(__FUNCTION__);
+	BleStartup::GetInstance().OnScanControlled();
 	BleDeviceWatcher& watcher = BleDeviceWatcher::GetInstance();
 	watcher.Stop();
 }
 
 DllExport void _BlePluginClearScanFilter() {
+	BleStartup::GetInstance().OnScanControlled();
 	BleDeviceWatcher& watcher = BleDeviceWatcher::GetInstance();
 	watcher.ClearFilterServiceUUID();
 }
@@ -113,19 +313,48 @@ DllExport void _BlePluginScanCopyDeviceManifactureData(int idx, void* ptr, int m
 
 
 DllExport DeviceHandle _BlePluginConnectDevice(uint64_t addr) {
+	BLE_TIMELINE_SCOPE(__FUNCTION__);
 	BleDeviceManager& manager = BleDeviceManager::GetInstance();
 	BleDeviceObject *obj = manager.ConnectDevice(addr);
 	return obj;
 }
+DllExport DeviceHandle _BlePluginConnectDeviceWithServices(uint64_t addr, UuidHandle* serviceUuids, int serviceNum) {
+	BLE_TIMELINE_SCOPE(__FUNCTION__);
+	if (serviceUuids == nullptr && serviceNum > 0) {
+		return nullptr;
+	}
+	std::vector<WinRtGuid> serviceFilter;
+	for (int i = 0; i < serviceNum; ++i) {
+		WinRtGuid* guid = reinterpret_cast<WinRtGuid*>(serviceUuids[i]);
+		if (guid == nullptr) {
+			continue;
+		}
+		serviceFilter.push_back(*guid);
+	}
+	BleDeviceManager& manager = BleDeviceManager::GetInstance();
+	BleDeviceObject* obj = manager.ConnectDevice(addr, serviceFilter);
+	return obj;
+}
 DllExport void _BlePluginDisconnectDevice(uint64_t addr) {
+	BLE_TIMELINE_SCOPE(__FUNCTION__);
 	BleDeviceManager& manager = BleDeviceManager::GetInstance();
 	manager.DisconnectDevice(addr);
 }
 
 DllExport void _BlePluginDisconnectAllDevice() {
+	BLE_TIMELINE_SCOPE(__FUNCTION__);
 	BleDeviceManager& manager = BleDeviceManager::GetInstance();
 	manager.DisconnectAll();
 }
+DllExport void _BlePluginSetDeviceIdleEviction(float timeoutSec, int poolSize) {
+	BleDeviceManager::GetInstance().SetIdleEviction(timeoutSec, poolSize);
+}
+DllExport void _BlePluginGetDeviceResidentStats(void* out) {
+	if (out == nullptr) {
+		return;
+	}
+	BleDeviceManager::GetInstance().GetResidentStats(*reinterpret_cast<DeviceResidentStats*>(out));
+}
 
 DllExport bool _BlePluginIsDeviceConnectedByAddr(uint64_t addr) {
 	BleDeviceManager& manager = BleDeviceManager::GetInstance();
@@ -204,6 +433,7 @@ DllExport UuidHandle _BlePluginDeviceCharastricServiceUuid(DeviceHandle devicePt
 
 
 DllExport ReadRequestHandle _BlePluginReadCharacteristicRequest(uint64_t addr, UuidHandle serviceUuid, UuidHandle charaUuid) {
+	BLE_TIMELINE_SCOPE(__FUNCTION__);
 	BleDeviceManager& manager = BleDeviceManager::GetInstance();
 	BleDeviceObject* deviceObj = manager.GetDeviceByAddr(addr);
 	WinRtGuid* serviceUuidObj = reinterpret_cast<WinRtGuid*>(serviceUuid);
@@ -217,6 +447,7 @@ DllExport ReadRequestHandle _BlePluginReadCharacteristicRequest(uint64_t addr, U
 }
 
 DllExport WriteRequestHandle _BlePluginWriteCharacteristicRequest(uint64_t addr, UuidHandle serviceUuid, UuidHandle charaUuid, void* data, int size) {
+	BLE_TIMELINE_SCOPE(__FUNCTION__);
 
 	BleDeviceManager& manager = BleDeviceManager::GetInstance();
 	BleDeviceObject *deviceObj = manager.GetDeviceByAddr(addr);
@@ -246,6 +477,7 @@ DllExport bool _BlePluginIsReadRequestError(ReadRequestHandle ptr) {
 	return (operation->Status() == AsyncStatus::Error);
 }
 DllExport int _BlePluginCopyReadRequestData(ReadRequestHandle ptr, void* data, int maxSize) {
+	BLE_TIMELINE_SCOPE(__FUNCTION__);
 	auto operation = reinterpret_cast<WinRtAsyncOperation< WinRtGattReadResult>*>(ptr);
 	if (operation == nullptr) {
 		return 0;
@@ -309,9 +541,201 @@ DllExport void _BlePluginReleaseWriteRequest(uint64_t deviceaddr, WriteRequestHa
 	deviceObj->RemoveWriteOperation(operation);
 }
 
+// Batch Write
+DllExport WriteBatchHandle _BlePluginWriteCharacteristicBatch(const void* records, int recordNum, const void* payload, int payloadSize, bool needCompletion) {
+	BLE_TIMELINE_SCOPE(__FUNCTION__);
+	if (records == nullptr || recordNum <= 0 || payloadSize < 0 || (payload == nullptr && payloadSize > 0)) {
+		return nullptr;
+	}
+	BleWriteBatch* batch = new BleWriteBatch();
+	batch->Submit(reinterpret_cast<const WriteBatchRecord*>(records), recordNum,
+		reinterpret_cast<const uint8_t*>(payload), payloadSize, needCompletion);
+	if (!needCompletion) {
+		delete batch;
+		return nullptr;
+	}
+	return batch;
+}
+DllExport bool _BlePluginIsWriteBatchComplete(WriteBatchHandle ptr) {
+	BleWriteBatch* batch = reinterpret_cast<BleWriteBatch*>(ptr);
+	if (batch == nullptr) {
+		return true;
+	}
+	return batch->IsComplete();
+}
+DllExport bool _BlePluginIsWriteBatchError(WriteBatchHandle ptr) {
+	BleWriteBatch* batch = reinterpret_cast<BleWriteBatch*>(ptr);
+	if (batch == nullptr) {
+		return false;
+	}
+	return batch->IsError();
+}
+DllExport void _BlePluginReleaseWriteBatch(WriteBatchHandle ptr) {
+	BleWriteBatch* batch = reinterpret_cast<BleWriteBatch*>(ptr);
+	delete batch;
+}
+
+// Scheduled Read/Write
+DllExport void _BlePluginSetOperationSchedulerConfig(uint64_t addr, int maxInFlight, float connectionIntervalMs, int operationsPerInterval) {
+	BleDeviceManager& manager = BleDeviceManager::GetInstance();
+	BleDeviceObject* deviceObj = manager.GetDeviceByAddr(addr);
+	if (deviceObj == nullptr) {
+		return;
+	}
+	deviceObj->GetScheduler().SetConfig(maxInFlight, connectionIntervalMs, operationsPerInterval);
+}
+DllExport void _BlePluginSetWriteCoalescing(uint64_t addr, UuidHandle serviceUuid, UuidHandle charaUuid, bool enable) {
+	BleDeviceManager& manager = BleDeviceManager::GetInstance();
+	BleDeviceObject* deviceObj = manager.GetDeviceByAddr(addr);
+	WinRtGuid* serviceUuidObj = reinterpret_cast<WinRtGuid*>(serviceUuid);
+	WinRtGuid* charaUuidObj = reinterpret_cast<WinRtGuid*>(charaUuid);
+	if (deviceObj == nullptr || serviceUuidObj == nullptr ||
+		charaUuidObj == nullptr) {
+		return;
+	}
+	deviceObj->SetWriteCoalescing(*serviceUuidObj, *charaUuidObj, enable);
+}
+DllExport void _BlePluginSetReadCache(uint64_t addr, UuidHandle serviceUuid, UuidHandle charaUuid, float ttlMs) {
+	BleDeviceManager& manager = BleDeviceManager::GetInstance();
+	BleDeviceObject* deviceObj = manager.GetDeviceByAddr(addr);
+	WinRtGuid* serviceUuidObj = reinterpret_cast<WinRtGuid*>(serviceUuid);
+	WinRtGuid* charaUuidObj = reinterpret_cast<WinRtGuid*>(charaUuid);
+	if (deviceObj == nullptr || serviceUuidObj == nullptr ||
+		charaUuidObj == nullptr) {
+		return;
+	}
+	deviceObj->SetReadCache(*serviceUuidObj, *charaUuidObj, ttlMs);
+}
+DllExport OperationHandle _BlePluginScheduleWriteRequest(uint64_t addr, UuidHandle serviceUuid, UuidHandle charaUuid, void* data, int size, bool withResponse, int priority) {
+	BLE_TIMELINE_SCOPE(__FUNCTION__);
+	BleDeviceManager& manager = BleDeviceManager::GetInstance();
+	BleDeviceObject* deviceObj = manager.GetDeviceByAddr(addr);
+	WinRtGuid* serviceUuidObj = reinterpret_cast<WinRtGuid*>(serviceUuid);
+	WinRtGuid* charaUuidObj = reinterpret_cast<WinRtGuid*>(charaUuid);
+	if (deviceObj == nullptr || serviceUuidObj == nullptr ||
+		charaUuidObj == nullptr) {
+		return nullptr;
+	}
+	auto option = withResponse ? WinRtGattWriteOption::WriteWithResponse : WinRtGattWriteOption::WriteWithoutResponse;
+	return deviceObj->ScheduleWrite(*serviceUuidObj, *charaUuidObj,
+		reinterpret_cast<uint8_t*>(data), size, option, static_cast<EOperationPriority>(priority));
+}
+DllExport OperationHandle _BlePluginScheduleReadRequest(uint64_t addr, UuidHandle serviceUuid, UuidHandle charaUuid, int priority) {
+	BLE_TIMELINE_SCOPE(__FUNCTION__);
+	BleDeviceManager& manager = BleDeviceManager::GetInstance();
+	BleDeviceObject* deviceObj = manager.GetDeviceByAddr(addr);
+	WinRtGuid* serviceUuidObj = reinterpret_cast<WinRtGuid*>(serviceUuid);
+	WinRtGuid* charaUuidObj = reinterpret_cast<WinRtGuid*>(charaUuid);
+	if (deviceObj == nullptr || serviceUuidObj == nullptr ||
+		charaUuidObj == nullptr) {
+		return nullptr;
+	}
+	return deviceObj->ScheduleRead(*serviceUuidObj, *charaUuidObj, static_cast<EOperationPriority>(priority));
+}
+DllExport int _BlePluginGetOperationStatus(OperationHandle ptr) {
+	BleGattOperation* operation = reinterpret_cast<BleGattOperation*>(ptr);
+	if (operation == nullptr) {
+		return static_cast<int>(BleGattOperation::EStatus::Error);
+	}
+	return static_cast<int>(operation->GetStatus());
+}
+DllExport int _BlePluginCopyOperationData(OperationHandle ptr, void* data, int maxSize) {
+	BLE_TIMELINE_SCOPE(__FUNCTION__);
+	BleGattOperation* operation = reinterpret_cast<BleGattOperation*>(ptr);
+	if (operation == nullptr ||
+		operation->GetType() != BleGattOperation::EType::Read ||
+		operation->GetStatus() != BleGattOperation::EStatus::Completed) {
+		return 0;
+	}
+	const std::vector<uint8_t>& src = operation->GetData();
+	int size = static_cast<int>(src.size());
+	uint8_t* dest = reinterpret_cast<uint8_t*>(data);
+	for (int i = 0; i < size && i < maxSize; ++i) {
+		dest[i] = src[i];
+	}
+	return size;
+}
+DllExport void _BlePluginReleaseOperation(uint64_t deviceaddr, OperationHandle ptr) {
+	BleDeviceManager& manager = BleDeviceManager::GetInstance();
+	BleDeviceObject* deviceObj = manager.GetDeviceByAddr(deviceaddr);
+	if (deviceObj == nullptr) {
+		return;
+	}
+	deviceObj->ReleaseOperation(reinterpret_cast<BleGattOperation*>(ptr));
+}
+DllExport bool _BlePluginGetOperationSchedulerStats(uint64_t addr, void* out) {
+	BleDeviceManager& manager = BleDeviceManager::GetInstance();
+	BleDeviceObject* deviceObj = manager.GetDeviceByAddr(addr);
+	if (deviceObj == nullptr || out == nullptr) {
+		return false;
+	}
+	deviceObj->GetScheduler().GetStats(reinterpret_cast<OperationSchedulerStats*>(out));
+	return true;
+}
+
+DllExport BulkTransferHandle _BlePluginStartBulkWrite(uint64_t addr, UuidHandle serviceUuid, UuidHandle charaUuid,
+	const void* data, int size, int chunkSize, int window, int checkpointInterval) {
+	BLE_TIMELINE_SCOPE(__FUNCTION__);
+	BleDeviceManager& manager = BleDeviceManager::GetInstance();
+	BleDeviceObject* deviceObj = manager.GetDeviceByAddr(addr);
+	WinRtGuid* serviceUuidObj = reinterpret_cast<WinRtGuid*>(serviceUuid);
+	WinRtGuid* charaUuidObj = reinterpret_cast<WinRtGuid*>(charaUuid);
+	if (deviceObj == nullptr || serviceUuidObj == nullptr ||
+		charaUuidObj == nullptr) {
+		return nullptr;
+	}
+	return deviceObj->StartBulkWrite(*serviceUuidObj, *charaUuidObj, reinterpret_cast<const uint8_t*>(data), size,
+		chunkSize, window, checkpointInterval);
+}
+DllExport BulkTransferHandle _BlePluginStartBulkReceive(uint64_t addr, UuidHandle serviceUuid, UuidHandle charaUuid,
+	int expectedSize, int headerSize) {
+	BleDeviceManager& manager = BleDeviceManager::GetInstance();
+	BleDeviceObject* deviceObj = manager.GetDeviceByAddr(addr);
+	WinRtGuid* serviceUuidObj = reinterpret_cast<WinRtGuid*>(serviceUuid);
+	WinRtGuid* charaUuidObj = reinterpret_cast<WinRtGuid*>(charaUuid);
+	if (deviceObj == nullptr || serviceUuidObj == nullptr ||
+		charaUuidObj == nullptr) {
+		return nullptr;
+	}
+	return deviceObj->StartBulkReceive(*serviceUuidObj, *charaUuidObj, expectedSize, headerSize);
+}
+DllExport bool _BlePluginGetBulkTransferProgress(uint64_t addr, BulkTransferHandle transfer, void* out) {
+	BleDeviceManager& manager = BleDeviceManager::GetInstance();
+	BleDeviceObject* deviceObj = manager.GetDeviceByAddr(addr);
+	if (deviceObj == nullptr || out == nullptr) {
+		return false;
+	}
+	return deviceObj->GetBulkTransferProgress(transfer, *reinterpret_cast<BulkTransferProgress*>(out));
+}
+DllExport int _BlePluginCopyBulkReceiveData(uint64_t addr, BulkTransferHandle transfer, void* out, int maxSize) {
+	BleDeviceManager& manager = BleDeviceManager::GetInstance();
+	BleDeviceObject* deviceObj = manager.GetDeviceByAddr(addr);
+	if (deviceObj == nullptr) {
+		return 0;
+	}
+	return deviceObj->CopyBulkReceiveData(transfer, reinterpret_cast<uint8_t*>(out), maxSize);
+}
+DllExport void _BlePluginCancelBulkTransfer(uint64_t addr, BulkTransferHandle transfer) {
+	BleDeviceManager& manager = BleDeviceManager::GetInstance();
+	BleDeviceObject* deviceObj = manager.GetDeviceByAddr(addr);
+	if (deviceObj == nullptr) {
+		return;
+	}
+	deviceObj->CancelBulkTransfer(transfer);
+}
+DllExport void _BlePluginReleaseBulkTransfer(uint64_t addr, BulkTransferHandle transfer) {
+	BleDeviceManager& manager = BleDeviceManager::GetInstance();
+	BleDeviceObject* deviceObj = manager.GetDeviceByAddr(addr);
+	if (deviceObj == nullptr) {
+		return;
+	}
+	deviceObj->ReleaseBulkTransfer(transfer);
+}
+
 
 // Notification
 DllExport void _BlePluginSetNotificateRequest(uint64_t addr, UuidHandle serviceUuid, UuidHandle charaUuid, bool enable) {
+	BLE_TIMELINE_SCOPE(__FUNCTION__);
 	BleDeviceManager& manager = BleDeviceManager::GetInstance();
 	BleDeviceObject* deviceObj = manager.GetDeviceByAddr(addr);
 	WinRtGuid* serviceUuidObj = reinterpret_cast<WinRtGuid*>(serviceUuid);
@@ -324,6 +748,7 @@ DllExport void _BlePluginSetNotificateRequest(uint64_t addr, UuidHandle serviceU
 }
 
 DllExport int _BlePluginGetDeviceNotificateNum(uint64_t addr) {
+	BLE_TIMELINE_SCOPE(__FUNCTION__);
 	BleDeviceManager& manager = BleDeviceManager::GetInstance();
 	BleDeviceObject* deviceObj = manager.GetDeviceByAddr(addr);
 	if (deviceObj == nullptr) {
@@ -332,6 +757,7 @@ DllExport int _BlePluginGetDeviceNotificateNum(uint64_t addr) {
 	return deviceObj->GetNofiticateNum();
 }
 DllExport int _BlePluginCopyDeviceNotificateData(uint64_t addr, int idx, void* ptr, int maxSize) {
+	BLE_TIMELINE_SCOPE(__FUNCTION__);
 	BleDeviceManager& manager = BleDeviceManager::GetInstance();
 	BleDeviceObject* deviceObj = manager.GetDeviceByAddr(addr);
 	if (deviceObj == nullptr) {
@@ -372,3 +798,108 @@ DllExport UuidHandle _BlePluginGetDeviceNotificateCharastricsUuid(uint64_t addr,
 	return uuidMgr.GetOrCreate(notifyData.GetCharastricsUuid());
 }
 
+DllExport bool _BlePluginSetNotificationSubscriberId(uint64_t addr, UuidHandle serviceUuid, UuidHandle charaUuid, int subscriberId) {
+	BleDeviceManager& manager = BleDeviceManager::GetInstance();
+	BleDeviceObject* deviceObj = manager.GetDeviceByAddr(addr);
+	WinRtGuid* serviceUuidObj = reinterpret_cast<WinRtGuid*>(serviceUuid);
+	WinRtGuid* charaUuidObj = reinterpret_cast<WinRtGuid*>(charaUuid);
+	if (deviceObj == nullptr || serviceUuidObj == nullptr ||
+		charaUuidObj == nullptr) {
+		return false;
+	}
+	deviceObj->SetNotificationSubscriberId(*serviceUuidObj, *charaUuidObj, subscriberId);
+	return true;
+}
+
+DllExport int _BlePluginGetDeviceNotificateSubscriberId(uint64_t addr, int idx) {
+	BleDeviceManager& manager = BleDeviceManager::GetInstance();
+	BleDeviceObject* deviceObj = manager.GetDeviceByAddr(addr);
+	if (deviceObj == nullptr || idx < 0 || idx >= deviceObj->GetNofiticateNum()) {
+		return -1;
+	}
+	return deviceObj->GetNotificateData(idx).GetSubscriberId();
+}
+
+DllExport void* _BlePluginEnableNotificationRing(int capacity) {
+	return BleNotificationRing::GetInstance().Enable(capacity);
+}
+
+DllExport void _BlePluginDisableNotificationRing() {
+	BleNotificationRing::GetInstance().Disable();
+}
+
+DllExport bool _BlePluginEnableSampleHistory(uint64_t addr, UuidHandle serviceUuid, UuidHandle charaUuid,
+	int capacity, const void* fields, int fieldNum, int matchOffset, int matchValue) {
+	BleDeviceManager& manager = BleDeviceManager::GetInstance();
+	BleDeviceObject* deviceObj = manager.GetDeviceByAddr(addr);
+	WinRtGuid* serviceUuidObj = reinterpret_cast<WinRtGuid*>(serviceUuid);
+	WinRtGuid* charaUuidObj = reinterpret_cast<WinRtGuid*>(charaUuid);
+	if (deviceObj == nullptr || serviceUuidObj == nullptr ||
+		charaUuidObj == nullptr || capacity <= 0) {
+		return false;
+	}
+	deviceObj->EnableSampleHistory(*serviceUuidObj, *charaUuidObj, capacity,
+		reinterpret_cast<const SampleField*>(fields), fieldNum, matchOffset, matchValue);
+	return true;
+}
+DllExport void _BlePluginDisableSampleHistory(uint64_t addr, UuidHandle serviceUuid, UuidHandle charaUuid) {
+	BleDeviceManager& manager = BleDeviceManager::GetInstance();
+	BleDeviceObject* deviceObj = manager.GetDeviceByAddr(addr);
+	WinRtGuid* serviceUuidObj = reinterpret_cast<WinRtGuid*>(serviceUuid);
+	WinRtGuid* charaUuidObj = reinterpret_cast<WinRtGuid*>(charaUuid);
+	if (deviceObj == nullptr || serviceUuidObj == nullptr ||
+		charaUuidObj == nullptr) {
+		return;
+	}
+	deviceObj->DisableSampleHistory(*serviceUuidObj, *charaUuidObj);
+}
+DllExport double _BlePluginGetHostTime() {
+	return BleSampleHistory::GetHostTime();
+}
+DllExport int _BlePluginCopySampleHistory(uint64_t addr, UuidHandle serviceUuid, UuidHandle charaUuid, void* out, int maxNum) {
+	BleDeviceManager& manager = BleDeviceManager::GetInstance();
+	BleDeviceObject* deviceObj = manager.GetDeviceByAddr(addr);
+	WinRtGuid* serviceUuidObj = reinterpret_cast<WinRtGuid*>(serviceUuid);
+	WinRtGuid* charaUuidObj = reinterpret_cast<WinRtGuid*>(charaUuid);
+	if (deviceObj == nullptr || serviceUuidObj == nullptr ||
+		charaUuidObj == nullptr) {
+		return 0;
+	}
+	return deviceObj->CopySampleHistory(*serviceUuidObj, *charaUuidObj, reinterpret_cast<HistorySample*>(out), maxNum);
+}
+DllExport int _BlePluginSampleHistoryAt(uint64_t addr, UuidHandle serviceUuid, UuidHandle charaUuid,
+	double time, float maxExtrapolationSec, float* outValues, int maxValues) {
+	BleDeviceManager& manager = BleDeviceManager::GetInstance();
+	BleDeviceObject* deviceObj = manager.GetDeviceByAddr(addr);
+	WinRtGuid* serviceUuidObj = reinterpret_cast<WinRtGuid*>(serviceUuid);
+	WinRtGuid* charaUuidObj = reinterpret_cast<WinRtGuid*>(charaUuid);
+	if (deviceObj == nullptr || serviceUuidObj == nullptr ||
+		charaUuidObj == nullptr) {
+		return static_cast<int>(ESampleResult::None);
+	}
+	return static_cast<int>(deviceObj->SampleHistoryAt(*serviceUuidObj, *charaUuidObj,
+		time, maxExtrapolationSec, outValues, maxValues));
+}
+
+DllExport int _BlePluginRegisterPayloadSchema(UuidHandle serviceUuid, UuidHandle charaUuid,
+	const void* fields, int fieldNum, int matchOffset, int matchValue) {
+	WinRtGuid* serviceUuidObj = reinterpret_cast<WinRtGuid*>(serviceUuid);
+	WinRtGuid* charaUuidObj = reinterpret_cast<WinRtGuid*>(charaUuid);
+	if (serviceUuidObj == nullptr || charaUuidObj == nullptr) {
+		return -1;
+	}
+	return BlePayloadDecoder::GetInstance().Register(*serviceUuidObj, *charaUuidObj,
+		reinterpret_cast<const PayloadField*>(fields), fieldNum, matchOffset, matchValue);
+}
+DllExport void _BlePluginUnregisterPayloadSchema(int schemaId) {
+	BlePayloadDecoder::GetInstance().Unregister(schemaId);
+}
+DllExport int _BlePluginGetDecodedRowNum(int schemaId) {
+	return BlePayloadDecoder::GetInstance().GetRowNum(schemaId);
+}
+DllExport const float* _BlePluginGetDecodedColumn(int schemaId, int fieldIdx) {
+	return BlePayloadDecoder::GetInstance().GetColumn(schemaId, fieldIdx);
+}
+DllExport const uint64_t* _BlePluginGetDecodedAddrs(int schemaId) {
+	return BlePayloadDecoder::GetInstance().GetAddrs(schemaId);
+}
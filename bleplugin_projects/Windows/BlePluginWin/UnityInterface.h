@@ -8,17 +8,76 @@ extern "C" {
 	typedef void* DeviceHandle;
 	typedef void* WriteRequestHandle;
 	typedef void* ReadRequestHandle;
+	typedef void* WriteBatchHandle;
+	typedef void* OperationHandle;
+	typedef void* BulkTransferHandle;
 
     DllExport void _BlePluginBleAdapterStatusRequest();
     DllExport int _BlePluginBleAdapterUpdate();
 
+	// adapter/radio checks on a native thread instead of polling _BlePluginBleAdapterUpdate.
+	// with scanImmediately the watcher starts on the first _BlePluginGetStartupStatus poll with the
+	// filter already added, without waiting for the checks
+	DllExport void _BlePluginStartupAsync(bool scanImmediately);
+	// EBluetoothStatus, None (-1) while checking
+	DllExport int _BlePluginGetStartupStatus();
+	// the startup is still checking; changing the scan filter now would cancel its early scan
+	DllExport bool _BlePluginIsStartupRunning();
+	// StartupTimings of the last startup, either path
+	DllExport void _BlePluginGetStartupTimings(void* out);
+
+	// every adapter on the machine (enumerated along with the status request, see BleAdapterPool.h)
+	DllExport int _BlePluginGetAdapterNum();
+	DllExport bool _BlePluginGetAdapterStats(int idx, void* out);
+	// EAdapterPlacement (DefaultOnly until set); applies to connections made afterwards
+	DllExport void _BlePluginSetAdapterPlacement(int placement);
+	// adapterIdx < 0 removes the pin
+	DllExport void _BlePluginPinDeviceToAdapter(uint64_t addr, int adapterIdx);
+	DllExport int _BlePluginGetDeviceAdapter(uint64_t addr);
+
 
     DllExport void _BlePluginFinalize();
+	// closes every device in parallel and returns at once; poll _BlePluginGetFinalizeStatus
+	// (BleTeardown::EStatus). _BlePluginFinalize is the same but waits up to the default deadline.
+	DllExport void _BlePluginFinalizeAsync(int timeoutMs);
+	DllExport int _BlePluginGetFinalizeStatus();
+	// one TeardownRecord per device that had a connection to close
+	DllExport int _BlePluginGetFinalizeRecordNum();
+	DllExport int _BlePluginCopyFinalizeRecords(void* out, int maxNum);
+
+	// keep-alive: Finalize only detaches so connections survive a domain reload (see BleSession.h)
+	DllExport void _BlePluginSetKeepAlive(bool enable);
+	DllExport bool _BlePluginIsSessionDetached();
+	// returns the snapshot size; copies it and reattaches when capacity is large enough
+	DllExport int _BlePluginReattachSession(void* out, int capacity);
+
+	// binary trace of all BLE traffic (see BleTrace.h)
+	DllExport bool _BlePluginStartCapture(const wchar_t* path);
+	DllExport void _BlePluginStopCapture();
+	// replays a trace through the watcher/device manager. speed <= 0 replays without waiting
+	DllExport bool _BlePluginStartReplay(const wchar_t* path, float speed, bool loop);
+	DllExport void _BlePluginStopReplay();
+	DllExport bool _BlePluginIsReplaying();
+
+	// Chrome trace-event timeline (BleTimeline.h); false when built without BLEPLUGIN_TIMELINE
+	DllExport bool _BlePluginTimelineStart();
+	DllExport void _BlePluginTimelineStop();
+	DllExport bool _BlePluginTimelineExport(const wchar_t* path);
 
 
 	DllExport UuidHandle _BlePluginGetOrCreateUuidObject(uint32_t d1, uint32_t d2, uint32_t d3, uint32_t d4);
 	DllExport void _BlePluginConvertUuidUint128(UuidHandle ptr, void* out);
 
+	// canonical 36 character text or 4/8 digit Bluetooth short form; nullptr if malformed
+	DllExport UuidHandle _BlePluginParseUuidString(const char* str, int length);
+	// writes 36 characters (no terminator)
+	DllExport void _BlePluginFormatUuidString(UuidHandle uuid, char* out);
+	// strings are packed back to back in buffer; returns the number parsed successfully
+	DllExport int _BlePluginParseUuidStrings(const char* buffer, const int* lengths, int num, UuidHandle* out);
+	// writes num * 36 characters
+	DllExport void _BlePluginFormatUuidStrings(const UuidHandle* uuids, int num, char* out);
+	DllExport bool _BlePluginGetShortUuid(UuidHandle uuid, uint32_t* out);
+
 	DllExport void _BlePluginUpdateWatcher();
 	DllExport void _BlePluginUpdateDevicdeManger();
 
@@ -35,8 +94,12 @@ extern "C" {
 
 	// Connect Dissconnect
 	DllExport DeviceHandle _BlePluginConnectDevice(uint64_t addr);
+	DllExport DeviceHandle _BlePluginConnectDeviceWithServices(uint64_t addr, UuidHandle* serviceUuids, int serviceNum);
 	DllExport void _BlePluginDisconnectDevice(uint64_t addr);
 	DllExport void _BlePluginDisconnectAllDevice();
+	// disconnected devices are recycled after timeoutSec idle (< 0 never); poolSize objects are kept for reuse
+	DllExport void _BlePluginSetDeviceIdleEviction(float timeoutSec, int poolSize);
+	DllExport void _BlePluginGetDeviceResidentStats(void* out);
 	DllExport bool _BlePluginIsDeviceConnectedByAddr(uint64_t addr);
 	DllExport bool _BlePluginIsDeviceConnected(DeviceHandle devicePtr);
 	DllExport uint64_t _BlePluginDeviceGetAddr(DeviceHandle devicePtr);
@@ -64,6 +127,35 @@ extern "C" {
 	DllExport bool _BlePluginIsWriteRequestError(WriteRequestHandle ptr);
 	DllExport void _BlePluginReleaseWriteRequest(uint64_t deviceaddr, WriteRequestHandle ptr);
 
+	// Batch Write
+	DllExport WriteBatchHandle _BlePluginWriteCharacteristicBatch(const void* records, int recordNum, const void* payload, int payloadSize, bool needCompletion);
+	DllExport bool _BlePluginIsWriteBatchComplete(WriteBatchHandle ptr);
+	DllExport bool _BlePluginIsWriteBatchError(WriteBatchHandle ptr);
+	DllExport void _BlePluginReleaseWriteBatch(WriteBatchHandle ptr);
+
+	// Scheduled Read/Write (priority 0:Control 1:Bulk)
+	DllExport void _BlePluginSetOperationSchedulerConfig(uint64_t addr, int maxInFlight, float connectionIntervalMs, int operationsPerInterval);
+	DllExport void _BlePluginSetWriteCoalescing(uint64_t addr, UuidHandle serviceUuid, UuidHandle charaUuid, bool enable);
+	DllExport void _BlePluginSetReadCache(uint64_t addr, UuidHandle serviceUuid, UuidHandle charaUuid, float ttlMs);
+	DllExport OperationHandle _BlePluginScheduleWriteRequest(uint64_t addr, UuidHandle serviceUuid, UuidHandle charaUuid, void* data, int size, bool withResponse, int priority);
+	DllExport OperationHandle _BlePluginScheduleReadRequest(uint64_t addr, UuidHandle serviceUuid, UuidHandle charaUuid, int priority);
+	DllExport int _BlePluginGetOperationStatus(OperationHandle ptr);
+	DllExport int _BlePluginCopyOperationData(OperationHandle ptr, void* data, int maxSize);
+	DllExport void _BlePluginReleaseOperation(uint64_t deviceaddr, OperationHandle ptr);
+	DllExport bool _BlePluginGetOperationSchedulerStats(uint64_t addr, void* out);
+
+	// bulk transfer (see BleBulkTransfer.h). chunkSize 0 uses the default ATT MTU payload;
+	// checkpointInterval 0 only acknowledges the last chunk
+	DllExport BulkTransferHandle _BlePluginStartBulkWrite(uint64_t addr, UuidHandle serviceUuid, UuidHandle charaUuid,
+		const void* data, int size, int chunkSize, int window, int checkpointInterval);
+	// expectedSize 0 receives until cancelled
+	DllExport BulkTransferHandle _BlePluginStartBulkReceive(uint64_t addr, UuidHandle serviceUuid, UuidHandle charaUuid,
+		int expectedSize, int headerSize);
+	DllExport bool _BlePluginGetBulkTransferProgress(uint64_t addr, BulkTransferHandle transfer, void* out);
+	DllExport int _BlePluginCopyBulkReceiveData(uint64_t addr, BulkTransferHandle transfer, void* out, int maxSize);
+	DllExport void _BlePluginCancelBulkTransfer(uint64_t addr, BulkTransferHandle transfer);
+	DllExport void _BlePluginReleaseBulkTransfer(uint64_t addr, BulkTransferHandle transfer);
+
 	// notificate
 	DllExport void _BlePluginSetNotificateRequest(uint64_t addr, UuidHandle serviceUuid, UuidHandle charaUuid, bool enable);
 	
@@ -71,6 +163,39 @@ extern "C" {
 	DllExport int _BlePluginCopyDeviceNotificateData(uint64_t addr, int idx, void* ptr, int maxSize);
 	DllExport UuidHandle _BlePluginGetDeviceNotificateServiceUuid(uint64_t addr, int idx);
 	DllExport UuidHandle _BlePluginGetDeviceNotificateCharastricsUuid(uint64_t addr, int idx);
+	// tags every notification of the characteristic with the caller's id (< 0 removes it), so the
+	// managed side dispatches by index instead of comparing uuid strings
+	DllExport bool _BlePluginSetNotificationSubscriberId(uint64_t addr, UuidHandle serviceUuid, UuidHandle charaUuid, int subscriberId);
+	// -1 when the characteristic has no id
+	DllExport int _BlePluginGetDeviceNotificateSubscriberId(uint64_t addr, int idx);
+
+	// every notification also lands in a shared ring read in place (see BleNotificationRing.h for the
+	// layout and memory ordering). returns the region, which stays put until disabled or finalize
+	DllExport void* _BlePluginEnableNotificationRing(int capacity);
+	DllExport void _BlePluginDisableNotificationRing();
+
+	// sample history (see BleSampleHistory.h). fields is an array of SampleField;
+	// only notifications whose byte at matchOffset equals matchValue are kept (matchOffset < 0 keeps all)
+	DllExport bool _BlePluginEnableSampleHistory(uint64_t addr, UuidHandle serviceUuid, UuidHandle charaUuid,
+		int capacity, const void* fields, int fieldNum, int matchOffset, int matchValue);
+	DllExport void _BlePluginDisableSampleHistory(uint64_t addr, UuidHandle serviceUuid, UuidHandle charaUuid);
+	// clock the samples are stamped with, in seconds
+	DllExport double _BlePluginGetHostTime();
+	// newest maxNum HistorySample, oldest first
+	DllExport int _BlePluginCopySampleHistory(uint64_t addr, UuidHandle serviceUuid, UuidHandle charaUuid, void* out, int maxNum);
+	// field values at time (ESampleResult)
+	DllExport int _BlePluginSampleHistoryAt(uint64_t addr, UuidHandle serviceUuid, UuidHandle charaUuid,
+		double time, float maxExtrapolationSec, float* outValues, int maxValues);
+
+	// struct-of-arrays decode of drained notifications (see BlePayloadDecoder.h). fields is an array
+	// of PayloadField; returns the schema id or -1
+	DllExport int _BlePluginRegisterPayloadSchema(UuidHandle serviceUuid, UuidHandle charaUuid,
+		const void* fields, int fieldNum, int matchOffset, int matchValue);
+	DllExport void _BlePluginUnregisterPayloadSchema(int schemaId);
+	// rows decoded by the last _BlePluginUpdateDevicdeManger; the pointers stay valid until the next one
+	DllExport int _BlePluginGetDecodedRowNum(int schemaId);
+	DllExport const float* _BlePluginGetDecodedColumn(int schemaId, int fieldIdx);
+	DllExport const uint64_t* _BlePluginGetDecodedAddrs(int schemaId);
 
 }
 
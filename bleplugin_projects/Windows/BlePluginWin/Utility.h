@@ -10,30 +10,24 @@ namespace BlePlugin {
 			guid.Data2 = (d2 & 0xffff0000)>>16;
 			guid.Data3 = (d2 & 0xffff);
 
-			for (int i = 0; i < 8; ++i) {
-				int idx = i & 0x03;
-				int shift = (3 - idx) * 8;
-				int val = d3;
-				if (i >= 4) {
-					val = d4;
-				}
-				guid.Data4[i] = (((val & (0xff << shift)) >> shift) & 0xff);
-			}
+			guid.Data4[0] = static_cast<uint8_t>(d3 >> 24);
+			guid.Data4[1] = static_cast<uint8_t>(d3 >> 16);
+			guid.Data4[2] = static_cast<uint8_t>(d3 >> 8);
+			guid.Data4[3] = static_cast<uint8_t>(d3);
+			guid.Data4[4] = static_cast<uint8_t>(d4 >> 24);
+			guid.Data4[5] = static_cast<uint8_t>(d4 >> 16);
+			guid.Data4[6] = static_cast<uint8_t>(d4 >> 8);
+			guid.Data4[7] = static_cast<uint8_t>(d4);
 			return guid;
 		}
 		inline static void ConvertFromGUID(const WinRtGuid &uuid,
 			uint32_t *data) {
 			data[0] = uuid.Data1;
 			data[1] = (uuid.Data2 << 16) | uuid.Data3;
-
-			for (int i = 0; i < 2; ++i) {
-				data[2+i] = 0;
-				for (int j = 0; j < 4; ++j) {
-					int idx = j + i *4;
-					int shift = (3 - idx) * 8;
-					data[2 + i] |= uuid.Data4[idx] << shift;
-				}
-			}
+			data[2] = (static_cast<uint32_t>(uuid.Data4[0]) << 24) | (uuid.Data4[1] << 16) |
+				(uuid.Data4[2] << 8) | uuid.Data4[3];
+			data[3] = (static_cast<uint32_t>(uuid.Data4[4]) << 24) | (uuid.Data4[5] << 16) |
+				(uuid.Data4[6] << 8) | uuid.Data4[7];
 		}
 
 
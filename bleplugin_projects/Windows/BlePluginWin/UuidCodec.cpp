@@ -0,0 +1,183 @@
+#include "UuidCodec.h"
+#include <cstring>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#define BLEPLUGIN_UUID_SSE2 1
+#include <emmintrin.h>
+#endif
+
+using namespace BlePlugin;
+
+namespace {
+	// bytes 4-15 of the Bluetooth Base UUID
+	const uint8_t BaseUuidTail[12] = {
+		0x00, 0x00, 0x10, 0x00, 0x80, 0x00, 0x00, 0x80, 0x5F, 0x9B, 0x34, 0xFB
+	};
+
+	// copies the 32 hex digits out of the canonical form
+	inline bool Compact(const char* str, char* digits) {
+		if ((str[8] != '-') | (str[13] != '-') | (str[18] != '-') | (str[23] != '-')) {
+			return false;
+		}
+		memcpy(digits, str, 8);
+		memcpy(digits + 8, str + 9, 4);
+		memcpy(digits + 12, str + 14, 4);
+		memcpy(digits + 16, str + 19, 4);
+		memcpy(digits + 20, str + 24, 12);
+		return true;
+	}
+
+	inline void Expand(const char* digits, char* str) {
+		memcpy(str, digits, 8);
+		str[8] = '-';
+		memcpy(str + 9, digits + 8, 4);
+		str[13] = '-';
+		memcpy(str + 14, digits + 12, 4);
+		str[18] = '-';
+		memcpy(str + 19, digits + 16, 4);
+		str[23] = '-';
+		memcpy(str + 24, digits + 20, 12);
+	}
+
+	inline int HexValue(char ch, int& invalid) {
+		int c = static_cast<unsigned char>(ch);
+		int digit = c - '0';
+		int alpha = (c | 0x20) - 'a';
+		int isDigit = static_cast<unsigned>(digit) < 10;
+		int isAlpha = static_cast<unsigned>(alpha) < 6;
+		invalid |= !(isDigit | isAlpha);
+		return (-isDigit & digit) | (-isAlpha & (alpha + 10));
+	}
+
+#if defined(BLEPLUGIN_UUID_SSE2)
+	// 16 hex characters -> 8 bytes in the low half (valid is cleared on a bad character)
+	inline __m128i DecodeHex16(__m128i c, bool& valid) {
+		const __m128i lower = _mm_or_si128(c, _mm_set1_epi8(0x20));
+		const __m128i isDigit = _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('0' - 1)),
+			_mm_cmplt_epi8(c, _mm_set1_epi8('9' + 1)));
+		const __m128i isAlpha = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)),
+			_mm_cmplt_epi8(lower, _mm_set1_epi8('f' + 1)));
+		const __m128i digit = _mm_sub_epi8(c, _mm_set1_epi8('0'));
+		const __m128i alpha = _mm_sub_epi8(lower, _mm_set1_epi8('a' - 10));
+		const __m128i val = _mm_or_si128(_mm_and_si128(isDigit, digit), _mm_and_si128(isAlpha, alpha));
+		valid &= (_mm_movemask_epi8(_mm_or_si128(isDigit, isAlpha)) == 0xffff);
+
+		// each 16bit lane holds (high nibble char, low nibble char)
+		const __m128i high = _mm_and_si128(val, _mm_set1_epi16(0x00ff));
+		const __m128i low = _mm_srli_epi16(val, 8);
+		return _mm_or_si128(_mm_slli_epi16(high, 4), low);
+	}
+
+	inline __m128i EncodeNibbles(__m128i nibble) {
+		const __m128i isAlpha = _mm_cmpgt_epi8(nibble, _mm_set1_epi8(9));
+		return _mm_add_epi8(_mm_add_epi8(nibble, _mm_set1_epi8('0')),
+			_mm_and_si128(isAlpha, _mm_set1_epi8('A' - '0' - 10)));
+	}
+#endif
+}
+
+bool UuidCodec::ParseHex(const char* str, int digitNum, uint8_t* out) {
+#if defined(BLEPLUGIN_UUID_SSE2)
+	if (digitNum == 32) {
+		bool valid = true;
+		__m128i first = DecodeHex16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(str)), valid);
+		__m128i second = DecodeHex16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(str + 16)), valid);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_packus_epi16(first, second));
+		return valid;
+	}
+#endif
+	int invalid = 0;
+	for (int i = 0; i < digitNum / 2; ++i) {
+		int high = HexValue(str[i * 2], invalid);
+		int low = HexValue(str[i * 2 + 1], invalid);
+		out[i] = static_cast<uint8_t>((high << 4) | low);
+	}
+	return (invalid == 0);
+}
+
+bool UuidCodec::Parse(const char* str, int length, WinRtGuid& out) {
+	if (str == nullptr) {
+		return false;
+	}
+	if (length == StringLength) {
+		char digits[32];
+		uint8_t bytes[16];
+		if (!Compact(str, digits) || !ParseHex(digits, 32, bytes)) {
+			return false;
+		}
+		out = FromBytes(bytes);
+		return true;
+	}
+	if (length == 4 || length == 8) {
+		uint8_t bytes[4] = { 0, 0, 0, 0 };
+		if (!ParseHex(str, length, bytes + (8 - length) / 2)) {
+			return false;
+		}
+		uint32_t shortUuid = (static_cast<uint32_t>(bytes[0]) << 24) | (bytes[1] << 16) | (bytes[2] << 8) | bytes[3];
+		out = FromShortUuid(shortUuid);
+		return true;
+	}
+	return false;
+}
+
+void UuidCodec::Format(const WinRtGuid& guid, char* out) {
+	uint8_t bytes[16];
+	char digits[32];
+	ToBytes(guid, bytes);
+#if defined(BLEPLUGIN_UUID_SSE2)
+	const __m128i src = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes));
+	const __m128i mask = _mm_set1_epi8(0x0f);
+	const __m128i high = EncodeNibbles(_mm_and_si128(_mm_srli_epi16(src, 4), mask));
+	const __m128i low = EncodeNibbles(_mm_and_si128(src, mask));
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(digits), _mm_unpacklo_epi8(high, low));
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(digits + 16), _mm_unpackhi_epi8(high, low));
+#else
+	static const char HexChars[] = "0123456789ABCDEF";
+	for (int i = 0; i < 16; ++i) {
+		digits[i * 2] = HexChars[bytes[i] >> 4];
+		digits[i * 2 + 1] = HexChars[bytes[i] & 0x0f];
+	}
+#endif
+	Expand(digits, out);
+}
+
+bool UuidCodec::TryGetShortUuid(const WinRtGuid& guid, uint32_t& shortUuid) {
+	uint8_t bytes[16];
+	ToBytes(guid, bytes);
+	if (memcmp(bytes + 4, BaseUuidTail, sizeof(BaseUuidTail)) != 0) {
+		return false;
+	}
+	shortUuid = guid.Data1;
+	return true;
+}
+
+WinRtGuid UuidCodec::FromShortUuid(uint32_t shortUuid) {
+	uint8_t bytes[16];
+	bytes[0] = static_cast<uint8_t>(shortUuid >> 24);
+	bytes[1] = static_cast<uint8_t>(shortUuid >> 16);
+	bytes[2] = static_cast<uint8_t>(shortUuid >> 8);
+	bytes[3] = static_cast<uint8_t>(shortUuid);
+	memcpy(bytes + 4, BaseUuidTail, sizeof(BaseUuidTail));
+	return FromBytes(bytes);
+}
+
+void UuidCodec::ToBytes(const WinRtGuid& guid, uint8_t* bytes) {
+	bytes[0] = static_cast<uint8_t>(guid.Data1 >> 24);
+	bytes[1] = static_cast<uint8_t>(guid.Data1 >> 16);
+	bytes[2] = static_cast<uint8_t>(guid.Data1 >> 8);
+	bytes[3] = static_cast<uint8_t>(guid.Data1);
+	bytes[4] = static_cast<uint8_t>(guid.Data2 >> 8);
+	bytes[5] = static_cast<uint8_t>(guid.Data2);
+	bytes[6] = static_cast<uint8_t>(guid.Data3 >> 8);
+	bytes[7] = static_cast<uint8_t>(guid.Data3);
+	memcpy(bytes + 8, guid.Data4, 8);
+}
+
+WinRtGuid UuidCodec::FromBytes(const uint8_t* bytes) {
+	WinRtGuid guid;
+	guid.Data1 = (static_cast<uint32_t>(bytes[0]) << 24) | (bytes[1] << 16) | (bytes[2] << 8) | bytes[3];
+	guid.Data2 = static_cast<uint16_t>((bytes[4] << 8) | bytes[5]);
+	guid.Data3 = static_cast<uint16_t>((bytes[6] << 8) | bytes[7]);
+	memcpy(guid.Data4, bytes + 8, 8);
+	return guid;
+}
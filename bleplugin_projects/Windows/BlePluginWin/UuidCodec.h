@@ -0,0 +1,25 @@
+#pragma once
+
+#include "pch.h"
+
+namespace BlePlugin {
+	// text <-> WinRtGuid without per-character branches.
+	// accepts the canonical "XXXXXXXX-XXXX-XXXX-XXXX-XXXXXXXXXXXX" form and
+	// 4/8 hex digit short forms of the Bluetooth Base UUID (0000XXXX-0000-1000-8000-00805F9B34FB).
+	class UuidCodec {
+	public:
+		static const int StringLength = 36;
+
+		static bool Parse(const char* str, int length, WinRtGuid& out);
+		// writes StringLength upper case characters (no terminator)
+		static void Format(const WinRtGuid& guid, char* out);
+
+		static bool TryGetShortUuid(const WinRtGuid& guid, uint32_t& shortUuid);
+		static WinRtGuid FromShortUuid(uint32_t shortUuid);
+
+		static void ToBytes(const WinRtGuid& guid, uint8_t* bytes);
+		static WinRtGuid FromBytes(const uint8_t* bytes);
+	private:
+		static bool ParseHex(const char* str, int digitNum, uint8_t* out);
+	};
+}
@@ -1,5 +1,6 @@
 #include "UuidManager.h"
 #include "Utility.h"
+#include "UuidCodec.h"
 
 using namespace BlePlugin;
 
@@ -12,6 +13,10 @@ WinRtGuid* UuidManager::GetOrCreate(uint32_t d1, uint32_t d2, uint32_t d3, uint3
 }
 
 WinRtGuid* UuidManager::GetOrCreate(const WinRtGuid& guid) {
+	uint32_t shortUuid;
+	if (UuidCodec::TryGetShortUuid(guid, shortUuid)) {
+		return this->GetOrCreateShort(shortUuid);
+	}
 	for (auto it = m_cache.begin(); it != m_cache.end(); ++it) {
 		if (guid == *it) {
 			return &(*it);
@@ -21,6 +26,17 @@ WinRtGuid* UuidManager::GetOrCreate(const WinRtGuid& guid) {
 	return &(*insertIt);
 }
 
+WinRtGuid* UuidManager::GetOrCreateShort(uint32_t shortUuid) {
+	auto found = m_shortCache.find(shortUuid);
+	if (found != m_shortCache.end()) {
+		return found->second;
+	}
+	// kept in m_cache too so the handle stays valid as long as the others
+	auto insertIt = (m_cache.insert(m_cache.end(), UuidCodec::FromShortUuid(shortUuid)));
+	m_shortCache[shortUuid] = &(*insertIt);
+	return &(*insertIt);
+}
+
 
 UuidManager& UuidManager::GetInstance() {
 	return s_instance;
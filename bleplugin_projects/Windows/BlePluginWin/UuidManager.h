@@ -3,16 +3,20 @@
 #include "pch.h"
 #include <vector>
 #include <list>
+#include <unordered_map>
 
 namespace BlePlugin {
 	class UuidManager {
 	private:
 		std::list<WinRtGuid> m_cache;
+		// Bluetooth Base UUIDs keyed by their 16/32bit short form
+		std::unordered_map<uint32_t, WinRtGuid*> m_shortCache;
 		static UuidManager s_instance;
 		UuidManager();
 	public:
 		WinRtGuid* GetOrCreate(uint32_t d1, uint32_t d2, uint32_t d3, uint32_t d4);
 		WinRtGuid* GetOrCreate(const WinRtGuid &guid);
+		WinRtGuid* GetOrCreateShort(uint32_t shortUuid);
 		static UuidManager &GetInstance();
 
 	};
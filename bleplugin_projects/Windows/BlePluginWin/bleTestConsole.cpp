@@ -5,7 +5,25 @@
 #include "BleDeviceWatcher.h"
 #include "BleDeviceObject.h"
 #include "UuidManager.h"
+#include "UuidCodec.h"
+#include "BleAdapterPool.h"
+#include "BleTimeline.h"
+#include "BlePayloadDecoder.h"
+#include "BleBulkTransfer.h"
+#include "BleLinkEmulator.h"
+#include "BleStartup.h"
+#include "BleDeviceManager.h"
+#include "BleOperationScheduler.h"
+#include <deque>
 #include "UnityInterface.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <cctype>
+#include <string>
+#include <atomic>
+#include <crtdbg.h>
+#include <psapi.h>
 
 using namespace BlePlugin;
 
@@ -93,9 +111,985 @@ void TestRun(){
 
 }
 
+// the uuid conversion as it was before UuidCodec, ported 1:1 from UuidDatabase.cs (ParseUuid,
+// GetUintFromString, ToUpper), UuidData.ToString() and the bit loop Utility::CreateGUID/ConvertFromGUID.
+// the managed side also paid for P/Invoke and GC, so this is a lower bound of the old cost
+namespace LegacyUuid {
+    static int GetUintFromString(const std::string& str, int idx, uint32_t& data) {
+        data = 0;
+        int length = static_cast<int>(str.size());
+        int currentExecChar = 0;
+        for (; idx < length; ++idx) {
+            char ch = str[idx];
+            int val = 0;
+            if ('0' <= ch && ch <= '9') {
+                val = ch - '0';
+            }
+            else if ('A' <= ch && ch <= 'F') {
+                val = (ch - 'A') + 10;
+            }
+            else if ('a' <= ch && ch <= 'f') {
+                val = (ch - 'a') + 10;
+            }
+            else {
+                continue;
+            }
+            data = data << 4;
+            data |= static_cast<uint32_t>(val);
+            ++currentExecChar;
+            if (currentExecChar >= 8) {
+                break;
+            }
+        }
+        return idx + 1;
+    }
+    static WinRtGuid CreateGUID(uint32_t d1, uint32_t d2, uint32_t d3, uint32_t d4) {
+        WinRtGuid guid;
+        guid.Data1 = d1;
+        guid.Data2 = (d2 & 0xffff0000) >> 16;
+        guid.Data3 = (d2 & 0xffff);
+        for (int i = 0; i < 8; ++i) {
+            int idx = i & 0x03;
+            int shift = (3 - idx) * 8;
+            int val = d3;
+            if (i >= 4) {
+                val = d4;
+            }
+            guid.Data4[i] = (((val & (0xff << shift)) >> shift) & 0xff);
+        }
+        return guid;
+    }
+    // same loop; the shift is taken per word so the second word is defined behaviour
+    static void ConvertFromGUID(const WinRtGuid& uuid, uint32_t* data) {
+        data[0] = uuid.Data1;
+        data[1] = (uuid.Data2 << 16) | uuid.Data3;
+        for (int i = 0; i < 2; ++i) {
+            data[2 + i] = 0;
+            for (int j = 0; j < 4; ++j) {
+                int idx = j + i * 4;
+                int shift = (3 - j) * 8;
+                data[2 + i] |= uuid.Data4[idx] << shift;
+            }
+        }
+    }
+    // UuidDatabase.GetUuid without the dictionary: str.ToUpper() allocates a new string
+    static WinRtGuid Parse(const char* text) {
+        std::string str(text);
+        for (auto it = str.begin(); it != str.end(); ++it) {
+            *it = static_cast<char>(toupper(static_cast<unsigned char>(*it)));
+        }
+        uint32_t d1, d2, d3, d4;
+        int idx = 0;
+        idx = GetUintFromString(str, idx, d1);
+        idx = GetUintFromString(str, idx, d2);
+        idx = GetUintFromString(str, idx, d3);
+        idx = GetUintFromString(str, idx, d4);
+        return CreateGUID(d1, d2, d3, d4);
+    }
+    // ConvertUuidData + UuidData.ToString (string.Format allocates the result)
+    static std::string Format(const WinRtGuid& guid) {
+        uint32_t data[4];
+        ConvertFromGUID(guid, data);
+        char buf[UuidCodec::StringLength + 1];
+        snprintf(buf, sizeof(buf), "%08X-%04X-%04X-%04X-%04X%08X", data[0],
+            (data[1] >> 16) & 0xffff, data[1] & 0xffff, (data[2] >> 16) & 0xffff, data[2] & 0xffff, data[3]);
+        return std::string(buf);
+    }
+}
+
+// uuid text conversion: the pre-UuidCodec path (LegacyUuid) vs UuidCodec
+void BenchmarkUuidConversion() {
+    const int loopNum = 1000000;
+    const char* text = "10b20107-5b3b-4571-9508-cf3efcd7bbae";
+    char out[UuidCodec::StringLength + 1] = {};
+    uint32_t check = 0;
+
+    // both sides have to agree before their times mean anything
+    WinRtGuid legacyGuid = LegacyUuid::Parse(text);
+    WinRtGuid codecGuid;
+    UuidCodec::Parse(text, UuidCodec::StringLength, codecGuid);
+    UuidCodec::Format(codecGuid, out);
+    if (legacyGuid != codecGuid || LegacyUuid::Format(legacyGuid) != std::string(out, UuidCodec::StringLength)) {
+        std::cout << "uuid legacy/codec mismatch  NG" << std::endl;
+        return;
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < loopNum; ++i) {
+        WinRtGuid guid = LegacyUuid::Parse(text);
+        check += guid.Data1;
+    }
+    auto legacyParse = std::chrono::high_resolution_clock::now() - start;
+    start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < loopNum; ++i) {
+        std::string str = LegacyUuid::Format(legacyGuid);
+        check += str[i & 31];
+    }
+    auto legacyFormat = std::chrono::high_resolution_clock::now() - start;
+
+    start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < loopNum; ++i) {
+        WinRtGuid guid;
+        UuidCodec::Parse(text, UuidCodec::StringLength, guid);
+        check += guid.Data1;
+    }
+    auto codecParse = std::chrono::high_resolution_clock::now() - start;
+    start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < loopNum; ++i) {
+        UuidCodec::Format(codecGuid, out);
+        check += out[i & 31];
+    }
+    auto codecFormat = std::chrono::high_resolution_clock::now() - start;
+
+    auto us = [](std::chrono::high_resolution_clock::duration d) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(d).count();
+    };
+    std::cout << std::dec << "uuid x" << loopNum << "        parse     format" << std::endl <<
+        "  legacy " << us(legacyParse) << "us " << us(legacyFormat) << "us" << std::endl <<
+        "  codec  " << us(codecParse) << "us " << us(codecFormat) << "us" << std::endl <<
+        "  (" << check << ")" << std::endl;
+}
+
+// one second of notifications pushed through the device objects: each device asks for
+// deviceBytesPerSec and each adapter carries at most adapterBytesPerSec. the budget is charged to the
+// adapter the device object was placed on and the result is read back from the pool counters.
+// counterMiss counts adapters whose notificationBytes differ from what their devices sent
+uint64_t SimulateAdapterSecond(const std::vector<uint64_t>& addrs, int adapterBytesPerSec, int deviceBytesPerSec, int& counterMiss) {
+    const int packetSize = 20;
+    const int frameNum = 50;
+    BleAdapterPool& pool = BleAdapterPool::GetInstance();
+    BleDeviceManager& manager = BleDeviceManager::GetInstance();
+    WinRtGuid serviceUuid = Utility::CreateGUID(0x10B20100U, 0x5B3B4571U, 0x9508CF3EU, 0xFCD7BBAEU);
+    WinRtGuid charaUuid = Utility::CreateGUID(0x10B20102U, 0x5B3B4571U, 0x9508CF3EU, 0xFCD7BBAEU);
+    uint8_t packet[packetSize] = {};
+    int adapterNum = pool.GetAdapterNum();
+
+    uint64_t before[BleAdapterPool::MaxAdapterNum] = {};
+    uint64_t sent[BleAdapterPool::MaxAdapterNum] = {};
+    int budget[BleAdapterPool::MaxAdapterNum] = {};
+    for (int i = 0; i < adapterNum; ++i) {
+        BleAdapterStats stats;
+        pool.GetStats(i, stats);
+        before[i] = stats.notificationBytes;
+        budget[i] = adapterBytesPerSec;
+    }
+    for (int frame = 0; frame < frameNum; ++frame) {
+        for (auto it = addrs.begin(); it != addrs.end(); ++it) {
+            BleDeviceObject* device = manager.GetDeviceByAddr(*it);
+            int idx = (device != nullptr) ? device->GetAdapterIndex() : -1;
+            int assigned = pool.GetAssigned(*it);
+            if (idx < 0 || idx >= adapterNum || assigned < 0) {
+                continue;
+            }
+            for (int bytes = 0; bytes + packetSize <= deviceBytesPerSec / frameNum && budget[idx] >= packetSize; bytes += packetSize) {
+                device->OnChangeValue(serviceUuid, charaUuid, packet, packetSize);
+                budget[idx] -= packetSize;
+                sent[assigned] += packetSize;
+            }
+        }
+        manager.Update();
+    }
+    uint64_t total = 0;
+    for (int i = 0; i < adapterNum; ++i) {
+        BleAdapterStats stats;
+        pool.GetStats(i, stats);
+        uint64_t bytes = stats.notificationBytes - before[i];
+        counterMiss += (bytes != sent[i]);
+        total += bytes;
+    }
+    return total;
+}
+
+// placement and throughput scaling over simulated adapters (no radio needed).
+// devices are attached as replay connections, so they are placed by BleAdapterPool::Assign,
+// counted by BleDeviceManager::Update and released on detach like real links
+bool SimulateAdapterPlacement() {
+    BleAdapterPool& pool = BleAdapterPool::GetInstance();
+    BleDeviceManager& manager = BleDeviceManager::GetInstance();
+    const int adapterNum = 3;
+    const int deviceNum = 18;
+    const uint64_t deviceBase = 0xD0000000000ULL;
+    std::vector<uint64_t> addrs;
+    for (int i = 0; i < deviceNum; ++i) {
+        addrs.push_back(deviceBase + i);
+    }
+    auto attachAll = [&manager, &addrs]() {
+        for (auto it = addrs.begin(); it != addrs.end(); ++it) {
+            manager.AttachReplayDevice(*it);
+        }
+        manager.Update();
+    };
+    auto detachAll = [&manager, &addrs]() {
+        for (auto it = addrs.begin(); it != addrs.end(); ++it) {
+            manager.DetachReplayDevice(*it);
+        }
+        manager.Update();
+    };
+    auto addAdapters = [&pool](int num, int maxConnections) {
+        for (int i = 0; i < num; ++i) {
+            pool.AddSimulatedAdapter(0xA00000000000ULL + i, maxConnections);
+        }
+    };
+    bool ok = true;
+
+    // default only: nothing leaves the default adapter unless a placement is chosen
+    pool.Clear();
+    pool.SetPlacement(EAdapterPlacement::DefaultOnly);
+    addAdapters(adapterNum, deviceNum);
+    attachAll();
+    int defaultMiss = 0;
+    for (auto it = addrs.begin(); it != addrs.end(); ++it) {
+        defaultMiss += (pool.GetAssigned(*it) != pool.GetDefaultIndex()) ||
+            (manager.GetDeviceByAddr(*it)->GetAdapterIndex() != pool.GetDefaultIndex());
+    }
+    detachAll();
+    std::cout << "default only misplaced " << defaultMiss << std::endl;
+    ok &= (defaultMiss == 0);
+
+    // a scoped id that finds nothing moves the device to the default adapter, once
+    pool.SetPlacement(EAdapterPlacement::Pinned);
+    pool.Pin(addrs[0], adapterNum - 1);
+    pool.Assign(addrs[0]);
+    bool isFallenBack = (pool.FallBackToDefault(addrs[0]) == pool.GetDefaultIndex()) &&
+        pool.GetAssigned(addrs[0]) == pool.GetDefaultIndex() && pool.GetAdapter(adapterNum - 1).assignedNum == 0 &&
+        pool.FallBackToDefault(addrs[0]) < 0;
+    pool.Release(addrs[0]);
+    std::cout << "fallback to default " << (isFallenBack ? "ok" : "NG") << std::endl;
+    ok &= isFallenBack;
+
+    // least loaded: even split, and the links are counted where they were placed
+    pool.Clear();
+    pool.SetPlacement(EAdapterPlacement::LeastLoaded);
+    addAdapters(adapterNum, BleAdapterPool::DefaultMaxConnections);
+    attachAll();
+    for (int i = 0; i < adapterNum; ++i) {
+        BleAdapterStats stats;
+        pool.GetStats(i, stats);
+        bool even = (stats.assignedNum == deviceNum / adapterNum && stats.connectedNum == stats.assignedNum);
+        std::cout << "least loaded adapter " << i << " : " << stats.assignedNum << " assigned " <<
+            stats.connectedNum << " connected" << (even ? "" : "  NG") << std::endl;
+        ok &= even;
+    }
+
+    // enumerating again keeps the placement of live devices
+    std::vector<int> placed;
+    for (auto it = addrs.begin(); it != addrs.end(); ++it) {
+        placed.push_back(pool.GetAssigned(*it));
+    }
+    pool.Request();
+    for (int i = 0; i < 500 && !pool.IsRequestComplete(); ++i) {
+        pool.Update();
+        Sleep(10);
+    }
+    int movedNum = 0;
+    for (int i = 0; i < deviceNum; ++i) {
+        movedNum += (pool.GetAssigned(addrs[i]) != placed[i]) || (manager.GetDeviceByAddr(addrs[i])->GetAdapterIndex() != placed[i]);
+    }
+    int keptNum = 0;
+    for (int i = 0; i < adapterNum; ++i) {
+        keptNum += pool.GetAdapter(i).assignedNum;
+    }
+    std::cout << "re-enumerated with " << pool.GetAdapterNum() - adapterNum << " real adapters, moved " << movedNum <<
+        " kept " << keptNum << std::endl;
+    ok &= (movedNum == 0 && keptNum == deviceNum);
+
+    // detaching gives every link back
+    detachAll();
+    int leftNum = 0;
+    for (int i = 0; i < pool.GetAdapterNum(); ++i) {
+        leftNum += pool.GetAdapter(i).assignedNum + pool.GetAdapter(i).connectedNum;
+    }
+    std::cout << "links left after detach " << leftNum << std::endl;
+    ok &= (leftNum == 0);
+
+    // rssi best: device i is heard loudest by adapter i % adapterNum
+    pool.Clear();
+    pool.SetPlacement(EAdapterPlacement::RssiBest);
+    addAdapters(adapterNum, BleAdapterPool::DefaultMaxConnections);
+    int rssiMiss = 0;
+    for (int i = 0; i < deviceNum; ++i) {
+        for (int a = 0; a < adapterNum; ++a) {
+            pool.ReportRssi(a, addrs[i], (a == i % adapterNum) ? -45 : -80);
+        }
+        rssiMiss += (pool.Assign(addrs[i]) != i % adapterNum);
+    }
+    std::cout << "rssi best misplaced " << rssiMiss << std::endl;
+    ok &= (rssiMiss == 0);
+
+    // rssi best with only the default adapter reporting (what BleDeviceWatcher does): least loaded
+    pool.Clear();
+    pool.SetPlacement(EAdapterPlacement::RssiBest);
+    addAdapters(adapterNum, BleAdapterPool::DefaultMaxConnections);
+    for (int i = 0; i < deviceNum; ++i) {
+        pool.ReportRssi(pool.GetDefaultIndex(), addrs[i], -45);
+        pool.Assign(addrs[i]);
+    }
+    int fallbackMiss = 0;
+    for (int i = 0; i < adapterNum; ++i) {
+        fallbackMiss += (pool.GetAdapter(i).assignedNum != deviceNum / adapterNum);
+    }
+    std::cout << "rssi best default only, uneven adapters " << fallbackMiss << std::endl;
+    ok &= (fallbackMiss == 0);
+
+    // pinned: a third goes to the last adapter, the rest least loaded
+    pool.Clear();
+    pool.SetPlacement(EAdapterPlacement::Pinned);
+    addAdapters(adapterNum, BleAdapterPool::DefaultMaxConnections);
+    for (int i = 0; i < deviceNum / adapterNum; ++i) {
+        pool.Pin(addrs[i], adapterNum - 1);
+    }
+    int pinMiss = 0;
+    for (int i = 0; i < deviceNum; ++i) {
+        int idx = pool.Assign(addrs[i]);
+        pinMiss += (i < deviceNum / adapterNum) ? (idx != adapterNum - 1) : (pool.GetAdapter(idx).assignedNum > deviceNum / adapterNum);
+    }
+    std::cout << "pinned misplaced " << pinMiss << std::endl;
+    ok &= (pinMiss == 0);
+
+    // throughput: 18 devices x 2KB/s against 8KB/s per adapter should scale with the adapter count.
+    // it only does if the pool really spreads the device objects and counts their traffic
+    uint64_t base = 0;
+    for (int n = 1; n <= adapterNum; ++n) {
+        pool.Clear();
+        pool.SetPlacement(EAdapterPlacement::LeastLoaded);
+        addAdapters(n, deviceNum);
+        attachAll();
+        int counterMiss = 0;
+        uint64_t bytes = SimulateAdapterSecond(addrs, 8000, 2000, counterMiss);
+        detachAll();
+        if (n == 1) {
+            base = bytes;
+        }
+        double scale = (base > 0) ? static_cast<double>(bytes) / base : 0.0;
+        bool scaled = (scale > n * 0.9 && counterMiss == 0);
+        std::cout << std::dec << "adapters " << n << " : " << bytes << " B/s  x" << scale <<
+            " counter mismatch " << counterMiss << (scaled ? "" : "  NG") << std::endl;
+        ok &= scaled;
+    }
+    pool.Clear();
+    pool.SetPlacement(EAdapterPlacement::DefaultOnly);
+    std::cout << (ok ? "OK" : "NG") << std::endl;
+    return ok;
+}
+
+// toio position id packets: per packet copy+parse into a pose list (what BleWin callbacks do
+// after marshalling) vs BlePayloadDecoder columns
+void BenchmarkPayloadDecode() {
+    const int frameNum = 10000;
+    const int packetNum = 64 * 4;
+    WinRtGuid serviceUuid = Utility::CreateGUID(0x10B20100U, 0x5B3B4571U, 0x9508CF3EU, 0xFCD7BBAEU);
+    WinRtGuid charaUuid = Utility::CreateGUID(0x10B20101U, 0x5B3B4571U, 0x9508CF3EU, 0xFCD7BBAEU);
+    std::vector<NotificateData> packets;
+    for (int i = 0; i < packetNum; ++i) {
+        uint8_t data[13] = { 0x01, static_cast<uint8_t>(i), 0x01, static_cast<uint8_t>(i * 3), 0x01,
+            static_cast<uint8_t>(i * 7), 0x00, 0, 0, 0, 0, 0, 0 };
+        packets.emplace_back(serviceUuid, charaUuid, data, static_cast<int>(sizeof(data)));
+    }
+    float check = 0.0f;
+
+    struct Pose { uint64_t addr; float x; float y; float angle; };
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int frame = 0; frame < frameNum; ++frame) {
+        std::vector<Pose> poses;
+        for (int i = 0; i < packetNum; ++i) {
+            std::vector<uint8_t> bytes(packets[i].GetData(), packets[i].GetData() + packets[i].GetSize());
+            if (bytes.size() < 7 || bytes[0] != 0x01) {
+                continue;
+            }
+            Pose pose = { static_cast<uint64_t>(i & 63),
+                static_cast<float>(bytes[1] | (bytes[2] << 8)),
+                static_cast<float>(bytes[3] | (bytes[4] << 8)),
+                static_cast<float>(bytes[5] | (bytes[6] << 8)) };
+            poses.push_back(pose);
+        }
+        check += poses[frame % packetNum].x;
+    }
+    auto perPacket = std::chrono::high_resolution_clock::now() - start;
+
+    BlePayloadDecoder& decoder = BlePayloadDecoder::GetInstance();
+    PayloadField fields[3] = {
+        { 1, ESampleFieldType::UInt16, 1.0f, 0 },
+        { 3, ESampleFieldType::UInt16, 1.0f, 0 },
+        { 5, ESampleFieldType::UInt16, 1.0f, 0 },
+    };
+    int schemaId = decoder.Register(serviceUuid, charaUuid, fields, 3, 0, 0x01);
+    start = std::chrono::high_resolution_clock::now();
+    for (int frame = 0; frame < frameNum; ++frame) {
+        decoder.BeginFrame();
+        for (int i = 0; i < packetNum; ++i) {
+            decoder.Gather(static_cast<uint64_t>(i & 63), packets[i]);
+        }
+        decoder.EndFrame();
+        check += decoder.GetColumn(schemaId, 0)[frame % packetNum];
+    }
+    auto columns = std::chrono::high_resolution_clock::now() - start;
+    decoder.Unregister(schemaId);
+
+    double packetTotal = static_cast<double>(frameNum) * packetNum;
+    std::cout << std::dec << "payload decode " << packetNum << " packets x" << frameNum << std::endl <<
+        "  per packet " << std::chrono::duration_cast<std::chrono::nanoseconds>(perPacket).count() / packetTotal << "ns" << std::endl <<
+        "  columns    " << std::chrono::duration_cast<std::chrono::nanoseconds>(columns).count() / packetTotal << "ns" << std::endl <<
+        "  (" << check << ")" << std::endl;
+}
+
+// simulated peripheral: every connection event carries up to packetsPerEvent writes,
+// a write with response is acknowledged one event later. returns bytes/sec
+double SimulateBulkWrite(int size, int chunkSize, int window, int checkpointInterval,
+    double connectionIntervalMs, int packetsPerEvent) {
+    std::vector<uint8_t> payload(size, 0x5a);
+    BleBulkWriter writer(payload.data(), size, chunkSize, window, checkpointInterval, 0.0);
+    std::deque<BleBulkWriter::Chunk> txQueue;
+    std::vector<std::pair<int, double> > acks;
+    double nowMs = 0.0;
+    BleBulkWriter::Chunk chunk;
+    while (writer.GetStatus() == EBulkStatus::Running) {
+        while (writer.PeekNext(chunk)) {
+            writer.MarkIssued(chunk);
+            txQueue.push_back(chunk);
+        }
+        for (int i = 0; i < packetsPerEvent && !txQueue.empty(); ++i) {
+            const BleBulkWriter::Chunk& sent = txQueue.front();
+            if (sent.withResponse) {
+                acks.emplace_back(sent.index, nowMs + connectionIntervalMs);
+            }
+            else {
+                writer.OnChunkDone(sent.index, true, nowMs);
+            }
+            txQueue.pop_front();
+        }
+        nowMs += connectionIntervalMs;
+        for (auto it = acks.begin(); it != acks.end(); ) {
+            if (it->second <= nowMs) {
+                writer.OnChunkDone(it->first, true, nowMs);
+                it = acks.erase(it);
+            }
+            else {
+                ++it;
+            }
+        }
+    }
+    BulkTransferProgress progress;
+    writer.GetProgress(progress, nowMs);
+    return progress.bytesPerSec;
+}
+
+// windowed bulk writes vs one acknowledged write at a time, plus reassembly cost
+void BenchmarkBulkTransfer() {
+    const int size = 64 * 1024;
+    const double intervalMs = 15.0;
+    const int packetsPerEvent = 6;
+    std::cout << std::dec << "bulk write " << size << " bytes, " << intervalMs << "ms interval, " <<
+        packetsPerEvent << " packets/event" << std::endl;
+    const int chunkSizes[2] = { 20, 244 };
+    for (int c = 0; c < 2; ++c) {
+        int chunkSize = chunkSizes[c];
+        double serial = SimulateBulkWrite(size, chunkSize, 1, 1, intervalMs, packetsPerEvent);
+        double windowed = SimulateBulkWrite(size, chunkSize, 16, 64, intervalMs, packetsPerEvent);
+        std::cout << "  chunk " << chunkSize << " serial " << serial / 1024.0 << "KB/s" <<
+            "  windowed " << windowed / 1024.0 << "KB/s" << std::endl;
+    }
+
+    const int packetNum = 1000000;
+    uint8_t packet[244];
+    for (int i = 0; i < static_cast<int>(sizeof(packet)); ++i) {
+        packet[i] = static_cast<uint8_t>(i);
+    }
+    WinRtGuid uuid = Utility::CreateGUID(0x10B20100U, 0x5B3B4571U, 0x9508CF3EU, 0xFCD7BBAEU);
+    BleBulkReceiver receiver(uuid, uuid, 0, 2, 0.0);
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < packetNum; ++i) {
+        receiver.OnPacket(packet, sizeof(packet), 0.0);
+    }
+    auto elapsed = std::chrono::high_resolution_clock::now() - start;
+    double sec = std::chrono::duration<double>(elapsed).count();
+    std::cout << "  reassembly " << receiver.GetData().size() / sec / (1024.0 * 1024.0) << "MB/s" << std::endl;
+}
+
+// fleet soak: synthetic devices churn, advertise and stream through the replay entry points while
+// the host side drives the C ABI like BleWin.OnUpdate does. one sample per second; after the
+// warm-up the trend of memory, live heap blocks and per-frame cost has to stay flat.
+struct SoakSample {
+    double privateBytes;
+    double liveBlocks;
+    double liveBytes;
+    double frameMs;
+    double maxFrameMs;
+    double allocsPerFrame;
+    int scanNum;
+    int connectedNum;
+    int backlogNum;
+    int queueDepth;
+    int residentNum;
+};
+
+static std::atomic<uint64_t> s_soakAllocNum(0);
+
+// the alloc hook and the heap checkpoint only do something with the debug CRT; elsewhere the soak
+// still gates on private bytes and frame cost, and reports the CRT based checks as skipped
+#if defined(_DEBUG)
+static const bool s_hasCrtDebugHeap = true;
+#else
+static const bool s_hasCrtDebugHeap = false;
+#endif
 
-int main()
+static int SoakAllocHook(int allocType, void*, size_t, int blockType, long, const unsigned char*, int) {
+    if (allocType != _HOOK_FREE && blockType != _CRT_BLOCK) {
+        ++s_soakAllocNum;
+    }
+    return TRUE;
+}
+
+// growth across the measured span relative to its start, from a least squares fit
+static double GetSoakTrend(const std::vector<SoakSample>& samples, size_t begin, double SoakSample::* field) {
+    size_t num = samples.size() - begin;
+    if (num < 2) {
+        return 0.0;
+    }
+    double sumX = 0.0, sumY = 0.0, sumXX = 0.0, sumXY = 0.0;
+    for (size_t i = 0; i < num; ++i) {
+        double x = static_cast<double>(i);
+        double y = samples[begin + i].*field;
+        sumX += x;
+        sumY += y;
+        sumXX += x * x;
+        sumXY += x * y;
+    }
+    double slope = (num * sumXY - sumX * sumY) / (num * sumXX - sumX * sumX);
+    double first = (sumY - slope * sumX) / num;
+    return slope * (num - 1) / (std::max)(first, 1.0);
+}
+
+bool RunSoak(int durationSec, int deviceNum) {
+    const int warmupSec = (std::max)(durationSec / 4, 10);
+    const int frameSleepMs = 10;
+    const int advertPerFrame = (std::max)(deviceNum / 4, 1);
+    // random resolvable addresses: never seen again once they rotate
+    const int freshAdvertPerFrame = 8;
+    const int notificationPerFrame = 2;
+    const double churnRate = 0.01;
+    const double maxMemoryTrend = 0.10;
+    const double maxFrameTrend = 0.50;
+
+    WinRtGuid serviceUuid = Utility::CreateGUID(0x10B20100U, 0x5B3B4571U, 0x9508CF3EU, 0xFCD7BBAEU);
+    WinRtGuid charaUuid = Utility::CreateGUID(0x10B20102U, 0x5B3B4571U, 0x9508CF3EU, 0xFCD7BBAEU);
+    BleDeviceWatcher& watcher = BleDeviceWatcher::GetInstance();
+    BleDeviceManager& manager = BleDeviceManager::GetInstance();
+    _BlePluginSetDeviceIdleEviction(2.0f, 16);
+
+    std::vector<uint64_t> addrs(deviceNum);
+    std::vector<bool> connected(deviceNum, false);
+    for (int i = 0; i < deviceNum; ++i) {
+        addrs[i] = 0xD0C0A0000000ULL + static_cast<uint64_t>(i);
+    }
+    uint64_t freshAddr = 0xE0C0A0000000ULL;
+    uint32_t random = 0x12345678U;
+    auto nextRandom = [&random]() {
+        random = random * 1664525U + 1013904223U;
+        return random >> 8;
+    };
+
+    _CrtSetAllocHook(SoakAllocHook);
+    std::cout << std::dec << "soak " << durationSec << "s, " << deviceNum << " devices" << std::endl <<
+        "  sec privateKB liveBlocks liveKB frameMs maxFrameMs allocs/frame scan connected backlog queue resident" << std::endl;
+    std::vector<SoakSample> samples;
+    SoakSample window = {};
+    int windowFrameNum = 0;
+    uint64_t windowAllocNum = s_soakAllocNum;
+    uint8_t payload[NotificateData::MaxDataSize] = {};
+    std::vector<uint8_t> copyBuffer(NotificateData::MaxDataSize);
+    auto start = std::chrono::high_resolution_clock::now();
+    auto windowStart = start;
+    uint32_t frame = 0;
+    while (std::chrono::high_resolution_clock::now() - start < std::chrono::seconds(durationSec)) {
+        // backend side
+        for (int i = 0; i < advertPerFrame; ++i) {
+            watcher.OnAdvertisement(addrs[nextRandom() % deviceNum], -40 - static_cast<int>(nextRandom() % 50));
+        }
+        for (int i = 0; i < freshAdvertPerFrame; ++i) {
+            watcher.OnAdvertisement(freshAddr++, -90);
+        }
+        for (int i = 0; i < deviceNum; ++i) {
+            if (nextRandom() % 10000 < churnRate * 10000) {
+                if (connected[i]) {
+                    manager.DetachReplayDevice(addrs[i]);
+                }
+                else {
+                    manager.AttachReplayDevice(addrs[i]);
+                }
+                connected[i] = !connected[i];
+            }
+        }
+        int backlogNum = 0;
+        int queueDepth = 0;
+        for (int i = 0; i < deviceNum; ++i) {
+            if (!connected[i]) {
+                continue;
+            }
+            BleDeviceObject* device = manager.GetDeviceByAddr(addrs[i]);
+            if (device == nullptr) {
+                continue;
+            }
+            for (int n = 0; n < notificationPerFrame; ++n) {
+                payload[0] = static_cast<uint8_t>(frame);
+                payload[1] = static_cast<uint8_t>(n);
+                device->OnChangeValue(serviceUuid, charaUuid, payload, sizeof(payload));
+            }
+            backlogNum += device->GetBufferedNotificationNum();
+            OperationSchedulerStats stats;
+            if (_BlePluginGetOperationSchedulerStats(addrs[i], &stats)) {
+                for (int p = 0; p < static_cast<int>(EOperationPriority::Num); ++p) {
+                    queueDepth += stats.queueDepth[p];
+                }
+            }
+        }
+
+        // host side, what one BleWin.OnUpdate costs
+        auto frameStart = std::chrono::high_resolution_clock::now();
+        _BlePluginUpdateWatcher();
+        _BlePluginUpdateDevicdeManger();
+        int scanNum = _BlePluginScanGetDeviceLength();
+        for (int i = 0; i < scanNum; ++i) {
+            _BlePluginScanGetDeviceAddr(i);
+        }
+        int connectedNum = _BlePluginGetConectDeviceNum();
+        for (int i = 0; i < connectedNum; ++i) {
+            uint64_t addr = _BlePluginGetConectDevicAddr(i);
+            int notificationNum = _BlePluginGetDeviceNotificateNum(addr);
+            for (int n = 0; n < notificationNum; ++n) {
+                _BlePluginCopyDeviceNotificateData(addr, n, copyBuffer.data(), static_cast<int>(copyBuffer.size()));
+            }
+        }
+        double frameMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - frameStart).count();
+
+        window.frameMs += frameMs;
+        window.maxFrameMs = (std::max)(window.maxFrameMs, frameMs);
+        window.scanNum = scanNum;
+        window.connectedNum = connectedNum;
+        window.backlogNum = (std::max)(window.backlogNum, backlogNum);
+        window.queueDepth = (std::max)(window.queueDepth, queueDepth);
+        ++windowFrameNum;
+        ++frame;
+        Sleep(frameSleepMs);
+
+        auto now = std::chrono::high_resolution_clock::now();
+        if (now - windowStart < std::chrono::seconds(1)) {
+            continue;
+        }
+        PROCESS_MEMORY_COUNTERS_EX memory = {};
+        K32GetProcessMemoryInfo(GetCurrentProcess(), reinterpret_cast<PROCESS_MEMORY_COUNTERS*>(&memory), sizeof(memory));
+        _CrtMemState heap = {};
+        _CrtMemCheckpoint(&heap);
+        DeviceResidentStats resident;
+        _BlePluginGetDeviceResidentStats(&resident);
+        window.privateBytes = static_cast<double>(memory.PrivateUsage);
+        window.liveBlocks = static_cast<double>(heap.lCounts[_NORMAL_BLOCK] + heap.lCounts[_CLIENT_BLOCK]);
+        window.liveBytes = static_cast<double>(heap.lSizes[_NORMAL_BLOCK] + heap.lSizes[_CLIENT_BLOCK]);
+        window.frameMs /= windowFrameNum;
+        window.allocsPerFrame = static_cast<double>(s_soakAllocNum - windowAllocNum) / windowFrameNum;
+        window.residentNum = resident.residentNum;
+        samples.push_back(window);
+        std::cout << "  " << samples.size() << " " << static_cast<uint64_t>(window.privateBytes / 1024.0) << " " <<
+            static_cast<uint64_t>(window.liveBlocks) << " " << static_cast<uint64_t>(window.liveBytes / 1024.0) << " " <<
+            window.frameMs << " " << window.maxFrameMs << " " << window.allocsPerFrame << " " <<
+            window.scanNum << " " << window.connectedNum << " " << window.backlogNum << " " <<
+            window.queueDepth << " " << window.residentNum << std::endl;
+        window = {};
+        windowFrameNum = 0;
+        windowAllocNum = s_soakAllocNum;
+        windowStart = now;
+    }
+    _CrtSetAllocHook(nullptr);
+    for (int i = 0; i < deviceNum; ++i) {
+        if (connected[i]) {
+            manager.DetachReplayDevice(addrs[i]);
+        }
+    }
+
+    size_t begin = (std::min)(static_cast<size_t>(warmupSec), samples.size());
+    struct Check { const char* name; double SoakSample::* field; double limit; bool isCrtHeap; };
+    const Check checks[] = {
+        { "private bytes", &SoakSample::privateBytes, maxMemoryTrend, false },
+        { "live blocks", &SoakSample::liveBlocks, maxMemoryTrend, true },
+        { "live bytes", &SoakSample::liveBytes, maxMemoryTrend, true },
+        { "frame cost", &SoakSample::frameMs, maxFrameTrend, false },
+        { "allocs/frame", &SoakSample::allocsPerFrame, maxFrameTrend, true },
+    };
+    bool isPassed = samples.size() - begin >= 2;
+    for (const Check& check : checks) {
+        if (check.isCrtHeap && !s_hasCrtDebugHeap) {
+            std::cout << "  " << check.name << " skipped (needs the debug CRT heap)" << std::endl;
+            continue;
+        }
+        double trend = GetSoakTrend(samples, begin, check.field);
+        bool isOk = trend <= check.limit;
+        std::cout << "  " << check.name << " trend " << trend * 100.0 << "% (limit " << check.limit * 100.0 << "%) " <<
+            (isOk ? "ok" : "GROWING") << std::endl;
+        isPassed = isPassed && isOk;
+    }
+    std::cout << (isPassed ? "soak passed" : "soak FAILED") << std::endl;
+    return isPassed;
+}
+
+// hands what the emulated links deliver to the devices through the replay path
+class LinkDeviceSink : public BleLinkSink {
+public:
+    void OnConnected(uint64_t addr) override {
+        BleDeviceManager::GetInstance().AttachReplayDevice(addr);
+    }
+    void OnDisconnected(uint64_t addr) override {
+        BleDeviceManager::GetInstance().DetachReplayDevice(addr);
+    }
+    bool OnNotification(uint64_t addr, const uint8_t* serviceUuid, const uint8_t* charastricsUuid,
+        const uint8_t* data, int size) override {
+        BleDeviceObject* device = BleDeviceManager::GetInstance().GetDeviceByAddr(addr);
+        if (device == nullptr) {
+            return false;
+        }
+        device->OnChangeValue(UuidCodec::FromBytes(serviceUuid), UuidCodec::FromBytes(charastricsUuid), data, size);
+        return true;
+    }
+};
+static_assert(BleLinkEmulator::MaxDataSize == NotificateData::MaxDataSize, "the link carries a whole notification");
+
+// devices x hz notifications over emulated links for virtualSec of virtual time; the host drains
+// through the C ABI at frameHz. the gate is what the app sees: p99 of peripheral -> copied out of
+// _BlePluginCopyDeviceNotificateData must stay under targetP99Ms plus one frame (a notification that
+// lands right after a drain waits for the next one). after the peripherals stop and the links settle,
+// every notification handed to a device must have been drained exactly once (a disconnect drops the
+// device buffer like a real link does, so this holds for the default links, which don't disconnect).
+bool BenchmarkLink(int deviceNum, int hz, double targetP99Ms) {
+    const double virtualSec = 60.0;
+    const double settleSec = 5.0;
+    const double frameHz = 60.0;
+    const double stepMs = 0.25;
+    uint8_t serviceUuid[BleLinkEmulator::UuidSize];
+    uint8_t charaUuid[BleLinkEmulator::UuidSize];
+    UuidCodec::ToBytes(Utility::CreateGUID(0x10B20100U, 0x5B3B4571U, 0x9508CF3EU, 0xFCD7BBAEU), serviceUuid);
+    UuidCodec::ToBytes(Utility::CreateGUID(0x10B20102U, 0x5B3B4571U, 0x9508CF3EU, 0xFCD7BBAEU), charaUuid);
+
+    LinkDeviceSink sink;
+    BleLinkEmulator emulator(0x5eed, sink);
+    LinkParams params = LinkParams::Default();
+    std::vector<uint64_t> addrs(deviceNum);
+    std::vector<double> nextSampleMs(deviceNum);
+    for (int i = 0; i < deviceNum; ++i) {
+        addrs[i] = 0xD1C0A0000000ULL + static_cast<uint64_t>(i);
+        nextSampleMs[i] = 1000.0 * i / (static_cast<double>(hz) * deviceNum);
+        emulator.AddLink(addrs[i], params);
+    }
+    // queued time per sequence number, to time the app side as well
+    std::vector<double> queuedMs;
+    std::vector<uint8_t> isDrained;
+    std::vector<uint64_t> frameBins(BleLinkEmulator::LatencyBinNum, 0);
+    uint64_t drainedNum = 0;
+    uint64_t duplicateNum = 0;
+    uint8_t payload[20] = {};
+    uint8_t copyBuffer[NotificateData::MaxDataSize];
+    double nextFrameMs = 0.0;
+
+    auto drainFrame = [&](double nowMs) {
+        _BlePluginUpdateDevicdeManger();
+        int connectedNum = _BlePluginGetConectDeviceNum();
+        for (int i = 0; i < connectedNum; ++i) {
+            uint64_t addr = _BlePluginGetConectDevicAddr(i);
+            int notificationNum = _BlePluginGetDeviceNotificateNum(addr);
+            for (int n = 0; n < notificationNum; ++n) {
+                uint32_t seq = UINT32_MAX;
+                if (_BlePluginCopyDeviceNotificateData(addr, n, copyBuffer, sizeof(copyBuffer)) >= 4) {
+                    memcpy(&seq, copyBuffer, sizeof(seq));
+                }
+                if (seq >= queuedMs.size() || isDrained[seq]) {
+                    ++duplicateNum;
+                    continue;
+                }
+                isDrained[seq] = 1;
+                int bin = static_cast<int>(nowMs - queuedMs[seq]);
+                ++frameBins[(std::min)(bin, BleLinkEmulator::LatencyBinNum - 1)];
+                ++drainedNum;
+            }
+        }
+    };
+
+    auto start = std::chrono::high_resolution_clock::now();
+    LinkStats stats;
+    for (double nowMs = 0.0; nowMs < (virtualSec + settleSec) * 1000.0; nowMs += stepMs) {
+        bool isProducing = nowMs < virtualSec * 1000.0;
+        for (int i = 0; i < deviceNum && isProducing; ++i) {
+            while (nextSampleMs[i] <= nowMs) {
+                uint32_t seq = static_cast<uint32_t>(queuedMs.size());
+                memcpy(payload, &seq, sizeof(seq));
+                queuedMs.push_back(nowMs);
+                isDrained.push_back(0);
+                emulator.Notify(addrs[i], serviceUuid, charaUuid, payload, sizeof(payload));
+                nextSampleMs[i] += 1000.0 / hz;
+            }
+        }
+        emulator.AdvanceTo(nowMs);
+        if (nowMs < nextFrameMs) {
+            continue;
+        }
+        nextFrameMs += 1000.0 / frameHz;
+        drainFrame(nowMs);
+        // settled: nothing left in flight on any link
+        emulator.GetStats(stats);
+        if (!isProducing && stats.deliveredNum + stats.droppedNum == stats.queuedNum) {
+            break;
+        }
+    }
+    double wallSec = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+    // whatever reached a device after the last drain
+    drainFrame(emulator.GetNowMs());
+    emulator.GetStats(stats);
+    emulator.RemoveAll();
+    _BlePluginUpdateDevicdeManger();
+
+    double frameP99 = 0.0;
+    uint64_t count = 0;
+    for (int i = 0; i < BleLinkEmulator::LatencyBinNum && drainedNum > 0; ++i) {
+        count += frameBins[i];
+        if (count > static_cast<uint64_t>(0.99 * (drainedNum - 1))) {
+            frameP99 = i + 1;
+            break;
+        }
+    }
+    double appTargetP99Ms = targetP99Ms + 1000.0 / frameHz;
+    double p99 = emulator.GetLatencyPercentileMs(0.99);
+    bool isLatencyOk = drainedNum > 0 && frameP99 <= appTargetP99Ms;
+    bool isSettled = stats.deliveredNum + stats.droppedNum == stats.queuedNum;
+    bool isDrainOk = isSettled && drainedNum == stats.deliveredNum && duplicateNum == 0;
+    std::cout << std::dec << "link " << deviceNum << " devices x " << hz << "Hz, " << virtualSec << "s virtual in " <<
+        wallSec << "s (" << virtualSec / wallSec << "x)" << std::endl <<
+        "  interval " << params.connectionIntervalMs << "ms, " << params.packetsPerEvent << " packets/event, mtu " <<
+        params.attMtu << ", loss " << params.lossRate * 100.0f << "%" << std::endl <<
+        "  queued " << stats.queuedNum << " delivered " << stats.deliveredNum << " dropped " << stats.droppedNum <<
+        " retransmit " << stats.retransmitNum << " disconnect " << stats.disconnectNum << std::endl <<
+        "  to device p50 " << emulator.GetLatencyPercentileMs(0.5) << "ms p99 " << p99 << "ms max " <<
+        emulator.GetMaxLatencyMs() << "ms" << std::endl <<
+        "  to app p99 " << frameP99 << "ms at " << frameHz << "fps (target " << targetP99Ms << "ms + 1 frame = " <<
+        appTargetP99Ms << "ms) " << (isLatencyOk ? "ok" : "NG") << std::endl <<
+        "  drained " << drainedNum << " of " << stats.deliveredNum << ", unknown/duplicate " << duplicateNum <<
+        (isSettled ? "" : ", links not settled") << (isDrainOk ? " ok" : " NG") << std::endl;
+    return isLatencyOk && isDrainOk;
+}
+
+// time to first device of the polled startup (one check step per 16ms frame, scan after it) against
+// _BlePluginStartupAsync with the scan requested up front. needs a real adapter and something advertising
+static void PrintStartupTimings(const char* label) {
+    StartupTimings timings;
+    _BlePluginGetStartupTimings(&timings);
+    std::cout << std::dec << label << " status " << timings.status << std::endl <<
+        "  apartment " << timings.apartmentReadyMs << "ms adapter " << timings.adapterReadyMs <<
+        "ms status " << timings.statusReadyMs << "ms" << std::endl <<
+        "  scan " << timings.scanStartedMs << "ms first advertisement " << timings.firstAdvertisementMs <<
+        "ms first device " << timings.firstDeviceListedMs << "ms" << std::endl;
+}
+static bool WaitFirstDevice(int timeoutMs) {
+    for (int elapsed = 0; elapsed < timeoutMs; elapsed += 16) {
+        _BlePluginUpdateWatcher();
+        _BlePluginUpdateDevicdeManger();
+        if (_BlePluginScanGetDeviceLength() > 0) {
+            return true;
+        }
+        Sleep(16);
+    }
+    return false;
+}
+bool BenchmarkStartup() {
+    const int timeoutMs = 10000;
+    _BlePluginBleAdapterStatusRequest();
+    int status;
+    while ((status = _BlePluginBleAdapterUpdate()) < 0) {
+        Sleep(16);
+    }
+    if (status == 0) {
+        _BlePluginClearScanFilter();
+        _BlePluginStartScan();
+        WaitFirstDevice(timeoutMs);
+        _BlePluginStopScan();
+    }
+    PrintStartupTimings("polled");
+    _BlePluginFinalize();
+
+    _BlePluginClearScanFilter();
+    _BlePluginStartupAsync(true);
+    // a second start and a polled status request while the checks run: neither may block the
+    // frame or clear the running startup's timings
+    auto repeatStart = std::chrono::high_resolution_clock::now();
+    _BlePluginStartupAsync(true);
+    _BlePluginBleAdapterStatusRequest();
+    double repeatMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - repeatStart).count();
+    while ((status = _BlePluginGetStartupStatus()) < 0) {
+        Sleep(16);
+    }
+    if (status == 0) {
+        WaitFirstDevice(timeoutMs);
+        _BlePluginStopScan();
+    }
+    PrintStartupTimings("async");
+    StartupTimings timings;
+    _BlePluginGetStartupTimings(&timings);
+    bool isRepeatOk = repeatMs < 16.0 && timings.isScanEarly == 1 && timings.statusReadyMs >= 0.0;
+    std::cout << "  repeated start " << repeatMs << "ms " << (isRepeatOk ? "ok" : "NG") << std::endl;
+    _BlePluginFinalize();
+    return status == 0 && isRepeatOk;
+}
+
+#if defined(BLEPLUGIN_TIMELINE)
+// cost of one recorded timeline event
+void BenchmarkTimeline() {
+    const int loopNum = 10000000;
+    Timeline::GetInstance().Start();
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < loopNum; ++i) {
+        BLE_TIMELINE_INSTANT("bench", i);
+    }
+    auto elapsed = std::chrono::high_resolution_clock::now() - start;
+    Timeline::GetInstance().Stop();
+    std::cout << std::dec << "timeline event " <<
+        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count() / static_cast<double>(loopNum) <<
+        "ns" << std::endl;
+}
+#endif
+
+int main(int argc, char** argv)
 {
+    if (argc > 1 && strcmp(argv[1], "uuidbench") == 0) {
+        BenchmarkUuidConversion();
+        return 0;
+    }
+    if (argc > 1 && strcmp(argv[1], "adaptersim") == 0) {
+        return SimulateAdapterPlacement() ? 0 : 1;
+    }
+    if (argc > 1 && strcmp(argv[1], "decodebench") == 0) {
+        BenchmarkPayloadDecode();
+        return 0;
+    }
+    if (argc > 1 && strcmp(argv[1], "bulkbench") == 0) {
+        BenchmarkBulkTransfer();
+        return 0;
+    }
+    if (argc > 1 && strcmp(argv[1], "soak") == 0) {
+        // soak [seconds] [devices]
+        int durationSec = (argc > 2) ? atoi(argv[2]) : 120;
+        int deviceNum = (argc > 3) ? atoi(argv[3]) : 200;
+        return RunSoak(durationSec, (std::max)(deviceNum, 1)) ? 0 : 1;
+    }
+    if (argc > 1 && strcmp(argv[1], "linkbench") == 0) {
+        // linkbench [devices] [hz] [p99Ms]
+        int deviceNum = (argc > 2) ? atoi(argv[2]) : 40;
+        int hz = (argc > 3) ? atoi(argv[3]) : 100;
+        double targetP99Ms = (argc > 4) ? atof(argv[4]) : 20.0;
+        return BenchmarkLink((std::max)(deviceNum, 1), (std::max)(hz, 1), targetP99Ms) ? 0 : 1;
+    }
+    if (argc > 1 && strcmp(argv[1], "startupbench") == 0) {
+        return BenchmarkStartup() ? 0 : 1;
+    }
+#if defined(BLEPLUGIN_TIMELINE)
+    if (argc > 1 && strcmp(argv[1], "timelinebench") == 0) {
+        BenchmarkTimeline();
+        return 0;
+    }
+#endif
     // init
     _BlePluginBleAdapterStatusRequest();
 
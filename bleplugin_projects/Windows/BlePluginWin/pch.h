@@ -4,6 +4,9 @@
 /* workaround */
 #define USE_WORKAROUND 1
 
+/* Chrome trace timeline of plugin activity (BleTimeline.h) */
+// #define BLEPLUGIN_TIMELINE 1
+
 #if defined(USE_WORKAROUND)
 #include "winrt/base.h"
 namespace winrt::impl
@@ -19,6 +22,7 @@ namespace winrt::impl
 #include "winrt/Windows.Devices.Bluetooth.GenericAttributeProfile.h"
 #include "winrt/Windows.Devices.Bluetooth.Advertisement.h"
 #include "winrt/Windows.Devices.Radios.h"
+#include "winrt/Windows.Devices.Enumeration.h"
 #include <winrt/Windows.Storage.Streams.h>
 
 #include <iostream>
@@ -43,6 +47,7 @@ namespace BlePlugin {
     using WinRtGattReadResult = winrt::Windows::Devices::Bluetooth::GenericAttributeProfile::GattReadResult;
     using WinRtGattWriteResult = winrt::Windows::Devices::Bluetooth::GenericAttributeProfile::GattWriteResult;
     using WinRtGattCommunicateState = winrt::Windows::Devices::Bluetooth::GenericAttributeProfile::GattCommunicationStatus;
+    using WinRtGattWriteOption = winrt::Windows::Devices::Bluetooth::GenericAttributeProfile::GattWriteOption;
 
     template<class Value>
     using WinRtAsyncOperation = winrt::Windows::Foundation::IAsyncOperation<Value>;